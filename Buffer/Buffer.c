@@ -8,6 +8,9 @@
  * @date 4/1/19    Original creation
  * @date 10/5/21   Updated documention
  * @date 5/16/22   Fixed bug with tail not getting updated with circular inc
+ * @date 10/18/26  Added Buffer_WriteBytes and Buffer_ReadBytes. Init resets
+ *                 the head and tail
+ * @date 10/18/26  Added Buffer_PeekSpan and Buffer_Skip
  * 
  * @details
  *      A basic 8-bit ring buffer. To create a buffer, the minimum you will 
@@ -24,6 +27,7 @@
  ******************************************************************************/
 
 #include "Buffer.h"
+#include <string.h>
 
 // ***** Defines ***************************************************************
 
@@ -51,7 +55,10 @@ void Buffer_InitWithOverwrite(Buffer *self, uint8_t *arrayIn, uint8_t arrayInSiz
 {
     self->private.buffer = arrayIn;
     self->private.size = arrayInSize;
+    self->private.head = 0;
+    self->private.tail = 0;
     self->enableOverwrite = overwrite;
+    self->overflow = false;
     self->count = 0;
 }
 
@@ -96,6 +103,39 @@ void Buffer_WriteByte(Buffer *self, uint8_t receivedByte)
 
 // *****************************************************************************
 
+void Buffer_WriteBytes(Buffer *self, const uint8_t *data, uint16_t numBytes)
+{
+    /* One spot is always left open so that head == tail means empty */
+    uint16_t space = self->private.size - 1 - self->count;
+    uint16_t toEnd = self->private.size - self->private.head;
+
+    if(numBytes > space)
+    {
+        /* Fill what we can, then let WriteByte deal with the rest */
+        Buffer_WriteBytes(self, data, space);
+        while(space < numBytes)
+        {
+            Buffer_WriteByte(self, data[space++]);
+        }
+        return;
+    }
+
+    if(numBytes < toEnd)
+    {
+        memcpy(&self->private.buffer[self->private.head], data, numBytes);
+        self->private.head += numBytes;
+    }
+    else
+    {
+        memcpy(&self->private.buffer[self->private.head], data, toEnd);
+        memcpy(self->private.buffer, &data[toEnd], numBytes - toEnd);
+        self->private.head = numBytes - toEnd;
+    }
+    self->count += numBytes;
+}
+
+// *****************************************************************************
+
 uint8_t Buffer_ReadByte(Buffer *self)
 {
     uint8_t dataToReturn = 0;
@@ -113,6 +153,32 @@ uint8_t Buffer_ReadByte(Buffer *self)
 
 // *****************************************************************************
 
+uint16_t Buffer_ReadBytes(Buffer *self, uint8_t *dst, uint16_t max)
+{
+    uint16_t numBytes = (self->count < max) ? self->count : max;
+    uint16_t toEnd = self->private.size - self->private.tail;
+
+    if(numBytes == 0)
+        return 0;
+
+    if(numBytes < toEnd)
+    {
+        memcpy(dst, &self->private.buffer[self->private.tail], numBytes);
+        self->private.tail += numBytes;
+    }
+    else
+    {
+        memcpy(dst, &self->private.buffer[self->private.tail], toEnd);
+        memcpy(&dst[toEnd], self->private.buffer, numBytes - toEnd);
+        self->private.tail = numBytes - toEnd;
+    }
+    self->count -= numBytes;
+    self->overflow = false;
+    return numBytes;
+}
+
+// *****************************************************************************
+
 uint8_t Buffer_Peek(Buffer *self)
 {
     uint8_t dataToReturn = 0;
@@ -126,6 +192,34 @@ uint8_t Buffer_Peek(Buffer *self)
 
 // *****************************************************************************
 
+uint16_t Buffer_PeekSpan(Buffer *self, const uint8_t **data)
+{
+    uint16_t toEnd = self->private.size - self->private.tail;
+
+    *data = &self->private.buffer[self->private.tail];
+    return (self->count < toEnd) ? self->count : toEnd;
+}
+
+// *****************************************************************************
+
+void Buffer_Skip(Buffer *self, uint16_t numBytes)
+{
+    if(numBytes > self->count)
+        numBytes = self->count;
+
+    if(numBytes == 0)
+        return;
+
+    self->private.tail += numBytes;
+    if(self->private.tail >= self->private.size)
+        self->private.tail -= self->private.size;
+
+    self->count -= numBytes;
+    self->overflow = false;
+}
+
+// *****************************************************************************
+
 void Buffer_Flush(Buffer *self)
 {
     self->private.tail = self->private.head;
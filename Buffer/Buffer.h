@@ -8,6 +8,8 @@
  * @date 4/1/19    Original creation
  * @date 10/5/21   Updated documention
  * @date 2/21/22   Added doxygen
+ * @date 10/18/26  Added Buffer_WriteBytes and Buffer_ReadBytes
+ * @date 10/18/26  Added Buffer_PeekSpan and Buffer_Skip
  * 
  * @details
  *      A basic 8-bit ring buffer. To create a buffer, the minimum you will 
@@ -140,6 +142,23 @@ void Buffer_InitWithOverwrite(Buffer *self, uint8_t *arrayIn, uint8_t arrayInSiz
  */
 void Buffer_WriteByte(Buffer *self, uint8_t receivedByte);
 
+/***************************************************************************//**
+ * @brief Put a block of bytes into the buffer then update the head.
+ * 
+ * If all of it fits, it is copied in at most two pieces, one up to the end of
+ * the array and one from the beginning. This is meant for things like DMA 
+ * that hand you a whole span at once. If it doesn't all fit, the rest is 
+ * written one byte at a time the same as Buffer_WriteByte, so the overwrite
+ * and overflow settings work the same way.
+ * 
+ * @param self  pointer to the Buffer that you are using
+ * 
+ * @param data  pointer to the bytes to store
+ * 
+ * @param numBytes  how many bytes to store
+ */
+void Buffer_WriteBytes(Buffer *self, const uint8_t *data, uint16_t numBytes);
+
 /*******************************************************************************
  * @brief Read a byte from the buffer then update the tail
  * 
@@ -153,6 +172,21 @@ void Buffer_WriteByte(Buffer *self, uint8_t receivedByte);
  */
 uint8_t Buffer_ReadByte(Buffer *self);
 
+/***************************************************************************//**
+ * @brief Read up to max bytes from the buffer then update the tail
+ * 
+ * Copies in at most two pieces, the same as Buffer_WriteBytes.
+ * 
+ * @param self  pointer to the Buffer that you are using
+ * 
+ * @param dst  where to put the bytes
+ * 
+ * @param max  the most bytes you want
+ * 
+ * @return uint16_t  number of bytes read. 0 if empty
+ */
+uint16_t Buffer_ReadBytes(Buffer *self, uint8_t *dst, uint16_t max);
+
 /*******************************************************************************
  * @brief Read a byte from the buffer but don't update the tail
  * 
@@ -162,6 +196,31 @@ uint8_t Buffer_ReadByte(Buffer *self);
  */
 uint8_t Buffer_Peek(Buffer *self);
 
+/***************************************************************************//**
+ * @brief Look at the data in the buffer without copying it
+ * 
+ * Gives you a pointer to the oldest byte and how many bytes after it are in
+ * one piece. If the data wraps around the end of the array, you only get the
+ * part up to the end. Call Buffer_Skip when you're done with it, then call
+ * this again to get the rest.
+ * 
+ * @param self  pointer to the Buffer that you are using
+ * 
+ * @param data  set to point at the oldest byte
+ * 
+ * @return uint16_t  number of bytes you can look at. 0 if empty
+ */
+uint16_t Buffer_PeekSpan(Buffer *self, const uint8_t **data);
+
+/***************************************************************************//**
+ * @brief Throw away bytes from the buffer without reading them
+ * 
+ * @param self  pointer to the Buffer that you are using
+ * 
+ * @param numBytes  how many to throw away. Limited to the count.
+ */
+void Buffer_Skip(Buffer *self, uint16_t numBytes);
+
 /***************************************************************************//**
  * @brief Clear the buffer
  * 
@@ -6,6 +6,7 @@
  * @author Matthew Spinks <https://github.com/mspinksosu>
  * 
  * @date 2/25/23   Original creation
+ * @date 10/18/26  Added CRC-16
  * 
  * @details
  *      I decided to make a simple file to hold some different checksum 
@@ -28,6 +29,13 @@
 
 // ***** Global Variables ******************************************************
 
+/* The CRC is done four bits at a time. A full 256 entry table is faster, but
+it's 512 bytes. This one is 32 bytes and is still a lot faster than doing it
+one bit at a time. */
+static const uint16_t crc16Table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
 
 // ***** Static Functions Prototypes *******************************************
 
@@ -104,6 +112,29 @@ uint16_t Checksum_OnesComp16Bit(const uint8_t *array, uint16_t length)
     return (uint16_t)(~checksum);
 }
 
+// *****************************************************************************
+
+uint16_t Checksum_CRC16Update(uint16_t crc, uint8_t data)
+{
+    crc = (uint16_t)(crc << 4) ^ crc16Table[(crc >> 12) ^ (data >> 4)];
+    crc = (uint16_t)(crc << 4) ^ crc16Table[(crc >> 12) ^ (data & 0x0F)];
+    return crc;
+}
+
+// *****************************************************************************
+
+uint16_t Checksum_CRC16(const uint8_t *array, uint16_t length)
+{
+    uint16_t crc = CHECKSUM_CRC16_INITIAL;
+
+    for(uint16_t i = 0; i < length; i++)
+    {
+        crc = Checksum_CRC16Update(crc, array[i]);
+    }
+
+    return crc;
+}
+
 /*
  End of File
  */
\ No newline at end of file
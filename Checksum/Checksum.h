@@ -6,11 +6,18 @@
  * @author Matthew Spinks <https://github.com/mspinksosu>
  * 
  * @date 2/25/23   Original creation
+ * @date 10/18/26  Added CRC-16
  * 
  * @details
  *      I decided to make a simple file to hold some different checksum 
  * routines, since it's something that I use a lot.
  * 
+ * The CRC is CRC-16/CCITT-FALSE (polynomial 0x1021, starts at 0xFFFF). Send
+ * it high byte first. If you run the CRC over the data and the two CRC bytes
+ * together, you get zero when nothing is wrong, the same trick as the one's
+ * and two's comp checksums. That way you don't need to know where the data
+ * ends and the CRC begins when you're checking it.
+ * 
  * @section license License
  * SPDX-FileCopyrightText: © 2023 Matthew Spinks
  * SPDX-License-Identifier: Zlib
@@ -29,6 +36,7 @@
 
 // ***** Defines ***************************************************************
 
+#define CHECKSUM_CRC16_INITIAL  0xFFFF
 
 // ***** Global Variables ******************************************************
 
@@ -47,4 +55,9 @@ uint8_t Checksum_OnesComp8Bit(const uint8_t *array, uint16_t length);
 
 uint16_t Checksum_OnesComp16Bit(const uint8_t *array, uint16_t length);
 
+/* Add one more byte to a CRC. Start with CHECKSUM_CRC16_INITIAL. */
+uint16_t Checksum_CRC16Update(uint16_t crc, uint8_t data);
+
+uint16_t Checksum_CRC16(const uint8_t *array, uint16_t length);
+
 #endif  /* CHECKSUM_H */
\ No newline at end of file
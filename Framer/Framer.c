@@ -0,0 +1,529 @@
+/***************************************************************************//**
+ * @brief Packet Framer
+ * 
+ * @file Framer.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      See Framer.h for how to use it. The decoder is one byte at a time with
+ * a switch for each type of framing. The bytes that make it into the frame
+ * all go through PutByte. That's where the CRC is done and where it decides
+ * if the frame can stay where it is or needs to be copied.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "Framer.h"
+#include "Checksum.h"
+#include <stddef.h>
+#include <string.h>
+
+// ***** Defines ***************************************************************
+
+#define SLIP_END        0xC0
+#define SLIP_ESC        0xDB
+#define SLIP_ESC_END    0xDC
+#define SLIP_ESC_ESC    0xDD
+
+#define COBS_MAX_CODE   0xFF
+
+/* Decoder states */
+#define STATE_IDLE          0   // between frames
+#define STATE_DATA          1   // in the middle of a frame
+#define STATE_ESCAPE        2   // SLIP: the last byte was ESC
+#define STATE_DISCARD       3   // bad frame, wait for the end of it
+#define STATE_LENGTH_LOW    4   // length: got the high byte of the length
+#define STATE_SKIP          5   // length: frame is too big, skip over it
+
+// ***** Global Variables ******************************************************
+
+
+// ***** Static Function Prototypes ********************************************
+
+static void StartOver(Framer *self);
+static bool PutByte(Framer *self, const uint8_t *source, uint8_t data);
+static void FinishFrame(Framer *self);
+static void DecodeCOBS(Framer *self, const uint8_t *data, uint16_t length);
+static void DecodeSLIP(Framer *self, const uint8_t *data, uint16_t length);
+static void DecodeLength(Framer *self, const uint8_t *data, uint16_t length);
+
+// *****************************************************************************
+
+void Framer_Create(Framer *self, FramerType type, uint8_t *frameArray, uint16_t frameSize)
+{
+    self->type = type;
+    self->frame = frameArray;
+    self->frameSize = frameSize;
+    self->FrameReceivedCallback = NULL;
+    self->stats.frames = 0;
+    self->stats.zeroCopyFrames = 0;
+    self->stats.crcErrors = 0;
+    self->stats.framingErrors = 0;
+    self->stats.tooLong = 0;
+    StartOver(self);
+}
+
+// *****************************************************************************
+
+void Framer_Reset(Framer *self)
+{
+    StartOver(self);
+}
+
+// *****************************************************************************
+
+uint16_t Framer_Encode(Framer *self, const uint8_t *data, uint16_t length,
+    uint8_t *out, uint16_t outSize)
+{
+    uint16_t crc = Checksum_CRC16(data, length);
+    uint8_t crcBytes[2] = { (uint8_t)(crc >> 8), (uint8_t)crc };
+    uint32_t total = (uint32_t)length + 2;
+    uint16_t o = 0, codeIndex;
+    uint8_t code, b;
+
+    if(total > 0xFFFF)
+        return 0;
+
+    switch(self->type)
+    {
+        case FRAMER_COBS:
+            if(outSize < 2)
+                return 0;
+
+            /* Each block starts with a code that says how far it is to the
+            next zero. We don't know that until we get there, so save a spot
+            for it and fill it in later. */
+            codeIndex = o++;
+            code = 1;
+            for(uint32_t i = 0; i < total; i++)
+            {
+                b = (i < length) ? data[i] : crcBytes[i - length];
+                if(b != 0)
+                {
+                    if(o >= outSize)
+                        return 0;
+                    out[o++] = b;
+                    code++;
+                }
+                if(b == 0 || code == COBS_MAX_CODE)
+                {
+                    out[codeIndex] = code;
+                    if(o >= outSize)
+                        return 0;
+                    codeIndex = o++;
+                    code = 1;
+                }
+            }
+            out[codeIndex] = code;
+            if(o >= outSize)
+                return 0;
+            out[o++] = 0;
+            break;
+
+        case FRAMER_SLIP:
+            /* An END up front too. That flushes out any noise on the line. */
+            if(outSize < 2)
+                return 0;
+            out[o++] = SLIP_END;
+            for(uint32_t i = 0; i < total; i++)
+            {
+                b = (i < length) ? data[i] : crcBytes[i - length];
+                if(b == SLIP_END || b == SLIP_ESC)
+                {
+                    if(o + 2 > outSize)
+                        return 0;
+                    out[o++] = SLIP_ESC;
+                    out[o++] = (b == SLIP_END) ? SLIP_ESC_END : SLIP_ESC_ESC;
+                }
+                else
+                {
+                    if(o >= outSize)
+                        return 0;
+                    out[o++] = b;
+                }
+            }
+            if(o >= outSize)
+                return 0;
+            out[o++] = SLIP_END;
+            break;
+
+        case FRAMER_LENGTH:
+            if(total + 2 > outSize)
+                return 0;
+            out[o++] = (uint8_t)(length >> 8);
+            out[o++] = (uint8_t)length;
+            memcpy(&out[o], data, length);
+            o += length;
+            out[o++] = crcBytes[0];
+            out[o++] = crcBytes[1];
+            break;
+
+        default:
+            break;
+    }
+
+    return o;
+}
+
+// *****************************************************************************
+
+void Framer_Decode(Framer *self, const uint8_t *data, uint16_t length)
+{
+    if(data == NULL || length == 0)
+        return;
+
+    switch(self->type)
+    {
+        case FRAMER_COBS:
+            DecodeCOBS(self, data, length);
+            break;
+        case FRAMER_SLIP:
+            DecodeSLIP(self, data, length);
+            break;
+        case FRAMER_LENGTH:
+            DecodeLength(self, data, length);
+            break;
+        default:
+            break;
+    }
+
+    /* The caller is allowed to get rid of these bytes once we return. If part
+    of a frame is still sitting in them, it needs to be copied now. */
+    if(self->rawStart != NULL)
+    {
+        memcpy(self->frame, self->rawStart, self->length);
+        self->rawStart = NULL;
+    }
+}
+
+// *****************************************************************************
+
+void Framer_ProcessBuffer(Framer *self, Buffer *buffer)
+{
+    const uint8_t *span;
+    uint16_t length;
+
+    /* At most two times around. Once up to the end of the array, then once
+    more for what wrapped around to the beginning. More could come in while
+    we're in here, but that can wait until next time. */
+    for(uint8_t i = 0; i < 2; i++)
+    {
+        FRAMER_ENTER_CRITICAL();
+        length = Buffer_PeekSpan(buffer, &span);
+        FRAMER_EXIT_CRITICAL();
+
+        if(length == 0)
+            break;
+
+        Framer_Decode(self, span, length);
+
+        FRAMER_ENTER_CRITICAL();
+        Buffer_Skip(buffer, length);
+        FRAMER_EXIT_CRITICAL();
+    }
+}
+
+// *****************************************************************************
+
+const FramerStats *Framer_GetStats(Framer *self)
+{
+    return &self->stats;
+}
+
+// *****************************************************************************
+
+void Framer_SetFrameReceivedCallback(Framer *self,
+    void (*Function)(const uint8_t *data, uint16_t length))
+{
+    self->FrameReceivedCallback = Function;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Get ready for the next frame
+ */
+static void StartOver(Framer *self)
+{
+    self->length = 0;
+    self->rawStart = NULL;
+    self->crc = CHECKSUM_CRC16_INITIAL;
+    self->remaining = 0;
+    self->state = STATE_IDLE;
+    self->zeroPending = false;
+}
+
+/***************************************************************************//**
+ * @brief Add a byte to the frame
+ * 
+ * If the byte came straight from the input, source points to where it was.
+ * If it's one we made up, like the zero at the end of a COBS block or an
+ * escaped SLIP byte, source is NULL. As long as every byte so far came from
+ * the input, one right after the other, we don't copy anything. We just
+ * remember where it started. The first byte that breaks that rule means it's
+ * time to copy.
+ * 
+ * @return false if there's no more room in the frame array
+ */
+static bool PutByte(Framer *self, const uint8_t *source, uint8_t data)
+{
+    if(self->length >= self->frameSize)
+        return false;
+
+    self->crc = Checksum_CRC16Update(self->crc, data);
+
+    if(self->rawStart != NULL)
+    {
+        if(source == self->rawStart + self->length)
+        {
+            self->length++;
+            return true;
+        }
+
+        memcpy(self->frame, self->rawStart, self->length);
+        self->rawStart = NULL;
+    }
+    else if(self->length == 0 && source != NULL)
+    {
+        self->rawStart = source;
+        self->length = 1;
+        return true;
+    }
+
+    self->frame[self->length++] = data;
+    return true;
+}
+
+/***************************************************************************//**
+ * @brief The end of a frame is here. Check it and hand it over.
+ * 
+ * Running the CRC over the CRC bytes at the end gives zero if it's good.
+ */
+static void FinishFrame(Framer *self)
+{
+    const uint8_t *data = (self->rawStart != NULL) ? self->rawStart : self->frame;
+
+    if(self->length < 2)
+    {
+        self->stats.framingErrors++;
+    }
+    else if(self->crc != 0)
+    {
+        self->stats.crcErrors++;
+    }
+    else
+    {
+        self->stats.frames++;
+        if(self->rawStart != NULL)
+            self->stats.zeroCopyFrames++;
+
+        if(self->FrameReceivedCallback)
+            self->FrameReceivedCallback(data, self->length - 2);
+    }
+    StartOver(self);
+}
+
+/***************************************************************************//**
+ * @brief COBS. Zero is the end of the frame. The code at the start of each
+ * block is one more than how many bytes of data follow it. There's a zero
+ * after each block, unless the code was 0xFF or it's the last block.
+ */
+static void DecodeCOBS(Framer *self, const uint8_t *data, uint16_t length)
+{
+    uint8_t b;
+
+    for(uint16_t i = 0; i < length; i++)
+    {
+        b = data[i];
+
+        if(b == 0)
+        {
+            if(self->state == STATE_DATA)
+            {
+                if(self->remaining != 0)
+                {
+                    self->stats.framingErrors++;
+                    StartOver(self);
+                }
+                else
+                {
+                    FinishFrame(self);
+                }
+            }
+            else
+            {
+                /* Discarded or empty. Either way, start fresh */
+                StartOver(self);
+            }
+        }
+        else if(self->state == STATE_DISCARD)
+        {
+            continue;
+        }
+        else if(self->remaining == 0)
+        {
+            /* A code byte */
+            if(self->zeroPending && !PutByte(self, NULL, 0))
+            {
+                self->stats.tooLong++;
+                self->state = STATE_DISCARD;
+                continue;
+            }
+            self->remaining = b - 1;
+            self->zeroPending = (b != COBS_MAX_CODE);
+            self->state = STATE_DATA;
+        }
+        else
+        {
+            if(!PutByte(self, &data[i], b))
+            {
+                self->stats.tooLong++;
+                self->state = STATE_DISCARD;
+                continue;
+            }
+            self->remaining--;
+        }
+    }
+}
+
+/***************************************************************************//**
+ * @brief SLIP. END is the end of a frame. ESC means the next byte is a
+ * stand in for an END or ESC that was in the data.
+ */
+static void DecodeSLIP(Framer *self, const uint8_t *data, uint16_t length)
+{
+    uint8_t b;
+    bool fits = true;
+
+    for(uint16_t i = 0; i < length; i++)
+    {
+        b = data[i];
+
+        if(b == SLIP_END)
+        {
+            if(self->state == STATE_ESCAPE)
+            {
+                self->stats.framingErrors++;
+                StartOver(self);
+            }
+            else if(self->state == STATE_DATA && self->length > 0)
+            {
+                FinishFrame(self);
+            }
+            else
+            {
+                /* Discarded or back to back ENDs */
+                StartOver(self);
+            }
+            continue;
+        }
+
+        switch(self->state)
+        {
+            case STATE_DISCARD:
+                break;
+
+            case STATE_ESCAPE:
+                if(b == SLIP_ESC_END)
+                {
+                    fits = PutByte(self, NULL, SLIP_END);
+                }
+                else if(b == SLIP_ESC_ESC)
+                {
+                    fits = PutByte(self, NULL, SLIP_ESC);
+                }
+                else
+                {
+                    self->stats.framingErrors++;
+                    self->state = STATE_DISCARD;
+                    break;
+                }
+                self->state = STATE_DATA;
+                break;
+
+            default:
+                self->state = STATE_DATA;
+                if(b == SLIP_ESC)
+                    self->state = STATE_ESCAPE;
+                else
+                    fits = PutByte(self, &data[i], b);
+                break;
+        }
+
+        if(!fits)
+        {
+            self->stats.tooLong++;
+            self->state = STATE_DISCARD;
+            fits = true;
+        }
+    }
+}
+
+/***************************************************************************//**
+ * @brief Length. Two bytes of length, high byte first, then the data and
+ * CRC. Remaining counts down the data and CRC bytes.
+ */
+static void DecodeLength(Framer *self, const uint8_t *data, uint16_t length)
+{
+    uint8_t b;
+
+    for(uint16_t i = 0; i < length; i++)
+    {
+        b = data[i];
+
+        switch(self->state)
+        {
+            case STATE_IDLE:
+                self->remaining = (uint32_t)b << 8;
+                self->state = STATE_LENGTH_LOW;
+                break;
+
+            case STATE_LENGTH_LOW:
+                self->remaining = (self->remaining | b) + 2;
+                if(self->remaining > self->frameSize)
+                {
+                    self->stats.tooLong++;
+                    self->state = STATE_SKIP;
+                }
+                else
+                {
+                    self->state = STATE_DATA;
+                }
+                break;
+
+            case STATE_DATA:
+                /* We already know it fits */
+                PutByte(self, &data[i], b);
+                if(--self->remaining == 0)
+                    FinishFrame(self);
+                break;
+
+            case STATE_SKIP:
+                if(--self->remaining == 0)
+                    StartOver(self);
+                break;
+
+            default:
+                StartOver(self);
+                break;
+        }
+    }
+}
+
+/*
+ End of File
+ */
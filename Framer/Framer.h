@@ -0,0 +1,251 @@
+/***************************************************************************//**
+ * @brief Packet Framer Header File
+ * 
+ * @file Framer.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      Puts packets into frames for sending over a byte stream like a UART,
+ * and finds them again on the other end. Three kinds of framing are here:
+ * 
+ * COBS  Consistent Overhead Byte Stuffing. Zeros are taken out of the data
+ *       so that a zero can mark the end of each frame. Costs one byte for
+ *       every 254, plus one, plus the zero at the end.
+ * 
+ * SLIP  0xC0 marks the start and end of a frame. Any 0xC0 or 0xDB in the
+ *       data gets turned into two bytes. Simple, but if your data is full of
+ *       those, it can be twice as big.
+ * 
+ * Length  Two bytes of length (high byte first), then the data. No overhead
+ *         from stuffing, but if a byte gets lost, there's no way to find the
+ *         start of the next frame except by luck. Only use this on a link
+ *         where that doesn't happen, or that you reset when there's an error.
+ * 
+ * Every frame ends with a CRC-16 (see Checksum.h), high byte first. The CRC
+ * goes inside the framing, so it gets stuffed just like the data.
+ * 
+ * The decoder takes bytes as they come, however many you have, and keeps its
+ * place between calls. You don't have to give it whole frames. It doesn't
+ * look back at bytes it's already seen, so the state is just a few variables
+ * no matter how long the frame is. The frame array you give it needs to hold
+ * the biggest frame you want plus two bytes for the CRC.
+ * 
+ * When a good frame comes in, your callback is called with a pointer to the
+ * data and the length, not counting the CRC. If the frame didn't need any
+ * changes (no stuffed bytes) and all of it was in the bytes you gave it in
+ * that one call, the pointer is right into your bytes. Nothing is copied. If
+ * not, the bytes get copied to the frame array as they come in and you get
+ * that instead. Either way, the pointer is only good until your callback
+ * returns.
+ * 
+ * Framer_ProcessBuffer reads straight from the inside of a Buffer, so a
+ * frame that doesn't wrap around the end of the Buffer's array never gets
+ * copied at all. The bytes are removed from the Buffer after your callback is
+ * finished with them.
+ * 
+ * @section example_code Example Code
+ *      Framer myFramer;
+ *      uint8_t frameArray[66];  // 64 bytes of data plus the CRC
+ *      uint8_t txArray[FRAMER_MAX_ENCODED_SIZE(64)];
+ *      Framer_Create(&myFramer, FRAMER_COBS, frameArray, sizeof(frameArray));
+ *      Framer_SetFrameReceivedCallback(&myFramer, MyFrameHandler);
+ * 
+ *      // in your main loop
+ *      Framer_ProcessBuffer(&myFramer, &rxBuffer);
+ * 
+ *      // to send
+ *      uint16_t n = Framer_Encode(&myFramer, data, 10, txArray, sizeof(txArray));
+ *      UART_TransmitBuffer(&myUART, txArray, n);
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef FRAMER_H
+#define FRAMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Buffer.h"
+
+// ***** Defines ***************************************************************
+
+/* The most bytes Framer_Encode could need for n bytes of data with any type
+of framing. SLIP is the worst. Use this to size your arrays. */
+#define FRAMER_MAX_ENCODED_SIZE(n)  (2 * ((n) + 2) + 2)
+
+/* The Buffer is shared with the UART interrupt. These go around the parts of
+Framer_ProcessBuffer that change it. */
+#ifndef FRAMER_ENTER_CRITICAL
+#define FRAMER_ENTER_CRITICAL()
+#endif
+
+#ifndef FRAMER_EXIT_CRITICAL
+#define FRAMER_EXIT_CRITICAL()
+#endif
+
+// ***** Global Variables ******************************************************
+
+typedef enum FramerTypeTag
+{
+    FRAMER_COBS = 0,
+    FRAMER_SLIP,
+    FRAMER_LENGTH,
+} FramerType;
+
+typedef struct FramerStatsTag
+{
+    uint32_t frames;
+    uint32_t zeroCopyFrames;
+    uint32_t crcErrors;
+    uint32_t framingErrors;
+    uint32_t tooLong;
+} FramerStats;
+
+typedef struct FramerTag
+{
+    FramerType type;
+    uint8_t *frame;
+    uint16_t frameSize;
+    uint16_t length;
+    const uint8_t *rawStart;
+    uint16_t crc;
+    uint32_t remaining;
+    uint8_t state;
+    bool zeroPending;
+    FramerStats stats;
+    void (*FrameReceivedCallback)(const uint8_t *data, uint16_t length);
+} Framer;
+
+/**
+ * Description of struct members. You shouldn't really mess with any of these
+ * variables directly. That is why I made functions for you to use.
+ * 
+ * type  COBS, SLIP, or length
+ * 
+ * frame  Your array. Frames go here when they can't be left where they are.
+ * 
+ * frameSize  Size of your array. The data can be up to two less than this.
+ * 
+ * length  How many bytes of the frame we have so far, counting the CRC
+ * 
+ * rawStart  While the frame so far is still all in one piece in the bytes
+ *           we were given, this points to the start of it and nothing has
+ *           been copied. NULL once it's been copied to the frame array.
+ * 
+ * crc  The CRC of everything so far. Zero at the end means it's good.
+ * 
+ * remaining  COBS: bytes left in this block. Length: bytes left in the frame.
+ * 
+ * state  Where the decoder is
+ * 
+ * zeroPending  COBS: a zero goes in the frame before the next block
+ * 
+ * frames  Good frames given to the callback
+ * 
+ * zeroCopyFrames  How many of those didn't have to be copied
+ * 
+ * crcErrors, framingErrors, tooLong  Frames that were thrown away and why
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Function Prototypes *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Set up a framer
+ * 
+ * @param self  pointer to the Framer you are using
+ * 
+ * @param type  FRAMER_COBS, FRAMER_SLIP, or FRAMER_LENGTH
+ * 
+ * @param frameArray  array to put frames in. Biggest frame plus two.
+ * 
+ * @param frameSize  size of the array
+ */
+void Framer_Create(Framer *self, FramerType type, uint8_t *frameArray, uint16_t frameSize);
+
+/***************************************************************************//**
+ * @brief Forget about any frame that's partway in and start over
+ * 
+ * @param self  pointer to the Framer you are using
+ */
+void Framer_Reset(Framer *self);
+
+/***************************************************************************//**
+ * @brief Put data in a frame with a CRC
+ * 
+ * @param self  pointer to the Framer you are using
+ * 
+ * @param data  the data to send
+ * 
+ * @param length  number of bytes of data
+ * 
+ * @param out  where to put the frame
+ * 
+ * @param outSize  size of out. Use FRAMER_MAX_ENCODED_SIZE to be safe.
+ * 
+ * @return uint16_t  length of the frame. 0 if it didn't fit.
+ */
+uint16_t Framer_Encode(Framer *self, const uint8_t *data, uint16_t length,
+    uint8_t *out, uint16_t outSize);
+
+/***************************************************************************//**
+ * @brief Look through some received bytes for frames
+ * 
+ * The callback is called for each good frame. This goes through all of the
+ * bytes you give it.
+ * 
+ * @param self  pointer to the Framer you are using
+ * 
+ * @param data  the received bytes
+ * 
+ * @param length  how many bytes
+ */
+void Framer_Decode(Framer *self, const uint8_t *data, uint16_t length);
+
+/***************************************************************************//**
+ * @brief Look through everything in a Buffer for frames
+ * 
+ * The bytes are removed from the Buffer as they're done.
+ * 
+ * @param self  pointer to the Framer you are using
+ * 
+ * @param buffer  pointer to the Buffer with the received bytes
+ */
+void Framer_ProcessBuffer(Framer *self, Buffer *buffer);
+
+/***************************************************************************//**
+ * @brief Get the statistics
+ * 
+ * @param self  pointer to the Framer you are using
+ * 
+ * @return const FramerStats*  pointer to the statistics
+ */
+const FramerStats *Framer_GetStats(Framer *self);
+
+/***************************************************************************//**
+ * @brief Set a function to be called when a good frame comes in
+ * 
+ * The pointer you get is only good until your function returns. Copy the data
+ * if you need to keep it.
+ * 
+ * @param self  pointer to the Framer you are using
+ * 
+ * @param Function  format: void SomeFunction(const uint8_t *data, uint16_t length)
+ */
+void Framer_SetFrameReceivedCallback(Framer *self,
+    void (*Function)(const uint8_t *data, uint16_t length));
+
+#endif  /* FRAMER_H */
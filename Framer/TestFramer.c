@@ -0,0 +1,271 @@
+/* Program to fuzz the framer - MS */
+
+/* Build from the Framer folder with:
+gcc -std=c99 -I../Buffer -I../Checksum TestFramer.c Framer.c ../Buffer/Buffer.c
+../Checksum/Checksum.c
+
+For each type of framing, a few thousand frames of random data get encoded
+into one long stream. The data has a lot of zeros, 0xC0, and 0xDB in it so
+that there's plenty of stuffing going on. The stream goes into a Buffer a
+random number of bytes at a time, like it would from a UART, and the framer
+reads from the Buffer at random times. So frames get split up every which way,
+including around the end of the Buffer's array.
+
+Then it's done again with some of the frames messed up. A byte gets changed,
+added, or taken out. No frame should come out different than it went in, and
+COBS and SLIP should find the next good frame right after. Last, a pile of
+random garbage goes in and nothing should come out of it that's bigger than
+the frame array, and nothing past the frame array should get written. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Framer.h"
+
+#define NUM_FRAMES      4000
+#define MAX_DATA        200
+#define FRAME_SIZE      (MAX_DATA + 2)
+#define STREAM_SIZE     (NUM_FRAMES * FRAMER_MAX_ENCODED_SIZE(MAX_DATA))
+#define GARBAGE_SIZE    1000000UL
+#define GUARD_SIZE      16
+#define GUARD_BYTE      0xA5
+
+static Framer framer;
+static Buffer rxBuffer;
+static uint8_t rxArray[255];
+static uint8_t frameArray[FRAME_SIZE + GUARD_SIZE];
+
+/* Everything that was sent */
+static uint8_t sentData[NUM_FRAMES][MAX_DATA];
+static uint16_t sentLength[NUM_FRAMES];
+static bool sentBad[NUM_FRAMES];
+static uint8_t stream[STREAM_SIZE];
+static uint32_t streamLength;
+
+/* What came out. Each one has to match a sent frame, in order. */
+static uint32_t nextSent, received, wrongFrames, goodCorrupted;
+static uint16_t biggestFrame;
+
+// ***** Callbacks *************************************************************
+
+void FrameReceived(const uint8_t *data, uint16_t length)
+{
+    received++;
+    if(length > biggestFrame)
+        biggestFrame = length;
+
+    /* Skip ahead to the frame that matches. Any we skip were lost. */
+    while(nextSent < NUM_FRAMES)
+    {
+        uint32_t k = nextSent++;
+        if(sentLength[k] == length && memcmp(sentData[k], data, length) == 0)
+        {
+            if(sentBad[k])
+                goodCorrupted++;
+            return;
+        }
+    }
+    wrongFrames++;
+}
+
+// *****************************************************************************
+
+uint8_t RandomByte(void)
+{
+    /* Lots of the bytes that need special handling */
+    switch(rand() % 8)
+    {
+        case 0: case 1: return 0x00;
+        case 2: return 0xC0;
+        case 3: return 0xDB;
+        default: return (uint8_t)rand();
+    }
+}
+
+/* Make the frames and encode them. Some frames get messed up if badPercent
+is more than zero. */
+void MakeStream(FramerType type, uint8_t badPercent)
+{
+    uint8_t encoded[FRAMER_MAX_ENCODED_SIZE(MAX_DATA) + 1];
+    uint16_t n;
+
+    Framer_Create(&framer, type, frameArray, FRAME_SIZE);
+    streamLength = 0;
+
+    for(uint32_t k = 0; k < NUM_FRAMES; k++)
+    {
+        /* Every so often a frame with no special bytes at all */
+        bool plain = (rand() % 4 == 0);
+        sentLength[k] = rand() % (MAX_DATA + 1);
+        for(uint16_t i = 0; i < sentLength[k]; i++)
+            sentData[k][i] = plain ? (uint8_t)(1 + rand() % 0xBF) : RandomByte();
+
+        n = Framer_Encode(&framer, sentData[k], sentLength[k], encoded,
+            sizeof(encoded));
+
+        sentBad[k] = (n > 0 && (uint8_t)(rand() % 100) < badPercent);
+        if(sentBad[k])
+        {
+            uint16_t at = rand() % n;
+            switch(rand() % 3)
+            {
+                case 0:
+                    encoded[at] ^= (uint8_t)(1 + rand() % 255);
+                    break;
+                case 1:
+                    memmove(&encoded[at + 1], &encoded[at], n - at);
+                    encoded[at] = (uint8_t)rand();
+                    n++;
+                    break;
+                default:
+                    memmove(&encoded[at], &encoded[at + 1], n - at - 1);
+                    n--;
+                    break;
+            }
+        }
+
+        memcpy(&stream[streamLength], encoded, n);
+        streamLength += n;
+    }
+}
+
+/* Push the stream through the Buffer in random sized pieces */
+void RunStream(const uint8_t *data, uint32_t length)
+{
+    uint32_t sent = 0;
+
+    Buffer_Init(&rxBuffer, rxArray, sizeof(rxArray));
+    Framer_Reset(&framer);
+    Framer_SetFrameReceivedCallback(&framer, FrameReceived);
+    memset(&frameArray[FRAME_SIZE], GUARD_BYTE, GUARD_SIZE);
+    nextSent = received = wrongFrames = goodCorrupted = 0;
+    biggestFrame = 0;
+
+    while(sent < length)
+    {
+        uint16_t space = sizeof(rxArray) - 1 - Buffer_GetCount(&rxBuffer);
+        uint16_t n = 1 + rand() % 64;
+        if(n > space)
+            n = space;
+        if(n > length - sent)
+            n = length - sent;
+
+        Buffer_WriteBytes(&rxBuffer, &data[sent], n);
+        sent += n;
+
+        if(rand() % 3 == 0 || Buffer_GetCount(&rxBuffer) > 200)
+            Framer_ProcessBuffer(&framer, &rxBuffer);
+    }
+    while(Buffer_IsNotEmpty(&rxBuffer))
+        Framer_ProcessBuffer(&framer, &rxBuffer);
+}
+
+bool GuardIsGood(void)
+{
+    for(uint16_t i = FRAME_SIZE; i < FRAME_SIZE + GUARD_SIZE; i++)
+    {
+        if(frameArray[i] != GUARD_BYTE)
+            return false;
+    }
+    return true;
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const char *names[] = { "COBS", "SLIP", "Length" };
+    static uint8_t garbage[GARBAGE_SIZE];
+    const FramerStats *stats = Framer_GetStats(&framer);
+    int failed = 0;
+    char line[80];
+
+    srand(1);
+
+    for(FramerType type = FRAMER_COBS; type <= FRAMER_LENGTH; type++)
+    {
+        uint32_t numBad = 0;
+
+        printf("%s\n", names[type]);
+
+        /* Clean */
+        MakeStream(type, 0);
+        RunStream(stream, streamLength);
+        printf("  %u frames, %u bytes, %u zero copy\n", NUM_FRAMES,
+            streamLength, stats->zeroCopyFrames);
+        failed += Check("Every frame came through in order",
+            received == NUM_FRAMES && nextSent == NUM_FRAMES &&
+            wrongFrames == 0 && stats->crcErrors == 0 &&
+            stats->framingErrors == 0 && stats->tooLong == 0);
+        failed += Check("Some frames didn't need to be copied",
+            stats->zeroCopyFrames > NUM_FRAMES / 20);
+
+        /* Messed up. Length framing can't find its place again after a
+        byte is added or lost, so it only gets the clean test. */
+        if(type != FRAMER_LENGTH)
+        {
+            MakeStream(type, 10);
+            for(uint32_t k = 0; k < NUM_FRAMES; k++)
+                numBad += sentBad[k];
+            RunStream(stream, streamLength);
+            printf("  %u messed up, %u received, %u CRC errors, "
+                "%u framing errors\n", numBad, received, stats->crcErrors,
+                stats->framingErrors);
+            /* Some of the messed up ones still come out right, like when
+            SLIP's extra END at the start gets hit. That's fine. What can't
+            happen is a frame coming out different than what was sent. */
+            printf("  %u messed up ones came out right anyway\n",
+                goodCorrupted);
+            failed += Check("No bad frames got through", wrongFrames == 0);
+            /* A bad byte can take out the frame after it too, if it ate
+            the end marker */
+            failed += Check("Found the next good frame after each bad one",
+                received >= NUM_FRAMES - 2 * numBad);
+        }
+
+        /* Garbage */
+        for(uint32_t i = 0; i < GARBAGE_SIZE; i++)
+            garbage[i] = (uint8_t)rand();
+        Framer_Create(&framer, type, frameArray, FRAME_SIZE);
+        RunStream(garbage, GARBAGE_SIZE);
+        sprintf(line, "Garbage: %u frames, none too big, array safe",
+            received);
+        failed += Check(line, biggestFrame <= MAX_DATA && GuardIsGood() &&
+            received < 5);
+    }
+
+    /* Too long for the frame array, then a good one right after */
+    {
+        uint8_t small[10 + GUARD_SIZE], data[40], encoded[100];
+        uint16_t n1, n2;
+
+        for(FramerType type = FRAMER_COBS; type <= FRAMER_LENGTH; type++)
+        {
+            for(uint16_t i = 0; i < sizeof(data); i++)
+                data[i] = (uint8_t)(i + 1);
+            Framer_Create(&framer, type, small, 10);
+            Framer_SetFrameReceivedCallback(&framer, FrameReceived);
+            memset(&small[10], GUARD_BYTE, GUARD_SIZE);
+            n1 = Framer_Encode(&framer, data, sizeof(data), encoded,
+                sizeof(encoded));
+            n2 = Framer_Encode(&framer, data, 8, &encoded[n1],
+                sizeof(encoded) - n1);
+            memcpy(sentData[0], data, 8);
+            sentLength[0] = 8;
+            sentBad[0] = false;
+            nextSent = received = wrongFrames = 0;
+            Framer_Decode(&framer, encoded, n1 + n2);
+            sprintf(line, "%s: too long thrown out, next one good",
+                names[type]);
+            failed += Check(line, stats->tooLong == 1 && received == 1 &&
+                wrongFrames == 0 && small[10] == GUARD_BYTE);
+        }
+    }
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
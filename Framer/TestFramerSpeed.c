@@ -0,0 +1,157 @@
+/* Program to measure how fast the framer is - MS */
+
+/* Build from the Framer folder with:
+gcc -std=c99 -O2 -I../Buffer -I../Checksum TestFramerSpeed.c Framer.c
+../Buffer/Buffer.c ../Checksum/Checksum.c
+
+A batch of 64 byte frames gets encoded and then decoded over and over with
+each type of framing. Decoding is done two ways: straight from one big array,
+where every frame can be left where it is, and through a 255 byte Buffer a
+UART sized chunk at a time. Half the frames are plain data and half have the
+bytes that need stuffing. A UART at 1 Mbaud only moves 100,000 bytes a second,
+so this should be way more than enough, even on a processor a hundred times
+slower than a PC. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Framer.h"
+
+#define NUM_FRAMES      400
+#define DATA_SIZE       64
+#define NUM_PASSES      500
+#define CHUNK_SIZE      16
+#define MIN_BYTES_PER_SECOND    10000000.0
+
+static Framer framer;
+static Buffer rxBuffer;
+static uint8_t rxArray[255];
+static uint8_t frameArray[DATA_SIZE + 2];
+static uint8_t data[NUM_FRAMES][DATA_SIZE];
+/* Decode takes a uint16_t, so keep this under 64k */
+static uint8_t stream[NUM_FRAMES * FRAMER_MAX_ENCODED_SIZE(DATA_SIZE)];
+static uint32_t streamLength, received, checkSum;
+
+// ***** Callbacks *************************************************************
+
+void FrameReceived(const uint8_t *frame, uint16_t length)
+{
+    /* Touch the data so the decode can't be skipped */
+    received++;
+    checkSum += frame[0] + frame[length - 1];
+}
+
+// *****************************************************************************
+
+double Seconds(clock_t start, clock_t end)
+{
+    double s = (double)(end - start) / CLOCKS_PER_SEC;
+    return (s <= 0.0) ? 1.0 / CLOCKS_PER_SEC : s;
+}
+
+void DecodeFromBuffer(void)
+{
+    uint32_t sent = 0;
+
+    while(sent < streamLength)
+    {
+        uint16_t n = CHUNK_SIZE;
+        if(n > streamLength - sent)
+            n = streamLength - sent;
+
+        Buffer_WriteBytes(&rxBuffer, &stream[sent], n);
+        sent += n;
+
+        if(Buffer_GetCount(&rxBuffer) > 128)
+            Framer_ProcessBuffer(&framer, &rxBuffer);
+    }
+    while(Buffer_IsNotEmpty(&rxBuffer))
+        Framer_ProcessBuffer(&framer, &rxBuffer);
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const char *names[] = { "COBS", "SLIP", "Length" };
+    const FramerStats *stats = Framer_GetStats(&framer);
+    double total, encodeRate, arrayRate, bufferRate;
+    uint32_t zeroCopyArray, zeroCopyBuffer;
+    clock_t start;
+    int failed = 0;
+    char line[80];
+
+    srand(1);
+    for(uint32_t k = 0; k < NUM_FRAMES; k++)
+    {
+        for(uint16_t i = 0; i < DATA_SIZE; i++)
+        {
+            if(k % 2)
+                data[k][i] = (uint8_t)(1 + rand() % 0xBF);
+            else
+                data[k][i] = (rand() % 4 == 0) ? 0xC0 : (uint8_t)rand();
+        }
+    }
+
+    printf("%-8s %14s %14s %14s %12s\n", "", "encode MB/s", "array MB/s",
+        "Buffer MB/s", "zero copy");
+
+    for(FramerType type = FRAMER_COBS; type <= FRAMER_LENGTH; type++)
+    {
+        Framer_Create(&framer, type, frameArray, sizeof(frameArray));
+        Framer_SetFrameReceivedCallback(&framer, FrameReceived);
+
+        start = clock();
+        for(uint32_t p = 0; p < NUM_PASSES; p++)
+        {
+            streamLength = 0;
+            for(uint32_t k = 0; k < NUM_FRAMES; k++)
+            {
+                streamLength += Framer_Encode(&framer, data[k], DATA_SIZE,
+                    &stream[streamLength],
+                    (uint16_t)(sizeof(stream) - streamLength));
+            }
+        }
+        total = (double)streamLength * NUM_PASSES;
+        encodeRate = total / Seconds(start, clock());
+
+        received = 0;
+        start = clock();
+        for(uint32_t p = 0; p < NUM_PASSES; p++)
+            Framer_Decode(&framer, stream, streamLength);
+        arrayRate = total / Seconds(start, clock());
+        zeroCopyArray = stats->zeroCopyFrames;
+        failed += (received != NUM_FRAMES * NUM_PASSES);
+
+        Framer_Create(&framer, type, frameArray, sizeof(frameArray));
+        Framer_SetFrameReceivedCallback(&framer, FrameReceived);
+        Buffer_Init(&rxBuffer, rxArray, sizeof(rxArray));
+        received = 0;
+        start = clock();
+        for(uint32_t p = 0; p < NUM_PASSES; p++)
+            DecodeFromBuffer();
+        bufferRate = total / Seconds(start, clock());
+        zeroCopyBuffer = stats->zeroCopyFrames;
+        failed += (received != NUM_FRAMES * NUM_PASSES);
+
+        printf("%-8s %14.1f %14.1f %14.1f %5.0f%% %5.0f%%\n", names[type],
+            encodeRate / 1e6, arrayRate / 1e6, bufferRate / 1e6,
+            100.0 * zeroCopyArray / (NUM_FRAMES * NUM_PASSES),
+            100.0 * zeroCopyBuffer / (NUM_FRAMES * NUM_PASSES));
+
+        sprintf(line, "%s: every frame, faster than %.0f MB/s", names[type],
+            MIN_BYTES_PER_SECOND / 1e6);
+        failed += Check(line, received == NUM_FRAMES * NUM_PASSES &&
+            arrayRate > MIN_BYTES_PER_SECOND &&
+            bufferRate > MIN_BYTES_PER_SECOND);
+    }
+
+    printf("(zero copy: from the array, then from the Buffer)\n");
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
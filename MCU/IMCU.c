@@ -6,6 +6,12 @@
  * @author Matthew Spinks <https://github.com/mspinksosu>
  * 
  * @date 10/14/22  Original creation
+ * @date 10/18/26  Added tickless idle
+ * @date 10/18/26  Priority bitmap ready queue
+ * @date 10/18/26  Optional preemption from a software interrupt
+ * @date 10/18/26  Optional run time statistics for each task
+ * @date 10/18/26  Coroutine tasks
+ * @date 10/18/26  Event queues and publish/subscribe
  * 
  * @details
  *      An interface that will handle tasks such as sleep, shutdown, delay.
@@ -26,18 +32,72 @@
 #include "IMCU.h"
 #include <stddef.h>
 
+#ifdef MCU_TICKLESS
+#include "IHardwareTimer.h"
+#endif
+
+#ifdef MCU_TASK_STATS
+#include <stdio.h>
+#endif
+
 // ***** Defines ***************************************************************
 
 
 // ***** Global Variables ******************************************************
 
 static MCUTask *taskList = NULL;    // the head of the task list
-static MCUTask *currentTask = NULL; // the head of the pending task list
+static MCUTask *currentTask = NULL; // the task that is running right now
+
+/* One list of ready tasks for each priority. Each one points to the last task 
+in the list. A bit is set for every priority that has a task ready. Priority 0 
+is the most significant bit of the first word. */
+static MCUTask *readyTail[MCU_NUM_PRIORITIES];
+static uint32_t readyBitmap[MCU_PRIORITY_WORDS];
+
+#ifdef MCU_TICKLESS
+static MCUTickless *tickless = NULL; // the tick timer, if used
+#endif
+
+/* Tasks with a priority number below the threshold are run by the software 
+interrupt. While one of them is running, only higher ones can interrupt it. */
+static uint8_t preemptThreshold = 0;
+static volatile uint8_t preemptCeiling = 0;
+static void (*PreemptTrigger)(uint8_t priority) = NULL;
+
+/* Every event queue that MCU_TaskLoop checks, and a list of subscribers for 
+each topic */
+static MCUEventQueue *eventQueues = NULL;
+static MCUSubscriber *subscribers[MCU_NUM_EVENT_TOPICS];
+
+#ifdef MCU_TASK_STATS
+static uint32_t (*GetCounter)(void) = NULL;
+static uint32_t lastSample;
+static uint64_t elapsedTime, busyTime;
+
+/* Total time spent in preemptive tasks. A task that gets interrupted takes 
+however much this went up out of its own time. */
+static volatile uint32_t preemptedTime;
+#endif
 
 // ***** Static Function Prototypes ********************************************
 
-static void FindTasks(void);
-static void AddToPending(MCUTask *newTask);
+static void AddToReady(MCUTask *task);
+static MCUTask *TakeHighestReady(uint8_t first, uint8_t end);
+static void RunTask(MCUTask *task);
+static void RunCoroutine(void);
+static void SignalRemove(MCUCoroutine *co);
+static bool EventsPending(void);
+static inline uint8_t CountLeadingZeros(uint32_t x);
+
+#ifdef MCU_TICKLESS
+static void TicklessCatchUp(void);
+#endif
+
+#ifdef MCU_TASK_STATS
+static void StatsClear(MCUTask *task);
+static void StatsAddLateTicks(MCUTask *task, uint32_t ticks);
+static void StatsSample(void);
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 //                                                                            //
@@ -55,33 +115,111 @@ void MCU_AddTask(MCUTask *self, uint16_t period, uint8_t priority, void (*Functi
     if(period == 0)
         period = 1;
 
-    if(priority > 127)
-        priority = 127;
+    if(priority >= MCU_NUM_PRIORITIES)
+        priority = MCU_NUM_PRIORITIES - 1;
     
     self->period = period;
     self->count = period;
     self->priority = priority;
+    self->Function = Function;
+    self->nextPending = NULL;
+    self->pending = false;
+    self->resume = false;
+
+#ifdef MCU_TASK_STATS
+    StatsClear(self);
+#endif
 }
 
 // *****************************************************************************
 
 void MCU_TaskLoop(void)
 {
-    FindTasks();
+#ifdef MCU_TASK_STATS
+    StatsSample();
+#endif
+
+    if(eventQueues != NULL)
+        MCU_EventDispatch();
+
+    /* The preemptive tasks are left for the software interrupt */
+    MCU_ENTER_CRITICAL();
+    currentTask = TakeHighestReady(preemptThreshold, MCU_NUM_PRIORITIES);
+    MCU_EXIT_CRITICAL();
 
     if(currentTask != NULL)
     {
-        if(currentTask->Function != NULL)
-            currentTask->Function();
-        
-        currentTask->pending = false;
-        currentTask->count = currentTask->period;
-        currentTask = currentTask->nextPending;
+        RunTask(currentTask);
+        currentTask = NULL;
     }
 }
 
 // *****************************************************************************
 
+MCUTask *MCU_GetCurrentTask(void)
+{
+    return currentTask;
+}
+
+// *****************************************************************************
+
+void MCU_PreemptInit(uint8_t threshold, 
+    void (*TriggerSoftwareInterrupt)(uint8_t priority))
+{
+    if(TriggerSoftwareInterrupt == NULL)
+        threshold = 0;
+
+    if(threshold > MCU_NUM_PRIORITIES)
+        threshold = MCU_NUM_PRIORITIES;
+
+    preemptThreshold = threshold;
+    preemptCeiling = threshold;
+    PreemptTrigger = TriggerSoftwareInterrupt;
+}
+
+// *****************************************************************************
+
+void MCU_PreemptDispatch(void)
+{
+    /* Remember what we interrupted. It could be the main loop or it could be 
+    another preemptive task. */
+    uint8_t ceiling = preemptCeiling;
+    MCUTask *interrupted = currentTask;
+    MCUTask *task;
+
+#ifdef MCU_TASK_STATS
+    uint32_t start = 0, preemptedBefore = preemptedTime;
+    if(GetCounter != NULL)
+        start = GetCounter();
+#endif
+
+    do {
+        MCU_ENTER_CRITICAL();
+        task = TakeHighestReady(0, ceiling);
+        if(task != NULL)
+            preemptCeiling = task->priority;
+        MCU_EXIT_CRITICAL();
+
+        if(task != NULL)
+        {
+            currentTask = task;
+            RunTask(task);
+        }
+    } while(task != NULL);
+
+    preemptCeiling = ceiling;
+    currentTask = interrupted;
+
+#ifdef MCU_TASK_STATS
+    /* If this interrupted another dispatch, set it instead of adding to it. 
+    The time for the other one is already included in our time. */
+    if(GetCounter != NULL)
+        preemptedTime = preemptedBefore + (GetCounter() - start);
+#endif
+}
+
+// *****************************************************************************
+
 void MCU_TaskTick(void)
 {
     static MCUTask *task;
@@ -94,15 +232,557 @@ void MCU_TaskTick(void)
             task->count--;
             if(task->count == 0)
             {
-                task->addToPending = true;
+                AddToReady(task);
+            }
+        }
+#ifdef MCU_TASK_STATS
+        else
+        {
+            /* Still waiting or still running from last time */
+            StatsAddLateTicks(task, 1);
+        }
+#endif
+        task = task->next;
+    }
+}
+
+// *****************************************************************************
+
+void MCU_TaskTickMultiple(uint32_t ticks)
+{
+    MCUTask *task = taskList;
+
+    if(ticks == 0)
+        return;
+
+    while(task != NULL)
+    {
+        if(task->count > 0)
+        {
+            if(ticks >= task->count)
+            {
+#ifdef MCU_TASK_STATS
+                StatsAddLateTicks(task, ticks - task->count);
+#endif
+                task->count = 0;
+                AddToReady(task);
+            }
+            else
+            {
+                task->count -= ticks;
+            }
+        }
+#ifdef MCU_TASK_STATS
+        else
+        {
+            StatsAddLateTicks(task, ticks);
+        }
+#endif
+        task = task->next;
+    }
+}
+
+// *****************************************************************************
+
+uint32_t MCU_GetTicksUntilNextTask(void)
+{
+    MCUTask *task = taskList;
+    uint32_t soonest = MCU_NO_DEADLINE;
+
+    for(uint8_t i = 0; i < MCU_PRIORITY_WORDS; i++)
+    {
+        if(readyBitmap[i] != 0)
+            return 0;
+    }
+
+    if(EventsPending())
+        return 0;
+
+    while(task != NULL)
+    {
+        /* A count of zero means it's pending, which the bitmap already told 
+        us, or it's a coroutine that's waiting on a signal */
+        if(task->count != 0 && task->count < soonest)
+            soonest = task->count;
+
+        task = task->next;
+    }
+    return soonest;
+}
+
+// *****************************************************************************
+
+#ifdef MCU_TICKLESS
+
+void MCU_TicklessInit(MCUTickless *self, struct HWTimerTag *timer, 
+    uint8_t compChan, uint16_t countsPerTick)
+{
+    if(countsPerTick == 0)
+        countsPerTick = 1;
+
+    self->timer = timer;
+    self->compChan = compChan;
+    self->countsPerTick = countsPerTick;
+    self->GetNextDeadline = NULL;
+    self->TickCallback = NULL;
+    self->tickInterrupts = 0;
+    self->ticks = 0;
+
+    /* Leave one tick of room so that waking up a little late doesn't look 
+    like the count rolled over */
+    self->maxIdleTicks = 0xFFFF / countsPerTick;
+    if(self->maxIdleTicks > 1)
+        self->maxIdleTicks--;
+
+    self->lastTick = HWTimer_GetCount(timer);
+    HWTimer_SetCompare16Bit(timer, compChan, self->lastTick + countsPerTick);
+    HWTimer_SetCompareMatchCallback(timer, MCU_TicklessCompareMatch);
+    tickless = self;
+}
+
+// *****************************************************************************
+
+void MCU_TicklessSetTimerFunctions(MCUTickless *self, 
+    uint32_t (*GetNextDeadline)(void), void (*TickCallback)(uint32_t ticks))
+{
+    self->GetNextDeadline = GetNextDeadline;
+    self->TickCallback = TickCallback;
+}
+
+// *****************************************************************************
+
+void MCU_TicklessCompareMatch(uint8_t compChan)
+{
+    if(tickless == NULL || compChan != tickless->compChan)
+        return;
+
+    tickless->tickInterrupts++;
+    TicklessCatchUp();
+}
+
+#endif
+
+// *****************************************************************************
+
+void MCU_TaskIdle(MCUPowerMode powerMode)
+{
+#ifdef MCU_TICKLESS
+    bool slept = false;
+#endif
+
+    /* Interrupts stay off from the check until we are asleep. If one came in 
+    right after the check and made a task ready, we'd go to sleep anyway and 
+    not see it until something else woke us up. With them off, it just stays 
+    pending, which wakes us right back up, and it runs when they come back 
+    on. MCU_EnterLowPowerMode has to be able to do that. */
+    MCU_ENTER_CRITICAL();
+#ifdef MCU_TICKLESS
+    if(tickless != NULL)
+    {
+        uint32_t ticks = MCU_GetTicksUntilNextTask();
+        if(tickless->GetNextDeadline != NULL)
+            ticks = MCU_MinU32(ticks, tickless->GetNextDeadline());
+
+        if(ticks > tickless->maxIdleTicks)
+            ticks = tickless->maxIdleTicks;
+
+        if(ticks > 0)
+        {
+            /* Move the compare out from the last tick, not from right now. 
+            That way the tick stays lined up no matter when we go to sleep. */
+            uint16_t sleepCounts = ticks * tickless->countsPerTick;
+            HWTimer_SetCompare16Bit(tickless->timer, tickless->compChan, 
+                tickless->lastTick + sleepCounts);
+
+            /* If we were so slow getting here that we already went past it, 
+            the compare match won't happen until the count rolls over. Don't 
+            sleep. */
+            uint16_t elapsed = HWTimer_GetCount(tickless->timer) - 
+                tickless->lastTick;
+            if(elapsed < sleepCounts)
+                MCU_EnterLowPowerMode(powerMode);
+
+            slept = true;
+        }
+    }
+    else
+#endif
+    if(MCU_GetTicksUntilNextTask() != 0)
+    {
+        MCU_EnterLowPowerMode(powerMode);
+    }
+    MCU_EXIT_CRITICAL();
+
+#ifdef MCU_TICKLESS
+    /* If something else woke us up early, catch up on the ticks that went 
+    by and put the compare back to the next tick */
+    if(slept)
+        TicklessCatchUp();
+#endif
+}
+
+// *****************************************************************************
+
+void MCU_AddCoroutine(MCUCoroutine *self, uint8_t priority, 
+    void (*Function)(MCUCoroutine *self))
+{
+    MCU_AddTask(&self->task, 1, priority, RunCoroutine);
+    self->Function = Function;
+    self->waitSignal = NULL;
+    self->nextWaiting = NULL;
+    self->line = 0;
+    self->timedOut = false;
+
+    /* It isn't waiting on anything yet, so get it started */
+    self->task.period = 0;
+    self->task.count = 0;
+    AddToReady(&self->task);
+}
+
+// *****************************************************************************
+
+void MCU_CoroutineRestart(MCUCoroutine *self)
+{
+    MCU_ENTER_CRITICAL();
+    SignalRemove(self);
+    self->line = 0;
+    self->timedOut = false;
+    self->task.period = 0;
+    self->task.count = 0;
+    AddToReady(&self->task);
+    MCU_EXIT_CRITICAL();
+}
+
+// *****************************************************************************
+
+bool MCU_CoroutineIsEnded(MCUCoroutine *self)
+{
+    return self->line == MCU_CO_ENDED;
+}
+
+// *****************************************************************************
+
+bool MCU_CoroutineTimedOut(MCUCoroutine *self)
+{
+    return self->timedOut;
+}
+
+// *****************************************************************************
+
+void MCU_SignalSet(MCUSignal *self)
+{
+    MCUCoroutine *co, *next;
+
+    MCU_ENTER_CRITICAL();
+    co = self->waiting;
+    self->waiting = NULL;
+
+    while(co != NULL)
+    {
+        next = co->nextWaiting;
+        co->nextWaiting = NULL;
+        co->waitSignal = NULL;
+
+        /* If it's running right now, it gets run again when it's done. Its 
+        count gets cleared so a timeout doesn't wake it up a second time. */
+        if(co->task.pending)
+            co->task.resume = true;
+        else
+            AddToReady(&co->task);
+        co->task.count = 0;
+
+        co = next;
+    }
+    MCU_EXIT_CRITICAL();
+}
+
+// *****************************************************************************
+
+void MCU_EventQueueInit(MCUEventQueue *self, MCUEvent *buffer, uint16_t size)
+{
+    MCUEventQueue *queue = eventQueues;
+
+    self->buffer = buffer;
+    self->size = size;
+    self->head = 0;
+    self->tail = 0;
+    self->dropped = 0;
+
+    /* Don't add it to the list twice */
+    while(queue != NULL)
+    {
+        if(queue == self)
+            return;
+        queue = queue->next;
+    }
+    self->next = eventQueues;
+    eventQueues = self;
+}
+
+// *****************************************************************************
+
+bool MCU_EventPost(MCUEventQueue *self, uint8_t topic, uint32_t data)
+{
+    uint16_t head = self->head;
+    uint16_t next = head + 1;
+    volatile MCUEvent *slot;
+
+    if(next >= self->size)
+        next = 0;
+
+    if(next == self->tail)
+    {
+        self->dropped++;
+        return false;
+    }
+
+    /* Write the event through a volatile pointer so the compiler can't move 
+    it after the head. The task loop must never see the new head before the 
+    event is there. */
+    slot = &self->buffer[head];
+    slot->topic = topic;
+    slot->data = data;
+    self->head = next;
+    return true;
+}
+
+// *****************************************************************************
+
+uint16_t MCU_EventQueueGetDropped(MCUEventQueue *self)
+{
+    return self->dropped;
+}
+
+// *****************************************************************************
+
+void MCU_Subscribe(MCUSubscriber *self, uint8_t topic, 
+    void (*Handler)(const MCUEvent *event))
+{
+    MCUSubscriber **link;
+
+    if(topic >= MCU_NUM_EVENT_TOPICS)
+        return;
+
+    self->Handler = Handler;
+    self->topic = topic;
+    self->next = NULL;
+
+    /* Put it on the end so they get called in the order they subscribed */
+    link = &subscribers[topic];
+    while(*link != NULL)
+    {
+        if(*link == self)
+            return;
+        link = &(*link)->next;
+    }
+    *link = self;
+}
+
+// *****************************************************************************
+
+void MCU_Unsubscribe(MCUSubscriber *self)
+{
+    MCUSubscriber **link;
+
+    if(self->topic >= MCU_NUM_EVENT_TOPICS)
+        return;
+
+    link = &subscribers[self->topic];
+    while(*link != NULL)
+    {
+        if(*link == self)
+        {
+            *link = self->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    self->next = NULL;
+}
+
+// *****************************************************************************
+
+bool MCU_EventDispatch(void)
+{
+    MCUEventQueue *queue = eventQueues;
+    MCUSubscriber *sub;
+    volatile MCUEvent *slot;
+    MCUEvent event;
+    uint16_t tail;
+    bool dispatched = false;
+
+    while(queue != NULL)
+    {
+        tail = queue->tail;
+        while(tail != queue->head)
+        {
+            slot = &queue->buffer[tail];
+            event.topic = slot->topic;
+            event.data = slot->data;
+
+            /* Free up the spot before calling anybody, in case they post */
+            tail++;
+            if(tail >= queue->size)
+                tail = 0;
+            queue->tail = tail;
+
+            if(event.topic < MCU_NUM_EVENT_TOPICS)
+            {
+                for(sub = subscribers[event.topic]; sub != NULL; sub = sub->next)
+                {
+                    if(sub->Handler != NULL)
+                        sub->Handler(&event);
+                }
             }
+            dispatched = true;
         }
+        queue = queue->next;
+    }
+    return dispatched;
+}
+
+// *****************************************************************************
+
+void MCU_CoroutineYield(MCUCoroutine *self)
+{
+    self->task.resume = true;
+}
+
+// *****************************************************************************
+
+void MCU_CoroutineDelay(MCUCoroutine *self, uint16_t ticks)
+{
+    if(ticks == 0)
+        MCU_CoroutineYield(self);
+    else
+        self->task.period = ticks;
+}
+
+// *****************************************************************************
+
+void MCU_CoroutineWait(MCUCoroutine *self, MCUSignal *signal, uint16_t ticks)
+{
+    MCU_ENTER_CRITICAL();
+    self->waitSignal = signal;
+    self->nextWaiting = signal->waiting;
+    signal->waiting = self;
+    MCU_EXIT_CRITICAL();
+
+    /* With no timeout the period stays at zero and the tick leaves it alone */
+    self->task.period = ticks;
+}
+
+// *****************************************************************************
+
+#ifdef MCU_TASK_STATS
+
+void MCU_StatsInit(uint32_t (*GetCounterFunc)(void))
+{
+    GetCounter = GetCounterFunc;
+    MCU_StatsReset();
+}
+
+// *****************************************************************************
+
+void MCU_StatsReset(void)
+{
+    MCUTask *task = taskList;
+
+    while(task != NULL)
+    {
+        StatsClear(task);
         task = task->next;
     }
+    elapsedTime = 0;
+    busyTime = 0;
+
+    if(GetCounter != NULL)
+        lastSample = GetCounter();
 }
 
 // *****************************************************************************
 
+const MCUTaskStats *MCU_StatsGet(MCUTask *self)
+{
+    return &self->stats;
+}
+
+// *****************************************************************************
+
+uint64_t MCU_StatsGetElapsedTime(void)
+{
+    return elapsedTime;
+}
+
+// *****************************************************************************
+
+uint64_t MCU_StatsGetBusyTime(void)
+{
+    return busyTime;
+}
+
+// *****************************************************************************
+
+void MCU_StatsDump(void (*PrintLine)(const char *line))
+{
+    MCUTask *task = taskList;
+    MCUTaskStats *st;
+    char line[128];
+    uint16_t index = 0;
+    uint32_t average, permille;
+
+    if(PrintLine == NULL)
+        return;
+
+    StatsSample();
+    PrintLine("task pri period     runs    avg    min    max  jitter  misses"
+        "   cpu");
+
+    while(task != NULL)
+    {
+        st = &task->stats;
+        average = (st->runs > 0) ? (uint32_t)(st->totalTime / st->runs) : 0;
+        permille = (elapsedTime > 0) ? 
+            (uint32_t)(st->totalTime * 1000 / elapsedTime) : 0;
+
+        /* If it hasn't run yet, don't print the starting min values */
+        snprintf(line, sizeof(line), 
+            "%4u %3u %6u %8lu %6lu %6lu %6lu %7lu %7lu %3lu.%lu%%", 
+            index, task->priority, task->period, (unsigned long)st->runs, 
+            (unsigned long)average, 
+            (unsigned long)(st->runs > 0 ? st->minTime : 0), 
+            (unsigned long)st->maxTime, 
+            (unsigned long)(st->runs > 0 ? st->maxLatency - st->minLatency : 0),
+            (unsigned long)st->deadlineMisses, (unsigned long)(permille / 10), 
+            (unsigned long)(permille % 10));
+        PrintLine(line);
+        task = task->next;
+        index++;
+    }
+
+    /* Not every printf can do 64-bit numbers, so print it in two pieces */
+    permille = (elapsedTime > 0) ? 
+        (uint32_t)(busyTime * 1000 / elapsedTime) : 0;
+    index = snprintf(line, sizeof(line), "busy %lu.%lu%% of ", 
+        (unsigned long)(permille / 10), (unsigned long)(permille % 10));
+    if(elapsedTime >= 100000000)
+    {
+        snprintf(&line[index], sizeof(line) - index, "%lu%08lu counts", 
+            (unsigned long)(elapsedTime / 100000000), 
+            (unsigned long)(elapsedTime % 100000000));
+    }
+    else
+    {
+        snprintf(&line[index], sizeof(line) - index, "%lu counts", 
+            (unsigned long)elapsedTime);
+    }
+    PrintLine(line);
+}
+
+#endif
+
+// *****************************************************************************
+
 void MCU_Delay(uint32_t count)
 {
     while(count--);
@@ -139,72 +819,348 @@ void *MCU_ReverseMemcpy(void *dst, const void *src, uint16_t n)
 ////////////////////////////////////////////////////////////////////////////////
 
 /***************************************************************************//**
- * @brief Find pending tasks
+ * @brief Add a task to the back of the ready list for its priority
+ * 
+ * A task cannot be added if it's already pending. This can be called from the 
+ * tick interrupt or from the main loop. If the task is preemptive, the 
+ * software interrupt is set pending so that it runs as soon as possible.
  * 
- * Go through the lists of tasks and look for pending tasks and add them to the
- * pending task list. If two tasks have equal priority then it will be first
- * come, first serve. A task cannot be added to the pending list if it is
- * already in it.
+ * @param task  the task that is ready to run
  */
-static void FindTasks(void)
+static void AddToReady(MCUTask *task)
 {
-    static MCUTask *task;
-    task = taskList;
+    uint8_t p = task->priority;
+    bool added = false;
 
-    while(task != NULL)
+    MCU_ENTER_CRITICAL();
+    if(!task->pending)
     {
-        if(task->addToPending == true && task->pending == false)
+        MCUTask *tail = readyTail[p];
+
+        if(tail == NULL)
         {
-            AddToPending(task);
-            task->addToPending = false;
+            /* Only one in the list, so it points to itself */
+            task->nextPending = task;
+            readyBitmap[p >> 5] |= 0x80000000UL >> (p & 0x1F);
         }
-        task = task->next;
+        else
+        {
+            task->nextPending = tail->nextPending;
+            tail->nextPending = task;
+        }
+        readyTail[p] = task;
+        task->pending = true;
+        added = true;
+#ifdef MCU_TASK_STATS
+        if(GetCounter != NULL)
+            task->stats.readyTime = GetCounter();
+#endif
     }
+    MCU_EXIT_CRITICAL();
+
+    if(added && p < preemptThreshold)
+        PreemptTrigger(p);
 }
 
 /***************************************************************************//**
- * @brief Add a task to the pending list
+ * @brief Take the first task out of the highest priority ready list
+ * 
+ * The first word of the bitmap that isn't zero has the highest priority. The 
+ * number of leading zeros in that word is how far down in that word it is. 
+ * Only priorities from first up to but not including end are looked at. The 
+ * bits before first are masked off.
+ * 
+ * @param first  the highest priority (lowest number) to look at
  * 
- * Go through the list of pending tasks and find where to insert the new task 
- * based on priority. The currentTask pointer will always point to the task to 
- * be executed. I've made a pending list within the list of tasks and made it 
- * so that no task can jump in front of the current task. Except if the pending
- * task list is empty. Then the new task becomes the head of the list.
+ * @param end  one past the lowest priority to look at
  * 
- * @param newTask  the pending task to be added
+ * @return MCUTask*  the task to run, or NULL if nothing is ready
  */
-static void AddToPending(MCUTask *newTask)
+static MCUTask *TakeHighestReady(uint8_t first, uint8_t end)
 {
-    static MCUTask *task;
-    task = currentTask;
+    uint32_t word;
 
-    if(task == NULL)
+    for(uint8_t i = first >> 5; i < MCU_PRIORITY_WORDS; i++)
     {
-        /* Make the new task point to the current head of the list */
-        newTask->nextPending = currentTask;
-        /* Move the head to point to the new task */
-        currentTask = newTask;
+        word = readyBitmap[i];
+        if(i == (first >> 5))
+            word &= 0xFFFFFFFFUL >> (first & 0x1F);
+
+        if(word != 0)
+        {
+            uint8_t p = (i << 5) + CountLeadingZeros(word);
+            if(p >= end)
+                return NULL;
+
+            MCUTask *tail = readyTail[p];
+            MCUTask *head = tail->nextPending;
+
+            if(head == tail)
+            {
+                readyTail[p] = NULL;
+                readyBitmap[i] &= ~(0x80000000UL >> (p & 0x1F));
+            }
+            else
+            {
+                tail->nextPending = head->nextPending;
+            }
+            head->nextPending = NULL;
+            return head;
+        }
     }
-    else
+    return NULL;
+}
+
+/***************************************************************************//**
+ * @brief Run a task and get it ready for next time
+ * 
+ * @param task  the task to run
+ */
+static void RunTask(MCUTask *task)
+{
+#ifdef MCU_TASK_STATS
+    MCUTaskStats *st = &task->stats;
+    uint32_t start = 0, time, preemptedBefore = preemptedTime;
+
+    if(GetCounter != NULL)
     {
-        MCUTask *tmp;
-        while(task->nextPending != NULL)
-        {
-            tmp = task->nextPending;
+        start = GetCounter();
+        time = start - st->readyTime;
+        if(time < st->minLatency)
+            st->minLatency = time;
+        if(time > st->maxLatency)
+            st->maxLatency = time;
+    }
+#endif
+
+    if(task->Function != NULL)
+        task->Function();
+
+#ifdef MCU_TASK_STATS
+    st->runs++;
+    if(GetCounter != NULL)
+    {
+        /* Take out any time that preemptive tasks took from us */
+        time = (GetCounter() - start) - (preemptedTime - preemptedBefore);
+        st->totalTime += time;
+        busyTime += time;
+        if(time < st->minTime)
+            st->minTime = time;
+        if(time > st->maxTime)
+            st->maxTime = time;
+    }
+    st->lateTicks = 0;
+#endif
+
+    /* Finish up with the tick blocked so it doesn't see the task half done. A 
+    coroutine that yielded, or got signalled while it was running, goes right 
+    back in the ready queue. */
+    MCU_ENTER_CRITICAL();
+    task->pending = false;
+    task->count = task->period;
+    if(task->resume)
+    {
+        task->resume = false;
+        AddToReady(task);
+    }
+    MCU_EXIT_CRITICAL();
+}
+
+/***************************************************************************//**
+ * @brief The task function for every coroutine
+ * 
+ * The scheduler runs the coroutine's task like normal, and this calls the 
+ * coroutine. If it's still on a signal's list, then the signal never came and 
+ * the timeout is what woke it up. The period is cleared first, so unless the 
+ * coroutine waits on some ticks, the tick will leave it alone.
+ */
+static void RunCoroutine(void)
+{
+    /* The task is the first thing in the coroutine, so this works */
+    MCUCoroutine *co = (MCUCoroutine *)currentTask;
+
+    MCU_ENTER_CRITICAL();
+    co->timedOut = (co->waitSignal != NULL);
+    SignalRemove(co);
+    co->task.resume = false;
+    MCU_EXIT_CRITICAL();
+
+    co->task.period = 0;
+    co->Function(co);
+}
+
+/***************************************************************************//**
+ * @brief Take a coroutine off the list of the signal it's waiting on
+ * 
+ * Call this from inside a critical section.
+ * 
+ * @param co  the coroutine
+ */
+static void SignalRemove(MCUCoroutine *co)
+{
+    MCUCoroutine **link;
 
-            if(newTask->priority < tmp->priority)
-                break;
+    if(co->waitSignal == NULL)
+        return;
 
-            task = tmp;
+    link = &co->waitSignal->waiting;
+    while(*link != NULL)
+    {
+        if(*link == co)
+        {
+            *link = co->nextWaiting;
+            break;
         }
-        /* Insert after task. Make new task point to previous->nextPending */
-        newTask->nextPending = task->nextPending;
-        /* Make previous pending task point to our new task */
-        task->nextPending = newTask;
+        link = &(*link)->nextWaiting;
+    }
+    co->nextWaiting = NULL;
+    co->waitSignal = NULL;
+}
+
+/***************************************************************************//**
+ * @brief Count the number of zeros before the first 1, starting from the MSB
+ * 
+ * Most compilers have a built-in for this that turns into a single 
+ * instruction (CLZ on ARM). Otherwise, it's done with a binary search.
+ * 
+ * @param x  the number to look at. Must not be zero
+ * 
+ * @return uint8_t  0 to 31
+ */
+static inline uint8_t CountLeadingZeros(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint8_t)__builtin_clz(x);
+#else
+    uint8_t n = 0;
+    if((x & 0xFFFF0000UL) == 0) { n += 16; x <<= 16; }
+    if((x & 0xFF000000UL) == 0) { n += 8;  x <<= 8;  }
+    if((x & 0xF0000000UL) == 0) { n += 4;  x <<= 4;  }
+    if((x & 0xC0000000UL) == 0) { n += 2;  x <<= 2;  }
+    if((x & 0x80000000UL) == 0) { n += 1; }
+    return n;
+#endif
+}
+
+/***************************************************************************//**
+ * @brief See if any event queue has something in it
+ * 
+ * @return true if there's at least one event waiting
+ */
+static bool EventsPending(void)
+{
+    MCUEventQueue *queue = eventQueues;
+
+    while(queue != NULL)
+    {
+        if(queue->head != queue->tail)
+            return true;
+        queue = queue->next;
+    }
+    return false;
+}
+
+#ifdef MCU_TASK_STATS
+
+/***************************************************************************//**
+ * @brief Reset the statistics for one task
+ * 
+ * The minimums start out as high as they can go so the first run sets them.
+ * 
+ * @param task  the task to clear
+ */
+static void StatsClear(MCUTask *task)
+{
+    MCUTaskStats *st = &task->stats;
+
+    st->runs = 0;
+    st->totalTime = 0;
+    st->minTime = 0xFFFFFFFF;
+    st->maxTime = 0;
+    st->minLatency = 0xFFFFFFFF;
+    st->maxLatency = 0;
+    st->deadlineMisses = 0;
+    st->lateTicks = 0;
+}
+
+/***************************************************************************//**
+ * @brief Count ticks that went by while a task was waiting or running
+ * 
+ * Every time the number of late ticks reaches another whole period, the task 
+ * missed another deadline.
+ * 
+ * @param task  the task that's late
+ * 
+ * @param ticks  how many ticks went by
+ */
+static void StatsAddLateTicks(MCUTask *task, uint32_t ticks)
+{
+    MCUTaskStats *st = &task->stats;
+    uint32_t before = st->lateTicks;
+
+    /* A coroutine waiting on a signal has no deadline */
+    if(task->period == 0)
+        return;
+
+    st->lateTicks += ticks;
+    st->deadlineMisses += st->lateTicks / task->period - before / task->period;
+}
+
+/***************************************************************************//**
+ * @brief Add the time since the last sample to the total elapsed time
+ * 
+ * This keeps a 64-bit total from a 32-bit counter. It just has to be called 
+ * at least once before the counter rolls over.
+ */
+static void StatsSample(void)
+{
+    uint32_t now;
+
+    if(GetCounter == NULL)
+        return;
+
+    now = GetCounter();
+    elapsedTime += (uint32_t)(now - lastSample);
+    lastSample = now;
+}
+
+#endif
+
+#ifdef MCU_TICKLESS
+
+/***************************************************************************//**
+ * @brief Count the ticks since the last one and set up the next tick
+ * 
+ * The number of whole ticks that went by is figured from the hardware count, 
+ * so it doesn't matter if we were asleep for one tick or a hundred. Whatever 
+ * is left over stays in the count for next time. This gets called from the 
+ * compare match interrupt and from MCU_TaskIdle, so the whole thing is done 
+ * in a critical section. Otherwise the interrupt could count the same ticks 
+ * a second time in between reading lastTick and moving it.
+ */
+static void TicklessCatchUp(void)
+{
+    MCU_ENTER_CRITICAL();
+    uint16_t elapsed = HWTimer_GetCount(tickless->timer) - tickless->lastTick;
+    uint32_t ticks = elapsed / tickless->countsPerTick;
+
+    if(ticks > 0)
+    {
+        tickless->lastTick += ticks * tickless->countsPerTick;
+        tickless->ticks += ticks;
+        MCU_TaskTickMultiple(ticks);
+
+        if(tickless->TickCallback != NULL)
+            tickless->TickCallback(ticks);
     }
-    newTask->pending = true;
+
+    HWTimer_SetCompare16Bit(tickless->timer, tickless->compChan, 
+        tickless->lastTick + tickless->countsPerTick);
+    MCU_EXIT_CRITICAL();
 }
 
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 //                                                                            //
 // ***** Interface Functions *************************************************//
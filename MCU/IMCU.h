@@ -6,12 +6,180 @@
  * @author Matthew Spinks <https://github.com/mspinksosu>
  * 
  * @date 10/14/22  Original creation
+ * @date 10/18/26  Added tickless idle
+ * @date 10/18/26  Priority bitmap ready queue
+ * @date 10/18/26  Optional preemption from a software interrupt
+ * @date 10/18/26  Optional run time statistics for each task
+ * @date 10/18/26  Coroutine tasks
+ * @date 10/18/26  Event queues and publish/subscribe
  * 
  * @details
  *      An interface that will handle tasks such as sleep, shutdown, delay.
  * It will also have a very simple scheduler.
  * // TODO more details
  * 
+ * Tickless idle: Normally you call MCU_TaskTick from a 1 ms interrupt, and the 
+ * processor wakes up every tick even if there's nothing to do. If you have a 
+ * spare hardware timer, you can let it run the scheduler tick instead. Define 
+ * MCU_TICKLESS in your project settings and add IHardwareTimer.c to your 
+ * project. Without it, none of the tickless code is compiled and IMCU doesn't 
+ * need the HWTimer interface at all. Set the timer up as a free-running 
+ * 16-bit timer (period of 0xFFFF) and give it to MCU_TicklessInit along with 
+ * how many timer counts make one tick. The scheduler uses a compare channel 
+ * to make its tick. When you call MCU_TaskIdle, it figures out how many ticks 
+ * until the next task (and the next software timer if you give it a function 
+ * for that), moves the compare value out that far, and goes to sleep. When it 
+ * wakes up, every task gets caught up by however many ticks actually went by. 
+ * Because the compare value is always moved from the last tick and not from 
+ * when we went to sleep, the tick doesn't drift no matter how often we sleep 
+ * or get woken up early.
+ * 
+ * MCU_TaskIdle looks for work and goes to sleep inside MCU_ENTER_CRITICAL. 
+ * Otherwise an interrupt that sets a signal or posts an event right after 
+ * the check would be missed, and we'd sleep until the next tick or longer. 
+ * So MCU_EnterLowPowerMode gets called with interrupts masked, and it has to 
+ * wake up when one is pending anyway. The interrupt runs once 
+ * MCU_EXIT_CRITICAL unmasks it. On a Cortex-M, __WFI does exactly that when 
+ * PRIMASK is set.
+ * 
+ * Ready queue: When a task's count runs out, the tick puts it straight into a 
+ * first in, first out list for its priority and sets a bit for that priority. 
+ * The task loop finds the highest priority list with something in it by 
+ * counting the leading zeros of the bitmap, one 32-bit word at a time. So 
+ * picking the next task takes the same amount of time whether you have five 
+ * tasks or a thousand. Each list only keeps a pointer to its last task, and 
+ * the last task points back around to the first, so each priority level only 
+ * costs one pointer. If you don't need all 128 levels, define 
+ * MCU_NUM_PRIORITIES to something smaller to save RAM.
+ * 
+ * The tick adds tasks to the ready queue from an interrupt, so the task loop 
+ * needs to briefly block that interrupt while it takes a task out. Define 
+ * MCU_ENTER_CRITICAL and MCU_EXIT_CRITICAL for your processor. They are used 
+ * in pairs inside the same function, so something that saves the interrupt 
+ * state in a local variable and restores it works fine. For example on a 
+ * Cortex-M:
+ * 
+ *      #define MCU_ENTER_CRITICAL()  uint32_t primask = __get_PRIMASK(); \
+ *                                    __disable_irq()
+ *      #define MCU_EXIT_CRITICAL()   __set_PRIMASK(primask)
+ * 
+ * Preemption: Normally every task runs to completion from MCU_TaskLoop, so one
+ * long task holds up everything else until it returns, even a high priority 
+ * task. If you call MCU_PreemptInit, every task with a priority number below 
+ * the threshold you give it gets run from a software interrupt instead. When 
+ * the tick makes one of those tasks ready, it calls your trigger function, 
+ * which should set a software interrupt pending. That interrupt calls 
+ * MCU_PreemptDispatch, which runs the ready high priority tasks right away, 
+ * right over top of whatever task the main loop was in the middle of. The 
+ * rest of the tasks are still run from MCU_TaskLoop just like before. Think 
+ * of it as two levels. Tasks below the threshold act like interrupts and the 
+ * rest act like the main loop.
+ * 
+ * The software interrupt must be a lower priority than the tick interrupt, 
+ * so that the tick can finish before any tasks run. On a Cortex-M, PendSV 
+ * is made for this. Give it the lowest priority and do this:
+ * 
+ *      void TriggerPendSV(uint8_t priority) 
+ *      { 
+ *          SCB->ICSR = SCB_ICSR_PENDSVSET_Msk; 
+ *      }
+ *      void PendSV_Handler(void) { MCU_PreemptDispatch(); }
+ * 
+ * The trigger gets the priority of the task so that you could use a few 
+ * different software interrupts at different levels if you want (unused 
+ * interrupt vectors work fine). A dispatch that interrupts another one only 
+ * runs tasks with a higher priority than the one it interrupted. With only 
+ * PendSV, a high priority task that becomes ready while another preemptive 
+ * task is running just runs after it, before going back to the main loop.
+ * 
+ * Preemptive tasks share data with everything below them the same way an 
+ * interrupt would, so be careful. MCU_ENTER_CRITICAL must also block the 
+ * software interrupt. Disabling all interrupts does that already.
+ * 
+ * Statistics: Define MCU_TASK_STATS (in your project settings, so that every 
+ * file sees it) and each task keeps track of how many times it ran, how long 
+ * it took, how late it started, and how many times it missed its deadline. 
+ * A deadline is missed when a whole period goes by and the task is still 
+ * waiting to run or still running. Times are measured with whatever counter 
+ * you give to MCU_StatsInit. On a Cortex-M3 or higher the DWT cycle counter 
+ * is perfect for this:
+ * 
+ *      uint32_t GetCycles(void) { return DWT->CYCCNT; }
+ * 
+ *      CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+ *      DWT->CYCCNT = 0;
+ *      DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+ *      MCU_StatsInit(GetCycles);
+ * 
+ * The counter only needs to count up and roll over at 32 bits. It doesn't 
+ * have to be cycles. Any unit works as long as it's fast enough to see your 
+ * tasks. If a task gets interrupted by a preemptive task, the time spent in 
+ * the preemptive task is taken out of its time. Regular interrupts are not 
+ * taken out. MCU_StatsDump gives you one line of text for each task, or you 
+ * can look at the numbers yourself with MCU_StatsGet. Without MCU_TASK_STATS 
+ * none of this is compiled and the tasks are the same size as before.
+ * 
+ * Coroutines: A lot of code ends up as a big switch(state) that gets called 
+ * over and over to see if it's time to move to the next state. A coroutine 
+ * lets you write that as straight line code that waits in the middle. It's 
+ * the protothread trick. The MCU_CO macros put a case label at every place 
+ * you wait, save which one you're at, and return. The next time the function 
+ * gets called it jumps right back to that case. There's no stack for each 
+ * coroutine, so it only costs the MCUCoroutine struct, which is a task and a 
+ * few more pointers.
+ * 
+ *      MCUSignal rxSignal;     // MCU_SignalSet(&rxSignal) from the UART ISR
+ * 
+ *      void Blink(MCUCoroutine *co)
+ *      {
+ *          MCU_CO_BEGIN(co);
+ *          while(1)
+ *          {
+ *              LedOn();
+ *              MCU_CO_DELAY(co, 100);
+ *              LedOff();
+ *              MCU_CO_AWAIT_COND(co, &rxSignal, rxCount > 0);
+ *          }
+ *          MCU_CO_END(co);
+ *      }
+ * 
+ * A coroutine isn't run at all while it waits. Waiting on ticks uses the 
+ * task's count, the same as any other task. Waiting on a signal puts the 
+ * coroutine on that signal's list, and MCU_SignalSet puts everything on that 
+ * list in the ready queue. Nobody is polling anything. A signal is not a 
+ * flag. If it gets set when nobody is waiting on it, nothing happens. That's 
+ * why MCU_CO_AWAIT_COND is usually what you want. It checks your condition 
+ * first and only waits if it isn't true yet, then checks it again each time 
+ * the signal is set.
+ * 
+ * Since there's no stack, local variables are gone after every wait. Use 
+ * static variables, or make a struct with the MCUCoroutine first and your 
+ * variables after it and cast the pointer. Also, only one MCU_CO macro can go 
+ * on each line of code, and you can't wait from inside a switch statement of 
+ * your own, since the macros use __LINE__ for the case labels. 
+ * MCU_CO_AWAIT_COND and MCU_CO_POLL_UNTIL fall through into their own case
+ * label on purpose. They're marked with MCU_CO_FALLTHROUGH so 
+ * -Wimplicit-fallthrough doesn't warn about it. A comment won't work there, 
+ * since comments are gone by the time a macro is expanded.
+ * 
+ * Events: Instead of the main loop asking every module over and over if 
+ * something happened (Button_GetShortPress, SPI_Manager_IsTransferFinished, 
+ * etc.), the module can post an event when it happens. An event is just a 
+ * topic number and 32 bits of data. Anybody who wants to know about a topic 
+ * subscribes to it with a handler function. Every time around, MCU_TaskLoop 
+ * looks to see if anything was posted, and if so it calls the handlers for 
+ * each event, oldest first, before it runs a task. If nothing was posted, 
+ * that's all it does. Nobody gets called unless something happened.
+ * 
+ * Events go into an MCUEventQueue, which is a ring buffer that you give an 
+ * array to. Posting doesn't turn off interrupts. Only the poster moves the 
+ * head, and only the task loop moves the tail, so they can't step on each 
+ * other. That only works with one poster per queue though. If two interrupts 
+ * that can interrupt each other both post events, give each one its own 
+ * queue. Interrupts at the same priority level can share a queue, and so can 
+ * anything in the main loop. Events in different queues aren't kept in order 
+ * with each other. If a queue fills up, the event is thrown away and counted.
+ * 
  * @section license License
  * SPDX-FileCopyrightText: © 2022 Matthew Spinks
  * SPDX-License-Identifier: Zlib
@@ -30,6 +198,92 @@
 
 // ***** Defines ***************************************************************
 
+/* Returned by MCU_GetTicksUntilNextTask when there are no tasks */
+#define MCU_NO_DEADLINE     0xFFFFFFFF
+
+/* Number of priority levels for tasks. Must be a multiple of 32, 128 max. */
+#ifndef MCU_NUM_PRIORITIES
+#define MCU_NUM_PRIORITIES  128
+#endif
+
+#define MCU_PRIORITY_WORDS  (MCU_NUM_PRIORITIES / 32)
+
+/* Block and unblock the interrupt that calls MCU_TaskTick (and the software 
+interrupt, if you use preemption) */
+#ifndef MCU_ENTER_CRITICAL
+#define MCU_ENTER_CRITICAL()
+#endif
+
+#ifndef MCU_EXIT_CRITICAL
+#define MCU_EXIT_CRITICAL()
+#endif
+
+/* Define MCU_TASK_STATS to keep run time statistics for every task */
+
+/* Define MCU_TICKLESS to let a hardware timer make the tick. It needs the 
+HWTimer interface. */
+
+/* Number of event topics. 255 max. */
+#ifndef MCU_NUM_EVENT_TOPICS
+#define MCU_NUM_EVENT_TOPICS    32
+#endif
+
+/* Coroutine macros. See the description at the top and the functions they use 
+at the bottom of the non-interface functions. */
+#define MCU_CO_ENDED        0xFFFF
+
+/* Tells the compiler the fall through into the next case label is on purpose */
+#if defined(__has_attribute)
+#if __has_attribute(fallthrough)
+#define MCU_CO_FALLTHROUGH  __attribute__((fallthrough))
+#endif
+#endif
+#ifndef MCU_CO_FALLTHROUGH
+#define MCU_CO_FALLTHROUGH
+#endif
+
+#define MCU_CO_BEGIN(co)    switch((co)->line) { case 0:
+
+#define MCU_CO_END(co)      } (co)->line = MCU_CO_ENDED; return
+
+/* Let every other ready task have a turn, then keep going */
+#define MCU_CO_YIELD(co)    do { (co)->line = __LINE__; \
+                            MCU_CoroutineYield(co); return; \
+                            case __LINE__:; } while(0)
+
+/* Wait for a number of ticks */
+#define MCU_CO_DELAY(co, ticks)     do { (co)->line = __LINE__; \
+                                    MCU_CoroutineDelay(co, ticks); return; \
+                                    case __LINE__:; } while(0)
+
+/* Wait until the signal is set */
+#define MCU_CO_AWAIT(co, signal)    do { (co)->line = __LINE__; \
+                                    MCU_CoroutineWait(co, signal, 0); return; \
+                                    case __LINE__:; } while(0)
+
+/* Wait until the signal is set or the number of ticks goes by. Check 
+MCU_CoroutineTimedOut afterwards to see which one it was. */
+#define MCU_CO_AWAIT_TIMEOUT(co, signal, ticks) \
+                                    do { (co)->line = __LINE__; \
+                                    MCU_CoroutineWait(co, signal, ticks); \
+                                    return; case __LINE__:; } while(0)
+
+/* Wait until the condition is true. It's only checked when the signal is set, 
+so set the signal whenever something changes that could make it true. */
+#define MCU_CO_AWAIT_COND(co, signal, condition) \
+                                    do { (co)->line = __LINE__; \
+                                    MCU_CO_FALLTHROUGH; \
+                                    case __LINE__: if(!(condition)) { \
+                                    MCU_CoroutineWait(co, signal, 0); \
+                                    return; } } while(0)
+
+/* If there's nothing to wait on, this checks the condition once every tick */
+#define MCU_CO_POLL_UNTIL(co, condition) \
+                                    do { (co)->line = __LINE__; \
+                                    MCU_CO_FALLTHROUGH; \
+                                    case __LINE__: if(!(condition)) { \
+                                    MCU_CoroutineDelay(co, 1); \
+                                    return; } } while(0)
 
 // ***** Global Variables ******************************************************
 
@@ -40,6 +294,38 @@ typedef enum MCUPowerModeTag
     MCU_LPM_LEVEL_3, // lowest power consumption
 } MCUPowerMode;
 
+typedef struct MCUTaskStatsTag
+{
+    uint32_t runs;
+    uint64_t totalTime;
+    uint32_t minTime;
+    uint32_t maxTime;
+    uint32_t minLatency;
+    uint32_t maxLatency;
+    uint32_t deadlineMisses;
+    uint32_t readyTime;
+    uint32_t lateTicks;
+} MCUTaskStats;
+
+/**
+ * runs  How many times the task has run
+ * 
+ * totalTime  Total time spent running the task, in counts of your counter
+ * 
+ * minTime, maxTime  The shortest and longest the task has taken to run
+ * 
+ * minLatency, maxLatency  The shortest and longest time from when the task 
+ *                         was ready until it started. The difference between 
+ *                         the two is the jitter.
+ * 
+ * deadlineMisses  How many times a whole period went by while the task was 
+ *                 waiting to run or still running
+ * 
+ * readyTime  The counter value when the task was put in the ready queue
+ * 
+ * lateTicks  How many ticks the task has been waiting since it was ready
+ */
+
 typedef struct MCUTaskTag MCUTask;
 
 struct MCUTaskTag
@@ -49,9 +335,12 @@ struct MCUTaskTag
     void (*Function)(void);
     uint16_t period;
     uint16_t count;
-    bool addToPending;
     bool pending;
+    bool resume;
     uint8_t priority;
+#ifdef MCU_TASK_STATS
+    MCUTaskStats stats;
+#endif
 };
 
 /**
@@ -60,9 +349,8 @@ struct MCUTaskTag
  * 
  * next  A pointer to the next task in the list of tasks
  * 
- * nextPending  A pointer to the next task in the pending task list. This list
- *              contains just the currently pending tasks sorted by their 
- *              priority.
+ * nextPending  A pointer to the next task in the ready queue with the same 
+ *              priority. The last one points back to the first.
  * 
  * Function  A pointer to the function/task that you wish to have called
  * 
@@ -70,13 +358,138 @@ struct MCUTaskTag
  * 
  * count  How long until it's time to call your function (in ticks)
  * 
- * addToPending  Signals to the task loop to insert this task into the pending
- *               task list to be executed
- * 
- * pending  Set to true when a task is added to the pending task list. Set to
+ * pending  Set to true when a task is added to the ready queue. Set to
  *          false after the task/function has finished
  * 
+ * resume  Set if the task needs to go right back in the ready queue after it 
+ *         finishes. Used by coroutines.
+ * 
  * priority  The priority of the task. 0 is the highest priority.
+ * 
+ * stats  Run time statistics. Only there if MCU_TASK_STATS is defined.
+ */
+
+#ifdef MCU_TICKLESS
+struct HWTimerTag;
+
+typedef struct MCUTicklessTag
+{
+    struct HWTimerTag *timer;
+    uint32_t (*GetNextDeadline)(void);
+    void (*TickCallback)(uint32_t ticks);
+    uint32_t tickInterrupts;
+    uint32_t ticks;
+    uint16_t countsPerTick;
+    uint16_t lastTick;
+    uint16_t maxIdleTicks;
+    uint8_t compChan;
+} MCUTickless;
+#endif
+
+typedef struct MCUCoroutineTag MCUCoroutine;
+
+typedef struct MCUSignalTag
+{
+    MCUCoroutine *waiting;
+} MCUSignal;
+
+struct MCUCoroutineTag
+{
+    MCUTask task;
+    void (*Function)(MCUCoroutine *self);
+    MCUSignal *waitSignal;
+    MCUCoroutine *nextWaiting;
+    uint16_t line;
+    bool timedOut;
+};
+
+/**
+ * waiting  The list of coroutines waiting on the signal. A signal has to start 
+ *          out zeroed, so make it static or global.
+ * 
+ * task  The coroutine is run by the scheduler like any other task. The 
+ *       period is changed every time it runs to however long it's waiting.
+ * 
+ * Function  Your coroutine. Format: void SomeFunction(MCUCoroutine *co)
+ * 
+ * waitSignal  The signal it's waiting on, or NULL if none
+ * 
+ * nextWaiting  The next coroutine waiting on the same signal
+ * 
+ * line  Where to pick back up. 0 is the beginning.
+ * 
+ * timedOut  Set if the last wait with a timeout ran out of time
+ */
+
+typedef struct MCUEventTag
+{
+    uint8_t topic;
+    uint32_t data;
+} MCUEvent;
+
+typedef struct MCUEventQueueTag MCUEventQueue;
+
+struct MCUEventQueueTag
+{
+    MCUEventQueue *next;
+    MCUEvent *buffer;
+    uint16_t size;
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    volatile uint16_t dropped;
+};
+
+typedef struct MCUSubscriberTag MCUSubscriber;
+
+struct MCUSubscriberTag
+{
+    MCUSubscriber *next;
+    void (*Handler)(const MCUEvent *event);
+    uint8_t topic;
+};
+
+/**
+ * topic  What the event is about. 0 to MCU_NUM_EVENT_TOPICS - 1.
+ * 
+ * data  Whatever goes with it. A button number, a byte, an index, etc.
+ * 
+ * next  The next event queue or subscriber in the list
+ * 
+ * buffer  The array for the ring buffer
+ * 
+ * size  The number of events in the array. One spot is always left empty so 
+ *       that a full queue doesn't look like an empty one.
+ * 
+ * head  Where the next event will be put. Only the poster changes this.
+ * 
+ * tail  The next event to be handled. Only the task loop changes this.
+ * 
+ * dropped  How many events were thrown away because the queue was full
+ * 
+ * Handler  The function that gets called with each event for the topic
+ */
+
+/**
+ * timer  The hardware timer that makes the tick. It must be free-running with 
+ *        a period of 0xFFFF so that the compare values are in counts.
+ * 
+ * GetNextDeadline  Optional. Returns how many ticks until something other than 
+ *                  a task needs to happen, like a software timer.
+ * 
+ * TickCallback  Optional. Called from the tick with the number of ticks that 
+ *               went by. Use this to tick your software timers.
+ * 
+ * tickInterrupts  How many times the processor has been woken by the tick
+ * 
+ * ticks  How many ticks have gone by in total
+ * 
+ * countsPerTick  Hardware timer counts in one tick
+ * 
+ * lastTick  The timer count at the last tick
+ * 
+ * maxIdleTicks  The most ticks we can sleep before the 16-bit count rolls over
+ * 
+ * compChan  The compare channel used for the tick
  */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -97,7 +510,7 @@ struct MCUTaskTag
  * 
  * @param period  the desired period in ticks (1 is lowest)
  * 
- * @param priority  from 0 to 127. 0 is highest priority
+ * @param priority  from 0 to MCU_NUM_PRIORITIES - 1. 0 is highest priority
  * 
  * @param Function  the function to be called. Format: void someFunction(void)
  */
@@ -107,12 +520,14 @@ void MCU_AddTask(MCUTask *self, uint16_t period, uint8_t priority, void (*Functi
  * @brief Main Task Scheduler
  * 
  * This is a simple non-preemptive, priority based scheduler. Call this 
- * function in your main loop.
+ * function in your main loop. If you've turned on preemption, tasks below the 
+ * threshold are not run from here. See MCU_PreemptInit.
  * 
- * It will go through the list of tasks and look for any pending tasks. If 
- * more than one task is pending, the one with highest priority (lowest number)
+ * First it hands out any events that were posted (see MCU_EventDispatch). 
+ * Then it will take the next task out of the ready queue and run it. If more 
+ * than one task is pending, the one with highest priority (lowest number) 
  * gets executed next. If two tasks have the same priority, they are executed 
- * on a first come, first serve basis.
+ * on a first come, first serve basis. Only one task is run per call.
  * 
  * Tasks are not suspended and no context is saved. Each task will run to 
  * completion, so be careful not to let your task take too long. If you have a 
@@ -122,11 +537,239 @@ void MCU_AddTask(MCUTask *self, uint16_t period, uint8_t priority, void (*Functi
  */
 void MCU_TaskLoop(void);
 
+/***************************************************************************//**
+ * @brief Get the task that is running right now
+ * 
+ * Useful if more than one task shares the same function.
+ * 
+ * @return MCUTask*  the task being run by MCU_TaskLoop, or NULL if none
+ */
+MCUTask *MCU_GetCurrentTask(void);
+
+/***************************************************************************//**
+ * @brief Run the high priority tasks from a software interrupt
+ * 
+ * Every task with a priority number less than the threshold will be run by 
+ * MCU_PreemptDispatch instead of MCU_TaskLoop. Whenever one of those tasks 
+ * is ready, the trigger function is called. It should set your software 
+ * interrupt pending, and that interrupt should call MCU_PreemptDispatch. Call 
+ * this before you start the tick. A threshold of 0 turns preemption off.
+ * 
+ * @param threshold  tasks with a priority number below this are preemptive
+ * 
+ * @param TriggerSoftwareInterrupt  format: void SomeFunction(uint8_t priority)
+ */
+void MCU_PreemptInit(uint8_t threshold, 
+    void (*TriggerSoftwareInterrupt)(uint8_t priority));
+
+/***************************************************************************//**
+ * @brief Run every preemptive task that is ready
+ * 
+ * Call this from your software interrupt. Tasks are run highest priority 
+ * first until there are none left. If this interrupts another call to 
+ * MCU_PreemptDispatch, it only runs tasks with a higher priority than the task 
+ * that was interrupted.
+ */
+void MCU_PreemptDispatch(void);
+
+/***************************************************************************//**
+ * @brief Add a coroutine to the scheduler
+ * 
+ * The coroutine starts right away on the next call to MCU_TaskLoop. It's a 
+ * task like any other, so the priority works the same way, and it can be 
+ * preemptive too.
+ * 
+ * @param self  pointer to the coroutine
+ * 
+ * @param priority  from 0 to MCU_NUM_PRIORITIES - 1. 0 is highest priority
+ * 
+ * @param Function  format: void SomeFunction(MCUCoroutine *co)
+ */
+void MCU_AddCoroutine(MCUCoroutine *self, uint8_t priority, 
+    void (*Function)(MCUCoroutine *self));
+
+/***************************************************************************//**
+ * @brief Start a coroutine over from the beginning
+ * 
+ * If it was waiting on something, it stops waiting. Call this from the main 
+ * loop or from another task, not from inside the coroutine itself.
+ * 
+ * @param self  pointer to the coroutine
+ */
+void MCU_CoroutineRestart(MCUCoroutine *self);
+
+/***************************************************************************//**
+ * @brief See if a coroutine got to MCU_CO_END
+ * 
+ * @param self  pointer to the coroutine
+ * 
+ * @return true if it's finished
+ */
+bool MCU_CoroutineIsEnded(MCUCoroutine *self);
+
+/***************************************************************************//**
+ * @brief See if the last MCU_CO_AWAIT_TIMEOUT ran out of time
+ * 
+ * @param self  pointer to the coroutine
+ * 
+ * @return true if the signal never came
+ */
+bool MCU_CoroutineTimedOut(MCUCoroutine *self);
+
+/***************************************************************************//**
+ * @brief Wake up every coroutine waiting on the signal
+ * 
+ * Safe to call from an interrupt, as long as MCU_ENTER_CRITICAL blocks that 
+ * interrupt too. If a coroutine is in the middle of running when this 
+ * happens, it will be run again as soon as it returns.
+ * 
+ * @param self  pointer to the signal
+ */
+void MCU_SignalSet(MCUSignal *self);
+
+/***************************************************************************//**
+ * @brief Set up an event queue
+ * 
+ * The queue is added to the list that MCU_TaskLoop checks. Each queue should 
+ * only be posted to from one place at a time. See the description at the top.
+ * 
+ * @param self  pointer to the event queue
+ * 
+ * @param buffer  an array of events to hold the queue
+ * 
+ * @param size  the number of events in the array. It can hold one less.
+ */
+void MCU_EventQueueInit(MCUEventQueue *self, MCUEvent *buffer, uint16_t size);
+
+/***************************************************************************//**
+ * @brief Post an event
+ * 
+ * Safe to call from an interrupt without blocking anything, as long as 
+ * nothing else can post to the same queue in the middle of it.
+ * 
+ * @param self  pointer to the event queue
+ * 
+ * @param topic  0 to MCU_NUM_EVENT_TOPICS - 1
+ * 
+ * @param data  anything you want to go along with it
+ * 
+ * @return true if it was posted, false if the queue was full
+ */
+bool MCU_EventPost(MCUEventQueue *self, uint8_t topic, uint32_t data);
+
+/***************************************************************************//**
+ * @brief Get the number of events thrown away because the queue was full
+ * 
+ * @param self  pointer to the event queue
+ * 
+ * @return uint16_t  number of events lost
+ */
+uint16_t MCU_EventQueueGetDropped(MCUEventQueue *self);
+
+/***************************************************************************//**
+ * @brief Have a function called every time an event is posted to a topic
+ * 
+ * More than one subscriber can listen to the same topic. They get called in 
+ * the order they subscribed. If you want one function to get more than one 
+ * topic, use one MCUSubscriber for each topic. Don't subscribe from inside a 
+ * handler.
+ * 
+ * @param self  pointer to the subscriber
+ * 
+ * @param topic  0 to MCU_NUM_EVENT_TOPICS - 1
+ * 
+ * @param Handler  format: void SomeFunction(const MCUEvent *event)
+ */
+void MCU_Subscribe(MCUSubscriber *self, uint8_t topic, 
+    void (*Handler)(const MCUEvent *event));
+
+/***************************************************************************//**
+ * @brief Stop getting events
+ * 
+ * @param self  pointer to the subscriber
+ */
+void MCU_Unsubscribe(MCUSubscriber *self);
+
+/***************************************************************************//**
+ * @brief Hand out every event that has been posted
+ * 
+ * MCU_TaskLoop does this for you. It's here in case you want to do it 
+ * yourself somewhere else.
+ * 
+ * @return true if there were any events
+ */
+bool MCU_EventDispatch(void);
+
+/* These are used by the MCU_CO macros. You don't need to call them. */
+void MCU_CoroutineYield(MCUCoroutine *self);
+void MCU_CoroutineDelay(MCUCoroutine *self, uint16_t ticks);
+void MCU_CoroutineWait(MCUCoroutine *self, MCUSignal *signal, uint16_t ticks);
+
+#ifdef MCU_TASK_STATS
+
+/***************************************************************************//**
+ * @brief Give the statistics a counter to measure time with
+ * 
+ * The counter must count up and roll over from 0xFFFFFFFF to 0. Until this is 
+ * called, only the number of runs and the deadline misses are counted. This 
+ * also resets all of the statistics.
+ * 
+ * @param GetCounter  format: uint32_t SomeFunction(void)
+ */
+void MCU_StatsInit(uint32_t (*GetCounter)(void));
+
+/***************************************************************************//**
+ * @brief Start all of the statistics over again
+ * 
+ */
+void MCU_StatsReset(void);
+
+/***************************************************************************//**
+ * @brief Get the statistics for one task
+ * 
+ * @param self  pointer to the task
+ * 
+ * @return const MCUTaskStats*  pointer to the statistics for that task
+ */
+const MCUTaskStats *MCU_StatsGet(MCUTask *self);
+
+/***************************************************************************//**
+ * @brief Get how much time has gone by since the statistics were reset
+ * 
+ * The counter is only read by MCU_TaskLoop, so make sure the main loop gets 
+ * around at least once before the counter rolls over.
+ * 
+ * @return uint64_t  total time in counts
+ */
+uint64_t MCU_StatsGetElapsedTime(void);
+
+/***************************************************************************//**
+ * @brief Get how much of the time was spent running tasks
+ * 
+ * @return uint64_t  total time in counts
+ */
+uint64_t MCU_StatsGetBusyTime(void);
+
+/***************************************************************************//**
+ * @brief Print out the statistics for every task
+ * 
+ * Your function gets called once with a header, once for each task, and once 
+ * with a summary. Each line is text without a newline at the end, so you can 
+ * send it out a UART or printf it or whatever. Tasks are numbered in the order 
+ * they are in the task list. That's the reverse of the order you added them. 
+ * Times are in counts of your counter.
+ * 
+ * @param PrintLine  format: void SomeFunction(const char *line)
+ */
+void MCU_StatsDump(void (*PrintLine)(const char *line));
+
+#endif
+
 /***************************************************************************//**
  * @brief Tick the Task Loop
  * 
  * Every time this function is called, each task's counter will be decremented.
- * Any task that is ready will have a pending flag set. This function should
+ * Any task that is ready will be put in the ready queue. This function should
  * ideally be called via an interrupt so that your tasks' counters are updated 
  * regularly even if one task is taking a bit too long. 
  * 
@@ -136,6 +779,89 @@ void MCU_TaskLoop(void);
  */
 void MCU_TaskTick(void);
 
+/***************************************************************************//**
+ * @brief Tick the Task Loop more than once
+ * 
+ * Same as calling MCU_TaskTick that many times. This is used to catch up after
+ * sleeping. A task can only be pending once, so if a task's period went by 
+ * more than once it will still only run once.
+ * 
+ * @param ticks  the number of ticks that went by
+ */
+void MCU_TaskTickMultiple(uint32_t ticks);
+
+/***************************************************************************//**
+ * @brief Get the number of ticks until the next task needs to run
+ * 
+ * @return uint32_t  0 if something is pending, MCU_NO_DEADLINE if no tasks
+ */
+uint32_t MCU_GetTicksUntilNextTask(void);
+
+#ifdef MCU_TICKLESS
+
+/***************************************************************************//**
+ * @brief Use a hardware timer for the tick so the scheduler can be tickless
+ * 
+ * Set up your hardware timer first. It should be free-running 16-bit with a 
+ * period of 0xFFFF and the compare match interrupt enabled. This function sets
+ * the compare match callback of the timer, so don't use that callback for 
+ * anything else. Don't call MCU_TaskTick anymore after this. The timer makes 
+ * the tick now. Start the timer once you've called this.
+ * 
+ * @param self  pointer to the MCUTickless object that you are using
+ * 
+ * @param timer  pointer to the HWTimer that will make the tick
+ * 
+ * @param compChan  the compare channel to use
+ * 
+ * @param countsPerTick  how many hardware timer counts make one tick
+ */
+void MCU_TicklessInit(MCUTickless *self, struct HWTimerTag *timer, 
+    uint8_t compChan, uint16_t countsPerTick);
+
+/***************************************************************************//**
+ * @brief Give the tickless idle your software timers
+ * 
+ * Without this, only tasks are looked at when deciding how long to sleep. 
+ * For example, with a TimerWheel you could give it a function that returns 
+ * TimerWheel_GetNextDeadline and a function that calls 
+ * TimerWheel_TickMultiple.
+ * 
+ * @param self  pointer to the MCUTickless object that you are using
+ * 
+ * @param GetNextDeadline  format: uint32_t SomeFunction(void)
+ * 
+ * @param TickCallback  format: void SomeFunction(uint32_t ticks)
+ */
+void MCU_TicklessSetTimerFunctions(MCUTickless *self, 
+    uint32_t (*GetNextDeadline)(void), void (*TickCallback)(uint32_t ticks));
+
+/***************************************************************************//**
+ * @brief The compare match callback for the tick timer
+ * 
+ * MCU_TicklessInit sets this for you. It's public so that you can call it 
+ * yourself if your timer doesn't use callbacks.
+ * 
+ * @param compChan  the compare channel that matched
+ */
+void MCU_TicklessCompareMatch(uint8_t compChan);
+
+#endif
+
+/***************************************************************************//**
+ * @brief Sleep until the next task or timer needs to run
+ * 
+ * Call this in your main loop after MCU_TaskLoop. If something is pending, it
+ * returns right away. If you haven't set up tickless, it just calls 
+ * MCU_EnterLowPowerMode and the next tick will wake you up. Any interrupt can 
+ * still wake the processor early. When that happens the tasks are caught up 
+ * and the tick goes back to normal. The check and the sleep are both done 
+ * inside MCU_ENTER_CRITICAL. See the description at the top.
+ * 
+ * @param powerMode  MCU_LPM_LEVEL_1, MCU_LPM_LEVEL_2, MCU_LPM_LEVEL_3
+ */
+void MCU_TaskIdle(MCUPowerMode powerMode);
+
 /***************************************************************************//**
  * @brief Delay
  * 
@@ -309,6 +1035,10 @@ void MCU_DelayMs(uint16_t milliseconds);
  * levels 2 and 3 should do the same thing. All three cases must be implemented
  * in some way.
  * 
+ * MCU_TaskIdle calls this inside MCU_ENTER_CRITICAL. It must still wake up 
+ * when an interrupt becomes pending, and it must not turn interrupts back on 
+ * by itself. On a Cortex-M, __WFI with PRIMASK set does this.
+ * 
  * @param powerMode  MCU_LPM_LEVEL_1, MCU_LPM_LEVEL_2, MCU_LPM_LEVEL_3
  */
 void MCU_EnterLowPowerMode(MCUPowerMode powerMode);
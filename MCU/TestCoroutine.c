@@ -0,0 +1,231 @@
+/* Program to test the coroutine tasks in IMCU - MS */
+
+/* Build from the MCU folder with:
+gcc -std=c99 -I. TestCoroutine.c IMCU.c
+
+Everything happens one tick at a time. After each tick the task loop is run
+until nothing is ready. A fake receive interrupt puts a few bytes in a buffer
+every so often and sets a signal. The consumer should only be run when that
+happens, never just to check. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "IMCU.h"
+
+#define NUM_TICKS       2000
+#define BLINK_TICKS     10
+#define RX_BUFFER_SIZE  64
+
+static uint32_t tick;
+
+/* Blinker */
+static MCUCoroutine blinker;
+static uint32_t blinkCalls, blinkToggles, blinkErrors;
+static bool ledOn;
+
+/* Receive buffer, consumer, and the fake interrupt */
+static MCUCoroutine consumer;
+static MCUSignal rxSignal;
+static uint8_t rxBuffer[RX_BUFFER_SIZE];
+static volatile uint8_t rxHead, rxTail;
+static uint8_t nextSent, nextExpected;
+static uint32_t consumerCalls, rxInterrupts, bytesSent, bytesReceived, rxErrors;
+
+/* Timeouts */
+static MCUCoroutine waiter;
+static MCUSignal neverSet, ackSignal;
+static uint32_t timeoutTick, ackTick;
+static bool firstTimedOut, secondTimedOut;
+
+/* Yield */
+static MCUCoroutine yieldA, yieldB;
+static char yieldLog[16];
+static uint8_t yieldLength;
+
+/* Signal while running */
+static MCUCoroutine racer;
+static MCUSignal raceSignal;
+static uint32_t raceResumes;
+
+void Blink(MCUCoroutine *co)
+{
+    static uint32_t lastTick;
+
+    blinkCalls++;
+    MCU_CO_BEGIN(co);
+    lastTick = tick;
+    while(1)
+    {
+        ledOn = !ledOn;
+        blinkToggles++;
+        MCU_CO_DELAY(co, BLINK_TICKS);
+        if(tick - lastTick != BLINK_TICKS)
+            blinkErrors++;
+        lastTick = tick;
+    }
+    MCU_CO_END(co);
+}
+
+void Consume(MCUCoroutine *co)
+{
+    consumerCalls++;
+    MCU_CO_BEGIN(co);
+    while(1)
+    {
+        MCU_CO_AWAIT_COND(co, &rxSignal, rxHead != rxTail);
+        while(rxTail != rxHead)
+        {
+            if(rxBuffer[rxTail] != nextExpected++)
+                rxErrors++;
+            rxTail = (rxTail + 1) % RX_BUFFER_SIZE;
+            bytesReceived++;
+        }
+    }
+    MCU_CO_END(co);
+}
+
+void ReceiveInterrupt(void)
+{
+    uint8_t count = 1 + rand() % 3;
+
+    rxInterrupts++;
+    while(count--)
+    {
+        rxBuffer[rxHead] = nextSent++;
+        rxHead = (rxHead + 1) % RX_BUFFER_SIZE;
+        bytesSent++;
+    }
+    MCU_SignalSet(&rxSignal);
+}
+
+void Wait(MCUCoroutine *co)
+{
+    static uint32_t start;
+
+    MCU_CO_BEGIN(co);
+    start = tick;
+    MCU_CO_AWAIT_TIMEOUT(co, &neverSet, 5);
+    firstTimedOut = MCU_CoroutineTimedOut(co);
+    timeoutTick = tick - start;
+
+    start = tick;
+    MCU_CO_AWAIT_TIMEOUT(co, &ackSignal, 50);
+    secondTimedOut = MCU_CoroutineTimedOut(co);
+    ackTick = tick - start;
+    MCU_CO_END(co);
+}
+
+void YieldA(MCUCoroutine *co)
+{
+    static uint8_t i;
+
+    MCU_CO_BEGIN(co);
+    for(i = 0; i < 3; i++)
+    {
+        yieldLog[yieldLength++] = 'A';
+        MCU_CO_YIELD(co);
+    }
+    MCU_CO_END(co);
+}
+
+void YieldB(MCUCoroutine *co)
+{
+    static uint8_t i;
+
+    MCU_CO_BEGIN(co);
+    for(i = 0; i < 3; i++)
+    {
+        yieldLog[yieldLength++] = 'B';
+        MCU_CO_YIELD(co);
+    }
+    MCU_CO_END(co);
+}
+
+/* This is MCU_CO_AWAIT written out by hand, with the signal coming in after
+the coroutine is on the list but before it has returned. That's what would
+happen if an interrupt hit at just the wrong time. */
+void Race(MCUCoroutine *co)
+{
+    MCU_CO_BEGIN(co);
+    co->line = 1;
+    MCU_CoroutineWait(co, &raceSignal, 0);
+    MCU_SignalSet(&raceSignal);
+    return;
+    case 1:
+    raceResumes++;
+    MCU_CO_END(co);
+}
+
+/* Never called here, but IMCU.c needs it to link */
+void MCU_EnterLowPowerMode(MCUPowerMode powerMode)
+{
+    (void)powerMode;
+}
+
+void RunUntilIdle(void)
+{
+    while(MCU_GetTicksUntilNextTask() == 0)
+        MCU_TaskLoop();
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-48s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    int failed = 0;
+
+    srand(1);
+    MCU_AddCoroutine(&blinker, 1, Blink);
+    MCU_AddCoroutine(&consumer, 0, Consume);
+    MCU_AddCoroutine(&waiter, 2, Wait);
+    MCU_AddCoroutine(&yieldA, 3, YieldA);
+    MCU_AddCoroutine(&yieldB, 3, YieldB);
+    MCU_AddCoroutine(&racer, 4, Race);
+    RunUntilIdle();
+
+    for(tick = 1; tick <= NUM_TICKS; tick++)
+    {
+        MCU_TaskTick();
+        if(rand() % 20 == 0)
+            ReceiveInterrupt();
+        if(tick == 10)
+            MCU_SignalSet(&ackSignal);
+        RunUntilIdle();
+    }
+
+    printf("Coroutines are %u bytes each\n", (unsigned)sizeof(MCUCoroutine));
+    printf("Consumer was run %u times for %u interrupts over %u ticks\n\n",
+        consumerCalls, rxInterrupts, NUM_TICKS);
+
+    failed += Check("Blinker toggled once every period",
+        blinkToggles == NUM_TICKS / BLINK_TICKS + 1 && blinkErrors == 0);
+    failed += Check("Blinker only run when it was time",
+        blinkCalls == blinkToggles);
+    failed += Check("Every byte received in order",
+        bytesReceived == bytesSent && rxErrors == 0);
+    failed += Check("Consumer only run when signalled",
+        consumerCalls == rxInterrupts + 1);
+    failed += Check("Wait with no signal timed out after 5 ticks",
+        firstTimedOut && timeoutTick == 5);
+    failed += Check("Wait with a signal didn't time out",
+        !secondTimedOut && ackTick == 5);
+    failed += Check("Timeout waits finished",
+        MCU_CoroutineIsEnded(&waiter) && neverSet.waiting == NULL &&
+        ackSignal.waiting == NULL);
+    failed += Check("Yield takes turns", strcmp(yieldLog, "ABABAB") == 0);
+    failed += Check("Signal while running isn't lost",
+        raceResumes == 1 && MCU_CoroutineIsEnded(&racer));
+
+    /* Start one back up */
+    MCU_CoroutineRestart(&racer);
+    RunUntilIdle();
+    failed += Check("Restart runs it again", raceResumes == 2);
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
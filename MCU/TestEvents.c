@@ -0,0 +1,299 @@
+/* Program to compare the event queue in IMCU against polling flags - MS */
+
+/* Build from the MCU folder with:
+gcc -std=gnu99 -O2 -DMCU_NUM_EVENT_TOPICS=64 -I. TestEvents.c IMCU.c
+
+There are 40 fake modules. Each one has a flag and a getter and a function to
+clear the flag, just like Button_GetShortPress and Button_ClearShortPressFlag.
+With polling, the main loop calls every getter every time around. With events,
+the "interrupt" posts an event and the main loop just calls MCU_TaskLoop.
+
+Part 1 calls the interrupt from the main loop every so often, so nothing is
+random and we can see how long one trip around the main loop takes.
+
+Part 2 uses SIGALRM as a real interrupt at 2 kHz. Both versions sleep until
+an interrupt comes in, like they would with WFI, and then do their thing.
+Latency is how long from the interrupt until the handler got the event, and
+CPU is how much processor time the whole thing took compared to the wall
+clock. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/time.h>
+#include "IMCU.h"
+
+#define NUM_MODULES         40
+#define LOOPS               10000000UL
+#define INTERRUPT_EVERY     200
+#define QUEUE_SIZE          32
+#define ALARM_US            500
+#define RUN_SECONDS         1
+
+#define NOINLINE __attribute__((noinline))
+
+#if MCU_NUM_EVENT_TOPICS < NUM_MODULES
+#error "Each module needs its own topic. Build with -DMCU_NUM_EVENT_TOPICS=64"
+#endif
+
+typedef struct ModuleTag
+{
+    struct {
+        unsigned pressed : 1;
+    } flags;
+    volatile double stamp;
+} Module;
+
+static Module modules[NUM_MODULES];
+static MCUEventQueue queue;
+static MCUEvent queueBuffer[QUEUE_SIZE];
+static MCUSubscriber subscribers[NUM_MODULES];
+static bool useEvents;
+static uint32_t posted, handled, handledSum;
+static double totalLatency, maxLatency;
+static bool measureLatency;
+
+double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double CpuTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ***** The polled way ********************************************************
+
+NOINLINE bool Module_GetPressed(Module *self)
+{
+    if(self->flags.pressed)
+        return true;
+    else
+        return false;
+}
+
+NOINLINE void Module_ClearPressedFlag(Module *self)
+{
+    self->flags.pressed = 0;
+}
+
+void Handle(uint32_t which)
+{
+    handled++;
+    handledSum += which;
+    if(measureLatency)
+    {
+        double latency = Now() - modules[which].stamp;
+        totalLatency += latency;
+        if(latency > maxLatency)
+            maxLatency = latency;
+    }
+}
+
+void PollAll(void)
+{
+    for(uint32_t i = 0; i < NUM_MODULES; i++)
+    {
+        if(Module_GetPressed(&modules[i]))
+        {
+            Module_ClearPressedFlag(&modules[i]);
+            Handle(i);
+        }
+    }
+}
+
+// ***** The event way *********************************************************
+
+void PressedHandler(const MCUEvent *event)
+{
+    Handle(event->data);
+}
+
+// ***** Fake interrupt ********************************************************
+
+void Interrupt(void)
+{
+    uint32_t which = rand() % NUM_MODULES;
+
+    if(measureLatency)
+        modules[which].stamp = Now();
+
+    posted++;
+    if(useEvents)
+        MCU_EventPost(&queue, which, which);
+    else
+        modules[which].flags.pressed = 1;
+}
+
+void AlarmHandler(int sig)
+{
+    (void)sig;
+    Interrupt();
+}
+
+/* Never called here, but IMCU.c needs it to link */
+void MCU_EnterLowPowerMode(MCUPowerMode powerMode)
+{
+    (void)powerMode;
+}
+
+// *****************************************************************************
+
+void Reset(bool events)
+{
+    useEvents = events;
+    posted = handled = handledSum = 0;
+    totalLatency = maxLatency = 0;
+    memset(modules, 0, sizeof(modules));
+    MCU_EventQueueInit(&queue, queueBuffer, QUEUE_SIZE);
+    srand(1);
+}
+
+double RunLoop(bool events)
+{
+    double start;
+
+    Reset(events);
+    start = Now();
+    for(uint32_t i = 0; i < LOOPS; i++)
+    {
+        if(i % INTERRUPT_EVERY == 0)
+            Interrupt();
+
+        if(events)
+            MCU_TaskLoop();
+        else
+            PollAll();
+    }
+    return Now() - start;
+}
+
+void RunWithAlarm(bool events, double *cpuPercent)
+{
+    struct sigaction sa;
+    struct itimerval timer;
+    sigset_t alarmOnly, oldMask;
+    double wallStart, cpuStart;
+
+    Reset(events);
+    measureLatency = true;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = AlarmHandler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGALRM, &sa, NULL);
+    sigemptyset(&alarmOnly);
+    sigaddset(&alarmOnly, SIGALRM);
+
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = ALARM_US;
+    timer.it_value = timer.it_interval;
+
+    wallStart = Now();
+    cpuStart = CpuTime();
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    while(Now() - wallStart < RUN_SECONDS)
+    {
+        /* Block the interrupt while deciding whether to sleep, then wait for
+        it. Same idea as disabling interrupts and doing WFI. Polling has no
+        way to know if anything happened, so it always sleeps and then checks
+        everything. */
+        sigprocmask(SIG_BLOCK, &alarmOnly, &oldMask);
+        if(!events || MCU_GetTicksUntilNextTask() != 0)
+            sigsuspend(&oldMask);
+        sigprocmask(SIG_SETMASK, &oldMask, NULL);
+
+        if(events)
+            MCU_TaskLoop();
+        else
+            PollAll();
+    }
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    /* Get anything that came in right at the end */
+    if(events)
+        MCU_TaskLoop();
+    else
+        PollAll();
+
+    *cpuPercent = 100.0 * (CpuTime() - cpuStart) / (Now() - wallStart);
+    measureLatency = false;
+}
+
+int main(void)
+{
+    int failed = 0;
+    double pollTime, eventTime, pollCpu, eventCpu;
+    uint32_t pollHandled, pollSum, pollPosted;
+    double pollAvg, pollMax;
+
+    for(uint32_t i = 0; i < NUM_MODULES; i++)
+        MCU_Subscribe(&subscribers[i], i, PressedHandler);
+
+    /* Part 1 */
+    pollTime = RunLoop(false);
+    pollHandled = handled;
+    pollSum = handledSum;
+    eventTime = RunLoop(true);
+    if(handled != pollHandled || handledSum != pollSum || handled != posted)
+        failed = 1;
+
+    printf("%u modules, %lu trips around the main loop, %u events\n",
+        NUM_MODULES, LOOPS, handled);
+    printf("  Polling every flag: %8.3f s (%6.2f ns per trip)\n", pollTime,
+        pollTime / LOOPS * 1e9);
+    printf("  Event queue:        %8.3f s (%6.2f ns per trip)\n\n", eventTime,
+        eventTime / LOOPS * 1e9);
+
+    /* Part 2 */
+    RunWithAlarm(false, &pollCpu);
+    pollHandled = handled;
+    pollPosted = posted;
+    pollAvg = totalLatency / handled;
+    pollMax = maxLatency;
+
+    /* A flag that gets set twice before anybody looks at it only counts once, 
+    so polling could come up short. Events can't. */
+    RunWithAlarm(true, &eventCpu);
+    if(handled != posted || MCU_EventQueueGetDropped(&queue) != 0)
+        failed = 1;
+
+    printf("Interrupt every %u us for %u s, sleeping in between\n", ALARM_US,
+        RUN_SECONDS);
+    printf("  %-20s %8s %8s %10s %10s %8s\n", "", "posted", "handled",
+        "avg us", "max us", "cpu %");
+    printf("  %-20s %8u %8u %10.2f %10.2f %8.2f\n", "Polling every flag",
+        pollPosted, pollHandled, pollAvg * 1e6, pollMax * 1e6, pollCpu);
+    printf("  %-20s %8u %8u %10.2f %10.2f %8.2f\n", "Event queue", posted,
+        handled, totalLatency / handled * 1e6, maxLatency * 1e6, eventCpu);
+
+    /* Posting to a full queue should fail and count it */
+    Reset(true);
+    for(uint32_t i = 0; i < QUEUE_SIZE; i++)
+        MCU_EventPost(&queue, 0, i);
+    if(MCU_EventQueueGetDropped(&queue) != 1)
+        failed = 1;
+    MCU_EventDispatch();
+    if(handled != QUEUE_SIZE - 1)
+        failed = 1;
+
+    /* After unsubscribing, nothing should get called */
+    MCU_Unsubscribe(&subscribers[0]);
+    MCU_EventPost(&queue, 0, 0);
+    MCU_EventDispatch();
+    if(handled != QUEUE_SIZE - 1)
+        failed = 1;
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,268 @@
+/* Host test of the preemptive mode in IMCU using signals - MS */
+
+/* Build from the MCU folder with:
+gcc -std=gnu99 -O2 -I. TestPreempt.c
+
+Signals stand in for interrupts here. SIGALRM goes off every 1 ms and calls
+MCU_TaskTick, like a SysTick would. SIGUSR1 is the software interrupt, like
+PendSV. SIGUSR1 is blocked while the tick handler runs, so raising it from the
+tick leaves it pending until the tick is done, and then it runs right over top
+of the main loop. The critical section blocks both signals.
+
+IMCU.c is included right into this file so that the critical section macros
+can be defined before it is compiled.
+
+There's a motor task that needs to run every tick at the highest priority, a
+second high priority task, and two low priority tasks. One of them takes 5 ms
+every time it runs. Latency is how long after the tick made the motor task
+ready that it started to run. Without preemption it has to wait for the long
+task to finish. With preemption it shouldn't have to wait for anything. The
+scheduler has no way to remove tasks, so each run happens in its own
+process. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+static sigset_t interruptSignals;
+
+#define MCU_ENTER_CRITICAL()    sigset_t savedMask; \
+                                sigprocmask(SIG_BLOCK, &interruptSignals, &savedMask)
+#define MCU_EXIT_CRITICAL()     sigprocmask(SIG_SETMASK, &savedMask, NULL)
+
+#include "IMCU.c"
+
+#define NUM_TICKS           2000
+#define TICK_US             1000
+#define LONG_TASK_US        5000
+#define PREEMPT_THRESHOLD   16
+
+typedef struct SimTaskTag
+{
+    MCUTask task;
+    uint16_t period;
+    uint8_t priority;
+    uint32_t busyUs;
+    volatile double readyTime;
+    uint32_t runs;
+    double totalLatency;
+    double maxLatency;
+} SimTask;
+
+typedef struct ResultTag
+{
+    SimTask tasks[4];
+    uint32_t ticks;
+    uint32_t preempted;
+} Result;
+
+static SimTask tasks[4] = {
+    { .period = 1,  .priority = 0,  .busyUs = 50   },   // the motor loop
+    { .period = 5,  .priority = 1,  .busyUs = 100  },
+    { .period = 20, .priority = 20, .busyUs = LONG_TASK_US },
+    { .period = 3,  .priority = 30, .busyUs = 20   },
+};
+
+static volatile uint32_t ticks;
+static volatile bool inLongTask;
+static volatile uint32_t preempted;
+
+double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void BusyWait(uint32_t microseconds)
+{
+    double end = Now() + microseconds * 1e-6;
+    while(Now() < end);
+}
+
+void RunSimTask(uint8_t i)
+{
+    SimTask *t = &tasks[i];
+    double latency = Now() - t->readyTime;
+
+    t->runs++;
+    t->totalLatency += latency;
+    if(latency > t->maxLatency)
+        t->maxLatency = latency;
+
+    if(i < 2 && inLongTask)
+        preempted++;
+
+    if(i == 2)
+        inLongTask = true;
+    BusyWait(t->busyUs);
+    if(i == 2)
+        inLongTask = false;
+}
+
+void Task0(void) { RunSimTask(0); }
+void Task1(void) { RunSimTask(1); }
+void Task2(void) { RunSimTask(2); }
+void Task3(void) { RunSimTask(3); }
+
+// ***** Fake interrupts *******************************************************
+
+void TickHandler(int sig)
+{
+    bool wasPending[4];
+    double now = Now();
+    (void)sig;
+
+    for(uint8_t i = 0; i < 4; i++)
+        wasPending[i] = tasks[i].task.pending;
+
+    MCU_TaskTick();
+    ticks++;
+
+    for(uint8_t i = 0; i < 4; i++)
+    {
+        if(!wasPending[i] && tasks[i].task.pending)
+            tasks[i].readyTime = now;
+    }
+}
+
+void SoftwareInterruptHandler(int sig)
+{
+    (void)sig;
+    MCU_PreemptDispatch();
+}
+
+void TriggerSoftwareInterrupt(uint8_t priority)
+{
+    (void)priority;
+    raise(SIGUSR1);
+}
+
+/* Never called here, but IMCU.c needs it to link */
+void MCU_EnterLowPowerMode(MCUPowerMode powerMode)
+{
+    (void)powerMode;
+}
+
+// *****************************************************************************
+
+void Run(bool preempt, Result *result)
+{
+    void (*functions[4])(void) = {Task0, Task1, Task2, Task3};
+    struct sigaction sa;
+    struct itimerval timer;
+
+    sigemptyset(&interruptSignals);
+    sigaddset(&interruptSignals, SIGALRM);
+    sigaddset(&interruptSignals, SIGUSR1);
+
+    /* The tick blocks the software interrupt, but not the other way around */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = TickHandler;
+    sigemptyset(&sa.sa_mask);
+    sigaddset(&sa.sa_mask, SIGUSR1);
+    sigaction(SIGALRM, &sa, NULL);
+
+    sa.sa_handler = SoftwareInterruptHandler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
+
+    for(uint8_t i = 0; i < 4; i++)
+        MCU_AddTask(&tasks[i].task, tasks[i].period, tasks[i].priority,
+            functions[i]);
+
+    if(preempt)
+        MCU_PreemptInit(PREEMPT_THRESHOLD, TriggerSoftwareInterrupt);
+
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = TICK_US;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    while(ticks < NUM_TICKS)
+        MCU_TaskLoop();
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    memcpy(result->tasks, tasks, sizeof(tasks));
+    result->ticks = ticks;
+    result->preempted = preempted;
+}
+
+/* Do one run in a child process and read back the results */
+int RunInChild(bool preempt, Result *result)
+{
+    int fd[2];
+    pid_t pid;
+
+    if(pipe(fd) != 0 || (pid = fork()) < 0)
+        return 1;
+
+    if(pid == 0)
+    {
+        close(fd[0]);
+        Run(preempt, result);
+        _exit(write(fd[1], result, sizeof(Result)) == sizeof(Result) ? 0 : 1);
+    }
+
+    close(fd[1]);
+    ssize_t n = read(fd[0], result, sizeof(Result));
+    close(fd[0]);
+    waitpid(pid, NULL, 0);
+    return (n == sizeof(Result)) ? 0 : 1;
+}
+
+int main(void)
+{
+    Result coop, preempt;
+    int failed = 0;
+
+    if(RunInChild(false, &coop) || RunInChild(true, &preempt))
+    {
+        printf("Couldn't run the test\n");
+        return 1;
+    }
+
+    printf("%u ticks of %u us, task 2 takes %u us\n", NUM_TICKS, TICK_US,
+        LONG_TASK_US);
+    printf("%-6s %-12s %8s %8s %12s %12s\n", "task", "mode", "priority",
+        "runs", "avg us", "max us");
+    for(uint8_t i = 0; i < 4; i++)
+    {
+        SimTask *c = &coop.tasks[i], *p = &preempt.tasks[i];
+        printf("%-6u %-12s %8u %8u %12.1f %12.1f\n", i, "cooperative",
+            c->priority, c->runs, c->totalLatency / c->runs * 1e6,
+            c->maxLatency * 1e6);
+        printf("%-6u %-12s %8u %8u %12.1f %12.1f\n", i, "preemptive",
+            p->priority, p->runs, p->totalLatency / p->runs * 1e6,
+            p->maxLatency * 1e6);
+
+        if(c->runs == 0 || p->runs == 0)
+            failed = 1;
+    }
+    printf("High priority tasks started in the middle of the long task: "
+        "%u cooperative, %u preemptive\n", coop.preempted, preempt.preempted);
+
+    /* Without preemption the motor task has to wait on the long task. With it,
+    the motor task should start a lot sooner, and run on almost every tick. The
+    PC can always hiccup, so don't be too strict about it. The low priority 
+    tasks still need to get to run. */
+    SimTask *c = &coop.tasks[0], *p = &preempt.tasks[0];
+    if(coop.preempted != 0 || preempt.preempted == 0)
+        failed = 1;
+    if(c->maxLatency < LONG_TASK_US * 1e-6 / 2)
+        failed = 1;
+    if(p->maxLatency >= c->maxLatency / 4)
+        failed = 1;
+    if(p->runs < preempt.ticks * 9 / 10 || p->runs <= c->runs)
+        failed = 1;
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
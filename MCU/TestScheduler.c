@@ -0,0 +1,197 @@
+/* Program to compare the ready queue in IMCU against the old pending list
+- MS */
+
+/* Build from the MCU folder with:
+gcc -std=c99 -O2 -I. TestScheduler.c IMCU.c
+
+1000 tasks get random periods and priorities. The old scheduler (copied here
+so we can compare) looked through every task on each call to MCU_TaskLoop and
+then walked the pending list to insert by priority. The new one gets the
+highest priority ready task from the bitmap. The tick is the same for both so
+it isn't counted. Every task must run the same number of times both ways, and
+the new one must always pick a task with the highest priority that's ready. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "IMCU.h"
+
+#define NUM_TASKS       1000
+#define NUM_TICKS       20000UL
+#define MAX_PERIOD      200
+
+typedef struct OldTaskTag OldTask;
+
+struct OldTaskTag
+{
+    OldTask *next;
+    OldTask *nextPending;
+    uint16_t period;
+    uint16_t count;
+    bool addToPending;
+    bool pending;
+    uint8_t priority;
+};
+
+static OldTask oldTasks[NUM_TASKS], *oldTaskList, *oldCurrent;
+static MCUTask newTasks[NUM_TASKS];
+static uint32_t oldRuns[NUM_TASKS], newRuns[NUM_TASKS];
+static uint64_t newTotal;
+static bool checkOrder;
+static int orderErrors;
+
+// ***** The old scheduler *****************************************************
+
+void Old_TaskTick(void)
+{
+    for(OldTask *task = oldTaskList; task != NULL; task = task->next)
+    {
+        if(task->count > 0 && --task->count == 0)
+            task->addToPending = true;
+    }
+}
+
+void Old_AddToPending(OldTask *newTask)
+{
+    OldTask *task = oldCurrent;
+
+    if(task == NULL)
+    {
+        newTask->nextPending = oldCurrent;
+        oldCurrent = newTask;
+    }
+    else
+    {
+        while(task->nextPending != NULL)
+        {
+            if(newTask->priority < task->nextPending->priority)
+                break;
+            task = task->nextPending;
+        }
+        newTask->nextPending = task->nextPending;
+        task->nextPending = newTask;
+    }
+    newTask->pending = true;
+}
+
+bool Old_TaskLoop(void)
+{
+    for(OldTask *task = oldTaskList; task != NULL; task = task->next)
+    {
+        if(task->addToPending && !task->pending)
+        {
+            Old_AddToPending(task);
+            task->addToPending = false;
+        }
+    }
+
+    if(oldCurrent == NULL)
+        return false;
+
+    oldRuns[oldCurrent - oldTasks]++;
+    oldCurrent->pending = false;
+    oldCurrent->count = oldCurrent->period;
+    oldCurrent = oldCurrent->nextPending;
+    return true;
+}
+
+// ***** The new one ***********************************************************
+
+void NewTask(void)
+{
+    MCUTask *task = MCU_GetCurrentTask();
+    newRuns[task - newTasks]++;
+    newTotal++;
+
+    /* Nothing else that's ready should have a higher priority */
+    if(checkOrder)
+    {
+        for(uint32_t i = 0; i < NUM_TASKS; i++)
+        {
+            if(newTasks[i].pending && &newTasks[i] != task &&
+                newTasks[i].priority < task->priority)
+                orderErrors++;
+        }
+    }
+}
+
+/* Never called here, but IMCU.c needs it to link */
+void MCU_EnterLowPowerMode(MCUPowerMode powerMode)
+{
+    (void)powerMode;
+}
+
+double Now(void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+int main(void)
+{
+    double start, oldTime = 0, newTime = 0;
+    uint64_t runs = 0;
+    int failed = 0;
+
+    srand(1);
+    for(uint32_t i = 0; i < NUM_TASKS; i++)
+    {
+        uint16_t period = 1 + rand() % MAX_PERIOD;
+        uint8_t priority = rand() % 128;
+
+        oldTasks[i].next = oldTaskList;
+        oldTaskList = &oldTasks[i];
+        oldTasks[i].period = oldTasks[i].count = period;
+        oldTasks[i].priority = priority;
+
+        MCU_AddTask(&newTasks[i], period, priority, NewTask);
+    }
+
+    for(uint32_t t = 0; t < NUM_TICKS; t++)
+    {
+        Old_TaskTick();
+        start = Now();
+        while(Old_TaskLoop())
+            runs++;
+        oldTime += Now() - start;
+
+        /* The order check is slow, so only do it on the first few ticks */
+        checkOrder = (t < 500);
+        MCU_TaskTick();
+        start = Now();
+        uint64_t before;
+        do {
+            before = newTotal;
+            MCU_TaskLoop();
+        } while(newTotal != before);
+        if(!checkOrder)
+            newTime += Now() - start;
+    }
+
+    for(uint32_t i = 0; i < NUM_TASKS; i++)
+    {
+        if(oldRuns[i] != newRuns[i])
+        {
+            printf("Task %u ran %u times with the old scheduler and %u with the "
+                "new one\n", i, oldRuns[i], newRuns[i]);
+            failed = 1;
+        }
+    }
+    if(orderErrors > 0)
+    {
+        printf("%d times a lower priority task ran first\n", orderErrors);
+        failed = 1;
+    }
+
+    /* The first 500 ticks aren't timed for the new one, so scale it */
+    newTime = newTime * NUM_TICKS / (NUM_TICKS - 500);
+    printf("%u tasks, %lu ticks, %llu tasks run\n", NUM_TASKS, NUM_TICKS,
+        (unsigned long long)runs);
+    printf("  Old pending list:  %8.3f s (%6.1f ns per task run)\n", oldTime,
+        oldTime / runs * 1e9);
+    printf("  Ready queue:       %8.3f s (%6.1f ns per task run)\n", newTime,
+        newTime / runs * 1e9);
+    printf("%s\n", failed ? "FAIL" : "PASS");
+
+    return failed;
+}
@@ -0,0 +1,156 @@
+/* Program to test the task statistics in IMCU - MS */
+
+/* Build from the MCU folder with:
+gcc -std=c99 -DMCU_TASK_STATS -I. TestStats.c IMCU.c
+
+On a real chip the counter would be DWT->CYCCNT, and on a PC you could use
+clock_gettime. But then the numbers would be different every time, so here the
+counter is fake and only moves when we say so. That way every number can be
+checked exactly. It starts just before it rolls over to make sure that works.
+
+Tasks "work" by moving the counter forward a little at a time. Every 1000
+counts is a tick, which happens right then, even in the middle of a task, just
+like an interrupt. Task 0 is preemptive, so it runs right after the tick. The
+rest are cooperative. Task 3 takes longer than its own period, so it should
+miss deadlines. Task 0 should never miss one, and the time task 0 takes should
+not show up in the times for the tasks it interrupted. */
+
+#include <stdio.h>
+#include <string.h>
+#include "IMCU.h"
+
+#define COUNTS_PER_TICK     1000
+#define NUM_TICKS           10000
+#define START_COUNT         0xFFFFF000UL
+
+static uint32_t counter = START_COUNT;
+static uint32_t nextTick = START_COUNT + COUNTS_PER_TICK;
+static uint32_t ticks;
+static bool softwareInterrupt, inSoftwareInterrupt;
+static uint32_t task1Runs;
+static MCUTask tasks[4];
+
+uint32_t GetCounter(void)
+{
+    return counter;
+}
+
+void TriggerSoftwareInterrupt(uint8_t priority)
+{
+    (void)priority;
+    softwareInterrupt = true;
+}
+
+/* Like PendSV, the software interrupt can't interrupt itself */
+void CheckInterrupts(void)
+{
+    while((int32_t)(counter - nextTick) >= 0)
+    {
+        MCU_TaskTick();
+        ticks++;
+        nextTick += COUNTS_PER_TICK;
+    }
+
+    if(softwareInterrupt && !inSoftwareInterrupt)
+    {
+        softwareInterrupt = false;
+        inSoftwareInterrupt = true;
+        MCU_PreemptDispatch();
+        inSoftwareInterrupt = false;
+    }
+}
+
+void Work(uint32_t counts)
+{
+    while(counts >= 10)
+    {
+        counter += 10;
+        counts -= 10;
+        CheckInterrupts();
+    }
+}
+
+void Task0(void) { Work(100); }
+void Task1(void) { Work(200 + 100 * (task1Runs++ % 5)); }
+void Task2(void) { Work(500); }
+void Task3(void) { Work(2500); }
+
+/* Never called here, but IMCU.c needs it to link */
+void MCU_EnterLowPowerMode(MCUPowerMode powerMode)
+{
+    (void)powerMode;
+}
+
+void PrintLine(const char *line)
+{
+    printf("  %s\n", line);
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    int failed = 0;
+    const MCUTaskStats *st[4];
+
+    MCU_AddTask(&tasks[0], 1, 0, Task0);
+    MCU_AddTask(&tasks[1], 10, 5, Task1);
+    MCU_AddTask(&tasks[2], 7, 10, Task2);
+    MCU_AddTask(&tasks[3], 2, 20, Task3);
+    MCU_PreemptInit(1, TriggerSoftwareInterrupt);
+    MCU_StatsInit(GetCounter);
+
+    while(ticks < NUM_TICKS)
+    {
+        MCU_TaskLoop();
+        Work(10);   // the main loop itself takes a little time
+    }
+
+    printf("Statistics after %u ticks\n", ticks);
+    MCU_StatsDump(PrintLine);
+    printf("\n");
+
+    for(uint8_t i = 0; i < 4; i++)
+        st[i] = MCU_StatsGet(&tasks[i]);
+
+    failed += Check("Every task ran", st[0]->runs > 0 && st[1]->runs > 0 &&
+        st[2]->runs > 0 && st[3]->runs > 0);
+    failed += Check("Preemptive task ran on every tick",
+        st[0]->runs == ticks);
+    failed += Check("Preemptive task never missed a deadline",
+        st[0]->deadlineMisses == 0);
+    failed += Check("Preemptive task had no latency or jitter",
+        st[0]->maxLatency == 0);
+    failed += Check("Task 0 time taken out of interrupted tasks",
+        st[2]->minTime == 500 && st[2]->maxTime == 500 &&
+        st[3]->minTime == 2500 && st[3]->maxTime == 2500);
+    failed += Check("Min, max, and average of a task that varies",
+        st[1]->minTime == 200 && st[1]->maxTime == 600 &&
+        st[1]->totalTime == 200ULL * st[1]->runs + 100ULL *
+        (task1Runs / 5 * 10 + (task1Runs % 5) * (task1Runs % 5 - 1) / 2));
+    failed += Check("Task longer than its period missed deadlines",
+        st[3]->deadlineMisses > 0);
+    failed += Check("Cooperative tasks had some jitter",
+        st[3]->maxLatency > st[3]->minLatency);
+
+    /* Everything the counter did went through Work, so the elapsed time is
+    exact, and so is the busy time */
+    uint64_t busy = 0;
+    for(uint8_t i = 0; i < 4; i++)
+        busy += st[i]->totalTime;
+    failed += Check("Elapsed time across counter roll over",
+        MCU_StatsGetElapsedTime() == (uint32_t)(counter - START_COUNT));
+    failed += Check("Busy time is the sum of the task times",
+        MCU_StatsGetBusyTime() == busy);
+
+    MCU_StatsReset();
+    failed += Check("Reset clears everything", MCU_StatsGet(&tasks[3])->runs
+        == 0 && MCU_StatsGetElapsedTime() == 0 && MCU_StatsGetBusyTime() == 0);
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
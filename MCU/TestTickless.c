@@ -0,0 +1,415 @@
+/* Host simulation of the tickless idle in IMCU - MS */
+
+/* Build from the MCU folder with:
+gcc -std=gnu99 -I. -I"../Hardware Timer (PWM)/Interface" -I../Timer TestTickless.c
+"../Hardware Timer (PWM)/Interface/IHardwareTimer.c" ../Timer/Timer.c
+
+There's no real processor here, so time only moves forward while we are
+"asleep" inside MCU_EnterLowPowerMode. The fake hardware timer is a 16-bit
+free-running counter at 1 MHz with one compare channel. 1000 counts make a
+1 ms tick. A few tasks and a software timer run for a minute of simulated
+time, once waking up on every tick like normal, and once with MCU_TaskIdle.
+Some random outside interrupts are thrown in to wake the processor early.
+
+Latency is how long after the tick a task was due on that it actually ran.
+Both ways should run every task the same number of times with the same
+latency. The tickless version should just wake up a lot less. The scheduler
+has no way to remove tasks, so each run happens in its own process.
+
+IMCU.c is included right into this file with MCU_TICKLESS defined, so that the
+critical section macros can be defined first. They act like PRIMASK. While
+it's set, an interrupt only gets marked pending, and it runs as soon as the
+critical section ends. A pending interrupt still wakes up the fake processor,
+the same as WFI. Every so often a button gets pressed right in the middle of
+MCU_TaskIdle, after it checked for work but before it went to sleep. The
+button interrupt wakes up a coroutine. If MCU_TaskIdle went to sleep anyway,
+the coroutine would sit there until the next tick it had planned on. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <stdbool.h>
+
+static bool irqMasked;
+void Sim_RunPendingInterrupts(void);
+
+#define MCU_TICKLESS
+#define MCU_ENTER_CRITICAL()    bool savedMask = irqMasked; irqMasked = true
+#define MCU_EXIT_CRITICAL()     irqMasked = savedMask; Sim_RunPendingInterrupts()
+
+#include "IMCU.c"
+#include "IHardwareTimer.h"
+#include "Timer.h"
+
+#define COUNTS_PER_TICK     1000
+#define WAKE_UP_COUNTS      5       // time from the interrupt to running code
+#define SIM_TICKS           60000UL
+#define OUTSIDE_IRQ_MEAN    200000  // average counts between outside interrupts
+#define NUM_TASKS           4
+#define LED_PERIOD_MS       250
+#define BUTTON_MEAN         50000   // average counts between button presses
+
+typedef struct SimTaskTag
+{
+    MCUTask task;
+    uint64_t nextDue;
+    uint32_t runs;
+    uint64_t totalLatency;
+    uint32_t maxLatency;
+} SimTask;
+
+typedef struct ResultTag
+{
+    SimTask tasks[NUM_TASKS];
+    uint32_t tickInterrupts;
+    uint32_t wakeUps;
+    uint32_t outsideIrqs;
+    uint32_t ledToggles;
+    uint32_t presses;
+    uint32_t buttonRuns;
+    uint32_t maxButtonLatency;
+} Result;
+
+static uint64_t simTime, timerBase, nextOutsideIrq;
+static uint16_t compareValue;
+static bool compareFlag;
+static void (*CompareCallback)(uint8_t compChan);
+static uint32_t wakeUps, outsideIrqs, ledToggles;
+static bool useIdle;
+
+/* Interrupts waiting for the critical section to end */
+static bool comparePending, buttonPending;
+
+/* The button and the coroutine it wakes up */
+static MCUCoroutine buttonTask;
+static MCUSignal buttonSignal;
+static uint64_t nextPress, pressTime;
+static uint32_t presses, buttonRuns, maxButtonLatency;
+
+static HWTimer timer;
+static MCUTickless ticker;
+static TimerWheel wheel;
+static Timer ledTimer;
+static SimTask tasks[NUM_TASKS];
+static const uint16_t taskPeriods[NUM_TASKS] = {10, 25, 100, 1000};
+
+// ***** Fake hardware timer ***************************************************
+
+uint16_t Sim_GetCount(void)
+{
+    return (uint16_t)(simTime - timerBase);
+}
+
+void Sim_SetCompare16Bit(uint8_t compChan, uint16_t compValue)
+{
+    /* The period is 0xFFFF, so the full scale value is the count */
+    (void)compChan;
+    compareValue = compValue;
+}
+
+bool Sim_GetCompareMatch(uint8_t compChan)
+{
+    (void)compChan;
+    return compareFlag;
+}
+
+void Sim_ClearCompareMatchFlag(uint8_t compChan)
+{
+    (void)compChan;
+    compareFlag = false;
+}
+
+void Sim_CompareMatchEvent(void)
+{
+    compareFlag = false;
+    if(CompareCallback)
+        CompareCallback(0);
+}
+
+void Sim_SetCompareMatchCallback(void (*Function)(uint8_t compChan))
+{
+    CompareCallback = Function;
+}
+
+HWTimerInterface simTimerInterface = {
+    .HWTimer_GetCount = Sim_GetCount,
+    .HWTimer_SetCompare16Bit = Sim_SetCompare16Bit,
+    .HWTimer_GetCompareMatch = Sim_GetCompareMatch,
+    .HWTimer_ClearCompareMatchFlag = Sim_ClearCompareMatchFlag,
+    .HWTimer_CompareMatchEvent = Sim_CompareMatchEvent,
+    .HWTimer_SetCompareMatchCallback = Sim_SetCompareMatchCallback,
+};
+
+// ***** Fake interrupts ******************************************************
+
+void ButtonInterrupt(void)
+{
+    MCU_SignalSet(&buttonSignal);
+}
+
+/* Run whatever is pending, unless interrupts are masked. They're masked while 
+one runs, so they don't interrupt each other. */
+void Sim_RunPendingInterrupts(void)
+{
+    if(irqMasked)
+        return;
+
+    irqMasked = true;
+    if(comparePending)
+    {
+        comparePending = false;
+        compareFlag = true;
+        HWTimer_CompareMatchEvent(&timer);
+    }
+    if(buttonPending)
+    {
+        buttonPending = false;
+        ButtonInterrupt();
+    }
+    irqMasked = false;
+}
+
+// ***** The only interface function the scheduler needs ***********************
+
+void MCU_EnterLowPowerMode(MCUPowerMode powerMode)
+{
+    (void)powerMode;
+
+    /* Like WFI, a pending interrupt wakes us up right away even if they are 
+    masked */
+    if(comparePending || buttonPending)
+    {
+        Sim_RunPendingInterrupts();
+        return;
+    }
+
+    /* Sleep until the count hits the compare value or an outside interrupt
+    happens, whichever comes first */
+    uint32_t toCompare = (uint16_t)(compareValue - Sim_GetCount());
+    if(toCompare == 0)
+        toCompare = 0x10000;
+
+    uint64_t compareTime = simTime + toCompare;
+    wakeUps++;
+
+    if(compareTime <= nextOutsideIrq)
+    {
+        simTime = compareTime + WAKE_UP_COUNTS;
+        comparePending = true;
+    }
+    else
+    {
+        simTime = nextOutsideIrq + WAKE_UP_COUNTS;
+        outsideIrqs++;
+        nextOutsideIrq += 1 + rand() % (2 * OUTSIDE_IRQ_MEAN);
+
+        /* The compare could have matched while we were waking up. On a real 
+        chip that interrupt would be pending, so it runs right after. */
+        if(compareTime <= simTime)
+            comparePending = true;
+    }
+    Sim_RunPendingInterrupts();
+}
+
+// ***** Tasks and timers ******************************************************
+
+void RecordRun(uint8_t i)
+{
+    SimTask *t = &tasks[i];
+    uint32_t latency = (uint32_t)(simTime - t->nextDue);
+
+    t->runs++;
+    t->totalLatency += latency;
+    if(latency > t->maxLatency)
+        t->maxLatency = latency;
+
+    /* The count reloads when the task runs, so the next one is due one period
+    after the tick this one ran on */
+    uint64_t thisTick = simTime - (simTime - timerBase) % COUNTS_PER_TICK;
+    t->nextDue = thisTick + (uint64_t)taskPeriods[i] * COUNTS_PER_TICK;
+}
+
+void Task0(void) { RecordRun(0); }
+void Task1(void) { RecordRun(1); }
+void Task2(void) { RecordRun(2); }
+void Task3(void) { RecordRun(3); }
+
+void ToggleLed(void *timerContext)
+{
+    (void)timerContext;
+    ledToggles++;
+    Timer_ClearFlag(&ledTimer);
+}
+
+void ButtonCoroutine(MCUCoroutine *co)
+{
+    MCU_CO_BEGIN(co);
+    while(1)
+    {
+        MCU_CO_AWAIT(co, &buttonSignal);
+        uint32_t latency = (uint32_t)(simTime - pressTime);
+        buttonRuns++;
+        if(latency > maxButtonLatency)
+            maxButtonLatency = latency;
+    }
+    MCU_CO_END(co);
+}
+
+/* MCU_TaskIdle calls this after it has looked at the tasks and right before 
+it goes to sleep. That's the worst time for an interrupt to show up. */
+uint32_t NextTimerDeadline(void)
+{
+    if(simTime >= nextPress)
+    {
+        presses++;
+        pressTime = simTime;
+        nextPress = simTime + 1 + rand() % (2 * BUTTON_MEAN);
+        buttonPending = true;
+        Sim_RunPendingInterrupts();
+    }
+    return TimerWheel_GetNextDeadline(&wheel);
+}
+
+void TickTimers(uint32_t ticks)
+{
+    TimerWheel_TickMultiple(&wheel, ticks);
+}
+
+// *****************************************************************************
+
+void Run(bool useTickless, Result *result)
+{
+    void (*functions[NUM_TASKS])(void) = {Task0, Task1, Task2, Task3};
+
+    useIdle = useTickless;
+    simTime = 0;
+    timerBase = 0;
+    wakeUps = 0;
+    outsideIrqs = 0;
+    ledToggles = 0;
+    presses = 0;
+    buttonRuns = 0;
+    maxButtonLatency = 0;
+    srand(1);
+    nextOutsideIrq = 1 + rand() % (2 * OUTSIDE_IRQ_MEAN);
+    nextPress = 1 + rand() % (2 * BUTTON_MEAN);
+
+    HWTimer_Create(&timer, NULL, &simTimerInterface);
+    MCU_TicklessInit(&ticker, &timer, 0, COUNTS_PER_TICK);
+    MCU_TicklessSetTimerFunctions(&ticker, NextTimerDeadline, TickTimers);
+
+    TimerWheel_Init(&wheel);
+    Timer_InitMs(&ledTimer, LED_PERIOD_MS, 1);
+    Timer_SetMode(&ledTimer, TIMER_PERIODIC);
+    Timer_SetFinishedCallback(&ledTimer, ToggleLed);
+    TimerWheel_Add(&wheel, &ledTimer);
+    Timer_Start(&ledTimer);
+
+    for(uint8_t i = 0; i < NUM_TASKS; i++)
+    {
+        memset(&tasks[i], 0, sizeof(SimTask));
+        tasks[i].nextDue = (uint64_t)taskPeriods[i] * COUNTS_PER_TICK;
+        MCU_AddTask(&tasks[i].task, taskPeriods[i], i, functions[i]);
+    }
+    MCU_AddCoroutine(&buttonTask, NUM_TASKS, ButtonCoroutine);
+
+    while(ticker.ticks < SIM_TICKS)
+    {
+        MCU_TaskLoop();
+
+        if(useIdle)
+            MCU_TaskIdle(MCU_LPM_LEVEL_1);
+        else if(MCU_GetTicksUntilNextTask() != 0)
+            MCU_EnterLowPowerMode(MCU_LPM_LEVEL_1);
+    }
+
+    memcpy(result->tasks, tasks, sizeof(tasks));
+    result->tickInterrupts = ticker.tickInterrupts;
+    result->wakeUps = wakeUps;
+    result->outsideIrqs = outsideIrqs;
+    result->ledToggles = ledToggles;
+    result->presses = presses;
+    result->buttonRuns = buttonRuns;
+    result->maxButtonLatency = maxButtonLatency;
+}
+
+/* Do one run in a child process and read back the results */
+int RunInChild(bool useTickless, Result *result)
+{
+    int fd[2];
+    pid_t pid;
+
+    if(pipe(fd) != 0 || (pid = fork()) < 0)
+        return 1;
+
+    if(pid == 0)
+    {
+        close(fd[0]);
+        Run(useTickless, result);
+        _exit(write(fd[1], result, sizeof(Result)) == sizeof(Result) ? 0 : 1);
+    }
+
+    close(fd[1]);
+    ssize_t n = read(fd[0], result, sizeof(Result));
+    close(fd[0]);
+    waitpid(pid, NULL, 0);
+    return (n == sizeof(Result)) ? 0 : 1;
+}
+
+int main(void)
+{
+    Result normal, idle;
+    int failed = 0;
+
+    if(RunInChild(false, &normal) || RunInChild(true, &idle))
+    {
+        printf("Couldn't run the simulation\n");
+        return 1;
+    }
+
+    printf("Ticking every 1 ms: %u wake ups, %u tick interrupts, "
+        "%u outside interrupts, %u LED toggles\n", normal.wakeUps,
+        normal.tickInterrupts, normal.outsideIrqs, normal.ledToggles);
+    printf("Tickless idle:      %u wake ups, %u tick interrupts, "
+        "%u outside interrupts, %u LED toggles\n", idle.wakeUps,
+        idle.tickInterrupts, idle.outsideIrqs, idle.ledToggles);
+    printf("Tick interrupts cut by %.1f%%, wake ups cut by %.1f%%\n\n",
+        100.0 * (normal.tickInterrupts - idle.tickInterrupts) /
+        normal.tickInterrupts,
+        100.0 * (normal.wakeUps - idle.wakeUps) / normal.wakeUps);
+
+    printf("%-8s %-6s %8s %8s %12s %12s\n", "task", "mode", "period",
+        "runs", "avg us", "max us");
+    for(uint8_t i = 0; i < NUM_TASKS; i++)
+    {
+        SimTask *n = &normal.tasks[i], *t = &idle.tasks[i];
+        printf("%-8u %-6s %8u %8u %12.2f %12u\n", i, "normal", taskPeriods[i],
+            n->runs, (double)n->totalLatency / n->runs, n->maxLatency);
+        printf("%-8u %-6s %8u %8u %12.2f %12u\n", i, "idle", taskPeriods[i],
+            t->runs, (double)t->totalLatency / t->runs, t->maxLatency);
+
+        /* Every task should run the same number of times and never more
+        than a tick late */
+        if(n->runs != t->runs || t->runs == 0 ||
+            t->maxLatency >= COUNTS_PER_TICK)
+            failed = 1;
+    }
+
+    if(normal.ledToggles != idle.ledToggles ||
+        idle.tickInterrupts >= normal.tickInterrupts)
+        failed = 1;
+
+    /* The button is only pressed inside MCU_TaskIdle. Every press has to 
+    wake the coroutine before any more time goes by. */
+    printf("\nButton pressed inside MCU_TaskIdle %u times, coroutine ran %u "
+        "times, max latency %u us\n", idle.presses, idle.buttonRuns,
+        idle.maxButtonLatency);
+    if(idle.presses == 0 || idle.buttonRuns != idle.presses ||
+        idle.maxButtonLatency >= COUNTS_PER_TICK)
+        failed = 1;
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
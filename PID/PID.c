@@ -21,16 +21,28 @@
  ******************************************************************************/
 
 #include "PID.h"
+#include <stddef.h>
+#include <math.h>
 
 // ***** Defines ***************************************************************
 
 #define DEFAULT_I_REDUCE_FACTOR 0.05
 
+/* The first couple of cycles of the relay test are thrown away while the 
+process settles into a steady oscillation. Then the next few are averaged. */
+#define AUTOTUNE_DISCARD_CYCLES 2
+#define AUTOTUNE_MEASURE_CYCLES 3
+
+#define PID_PI                  3.14159265f
+
 // ***** Global Variables ******************************************************
 
 
 // ***** Static Functions Prototypes *******************************************
 
+static float AutotuneRelay(PID *self, float processVariable);
+static void AutotuneFinish(PID *self);
+
 
 // *****************************************************************************
 
@@ -44,6 +56,9 @@ void PID_Create(PID *self, float Kp, float Ki, float Kd, float min, float max)
     self->iReductionFactor = DEFAULT_I_REDUCE_FACTOR;
     self->integral = 0;
     self->prevError = 0;
+    self->setPoint = 0;
+    self->controlVariable = 0;
+    self->autotune = NULL;
     self->enable = false;
 }
 
@@ -59,7 +74,10 @@ void PID_AdjustSetPoint(PID *self, float setPoint)
 float PID_Compute(PID *self, float processVariable)
 {
     if(self->enable == false)
-        return;
+        return self->controlVariable;
+
+    if(self->autotune != NULL)
+        return AutotuneRelay(self, processVariable);
 
     float error = self->setPoint - processVariable;
     float derivative = error - self->prevError;
@@ -134,6 +152,213 @@ void PID_AdjustIReductionFactor(PID *self, float r)
     self->iReductionFactor = r;
 }
 
+// *****************************************************************************
+
+void PID_AutotuneInit(PIDAutotune *self, float outputBias, float relayAmplitude,
+    float hysteresis, PIDTuningRule rule, uint32_t maxSamples)
+{
+    if(relayAmplitude < 0)
+        relayAmplitude = -relayAmplitude;
+
+    if(hysteresis < 0)
+        hysteresis = -hysteresis;
+
+    self->outputBias = outputBias;
+    self->relayAmplitude = relayAmplitude;
+    self->hysteresis = hysteresis;
+    self->rule = rule;
+    self->maxSamples = maxSamples;
+    self->Ku = 0;
+    self->Tu = 0;
+    self->state = PID_AUTOTUNE_IDLE;
+}
+
+// *****************************************************************************
+
+void PID_AutotuneStart(PID *self, PIDAutotune *tuner)
+{
+    tuner->sampleCount = 0;
+    tuner->lastSwitch = 0;
+    tuner->periodSum = 0;
+    tuner->amplitudeSum = 0;
+    tuner->numSwitches = 0;
+    tuner->Ku = 0;
+    tuner->Tu = 0;
+    /* The relay direction gets picked on the first sample */
+    tuner->peakHigh = -INFINITY;
+    tuner->peakLow = INFINITY;
+    tuner->relayHigh = false;
+    tuner->state = PID_AUTOTUNE_RUNNING;
+    self->autotune = tuner;
+}
+
+// *****************************************************************************
+
+void PID_AutotuneStop(PID *self)
+{
+    if(self->autotune != NULL && self->autotune->state == PID_AUTOTUNE_RUNNING)
+        self->autotune->state = PID_AUTOTUNE_IDLE;
+
+    self->autotune = NULL;
+    self->integral = 0;
+    self->prevError = 0;
+}
+
+// *****************************************************************************
+
+PIDAutotuneState PID_AutotuneGetState(PIDAutotune *self)
+{
+    return self->state;
+}
+
+// *****************************************************************************
+
+float PID_AutotuneGetUltimateGain(PIDAutotune *self)
+{
+    return self->Ku;
+}
+
+// *****************************************************************************
+
+float PID_AutotuneGetUltimatePeriod(PIDAutotune *self)
+{
+    return self->Tu;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Run one sample of the relay test
+ * 
+ * The relay switches low when the process variable goes above the set point
+ * plus the hysteresis, and switches high when it goes below the set point 
+ * minus the hysteresis. Every time the relay switches high, one full cycle 
+ * has finished. The peaks and the number of samples for that cycle are saved.
+ * 
+ * @param self  pointer to the PID that you are using
+ * 
+ * @param processVariable  the current measurement
+ * 
+ * @return float  the relay output
+ */
+static float AutotuneRelay(PID *self, float processVariable)
+{
+    PIDAutotune *tuner = self->autotune;
+
+    if(tuner->sampleCount == 0)
+        tuner->relayHigh = (processVariable < self->setPoint);
+
+    tuner->sampleCount++;
+
+    if(processVariable > tuner->peakHigh)
+        tuner->peakHigh = processVariable;
+
+    if(processVariable < tuner->peakLow)
+        tuner->peakLow = processVariable;
+
+    if(tuner->relayHigh && processVariable > self->setPoint + tuner->hysteresis)
+    {
+        tuner->relayHigh = false;
+    }
+    else if(!tuner->relayHigh && 
+        processVariable < self->setPoint - tuner->hysteresis)
+    {
+        tuner->relayHigh = true;
+        tuner->numSwitches++;
+
+        /* The time between two switches is one full period. The first one 
+        doesn't have a full cycle before it, so it can never be counted. */
+        if(tuner->numSwitches > AUTOTUNE_DISCARD_CYCLES)
+        {
+            tuner->periodSum += tuner->sampleCount - tuner->lastSwitch;
+            tuner->amplitudeSum += (tuner->peakHigh - tuner->peakLow) / 2.0f;
+        }
+        tuner->lastSwitch = tuner->sampleCount;
+        tuner->peakHigh = processVariable;
+        tuner->peakLow = processVariable;
+
+        if(tuner->numSwitches >= AUTOTUNE_DISCARD_CYCLES + AUTOTUNE_MEASURE_CYCLES)
+        {
+            AutotuneFinish(self);
+            return self->controlVariable;
+        }
+    }
+
+    if(tuner->maxSamples != 0 && tuner->sampleCount >= tuner->maxSamples)
+    {
+        PID_AutotuneStop(self);
+        tuner->state = PID_AUTOTUNE_FAILED;
+        self->controlVariable = tuner->outputBias;
+        return self->controlVariable;
+    }
+
+    if(tuner->relayHigh)
+        self->controlVariable = tuner->outputBias + tuner->relayAmplitude;
+    else
+        self->controlVariable = tuner->outputBias - tuner->relayAmplitude;
+
+    return self->controlVariable;
+}
+
+/***************************************************************************//**
+ * @brief Compute Ku and Tu and load the new constants
+ * 
+ * The relay output is a square wave with amplitude d. Using the describing 
+ * function of a relay, the ultimate gain is Ku = 4d / (pi * a), where a is 
+ * the amplitude of the oscillation. With hysteresis e, it becomes 
+ * Ku = 4d / (pi * sqrt(a^2 - e^2)).
+ * 
+ * My PID adds the error to the integral once per sample and uses the
+ * difference between two samples for the derivative. So Ki = Kp / Ti and 
+ * Kd = Kp * Td with Ti and Td in samples.
+ * 
+ * @param self  pointer to the PID that you are using
+ */
+static void AutotuneFinish(PID *self)
+{
+    PIDAutotune *tuner = self->autotune;
+    float a = tuner->amplitudeSum / AUTOTUNE_MEASURE_CYCLES;
+    float e = tuner->hysteresis;
+    float Ti, Td, Kp;
+
+    self->autotune = NULL;
+
+    if(a <= e || tuner->periodSum == 0)
+    {
+        tuner->state = PID_AUTOTUNE_FAILED;
+        self->controlVariable = tuner->outputBias;
+        return;
+    }
+
+    tuner->Ku = (4.0f * tuner->relayAmplitude) / (PID_PI * sqrtf(a * a - e * e));
+    tuner->Tu = (float)tuner->periodSum / AUTOTUNE_MEASURE_CYCLES;
+
+    if(tuner->rule == PID_TUNE_TYREUS_LUYBEN)
+    {
+        Kp = tuner->Ku / 2.2f;
+        Ti = 2.2f * tuner->Tu;
+        Td = tuner->Tu / 6.3f;
+    }
+    else
+    {
+        Kp = 0.6f * tuner->Ku;
+        Ti = tuner->Tu / 2.0f;
+        Td = tuner->Tu / 8.0f;
+    }
+    PID_AdjustConstants(self, Kp, Kp / Ti, Kp * Td);
+
+    /* Preload the integral so the output picks up right where the relay was
+    centered. Otherwise the output would jump to zero when the PID takes over */
+    self->integral = tuner->outputBias / self->Ki;
+    self->prevError = 0;
+    self->controlVariable = tuner->outputBias;
+    tuner->state = PID_AUTOTUNE_FINISHED;
+}
+
 /*
  End of File
  */
\ No newline at end of file
@@ -10,6 +10,21 @@
  * @details
  *      // TODO Work in progress. Ready to test
  * 
+ * There is an autotune mode based on the relay method by Astrom and Hagglund.
+ * While it is running, the PID output is replaced with a relay that switches 
+ * between (bias + amplitude) and (bias - amplitude) each time the process 
+ * variable crosses the set point. The process will settle into a steady 
+ * oscillation. The height of that oscillation gives us the ultimate gain Ku 
+ * and the time between each cycle gives us the ultimate period Tu. Those two 
+ * numbers are then plugged into either the Ziegler-Nichols or the 
+ * Tyreus-Luyben rules and the new constants are loaded automatically. 
+ * 
+ * Since PID_Compute does not know anything about time, Tu is measured in 
+ * number of calls to PID_Compute. The constants that come out are scaled the 
+ * same way, so just keep calling PID_Compute at the same rate afterwards. 
+ * The Tyreus-Luyben rule is a little more conservative. It will have less 
+ * overshoot but it will take a little longer to settle.
+ * 
  * @section license License
  * SPDX-FileCopyrightText: © 2022 Matthew Spinks
  * SPDX-License-Identifier: Zlib
@@ -31,6 +46,72 @@
 
 // ***** Global Variables ******************************************************
 
+typedef enum PIDTuningRuleTag
+{
+    PID_TUNE_ZIEGLER_NICHOLS,
+    PID_TUNE_TYREUS_LUYBEN,
+} PIDTuningRule;
+
+typedef enum PIDAutotuneStateTag
+{
+    PID_AUTOTUNE_IDLE,
+    PID_AUTOTUNE_RUNNING,
+    PID_AUTOTUNE_FINISHED,
+    PID_AUTOTUNE_FAILED,
+} PIDAutotuneState;
+
+typedef struct PIDAutotuneTag
+{
+    PIDTuningRule rule;
+    PIDAutotuneState state;
+    float outputBias;
+    float relayAmplitude;
+    float hysteresis;
+    float peakHigh;
+    float peakLow;
+    float amplitudeSum;
+    float Ku;
+    float Tu;
+    uint32_t sampleCount;
+    uint32_t lastSwitch;
+    uint32_t periodSum;
+    uint32_t maxSamples;
+    uint8_t numSwitches;
+    bool relayHigh;
+} PIDAutotune;
+
+/** 
+ * Description of struct members. You shouldn't need to mess with any of these
+ * variables directly.
+ * 
+ * rule  Which set of tuning rules to use once Ku and Tu are found
+ * 
+ * state  Idle, running, finished, or failed if no oscillation was found
+ * 
+ * outputBias  The center of the relay output
+ * 
+ * relayAmplitude  How far the relay output swings above and below the bias
+ * 
+ * hysteresis  Noise band around the set point. The process variable must
+ *             cross the set point by this much before the relay switches.
+ * 
+ * peakHigh, peakLow  The highest and lowest value seen this cycle
+ * 
+ * amplitudeSum, periodSum  Running totals that get averaged at the end
+ * 
+ * Ku, Tu  The ultimate gain and ultimate period (in samples)
+ * 
+ * sampleCount  Number of calls to PID_Compute since autotune started
+ * 
+ * lastSwitch  The sample where the relay last switched high
+ * 
+ * maxSamples  Give up after this many samples. 0 will wait forever.
+ * 
+ * numSwitches  Number of times the relay has switched high
+ * 
+ * relayHigh  The current relay output
+ */
+
 /* Class specific variables */
 typedef struct PIDTag
 {
@@ -44,6 +125,7 @@ typedef struct PIDTag
     float integral;
     float iReductionFactor;
     float prevError;
+    PIDAutotune *autotune;
     bool enable;
 } PID;
 
@@ -76,4 +158,75 @@ void PID_Disable(PID *self);
 
 void PID_AdjustIReductionFactor(PID *self, float r);
 
+/***************************************************************************//**
+ * @brief Initialize an autotune object
+ * 
+ * The relay amplitude should be large enough to make the process move a good 
+ * amount, but small enough that it won't hurt anything. Keep the output bias
+ * plus or minus the amplitude within the min and max of the PID. The 
+ * hysteresis should be a little bit bigger than the noise on your process 
+ * variable or the relay will chatter.
+ * 
+ * @param self  pointer to the PIDAutotune object
+ * 
+ * @param outputBias  the center of the relay output
+ * 
+ * @param relayAmplitude  how far the output swings above and below the bias
+ * 
+ * @param hysteresis  noise band around the set point (0 for none)
+ * 
+ * @param rule  PID_TUNE_ZIEGLER_NICHOLS, PID_TUNE_TYREUS_LUYBEN
+ * 
+ * @param maxSamples  give up if not finished by this many samples (0 = never)
+ */
+void PID_AutotuneInit(PIDAutotune *self, float outputBias, float relayAmplitude,
+    float hysteresis, PIDTuningRule rule, uint32_t maxSamples);
+
+/***************************************************************************//**
+ * @brief Put the PID in autotune mode
+ * 
+ * The PID must be enabled and the set point must already be set. Keep calling 
+ * PID_Compute like you normally would. When the autotune is finished, the new
+ * constants are loaded and the PID goes back to normal operation on its own.
+ * 
+ * @param self  pointer to the PID that you are using
+ * 
+ * @param tuner  pointer to an initialized PIDAutotune object
+ */
+void PID_AutotuneStart(PID *self, PIDAutotune *tuner);
+
+/***************************************************************************//**
+ * @brief Cancel autotune and go back to the old constants
+ * 
+ * @param self  pointer to the PID that you are using
+ */
+void PID_AutotuneStop(PID *self);
+
+/***************************************************************************//**
+ * @brief Get the state of the autotune
+ * 
+ * @param self  pointer to the PIDAutotune object
+ * 
+ * @return PIDAutotuneState  idle, running, finished, or failed
+ */
+PIDAutotuneState PID_AutotuneGetState(PIDAutotune *self);
+
+/***************************************************************************//**
+ * @brief Get the ultimate gain measured by the relay test
+ * 
+ * @param self  pointer to the PIDAutotune object
+ * 
+ * @return float  Ku. Only valid after the autotune is finished
+ */
+float PID_AutotuneGetUltimateGain(PIDAutotune *self);
+
+/***************************************************************************//**
+ * @brief Get the ultimate period measured by the relay test
+ * 
+ * @param self  pointer to the PIDAutotune object
+ * 
+ * @return float  Tu in number of samples. Only valid after finishing
+ */
+float PID_AutotuneGetUltimatePeriod(PIDAutotune *self);
+
 #endif  /* PID_H */
\ No newline at end of file
@@ -0,0 +1,136 @@
+/* Program to test PID autotune against a simulated plant - MS */
+
+/* The plant is a first order system with dead time (FOPDT). Most thermal and
+motor speed loops look roughly like this. The relay test is run first, then
+the set point is stepped and the overshoot and settling time are measured for
+both sets of tuning rules. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PID.h"
+
+#define MAX_DEAD_TIME   64
+#define SETTLE_BAND     0.02f
+#define STEP_SAMPLES    4000
+
+typedef struct PlantTag
+{
+    float gain;
+    float tau;
+    uint8_t deadTime;
+    float y;
+    float delayLine[MAX_DEAD_TIME];
+    uint8_t index;
+} Plant;
+
+void Plant_Init(Plant *self, float gain, float tau, uint8_t deadTime, float u0)
+{
+    self->gain = gain;
+    self->tau = tau;
+    self->deadTime = deadTime;
+    self->y = gain * u0;
+    self->index = 0;
+    for(uint8_t i = 0; i < MAX_DEAD_TIME; i++)
+        self->delayLine[i] = u0;
+}
+
+float Plant_Step(Plant *self, float u)
+{
+    /* Delay the input by deadTime samples, then a simple Euler step of
+    tau * dy/dt = -y + K * u */
+    float delayed = u;
+    if(self->deadTime > 0)
+    {
+        delayed = self->delayLine[self->index];
+        self->delayLine[self->index] = u;
+        if(++self->index >= self->deadTime)
+            self->index = 0;
+    }
+    self->y += (self->gain * delayed - self->y) / self->tau;
+    return self->y;
+}
+
+float Limit(float x, float min, float max)
+{
+    return (x > max ? max : x < min ? min : x);
+}
+
+int RunTest(PIDTuningRule rule, const char *name, float gain, float tau,
+    uint8_t deadTime)
+{
+    PID pid;
+    PIDAutotune tuner;
+    Plant plant;
+    float bias = 50.0f, sp = 50.0f, step = 10.0f;
+    float u = bias, y;
+    uint32_t tuneSamples = 0;
+
+    Plant_Init(&plant, gain, tau, deadTime, bias);
+    y = plant.y;
+    PID_Create(&pid, 0, 0, 0, 0.0f, 100.0f);
+    PID_AdjustSetPoint(&pid, sp);
+    PID_Enable(&pid);
+    PID_AutotuneInit(&tuner, bias, 20.0f, 0.5f, rule, 100000);
+    PID_AutotuneStart(&pid, &tuner);
+
+    while(PID_AutotuneGetState(&tuner) == PID_AUTOTUNE_RUNNING)
+    {
+        u = Limit(PID_Compute(&pid, y), 0.0f, 100.0f);
+        y = Plant_Step(&plant, u);
+        tuneSamples++;
+    }
+
+    printf("%s\n", name);
+    if(PID_AutotuneGetState(&tuner) != PID_AUTOTUNE_FINISHED)
+    {
+        printf("  Autotune failed after %u samples\n", tuneSamples);
+        return 1;
+    }
+    printf("  Autotune finished in %u samples\n", tuneSamples);
+    printf("  Ku = %.4f  Tu = %.2f samples\n",
+        PID_AutotuneGetUltimateGain(&tuner),
+        PID_AutotuneGetUltimatePeriod(&tuner));
+    printf("  Kp = %.4f  Ki = %.5f  Kd = %.4f\n", pid.Kp, pid.Ki, pid.Kd);
+
+    /* Let it settle back to the set point before the step */
+    for(uint32_t i = 0; i < STEP_SAMPLES; i++)
+    {
+        u = Limit(PID_Compute(&pid, y), 0.0f, 100.0f);
+        y = Plant_Step(&plant, u);
+    }
+
+    float start = y, target = sp + step, peak = y;
+    uint32_t settle = 0;
+    PID_AdjustSetPoint(&pid, target);
+    for(uint32_t i = 0; i < STEP_SAMPLES; i++)
+    {
+        u = Limit(PID_Compute(&pid, y), 0.0f, 100.0f);
+        y = Plant_Step(&plant, u);
+        if(y > peak)
+            peak = y;
+        /* Settling time is the last sample that was outside of the band */
+        if(y > target + step * SETTLE_BAND || y < target - step * SETTLE_BAND)
+            settle = i + 1;
+    }
+    printf("  Step %.1f -> %.1f: overshoot = %.1f%%  settling time = %u "
+        "samples\n", start, target, (peak - target) / step * 100.0f, settle);
+
+    return (settle >= STEP_SAMPLES) ? 1 : 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    float gain = 1.0f, tau = 50.0f;
+    uint8_t deadTime = 10;
+
+    printf("Plant: K = %.2f  tau = %.1f  dead time = %u samples\n",
+        gain, tau, deadTime);
+    failed += RunTest(PID_TUNE_ZIEGLER_NICHOLS, "Ziegler-Nichols", gain, tau,
+        deadTime);
+    failed += RunTest(PID_TUNE_TYREUS_LUYBEN, "Tyreus-Luyben", gain, tau,
+        deadTime);
+
+    return failed;
+}
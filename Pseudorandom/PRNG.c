@@ -70,7 +70,35 @@ modulus as the 32-bit Park Miller */
 #define SCH_Q                   44488 // Q = M / A
 #define SCH_R                   3399  // R = M % A
 
-#define DEBUG_PRINT             true
+/* Multiplier from PCG reference code by M.E. O'Neill. The increment can be 
+any odd number. Each increment gives a different stream. */
+#define PCG32_MULT              6364136223846793005ULL
+#define PCG32_DEFAULT_STREAM    54ULL
+
+/* Larger elements are swapped a piece at a time through a buffer this big */
+#define SHUFFLE_TMP_SIZE        16
+
+/* Records smaller than this are shuffled in place by PRNG_ShuffleGather. On 
+a PC the list of indices starts to pay off at about one cache line. */
+#define SHUFFLE_GATHER_MIN_SIZE 64
+
+/* The shuffle picks this many random indices at a time before it swaps */
+#define SHUFFLE_BATCH           32
+
+/* The golden ratio constant used by SplitMix64 (Steele, Lea, Flood) */
+#define SPLITMIX64_GAMMA        0x9E3779B97F4A7C15ULL
+
+/* The characteristic polynomial of xoshiro128 is 
+x^128 + XOSHIRO128_POLY[3..0] (bit i = coefficient of x^i). It is needed to 
+compute the jump polynomial for an arbitrary skip. */
+static const uint32_t XOSHIRO128_POLY[4] = {0xDE18FC01, 0x1B489DB6,
+                                            0x006254B1, 0x00FC65A2};
+
+/* x^(2^64) mod the characteristic polynomial. Same as the reference JUMP */
+static const uint32_t XOSHIRO128_JUMP[4] = {0x8764000B, 0xF542D2D3,
+                                            0x6FA035C3, 0x77F2DB5B};
+
+#define DEBUG_PRINT             false
 
 #if DEBUG_PRINT
 #include <stdio.h>
@@ -79,8 +107,26 @@ modulus as the 32-bit Park Miller */
 // ***** Global Variables ******************************************************
 
 
+
 // ***** Static Functions Prototypes *******************************************
 
+static inline uint32_t Next32(PRNG *self);
+static inline uint32_t ModRecip(uint32_t x, uint32_t range, uint32_t recip);
+static void Advance(PRNG *self, int64_t n);
+static void SwapBytes(uint8_t *a, uint8_t *b, size_t s);
+static void ShuffleIndices(PRNG *self, uint32_t *j, uint32_t i, uint32_t count);
+static uint64_t SplitMix64_Step(uint64_t *state);
+static void Xoshiro128ss_MulMod(uint32_t *a, const uint32_t *b);
+static void Xoshiro128ss_ApplyPoly(uint32_t *state, const uint32_t *poly);
+
+// *****************************************************************************
+
+void PRNG_Create(PRNG *self, PRNGType type)
+{
+    self->type = type;
+    self->isSeeded = false;
+    self->boundedRange = 0;
+}
 
 // *****************************************************************************
 
@@ -102,9 +148,41 @@ void PRNG_Seed(PRNG *self, uint32_t seed)
             case PRNG_TYPE_SCHRAGE:
                 seed = PM_DEFAULT_SEED;
                 break;
+            default:
+                /* The newer generators are fine with a seed of 0 */
+                break;
         }
     }
-    self->state.u64 = seed;
+
+    switch(self->type)
+    {
+        case PRNG_TYPE_XOSHIRO128SS:
+        {
+            /* The state must not be all zeros. The authors recommend filling 
+            it with the output of SplitMix64, which will never give us four 
+            zeros in a row. */
+            uint64_t sm = seed;
+            uint64_t a = SplitMix64_Step(&sm);
+            uint64_t b = SplitMix64_Step(&sm);
+            self->state.u32x4[0] = (uint32_t)a;
+            self->state.u32x4[1] = (uint32_t)(a >> 32);
+            self->state.u32x4[2] = (uint32_t)b;
+            self->state.u32x4[3] = (uint32_t)(b >> 32);
+            break;
+        }
+        case PRNG_TYPE_PCG32:
+            /* Same as pcg32_srandom_r from the reference code */
+            self->state.u64x2[0] = 0;
+            self->state.u64x2[1] = (PCG32_DEFAULT_STREAM << 1) | 1ULL;
+            PCG32_Next(self->state.u64x2);
+            self->state.u64x2[0] += seed;
+            PCG32_Next(self->state.u64x2);
+            break;
+        default:
+            self->state.u64 = seed;
+            break;
+    }
+    self->boundedRange = 0;
     self->isSeeded = true;
 }
 
@@ -131,6 +209,15 @@ uint32_t PRNG_Next(PRNG *self)
         case PRNG_TYPE_SCHRAGE:
             result = Schrage_Next(&(self->state.u32));
             break;
+        case PRNG_TYPE_XOSHIRO128SS:
+            result = Xoshiro128ss_Next(self->state.u32x4);
+            break;
+        case PRNG_TYPE_PCG32:
+            result = PCG32_Next(self->state.u64x2);
+            break;
+        case PRNG_TYPE_SPLITMIX64:
+            result = SplitMix64_Next(&(self->state.u64));
+            break;
     }
     return result;
 }
@@ -140,7 +227,6 @@ uint32_t PRNG_Next(PRNG *self)
 uint32_t PRNG_NextBounded(PRNG *self, uint32_t lower, uint32_t upper)
 {
     uint32_t result = 0;
-    uint32_t randMax = 0xFFFFFFFF;
 
     if(!self->isSeeded)
         PRNG_Seed(self, 0);
@@ -149,55 +235,284 @@ uint32_t PRNG_NextBounded(PRNG *self, uint32_t lower, uint32_t upper)
     {
         uint32_t temp = lower;
         lower = upper;
-        upper = lower;
+        upper = temp;
+    }
+
+    /* output = output % (upper - lower + 1) + min. A range of 0 means the 
+    full 32 bits were asked for. */
+    uint32_t range = upper - lower + 1;
+
+    switch(self->type)
+    {
+        case PRNG_TYPE_PARK_MILLER:
+        case PRNG_TYPE_SCHRAGE:
+        {
+            /* The Park Miller output goes from 1 to m - 1, which isn't a 
+            power of two, so the multiply-shift method below doesn't work. Use 
+            the modulo bias removal method instead. Subtract one so the output 
+            starts at 0. If the range is bigger than the output there is 
+            nothing to remove. */
+            uint32_t count = PM_BIG_M - 1UL;
+            if(range == 0 || range >= count)
+                return (PRNG_Next(self) - 1) + lower;
+
+            /* Both divisions only depend on the range, so they're only done
+            when it changes. After that there are none. */
+            if(range != self->boundedRange)
+            {
+                self->boundedRange = range;
+                self->boundedThreshold = count - count % range;
+                self->boundedRecip = 0xFFFFFFFFUL / range;
+            }
+
+            do {
+                if(self->type == PRNG_TYPE_PARK_MILLER)
+                    result = ParkMiller_Next(&(self->state.u64)) - 1;
+                else
+                    result = Schrage_Next(&(self->state.u32)) - 1;
+            } while(result >= self->boundedThreshold);
+            return ModRecip(result, range, self->boundedRecip) + lower;
+        }
+        case PRNG_TYPE_LCG_SMALL:
+            /* Only 16 bits come out of the small LCG. That is fine for small 
+            ranges. For bigger ranges, glue two outputs together. */
+            if(range != 0 && range <= 0x10000UL)
+            {
+                uint32_t m = (uint32_t)LCGSmall_Next(&(self->state.u32)) * range;
+                if((m & 0xFFFFUL) < range)
+                {
+                    uint32_t threshold = (0x10000UL - range) % range;
+                    while((m & 0xFFFFUL) < threshold)
+                        m = (uint32_t)LCGSmall_Next(&(self->state.u32)) * range;
+                }
+                return (m >> 16) + lower;
+            }
+            result = Next32(self);
+            break;
+        case PRNG_TYPE_LCG_BIG:
+            result = LCGBig_Next(&(self->state.u64));
+            break;
+        case PRNG_TYPE_XOSHIRO128SS:
+            result = Xoshiro128ss_Next(self->state.u32x4);
+            break;
+        case PRNG_TYPE_PCG32:
+            result = PCG32_Next(self->state.u64x2);
+            break;
+        case PRNG_TYPE_SPLITMIX64:
+            result = SplitMix64_Next(&(self->state.u64));
+            break;
+    }
+
+    if(range == 0)
+        return result;
+
+    /* Lemire's nearly divisionless method. Multiply the 32-bit random number 
+    by the range to get a 64-bit product. The upper 32 bits are the output, 
+    which is already between 0 and range - 1. The lower 32 bits tell us if 
+    we landed in one of the few spots that would cause bias. That can only 
+    happen if the lower part is less than the range, so the division to get 
+    the exact threshold is only done in that case, which is rare. */
+    uint64_t m = (uint64_t)result * range;
+    if((uint32_t)m < range)
+    {
+        uint32_t threshold = (uint32_t)(0u - range) % range;
+        while((uint32_t)m < threshold)
+            m = (uint64_t)Next32(self) * range;
     }
+    return (uint32_t)(m >> 32) + lower;
+}
+
+// *****************************************************************************
 
+void PRNG_Fill(PRNG *self, uint32_t *out, uint32_t n)
+{
+    if(!self->isSeeded)
+        PRNG_Seed(self, 0);
+
+    /* Check the type once, then stay in the loop for that generator */
     switch(self->type)
     {
         case PRNG_TYPE_LCG_BIG:
-            randMax = 0xFFFFFFFF;
+            for(uint32_t i = 0; i < n; i++)
+                out[i] = LCGBig_Next(&(self->state.u64));
             break;
         case PRNG_TYPE_LCG_SMALL:
-            randMax = LCG_SMALL_M;
+            for(uint32_t i = 0; i < n; i++)
+                out[i] = LCGSmall_Next(&(self->state.u32));
             break;
         case PRNG_TYPE_PARK_MILLER:
-            randMax = PM_BIG_M;
+            for(uint32_t i = 0; i < n; i++)
+                out[i] = ParkMiller_Next(&(self->state.u64));
             break;
         case PRNG_TYPE_SCHRAGE:
-            randMax = SCH_M;
+            for(uint32_t i = 0; i < n; i++)
+                out[i] = Schrage_Next(&(self->state.u32));
+            break;
+        case PRNG_TYPE_XOSHIRO128SS:
+        {
+            /* Work on a local copy. Otherwise the compiler has to assume that
+            writing to out could change the state and reload it every time */
+            uint32_t state[4];
+            memcpy(state, self->state.u32x4, sizeof(state));
+            for(uint32_t i = 0; i < n; i++)
+                out[i] = Xoshiro128ss_Next(state);
+            memcpy(self->state.u32x4, state, sizeof(state));
+            break;
+        }
+        case PRNG_TYPE_PCG32:
+            for(uint32_t i = 0; i < n; i++)
+                out[i] = PCG32_Next(self->state.u64x2);
+            break;
+        case PRNG_TYPE_SPLITMIX64:
+            for(uint32_t i = 0; i < n; i++)
+                out[i] = SplitMix64_Next(&(self->state.u64));
             break;
     }
+}
 
-    /* output = output % (upper - lower + 1) + min */
-    uint32_t range = upper - lower;
-    if(range < 0xFFFFFFFF)
-        range++;
+// *****************************************************************************
 
-    /* method for removing modulo bias */
-    uint32_t threshold = randMax - randMax % range;
-    do {
-        switch(self->type)
+void PRNG_FillBounded(PRNG *self, uint32_t *out, uint32_t n, uint32_t lower,
+    uint32_t upper)
+{
+    if(!self->isSeeded)
+        PRNG_Seed(self, 0);
+
+    if(lower > upper)
+    {
+        uint32_t temp = lower;
+        lower = upper;
+        upper = temp;
+    }
+
+    uint32_t range = upper - lower + 1;
+
+    /* The full 32-bit range has nothing to remove. Just call the normal 
+    function for that. */
+    if(range == 0)
+    {
+        for(uint32_t i = 0; i < n; i++)
+            out[i] = PRNG_NextBounded(self, lower, upper);
+        return;
+    }
+
+    /* Same as PRNG_NextBounded, but the threshold is computed once for the 
+    whole array. There are no divisions at all inside the loop. A number that 
+    gets rejected is replaced with the next one from the same generator, so 
+    the output is the same as calling PRNG_NextBounded n times. */
+    uint32_t threshold = (uint32_t)(0u - range) % range;
+    uint64_t m;
+
+    switch(self->type)
+    {
+        case PRNG_TYPE_LCG_SMALL:
         {
-            case PRNG_TYPE_LCG_BIG:
-                result = LCGBig_Next(&(self->state.u64));
-                break;
-            case PRNG_TYPE_LCG_SMALL:
-                result = LCGSmall_Next(&(self->state.u32));
-                break;
-            case PRNG_TYPE_PARK_MILLER:
-                result = ParkMiller_Next(&(self->state.u64));
-                break;
-            case PRNG_TYPE_SCHRAGE:
-                result = Schrage_Next(&(self->state.u32));
+            if(range > 0x10000UL)
+            {
+                for(uint32_t i = 0; i < n; i++)
+                {
+                    do {
+                        m = (uint64_t)Next32(self) * range;
+                    } while((uint32_t)m < threshold);
+                    out[i] = (uint32_t)(m >> 32) + lower;
+                }
                 break;
+            }
+
+            /* 16 bits at a time, like PRNG_NextBounded */
+            uint32_t threshold16 = (0x10000UL - range) % range;
+            uint32_t m16;
+            for(uint32_t i = 0; i < n; i++)
+            {
+                do {
+                    m16 = (uint32_t)LCGSmall_Next(&(self->state.u32)) * range;
+                } while((m16 & 0xFFFFUL) < threshold16);
+                out[i] = (m16 >> 16) + lower;
+            }
+            break;
         }
-    } while(result >= threshold);
-
-    return (result % range) + lower;
+        case PRNG_TYPE_PARK_MILLER:
+        case PRNG_TYPE_SCHRAGE:
+        {
+            uint32_t count = PM_BIG_M - 1UL;
+            uint32_t result;
 
-    /* @note I tested the modulo bias removal method above against the naive 
-    method (just using % by itself), and I haven't seen a difference yet. 
-    Maybe it only makes a difference for very large values? Not sure. - MS */
+            if(range >= count)
+            {
+                for(uint32_t i = 0; i < n; i++)
+                    out[i] = PRNG_NextBounded(self, lower, upper);
+                break;
+            }
+
+            uint32_t pmThreshold = count - count % range;
+            uint32_t recip = 0xFFFFFFFFUL / range;
+
+            if(self->type == PRNG_TYPE_PARK_MILLER)
+            {
+                for(uint32_t i = 0; i < n; i++)
+                {
+                    do {
+                        result = ParkMiller_Next(&(self->state.u64)) - 1;
+                    } while(result >= pmThreshold);
+                    out[i] = ModRecip(result, range, recip) + lower;
+                }
+            }
+            else
+            {
+                for(uint32_t i = 0; i < n; i++)
+                {
+                    do {
+                        result = Schrage_Next(&(self->state.u32)) - 1;
+                    } while(result >= pmThreshold);
+                    out[i] = ModRecip(result, range, recip) + lower;
+                }
+            }
+            break;
+        }
+        case PRNG_TYPE_LCG_BIG:
+            for(uint32_t i = 0; i < n; i++)
+            {
+                do {
+                    m = (uint64_t)LCGBig_Next(&(self->state.u64)) * range;
+                } while((uint32_t)m < threshold);
+                out[i] = (uint32_t)(m >> 32) + lower;
+            }
+            break;
+        case PRNG_TYPE_XOSHIRO128SS:
+        {
+            uint32_t state[4];
+            memcpy(state, self->state.u32x4, sizeof(state));
+            for(uint32_t i = 0; i < n; i++)
+            {
+                do {
+                    m = (uint64_t)Xoshiro128ss_Next(state) * range;
+                } while((uint32_t)m < threshold);
+                out[i] = (uint32_t)(m >> 32) + lower;
+            }
+            memcpy(self->state.u32x4, state, sizeof(state));
+            break;
+        }
+        case PRNG_TYPE_PCG32:
+            for(uint32_t i = 0; i < n; i++)
+            {
+                do {
+                    m = (uint64_t)PCG32_Next(self->state.u64x2) * range;
+                } while((uint32_t)m < threshold);
+                out[i] = (uint32_t)(m >> 32) + lower;
+            }
+            break;
+        case PRNG_TYPE_SPLITMIX64:
+            for(uint32_t i = 0; i < n; i++)
+            {
+                do {
+                    m = (uint64_t)SplitMix64_Next(&(self->state.u64)) * range;
+                } while((uint32_t)m < threshold);
+                out[i] = (uint32_t)(m >> 32) + lower;
+            }
+            break;
+        default:
+            break;
+    }
 }
 
 // *****************************************************************************
@@ -227,34 +542,171 @@ uint32_t PRNG_Skip(PRNG *self, int64_t n)
             the output. - MS */
             result = ParkMiller_Skip(&(self->state.u64), n);
             break;
+        case PRNG_TYPE_XOSHIRO128SS:
+            result = Xoshiro128ss_Skip(self->state.u32x4, n);
+            break;
+        case PRNG_TYPE_PCG32:
+            result = PCG32_Skip(self->state.u64x2, n);
+            break;
+        case PRNG_TYPE_SPLITMIX64:
+            result = SplitMix64_Skip(&(self->state.u64), n);
+            break;
     }
     return result;
 }
 
 // *****************************************************************************
 
+void PRNG_SplitStreams(PRNG *base, PRNG *streams, uint16_t k, int64_t stride)
+{
+    if(!base->isSeeded)
+        PRNG_Seed(base, 0);
+
+    /* Each stream starts stride numbers after the one before it. Stream 0 is 
+    just a copy of the base. Using the skip ahead from the previous stream 
+    instead of from the base keeps the skip count small. */
+    if(k == 0)
+        return;
+
+    streams[0] = *base;
+    for(uint16_t i = 1; i < k; i++)
+    {
+        streams[i] = streams[i - 1];
+        Advance(&streams[i], stride);
+    }
+}
+
+// *****************************************************************************
+
 void PRNG_Shuffle(void *array, uint32_t n, size_t s, uint32_t seed)
 {
-    uint8_t tmp[s];
-    uint8_t *arrayPtr = array;
-    uint32_t schrageState = seed;
+    /* This used to be a Schrage. Its output isn't a power of two, so every 
+    index needed a division, which made this slower than the old shuffle. 
+    xoshiro128** has a full 32-bit output and still only needs 32-bit math. 
+    The same seed gives a different order than it used to. */
+    PRNG prng;
+    PRNG_Create(&prng, PRNG_TYPE_XOSHIRO128SS);
+    PRNG_Seed(&prng, seed);
+    PRNG_ShuffleWith(&prng, array, n, s);
+}
 
-    if(schrageState == 0)
-        schrageState++;
+// *****************************************************************************
 
-    if(n == 0)
-        n++;
+void PRNG_ShuffleWith(PRNG *self, void *array, uint32_t n, size_t s)
+{
+    uint32_t j[SHUFFLE_BATCH];
+    uint32_t i = n - 1;
+
+    if(n < 2 || s == 0)
+        return;
+
+    if(!self->isSeeded)
+        PRNG_Seed(self, 0);
 
-    for(uint32_t i = n - 1; i > 0; i--)
+    /* Fisher-Yates: for each element from the end, pick a random index from 
+    0 to i and swap. The indices are picked a batch at a time first. That way 
+    the swaps don't have to wait on the PRNG and the processor can have a few 
+    of them going at once, which is what matters once the array is bigger 
+    than the cache. Most arrays are made of plain 1, 2, 4, or 8 byte types, 
+    so those get their own loop that swaps with a single temporary variable. */
+    while(i > 0)
     {
-        // Pick a random index from 0 to i
-        uint32_t j = Schrage_Next(&schrageState) % (i + 1); // @todo should I replace this with the "modulo bias removal method" like above?
+        uint32_t count = (i < SHUFFLE_BATCH) ? i : SHUFFLE_BATCH;
+        ShuffleIndices(self, j, i, count);
+
+        switch(s)
+        {
+            case 1:
+            {
+                uint8_t *a = array;
+                for(uint32_t k = 0; k < count; k++, i--)
+                {
+                    uint8_t tmp = a[i];
+                    a[i] = a[j[k]];
+                    a[j[k]] = tmp;
+                }
+                break;
+            }
+            case 2:
+            {
+                uint16_t *a = array;
+                for(uint32_t k = 0; k < count; k++, i--)
+                {
+                    uint16_t tmp = a[i];
+                    a[i] = a[j[k]];
+                    a[j[k]] = tmp;
+                }
+                break;
+            }
+            case 4:
+            {
+                uint32_t *a = array;
+                for(uint32_t k = 0; k < count; k++, i--)
+                {
+                    uint32_t tmp = a[i];
+                    a[i] = a[j[k]];
+                    a[j[k]] = tmp;
+                }
+                break;
+            }
+            case 8:
+            {
+                uint64_t *a = array;
+                for(uint32_t k = 0; k < count; k++, i--)
+                {
+                    uint64_t tmp = a[i];
+                    a[i] = a[j[k]];
+                    a[j[k]] = tmp;
+                }
+                break;
+            }
+            default:
+            {
+                uint8_t *a = array;
+                for(uint32_t k = 0; k < count; k++, i--)
+                {
+                    if(j[k] != i)
+                        SwapBytes(a + (size_t)i * s, a + (size_t)j[k] * s, s);
+                }
+                break;
+            }
+        }
+    }
+}
+
+// *****************************************************************************
+
+void PRNG_ShuffleGather(PRNG *self, const void *src, void *dst, 
+    uint32_t *indices, uint32_t n, size_t s)
+{
+    const uint8_t *srcPtr = src;
+    uint8_t *dstPtr = dst;
 
-        // Swap arr[i] with the element at the random index (j)
-        memcpy(tmp, arrayPtr + j * s, s);
-        memcpy(arrayPtr + j * s, arrayPtr + i * s, s);
-        memcpy(arrayPtr + i * s, tmp, s);
+    /* For small records the list of indices costs more than it saves. Just 
+    copy them over in order and shuffle them in place. */
+    if(s < SHUFFLE_GATHER_MIN_SIZE)
+    {
+        memcpy(dst, src, (size_t)n * s);
+        PRNG_ShuffleWith(self, dst, n, s);
+        return;
     }
+
+    /* Shuffle a list of indices instead of the records themselves. Moving 
+    4 bytes around at random is a lot cheaper than moving big records around 
+    at random. The same swaps are done, so the order is the same as calling 
+    PRNG_ShuffleWith on the array with the same PRNG state. */
+    for(uint32_t i = 0; i < n; i++)
+        indices[i] = i;
+
+    PRNG_ShuffleWith(self, indices, n, sizeof(uint32_t));
+
+    /* Then each record gets copied exactly once. The writes to dst are in 
+    order, so only the reads from src jump around. I tried copying one window 
+    of src at a time so the reads stay in the cache, but then the writes jump 
+    around instead. It was about twice as slow on a PC from 1e3 to 1e7 
+    records. See TestShuffleSpeed. */
+    for(uint32_t i = 0; i < n; i++)
+        memcpy(dstPtr + (size_t)i * s, srcPtr + (size_t)indices[i] * s, s);
 }
 
 // *****************************************************************************
@@ -510,6 +962,431 @@ uint32_t Schrage_Next(uint32_t *state)
     return *state = (uint32_t)result;
 }
 
+// *****************************************************************************
+
+uint32_t Xoshiro128ss_Next(uint32_t *state)
+{
+    /* xoshiro128** by Blackman and Vigna. The state is 128 bits, the output 
+    is 32 bits, and the period is 2^128 - 1. It only uses 32-bit shifts, XOR, 
+    and two small multiplies, so it is fast on a Cortex-M with no 64-bit math.
+    The "**" scrambler is what fixes up the weak low bits of the linear 
+    engine underneath. */
+    uint32_t result = state[1] * 5;
+    result = ((result << 7) | (result >> 25)) * 9;
+    uint32_t t = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = (state[3] << 11) | (state[3] >> 21);
+
+    return result;
+}
+
+// *****************************************************************************
+
+void Xoshiro128ss_Jump(uint32_t *state)
+{
+    Xoshiro128ss_ApplyPoly(state, XOSHIRO128_JUMP);
+}
+
+// *****************************************************************************
+
+void Xoshiro128ss_Advance(uint32_t *state, int64_t n)
+{
+    /* Xoshiro isn't an LCG, so the skip ahead formula from Knuth doesn't work 
+    here. But the state update is linear over GF(2). Advancing n steps is the 
+    same as multiplying the state by the polynomial x^n mod p(x), where p(x) 
+    is the characteristic polynomial of the generator. The reference jump 
+    functions just have this polynomial precomputed for n = 2^64 and 2^96. 
+    I compute it with the same square and multiply trick as the LCG skip 
+    ahead, so it still takes O(log2(n)) steps.
+
+    The period is 2^128 - 1 and x^(2^128 - 1) = 1, so going backwards by m is 
+    the same as going forwards by 2^128 - 1 - m. In 128 bits that is just ~m */
+    uint64_t exponent[2];
+    uint32_t result[4] = {1, 0, 0, 0};
+    uint32_t h[4] = {2, 0, 0, 0}; // the polynomial "x"
+
+    if(n == 0)
+        return;
+
+    if(n > 0)
+    {
+        exponent[0] = (uint64_t)n;
+        exponent[1] = 0;
+    }
+    else
+    {
+        exponent[0] = ~(0ULL - (uint64_t)n);
+        exponent[1] = ~0ULL;
+    }
+
+    /* Square and multiply over all 128 bits of the exponent. Stop as soon 
+    as there are no more bits set. */
+    for(uint8_t b = 0; b < 128; b++)
+    {
+        uint64_t word = exponent[b >> 6] >> (b & 63);
+
+        if(word & 1ULL)
+            Xoshiro128ss_MulMod(result, h);
+
+        if((word >> 1) == 0 && (b >= 64 || exponent[1] == 0))
+            break;
+
+        Xoshiro128ss_MulMod(h, h);
+    }
+    Xoshiro128ss_ApplyPoly(state, result);
+}
+
+// *****************************************************************************
+
+uint32_t Xoshiro128ss_Skip(uint32_t *state, int64_t n)
+{
+    /* The output comes from the state before it is updated. So to get the nth 
+    number, advance n - 1 times and then call next. */
+    Xoshiro128ss_Advance(state, n - 1);
+    return Xoshiro128ss_Next(state);
+}
+
+// *****************************************************************************
+
+uint32_t PCG32_Next(uint64_t *state)
+{
+    /* PCG32 (XSH RR) by M.E. O'Neill. The state is a 64-bit LCG, the same 
+    kind as my big LCG. The difference is that the output isn't just the 
+    upper bits. It is a permutation of the old state: an xorshift followed by 
+    a random rotation chosen by the top 5 bits. This fixes the weak lower 
+    bits of the LCG and the output passes all of the usual tests. 
+    state[0] is the LCG state and state[1] is the increment (must be odd). */
+    uint64_t old = state[0];
+    state[0] = old * PCG32_MULT + state[1];
+    uint32_t xorShifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorShifted >> rot) | (xorShifted << ((0u - rot) & 31u));
+}
+
+// *****************************************************************************
+
+void PCG32_Advance(uint64_t *state, int64_t n)
+{
+    /* The exact same skip ahead algorithm from Brown that I use for the big 
+    LCG. The modulus is 2^64, so the multiply does the modulo for us, and a 
+    negative n cast to unsigned is already the right number of steps. */
+    uint64_t i = (uint64_t)n;
+    uint64_t A = 1, h = PCG32_MULT, C = 0, f = state[1];
+
+    for(; i > 0; i >>= 1)
+    {
+        if(i & 1ULL)
+        {
+            A = A * h;
+            C = C * h + f;
+        }
+        f = f * h + f;
+        h = h * h;
+    }
+    state[0] = A * state[0] + C;
+}
+
+// *****************************************************************************
+
+uint32_t PCG32_Skip(uint64_t *state, int64_t n)
+{
+    PCG32_Advance(state, n - 1);
+    return PCG32_Next(state);
+}
+
+// *****************************************************************************
+
+uint32_t SplitMix64_Next(uint64_t *state)
+{
+    return (uint32_t)(SplitMix64_Step(state) >> 32);
+}
+
+// *****************************************************************************
+
+uint32_t SplitMix64_Skip(uint64_t *state, int64_t n)
+{
+    /* SplitMix64 is just a counter that goes through a mixing function. So 
+    skipping ahead is one multiply. Skipping backwards works the same way 
+    since the counter wraps around at 2^64. The output comes from the new 
+    state, so this returns the nth value directly. */
+    *state += (uint64_t)n * SPLITMIX64_GAMMA;
+    uint64_t z = *state - SPLITMIX64_GAMMA;
+    return (uint32_t)(SplitMix64_Step(&z) >> 32);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Move the state of any PRNG forwards or backwards n steps
+ * 
+ * The LCG and Park Miller skip functions already leave the state exactly n 
+ * steps ahead. The return value is just thrown away.
+ * 
+ * @param self  pointer to the PRNG that you are using
+ * 
+ * @param n  number of steps. positive = forwards, negative = backwards
+ */
+static void Advance(PRNG *self, int64_t n)
+{
+    switch(self->type)
+    {
+        case PRNG_TYPE_LCG_BIG:
+            LCGBig_Skip(&(self->state.u64), n);
+            break;
+        case PRNG_TYPE_LCG_SMALL:
+            LCGSmall_Skip(&(self->state.u32), (int32_t)n);
+            break;
+        case PRNG_TYPE_PARK_MILLER:
+        case PRNG_TYPE_SCHRAGE:
+            ParkMiller_Skip(&(self->state.u64), n);
+            break;
+        case PRNG_TYPE_XOSHIRO128SS:
+            Xoshiro128ss_Advance(self->state.u32x4, n);
+            break;
+        case PRNG_TYPE_PCG32:
+            PCG32_Advance(self->state.u64x2, n);
+            break;
+        case PRNG_TYPE_SPLITMIX64:
+            SplitMix64_Skip(&(self->state.u64), n);
+            break;
+    }
+}
+
+/***************************************************************************//**
+ * @brief Pick the random indices for a batch of swaps
+ * 
+ * The generators with a full 32-bit output fill the batch with PRNG_Fill 
+ * and then use the multiply-shift method on each one. The small LCG does the 
+ * same with two outputs glued together. The Park Miller and Schrage just go 
+ * through PRNG_NextBounded.
+ * 
+ * @param self  pointer to the PRNG that you are using
+ * 
+ * @param j  where to put the indices
+ * 
+ * @param i  the element that gets swapped first. Its index is 0 to i, the 
+ *           next one is 0 to i - 1, and so on
+ * 
+ * @param count  how many indices to pick. Must be i or less
+ */
+static void ShuffleIndices(PRNG *self, uint32_t *j, uint32_t i, uint32_t count)
+{
+    if(self->type == PRNG_TYPE_PARK_MILLER || self->type == PRNG_TYPE_SCHRAGE)
+    {
+        for(uint32_t k = 0; k < count; k++)
+            j[k] = PRNG_NextBounded(self, 0, i - k);
+        return;
+    }
+
+    if(self->type == PRNG_TYPE_LCG_SMALL)
+    {
+        for(uint32_t k = 0; k < count; k++)
+            j[k] = Next32(self);
+    }
+    else
+    {
+        PRNG_Fill(self, j, count);
+    }
+
+    for(uint32_t k = 0; k < count; k++)
+    {
+        uint32_t range = i - k + 1;
+        uint64_t m = (uint64_t)j[k] * range;
+        if((uint32_t)m < range)
+        {
+            uint32_t threshold = (uint32_t)(0u - range) % range;
+            while((uint32_t)m < threshold)
+                m = (uint64_t)Next32(self) * range;
+        }
+        j[k] = (uint32_t)(m >> 32);
+    }
+}
+
+/***************************************************************************//**
+ * @brief Swap two elements of any size
+ * 
+ * Goes through a small fixed buffer instead of a variable length array, so 
+ * the stack usage doesn't depend on the size of the element. The pieces are 
+ * always the same size so the compiler can turn each memcpy into a couple of 
+ * moves. A memcpy with a variable size is a library call, and three of those 
+ * per swap made 64-byte records twice as slow as the old shuffle.
+ * 
+ * @param a  pointer to the first element
+ * 
+ * @param b  pointer to the second element
+ * 
+ * @param s  the size in bytes of each element
+ */
+static void SwapBytes(uint8_t *a, uint8_t *b, size_t s)
+{
+    uint8_t tmp[SHUFFLE_TMP_SIZE];
+
+    while(s >= SHUFFLE_TMP_SIZE)
+    {
+        memcpy(tmp, a, SHUFFLE_TMP_SIZE);
+        memcpy(a, b, SHUFFLE_TMP_SIZE);
+        memcpy(b, tmp, SHUFFLE_TMP_SIZE);
+        a += SHUFFLE_TMP_SIZE;
+        b += SHUFFLE_TMP_SIZE;
+        s -= SHUFFLE_TMP_SIZE;
+    }
+
+    /* Whatever is left over, one byte at a time */
+    while(s > 0)
+    {
+        uint8_t t = *a;
+        *a++ = *b;
+        *b++ = t;
+        s--;
+    }
+}
+
+/***************************************************************************//**
+ * @brief Get a full 32-bit random number
+ * 
+ * The small LCG only puts out 16 bits, so two outputs are glued together.
+ * Don't use this with the Park Miller. Its output isn't a power of two.
+ * 
+ * @param self  pointer to the PRNG that you are using
+ * 
+ * @return uint32_t  0 to 2^32-1
+ */
+static inline uint32_t Next32(PRNG *self)
+{
+    if(self->type == PRNG_TYPE_LCG_SMALL)
+    {
+        uint32_t result = (uint32_t)LCGSmall_Next(&(self->state.u32)) << 16;
+        return result | LCGSmall_Next(&(self->state.u32));
+    }
+    return PRNG_Next(self);
+}
+
+/***************************************************************************//**
+ * @brief x % range, without dividing
+ * 
+ * recip is 0xFFFFFFFF / range, worked out ahead of time. (x * recip) >> 32 
+ * is either x / range or one less, never more, so the remainder only needs 
+ * fixing up once. On a part with no hardware divide this is a lot faster.
+ * 
+ * @param x  the number to divide
+ * 
+ * @param range  what to divide by, 1 or more
+ * 
+ * @param recip  0xFFFFFFFF / range
+ * 
+ * @return uint32_t  x % range
+ */
+static inline uint32_t ModRecip(uint32_t x, uint32_t range, uint32_t recip)
+{
+    uint32_t q = (uint32_t)(((uint64_t)x * recip) >> 32);
+    uint32_t r = x - q * range;
+
+    if(r >= range)
+        r -= range;
+    return r;
+}
+
+/***************************************************************************//**
+ * @brief SplitMix64 with the full 64-bit output
+ * 
+ * Also used to fill the state of xoshiro from a single 32-bit seed
+ * 
+ * @param state  pointer to the 64-bit counter
+ * 
+ * @return uint64_t  output
+ */
+static uint64_t SplitMix64_Step(uint64_t *state)
+{
+    uint64_t z = (*state += SPLITMIX64_GAMMA);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/***************************************************************************//**
+ * @brief Multiply two polynomials mod the xoshiro128 characteristic polynomial
+ * 
+ * Each polynomial has 128 coefficients over GF(2), stored as four 32-bit 
+ * words. Bit 0 of word 0 is the constant term. Addition is XOR. The result is 
+ * stored back into a.
+ * 
+ * @param a  first polynomial and result
+ * 
+ * @param b  second polynomial (may be the same as a)
+ */
+static void Xoshiro128ss_MulMod(uint32_t *a, const uint32_t *b)
+{
+    uint32_t bCopy[4], result[4] = {0, 0, 0, 0};
+    memcpy(bCopy, b, sizeof(bCopy));
+
+    /* Horner's method: for each coefficient of b starting at the top, 
+    multiply the result by x and add a if the coefficient is 1. Multiplying 
+    by x is a shift left. If x^128 falls out the top, it is replaced by the 
+    lower part of the characteristic polynomial. */
+    for(int8_t w = 3; w >= 0; w--)
+    {
+        for(int8_t bit = 31; bit >= 0; bit--)
+        {
+            uint32_t carry = result[3] >> 31;
+            result[3] = (result[3] << 1) | (result[2] >> 31);
+            result[2] = (result[2] << 1) | (result[1] >> 31);
+            result[1] = (result[1] << 1) | (result[0] >> 31);
+            result[0] = (result[0] << 1);
+            if(carry)
+            {
+                for(uint8_t k = 0; k < 4; k++)
+                    result[k] ^= XOSHIRO128_POLY[k];
+            }
+            if((bCopy[w] >> bit) & 1UL)
+            {
+                for(uint8_t k = 0; k < 4; k++)
+                    result[k] ^= a[k];
+            }
+        }
+    }
+    memcpy(a, result, sizeof(result));
+}
+
+/***************************************************************************//**
+ * @brief Apply a jump polynomial to the xoshiro128 state
+ * 
+ * Same as the jump function from the reference code. For each coefficient 
+ * that is set, XOR in the current state, then step the generator.
+ * 
+ * @param state  pointer to the 128-bit state
+ * 
+ * @param poly  the jump polynomial
+ */
+static void Xoshiro128ss_ApplyPoly(uint32_t *state, const uint32_t *poly)
+{
+    uint32_t t[4] = {0, 0, 0, 0};
+
+    for(uint8_t w = 0; w < 4; w++)
+    {
+        for(uint8_t bit = 0; bit < 32; bit++)
+        {
+            if(poly[w] & (1UL << bit))
+            {
+                t[0] ^= state[0];
+                t[1] ^= state[1];
+                t[2] ^= state[2];
+                t[3] ^= state[3];
+            }
+            Xoshiro128ss_Next(state);
+        }
+    }
+    memcpy(state, t, sizeof(t));
+}
+
 /*
  End of File
  */
\ No newline at end of file
@@ -41,6 +41,14 @@
  * a "full-cycle" LCG. Meaning it will produce every number from 1 to m-1 
  * once before the sequence repeats.
  * 
+ * I've also added three newer generators. They aren't LCG's, but they are 
+ * faster than the Park Miller and their output is much better than the big 
+ * LCG. Xoshiro128** has a 128-bit state and only needs 32-bit math, which 
+ * makes it a good choice for a Cortex-M. PCG32 is a 64-bit LCG with a 
+ * scrambled output. SplitMix64 is a 64-bit counter fed through a mixing 
+ * function. It is very fast if you have 64-bit multiplies. All three of them 
+ * can skip ahead or backwards in O(log2(n)) time too (SplitMix64 is O(1)).
+ * 
  * // TODO more notes about Park Miller and Schrage
  * // TODO notes about PM value of 0 and X_0
  * // TODO lots of notes about the logarithmic skip ahead algorithm
@@ -65,6 +73,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // ***** Defines ***************************************************************
 
@@ -77,6 +86,9 @@ typedef enum PRNGTypeTag
     PRNG_TYPE_LCG_SMALL,
     PRNG_TYPE_PARK_MILLER,
     PRNG_TYPE_SCHRAGE,
+    PRNG_TYPE_XOSHIRO128SS,
+    PRNG_TYPE_PCG32,
+    PRNG_TYPE_SPLITMIX64,
     // TODO try making a bigger version of Park Miller
     // PRNG_TYPE_PARK_MILLER_BIG
 } PRNGType;
@@ -89,7 +101,12 @@ typedef struct PRNGTag
     {
         uint64_t u64;
         uint32_t u32;
+        uint64_t u64x2[2];
+        uint32_t u32x4[4];
     } state;
+    uint32_t boundedRange;
+    uint32_t boundedThreshold;
+    uint32_t boundedRecip;
 } PRNG;
 
 /** 
@@ -106,7 +123,15 @@ typedef struct PRNGTag
  *        about it. Be aware that output will either be a 16-bit or a 32-bit 
  *        number, but my functions all return a 32-bit number for simplicity. 
  *        A 64-bit PRNG will return a 32-bit number, and a 32-bit PRNG will 
- *        return a 16-bit number.
+ *        return a 16-bit number. Xoshiro128** uses all four 32-bit 
+ *        words. PCG32 uses the first 64-bit word for its state and the 
+ *        second for its increment.
+ * 
+ * boundedRange, boundedThreshold, boundedRecip  The range from the last call
+ *        to PRNG_NextBounded with the Park Miller or Schrage, and the two 
+ *        numbers worked out from it. Most of the time the range is the same 
+ *        as last time, so the divisions are skipped. A range of 0 means 
+ *        nothing is saved yet.
  */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -125,7 +150,8 @@ typedef struct PRNGTag
  * @param self  pointer to the PRNG that you are using
  * 
  * @param type  PRNG_TYPE_LCG_BIG, PRNG_TYPE_LCG_SMALL, PRNG_TYPE_PARK_MILLER,
- *              PRNG_TYPE_SCHRAGE,
+ *              PRNG_TYPE_SCHRAGE, PRNG_TYPE_XOSHIRO128SS, PRNG_TYPE_PCG32,
+ *              PRNG_TYPE_SPLITMIX64
  */
 void PRNG_Create(PRNG *self, PRNGType type);
 
@@ -151,6 +177,13 @@ uint32_t PRNG_Next(PRNG *self);
 /***************************************************************************//**
  * @brief Return a random number within a specified boundary
  * 
+ * Uses Lemire's multiply-shift method for the generators with a 32-bit or 
+ * 16-bit output. It needs a single multiply per number and only divides once 
+ * in a long while. The Park Miller and Schrage use the modulo bias removal 
+ * method, because their output isn't a power of two. Either way there is no 
+ * modulo bias. The Park Miller only has 2^31 - 2 different outputs though, so 
+ * a range bigger than that can't be covered.
+ * 
  * @param self  pointer to the PRNG that you are using
  * 
  * @param lower  lower bound inclusive
@@ -161,6 +194,41 @@ uint32_t PRNG_Next(PRNG *self);
  */
 uint32_t PRNG_NextBounded(PRNG *self, uint32_t lower, uint32_t upper);
 
+/***************************************************************************//**
+ * @brief Fill an array with pseudorandom numbers
+ * 
+ * Same as calling PRNG_Next n times, but the type of PRNG is only checked 
+ * once. After that it just runs a tight loop with that generator. Use this 
+ * when you need a lot of numbers at once.
+ * 
+ * @param self  pointer to the PRNG that you are using
+ * 
+ * @param out  pointer to the array to fill
+ * 
+ * @param n  number of values to write
+ */
+void PRNG_Fill(PRNG *self, uint32_t *out, uint32_t n);
+
+/***************************************************************************//**
+ * @brief Fill an array with random numbers within a specified boundary
+ * 
+ * Same as calling PRNG_NextBounded n times. For the 32-bit generators the 
+ * threshold for removing bias is only computed once for the whole array, so 
+ * there are no divisions inside the loop.
+ * 
+ * @param self  pointer to the PRNG that you are using
+ * 
+ * @param out  pointer to the array to fill
+ * 
+ * @param n  number of values to write
+ * 
+ * @param lower  lower bound inclusive
+ * 
+ * @param upper  upper bound inclusive
+ */
+void PRNG_FillBounded(PRNG *self, uint32_t *out, uint32_t n, uint32_t lower,
+    uint32_t upper);
+
 /***************************************************************************//**
  * @brief Perform logarithmic skip (forwards or backwards)
  * 
@@ -174,9 +242,38 @@ uint32_t PRNG_NextBounded(PRNG *self, uint32_t lower, uint32_t upper);
  */
 uint32_t PRNG_Skip(PRNG *self, int64_t n);
 
+/***************************************************************************//**
+ * @brief Split one PRNG into k independent streams
+ * 
+ * Uses the logarithmic skip ahead to hand out k pieces of the same sequence. 
+ * Stream 0 starts where the base PRNG is right now, stream 1 starts stride 
+ * numbers later, and so on. As long as each stream uses no more than stride 
+ * numbers, none of them will overlap. This is useful for giving each task or 
+ * thread its own PRNG. If you run all of the streams one after another, you 
+ * get the exact same numbers as running the base PRNG by itself.
+ * 
+ * Make sure k * stride is less than the period of the PRNG you choose. The 
+ * small LCG can only skip up to 2^31 - 1 at a time.
+ * 
+ * @param base  pointer to the PRNG to split. It is not changed
+ * 
+ * @param streams  pointer to an array of k PRNG objects
+ * 
+ * @param k  number of streams
+ * 
+ * @param stride  the distance between the start of each stream
+ */
+void PRNG_SplitStreams(PRNG *base, PRNG *streams, uint16_t k, int64_t stride);
+
 /***************************************************************************//**
  * @brief Shuffle an array using the Fisher-Yates method
  * 
+ * Uses a xoshiro128** PRNG seeded with the seed you give it. It used to be 
+ * a Schrage with modulo bias, so the same seed doesn't give the same order 
+ * that it used to. Arrays of 1, 2, 4, or 8 byte elements are the fastest. 
+ * Those must be aligned to their size, which any normal array of that type 
+ * already is. There is no modulo bias.
+ * 
  * @param array  pointer to an array of any type
  * 
  * @param n  number of elements
@@ -187,6 +284,49 @@ uint32_t PRNG_Skip(PRNG *self, int64_t n);
  */
 void PRNG_Shuffle(void *array, uint32_t n, size_t s, uint32_t seed);
 
+/***************************************************************************//**
+ * @brief Shuffle an array using the Fisher-Yates method with your own PRNG
+ * 
+ * Same as PRNG_Shuffle, but you pick the generator. The PRNG keeps going from 
+ * wherever it left off, so shuffling twice gives two different orders. The 
+ * generators with a 32-bit output are read a few numbers at a time, so the 
+ * PRNG may end up a little further along than the number of swaps.
+ * 
+ * @param self  pointer to the PRNG that you are using
+ * 
+ * @param array  pointer to an array of any type
+ * 
+ * @param n  number of elements
+ * 
+ * @param s  the size in bytes of each element
+ */
+void PRNG_ShuffleWith(PRNG *self, void *array, uint32_t n, size_t s);
+
+/***************************************************************************//**
+ * @brief Shuffle an array of large records into a second array
+ * 
+ * If your elements are big structs, moving them around at random is slow 
+ * because every swap touches two random places in memory. This shuffles an 
+ * array of indices instead and then copies each record into dst once. The 
+ * order is the same as PRNG_ShuffleWith would give you with the same PRNG. 
+ * Records smaller than 64 bytes aren't worth it, so those are copied to dst 
+ * in order and shuffled in place. The indices aren't touched in that case.
+ * 
+ * @param self  pointer to the PRNG that you are using
+ * 
+ * @param src  pointer to the original array. It is not changed
+ * 
+ * @param dst  pointer to the output array. Must not overlap src
+ * 
+ * @param indices  scratch array with room for n indices
+ * 
+ * @param n  number of elements
+ * 
+ * @param s  the size in bytes of each element
+ */
+void PRNG_ShuffleGather(PRNG *self, const void *src, void *dst, 
+    uint32_t *indices, uint32_t n, size_t s);
+
 ////////////////////////////////////////////////////////////////////////////////
 //                                                                            //
 // ***** Individual PRNG Function Prototypes *********************************//
@@ -277,4 +417,99 @@ uint32_t ParkMiller_Skip(uint64_t *state, int64_t n);
  */
 uint32_t Schrage_Next(uint32_t *state);
 
+/***************************************************************************//**
+ * @brief Xoshiro128** by Blackman and Vigna
+ * 
+ * Range is 0 to 2^32-1. Period is 2^128-1. The state must not be all zeros.
+ * 
+ * @param state  pointer to an array of four 32-bit words
+ * 
+ * @return uint32_t 
+ */
+uint32_t Xoshiro128ss_Next(uint32_t *state);
+
+/***************************************************************************//**
+ * @brief Jump ahead 2^64 steps
+ * 
+ * Same as the jump function from the reference code. Calling this k times 
+ * gives you k non-overlapping sequences of 2^64 numbers each.
+ * 
+ * @param state  pointer to an array of four 32-bit words
+ */
+void Xoshiro128ss_Jump(uint32_t *state);
+
+/***************************************************************************//**
+ * @brief Move the state of xoshiro128 forwards or backwards n steps
+ * 
+ * @param state  pointer to an array of four 32-bit words
+ * 
+ * @param n  number of steps. positive = forwards, negative = backwards
+ */
+void Xoshiro128ss_Advance(uint32_t *state, int64_t n);
+
+/***************************************************************************//**
+ * @brief Logarithmic skip function for xoshiro128**
+ * 
+ * @param state  pointer to an array of four 32-bit words
+ * 
+ * @param n  nth number. positive = forwards, negative = backwards
+ * 
+ * @return uint32_t  same as calling Xoshiro128ss_Next n times
+ */
+uint32_t Xoshiro128ss_Skip(uint32_t *state, int64_t n);
+
+/***************************************************************************//**
+ * @brief PCG32 (XSH RR) by M.E. O'Neill
+ * 
+ * Range is 0 to 2^32-1. Period is 2^64.
+ * 
+ * @param state  pointer to two 64-bit words. The LCG state followed by the 
+ *               increment (must be odd)
+ * 
+ * @return uint32_t 
+ */
+uint32_t PCG32_Next(uint64_t *state);
+
+/***************************************************************************//**
+ * @brief Move the state of PCG32 forwards or backwards n steps
+ * 
+ * @param state  pointer to two 64-bit words (state, increment)
+ * 
+ * @param n  number of steps. positive = forwards, negative = backwards
+ */
+void PCG32_Advance(uint64_t *state, int64_t n);
+
+/***************************************************************************//**
+ * @brief Logarithmic skip function for PCG32
+ * 
+ * @param state  pointer to two 64-bit words (state, increment)
+ * 
+ * @param n  nth number. positive = forwards, negative = backwards
+ * 
+ * @return uint32_t  same as calling PCG32_Next n times
+ */
+uint32_t PCG32_Skip(uint64_t *state, int64_t n);
+
+/***************************************************************************//**
+ * @brief SplitMix64 by Steele, Lea, and Flood
+ * 
+ * Range is 0 to 2^32-1 (the upper half of the 64-bit output). Period 2^64.
+ * 
+ * @param state  pointer to the 64-bit counter
+ * 
+ * @return uint32_t 
+ */
+uint32_t SplitMix64_Next(uint64_t *state);
+
+/***************************************************************************//**
+ * @brief Skip function for SplitMix64
+ * 
+ * @param state  pointer to the 64-bit counter
+ * 
+ * @param n  nth number. positive = forwards, negative = backwards
+ * 
+ * @return uint32_t  same as calling SplitMix64_Next n times
+ */
+uint32_t SplitMix64_Skip(uint64_t *state, int64_t n);
+
 #endif  /* PRNG_H */
\ No newline at end of file
@@ -1,10 +1,58 @@
 /* Program to demonstrate LCG bias removal method - MS */
 
+/* Option 9 calls PRNG_NextBounded, which uses the multiply-shift method 
+instead of modulo. That one always uses the full 32 bits, so rand max is 
+ignored. Before it writes anything, it checks PRNG_NextBounded and 
+PRNG_FillBounded against a copy of the method that gets the threshold with 
+64-bit math, 2^32 % range. Both have to pick the exact same numbers from the 
+same seed. A range of 2^31 + 1 rejects almost half of the numbers that land 
+in the low spots, so a wrong threshold shows up right away. */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "PRNG.h"
 
+#define CHECK_COUNT     100000UL
+
+/* Multiply-shift with the threshold done the long way */
+uint32_t Reference(PRNG *prng, uint32_t range)
+{
+    uint32_t threshold = (uint32_t)((1ULL << 32) % range);
+    uint64_t m;
+
+    do {
+        m = (uint64_t)PRNG_Next(prng) * range;
+    } while((uint32_t)m < threshold);
+
+    return (uint32_t)(m >> 32);
+}
+
+int CheckThreshold(PRNGType type, uint32_t seed, uint32_t range)
+{
+    static uint32_t buffer[CHECK_COUNT];
+    PRNG a, b, c;
+    int match = 1;
+
+    PRNG_Create(&a, type);
+    PRNG_Create(&b, type);
+    PRNG_Create(&c, type);
+    PRNG_Seed(&a, seed);
+    PRNG_Seed(&b, seed);
+    PRNG_Seed(&c, seed);
+    PRNG_FillBounded(&c, buffer, CHECK_COUNT, 0, range - 1);
+
+    for(uint32_t i = 0; i < CHECK_COUNT; i++)
+    {
+        uint32_t expected = Reference(&a, range);
+        if(PRNG_NextBounded(&b, 0, range - 1) != expected || 
+            buffer[i] != expected)
+            match = 0;
+    }
+    printf("Threshold check, range 0x%x: %s\n", range, match ? "ok" : "FAIL");
+    return match;
+}
+
 int main(void)
 {
     uint32_t seed, result, n, choice, lower, upper;
@@ -13,12 +61,20 @@ int main(void)
     FILE *out;
     PRNG prng;
     char c, removeBias;
-    char option[2][22] = {"LCG No Bias Removal",
-                          "LCG With Bias Removal"};
+    char option[9][32] = {"LCG No Bias Removal",
+                          "LCG With Bias Removal",
+                          "Xoshiro128** No Bias Removal",
+                          "Xoshiro128** With Bias Removal",
+                          "PCG32 No Bias Removal",
+                          "PCG32 With Bias Removal",
+                          "SplitMix64 No Bias Removal",
+                          "SplitMix64 With Bias Removal",
+                          "LCG Multiply-Shift (Lemire)"};
     while(1)
     {
-        printf("Select type:\n1. %s\n2. %s\n", 
-            option[0], option[1]);
+        printf("Select type:\n1. %s\n2. %s\n3. %s\n4. %s\n5. %s\n6. %s\n"
+            "7. %s\n8. %s\n9. %s\n", option[0], option[1], option[2],
+            option[3], option[4], option[5], option[6], option[7], option[8]);
         printf("Enter q to quit.\n");
         scanf(" %c", &c);
 
@@ -34,6 +90,41 @@ int main(void)
                 prng.type = PRNG_TYPE_LCG_BIG;
                 removeBias = 1;
                 break;
+            case '3':
+                choice = 2;
+                prng.type = PRNG_TYPE_XOSHIRO128SS;
+                removeBias = 0;
+                break;
+            case '4':
+                choice = 3;
+                prng.type = PRNG_TYPE_XOSHIRO128SS;
+                removeBias = 1;
+                break;
+            case '5':
+                choice = 4;
+                prng.type = PRNG_TYPE_PCG32;
+                removeBias = 0;
+                break;
+            case '6':
+                choice = 5;
+                prng.type = PRNG_TYPE_PCG32;
+                removeBias = 1;
+                break;
+            case '7':
+                choice = 6;
+                prng.type = PRNG_TYPE_SPLITMIX64;
+                removeBias = 0;
+                break;
+            case '8':
+                choice = 7;
+                prng.type = PRNG_TYPE_SPLITMIX64;
+                removeBias = 1;
+                break;
+            case '9':
+                choice = 8;
+                prng.type = PRNG_TYPE_LCG_BIG;
+                removeBias = 2;
+                break;
             case 'Q':
             case 'q':
                 fclose(out);
@@ -72,10 +163,23 @@ int main(void)
         
         /* If no bias removal is selected, skip the end of the do-while */
         uint32_t threshold = 0;
-        if(removeBias)
+        if(removeBias == 1)
             threshold = randMax - randMax % range;
 
-        for(uint32_t i = 0; i < n; i++)
+        /* Multiply-shift goes straight through the library */
+        if(removeBias == 2 && range > 1 && range < 0xFFFFFFFF)
+        {
+            CheckThreshold(prng.type, seed, range);
+            CheckThreshold(prng.type, seed, 0x80000001UL);
+        }
+
+        for(uint32_t i = 0; i < n && removeBias == 2; i++)
+        {
+            result = PRNG_NextBounded(&prng, lower, upper);
+            fprintf(out, "%u,\n", result);
+        }
+
+        for(uint32_t i = 0; i < n && removeBias != 2; i++)
         {
             /* The loop and threshold are the method for removing modulo bias.
             The step in the middle that performs modulus with randMax + 1 is so 
@@ -12,14 +12,18 @@ int main(void)
     FILE *out;
     PRNG prng;
     char c;
-    char option[4][12] = {"LCG Big",
+    char option[7][14] = {"LCG Big",
                           "LCG Small",
                           "Park Miller",
-                          "Schrage"};
+                          "Schrage",
+                          "Xoshiro128**",
+                          "PCG32",
+                          "SplitMix64"};
     while(1)
     {
-        printf("Select type:\n1. %s\n2. %s\n3. %s\n4. %s\n", 
-            option[0], option[1], option[2], option[3]);
+        printf("Select type:\n1. %s\n2. %s\n3. %s\n4. %s\n5. %s\n6. %s\n"
+            "7. %s\n", option[0], option[1], option[2], option[3], option[4],
+            option[5], option[6]);
         printf("Enter q to quit.\n");
         scanf(" %c", &c);
 
@@ -41,6 +45,18 @@ int main(void)
                 choice = 3;
                 prng.type = PRNG_TYPE_SCHRAGE;
                 break;
+            case '5':
+                choice = 4;
+                prng.type = PRNG_TYPE_XOSHIRO128SS;
+                break;
+            case '6':
+                choice = 5;
+                prng.type = PRNG_TYPE_PCG32;
+                break;
+            case '7':
+                choice = 6;
+                prng.type = PRNG_TYPE_SPLITMIX64;
+                break;
             case 'Q':
             case 'q':
                 fclose(out);
@@ -0,0 +1,293 @@
+/* Program to run statistical tests on every PRNG type - MS */
+
+/* Unlike the other test programs, this one doesn't ask for anything. It runs
+a handful of the classic tests from Knuth and Marsaglia on each generator,
+measures how fast PRNG_Fill is, and then prints the fastest one that passed.
+It returns non-zero if any generator fails, so it can be run by a script.
+Build with -lm. An optional argument sets the seed.
+
+Every output is turned into a number from 0 to 1 first, since each generator
+has a different range. The small LCG only gives 16 bits, so two outputs are
+glued together the same way PRNG_NextBounded does it.
+
+These are all done with a fixed seed, so the results don't change from run to
+run. A p-value below 0.0001 fails. So does one above 0.9999, which would mean
+the numbers are too even to be random. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "PRNG.h"
+
+#define NUM_TYPES           7
+#define NUM_SAMPLES         (1UL << 20)
+#define P_LIMIT             0.0001
+
+#define UNIFORM_BINS        256
+
+#define GAP_LOWER           0.0
+#define GAP_UPPER           0.5
+#define GAP_MAX             12
+#define GAP_COUNT           100000UL
+
+/* 1024 birthdays in a year of 2^24 days gives lambda = m^3 / (4n) = 16 */
+#define BDAY_DAYS           (1UL << 24)
+#define BDAY_M              1024
+#define BDAY_LAMBDA         16.0
+#define BDAY_REPEATS        500
+#define BDAY_LOW            8
+#define BDAY_HIGH           25
+
+#define SPEED_VALUES        1000000UL
+#define SPEED_PASSES        20
+
+typedef struct ResultTag
+{
+    double p[4];
+    double rate;
+    int passed;
+} Result;
+
+static uint32_t buffer[SPEED_VALUES];
+
+double Uniform(PRNG *prng)
+{
+    switch(prng->type)
+    {
+        case PRNG_TYPE_LCG_SMALL:
+        {
+            uint32_t high = PRNG_Next(prng);
+            return (double)((high << 16) | PRNG_Next(prng)) / 4294967296.0;
+        }
+        case PRNG_TYPE_PARK_MILLER:
+        case PRNG_TYPE_SCHRAGE:
+            /* 1 to 2^31 - 2 */
+            return (double)(PRNG_Next(prng) - 1) / 2147483646.0;
+        default:
+            return (double)PRNG_Next(prng) / 4294967296.0;
+    }
+}
+
+/* Upper tail of the chi-square distribution using the Wilson-Hilferty
+approximation. It's close enough for the degrees of freedom used here. */
+double ChiSquareP(double chi, double df)
+{
+    double z = (pow(chi / df, 1.0 / 3.0) - (1.0 - 2.0 / (9.0 * df))) /
+        sqrt(2.0 / (9.0 * df));
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+int Passed(double p)
+{
+    return (p >= P_LIMIT && p <= 1.0 - P_LIMIT);
+}
+
+int Compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Drop each number into one of 256 bins. They should all fill evenly. */
+double UniformityTest(PRNG *prng)
+{
+    static uint32_t counts[UNIFORM_BINS];
+    double expected = (double)NUM_SAMPLES / UNIFORM_BINS, chi = 0;
+
+    memset(counts, 0, sizeof(counts));
+    for(uint32_t i = 0; i < NUM_SAMPLES; i++)
+        counts[(uint32_t)(Uniform(prng) * UNIFORM_BINS)]++;
+
+    for(uint32_t i = 0; i < UNIFORM_BINS; i++)
+        chi += (counts[i] - expected) * (counts[i] - expected) / expected;
+
+    return ChiSquareP(chi, UNIFORM_BINS - 1);
+}
+
+/* Correlation between each number and the next one. For random numbers
+r * sqrt(N) is close to a standard normal. */
+double SerialCorrelationTest(PRNG *prng)
+{
+    double first = Uniform(prng), x = first, next;
+    double sumX = 0, sumXX = 0, sumXY = 0;
+
+    for(uint32_t i = 0; i < NUM_SAMPLES; i++)
+    {
+        next = (i == NUM_SAMPLES - 1) ? first : Uniform(prng);
+        sumX += x;
+        sumXX += x * x;
+        sumXY += x * next;
+        x = next;
+    }
+
+    double n = NUM_SAMPLES;
+    double r = (n * sumXY - sumX * sumX) / (n * sumXX - sumX * sumX);
+    double z = fabs(r) * sqrt(n);
+    return erfc(z / sqrt(2.0));
+}
+
+/* Count how many numbers fall outside of [0, 0.5) in between the ones that
+land inside. The length of those gaps should be geometric. */
+double GapTest(PRNG *prng)
+{
+    uint32_t counts[GAP_MAX + 1] = {0};
+    double p = GAP_UPPER - GAP_LOWER, chi = 0;
+
+    for(uint32_t g = 0; g < GAP_COUNT; g++)
+    {
+        uint32_t length = 0;
+        double u;
+        while((u = Uniform(prng)) < GAP_LOWER || u >= GAP_UPPER)
+            length++;
+        counts[length < GAP_MAX ? length : GAP_MAX]++;
+    }
+
+    for(uint32_t r = 0; r <= GAP_MAX; r++)
+    {
+        double prob = (r < GAP_MAX) ? p * pow(1.0 - p, r) : pow(1.0 - p, r);
+        double expected = prob * GAP_COUNT;
+        chi += (counts[r] - expected) * (counts[r] - expected) / expected;
+    }
+
+    return ChiSquareP(chi, GAP_MAX);
+}
+
+/* Marsaglia's birthday spacings. Pick m birthdays, sort them, and look at
+the spaces between them. The number of spaces that show up more than once
+should be Poisson with mean lambda. LCGs are known to fail this one when the
+low bits are used, which is why we take the top bits. */
+double BirthdayTest(PRNG *prng)
+{
+    uint32_t days[BDAY_M], spaces[BDAY_M];
+    uint32_t counts[BDAY_HIGH - BDAY_LOW + 1] = {0};
+    double chi = 0;
+
+    for(uint32_t t = 0; t < BDAY_REPEATS; t++)
+    {
+        uint32_t repeats = 0;
+
+        for(uint32_t i = 0; i < BDAY_M; i++)
+            days[i] = (uint32_t)(Uniform(prng) * BDAY_DAYS);
+        qsort(days, BDAY_M, sizeof(uint32_t), Compare);
+
+        spaces[0] = days[0];
+        for(uint32_t i = 1; i < BDAY_M; i++)
+            spaces[i] = days[i] - days[i - 1];
+        qsort(spaces, BDAY_M, sizeof(uint32_t), Compare);
+
+        for(uint32_t i = 1; i < BDAY_M; i++)
+        {
+            if(spaces[i] == spaces[i - 1])
+                repeats++;
+        }
+
+        if(repeats < BDAY_LOW)
+            repeats = BDAY_LOW;
+        else if(repeats > BDAY_HIGH)
+            repeats = BDAY_HIGH;
+        counts[repeats - BDAY_LOW]++;
+    }
+
+    /* The first and last bins hold the tails so that every bin expects at
+    least a few hits */
+    double term = exp(-BDAY_LAMBDA), below = 0;
+    for(uint32_t j = 0; j <= BDAY_HIGH; j++)
+    {
+        double prob = term;
+        if(j == BDAY_LOW)
+            prob += below;
+        else if(j == BDAY_HIGH)
+            prob = 1.0 - below;
+
+        if(j >= BDAY_LOW)
+        {
+            double expected = prob * BDAY_REPEATS;
+            double diff = counts[j - BDAY_LOW] - expected;
+            chi += diff * diff / expected;
+        }
+        below += term;
+        term *= BDAY_LAMBDA / (j + 1);
+    }
+
+    return ChiSquareP(chi, BDAY_HIGH - BDAY_LOW);
+}
+
+double Throughput(PRNG *prng)
+{
+    clock_t start = clock();
+    for(uint32_t p = 0; p < SPEED_PASSES; p++)
+        PRNG_Fill(prng, buffer, SPEED_VALUES);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    if(seconds <= 0.0)
+        seconds = 1.0 / CLOCKS_PER_SEC;
+    return (double)SPEED_VALUES * SPEED_PASSES / seconds / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    PRNG prng;
+    Result results[NUM_TYPES];
+    uint32_t seed = 12345;
+    int failed = 0, fastest = -1;
+    PRNGType types[NUM_TYPES] = {PRNG_TYPE_LCG_BIG,
+                                 PRNG_TYPE_LCG_SMALL,
+                                 PRNG_TYPE_PARK_MILLER,
+                                 PRNG_TYPE_SCHRAGE,
+                                 PRNG_TYPE_XOSHIRO128SS,
+                                 PRNG_TYPE_PCG32,
+                                 PRNG_TYPE_SPLITMIX64};
+    char option[NUM_TYPES][14] = {"LCG Big",
+                                  "LCG Small",
+                                  "Park Miller",
+                                  "Schrage",
+                                  "Xoshiro128**",
+                                  "PCG32",
+                                  "SplitMix64"};
+    char testName[4][12] = {"uniform", "serial", "gap", "birthday"};
+    double (*tests[4])(PRNG *) = {UniformityTest,
+                                  SerialCorrelationTest,
+                                  GapTest,
+                                  BirthdayTest};
+
+    if(argc > 1)
+        seed = (uint32_t)strtoul(argv[1], NULL, 0);
+
+    printf("Seed %u, p-values (fail below %g or above %g)\n\n", seed, P_LIMIT,
+        1.0 - P_LIMIT);
+    printf("%-14s %9s %9s %9s %9s %12s\n", "", testName[0], testName[1],
+        testName[2], testName[3], "M numbers/s");
+
+    for(uint8_t t = 0; t < NUM_TYPES; t++)
+    {
+        Result *result = &results[t];
+        result->passed = 1;
+
+        PRNG_Create(&prng, types[t]);
+        PRNG_Seed(&prng, seed);
+        printf("%-14s", option[t]);
+        for(uint8_t i = 0; i < 4; i++)
+        {
+            result->p[i] = tests[i](&prng);
+            if(!Passed(result->p[i]))
+                result->passed = 0;
+            printf(" %8.4f%c", result->p[i], Passed(result->p[i]) ? ' ' : '*');
+        }
+        result->rate = Throughput(&prng);
+        printf(" %12.2f  %s\n", result->rate, result->passed ? "PASS" : "FAIL");
+
+        if(!result->passed)
+            failed = 1;
+        else if(fastest < 0 || result->rate > results[fastest].rate)
+            fastest = t;
+    }
+
+    if(fastest >= 0)
+        printf("\nFastest generator that passed: %s\n", option[fastest]);
+    else
+        printf("\nNo generator passed\n");
+
+    return failed;
+}
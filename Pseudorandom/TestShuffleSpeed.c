@@ -0,0 +1,255 @@
+/* Program to compare the speed of PRNG_Shuffle on large arrays - MS */
+
+/* The old shuffle is kept here so it can be compared against. It used a
+variable length array for the swap, three memcpy's per swap, and % (i + 1)
+to pick the index. PRNG_Shuffle uses xoshiro128** now. Each of the 1, 2, 4, 
+and 8 byte loops is timed, and so is PCG32 through PRNG_ShuffleWith. The 
+64-byte records go up to 1e7 too, which needs about 2 GB of memory. The copy 
+at the end of PRNG_ShuffleGather is also timed against a cache-blocked 
+version of it.
+
+Each time is the fastest of a few runs. The first time a big array gets read
+in a random order can be many times slower than the rest on some machines, 
+which has nothing to do with the shuffle. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "PRNG.h"
+
+#define MAX_ELEMENTS    10000000UL
+#define MAX_RECORDS     10000000UL
+#define RECORD_SIZE     64
+#define RUNS            5
+#define BLOCK_SHIFT     12   // 4096 records, 256 kB of source per window
+
+typedef struct RecordTag
+{
+    uint32_t key;
+    uint8_t data[RECORD_SIZE - sizeof(uint32_t)];
+} Record;
+
+double Now(void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+void OldShuffle(void *array, uint32_t n, size_t s, uint32_t seed)
+{
+    uint8_t tmp[s];
+    uint8_t *arrayPtr = array;
+    uint32_t schrageState = seed;
+
+    if(schrageState == 0)
+        schrageState++;
+
+    for(uint32_t i = n - 1; i > 0; i--)
+    {
+        uint32_t j = Schrage_Next(&schrageState) % (i + 1);
+        memcpy(tmp, arrayPtr + j * s, s);
+        memcpy(arrayPtr + j * s, arrayPtr + i * s, s);
+        memcpy(arrayPtr + i * s, tmp, s);
+    }
+}
+
+/* The copy at the end of PRNG_ShuffleGather, on its own */
+void PlainGather(const Record *src, Record *dst, const uint32_t *indices, 
+    uint32_t n)
+{
+    for(uint32_t i = 0; i < n; i++)
+        dst[i] = src[indices[i]];
+}
+
+/* A cache-blocked version of the same copy. The destinations are sorted by 
+which window of the source they read from, and then copied one window at a 
+time so the reads stay in the cache. It needs a second list of n indices. 
+The writes to dst end up jumping around instead, so on a PC it loses to the 
+plain copy and PRNG_ShuffleGather doesn't use it. It's kept here to show 
+that. */
+void BlockedGather(const Record *src, Record *dst, const uint32_t *indices, 
+    uint32_t *order, uint32_t n)
+{
+    static uint32_t start[(MAX_RECORDS >> BLOCK_SHIFT) + 2];
+    uint32_t blocks = (n >> BLOCK_SHIFT) + 1;
+
+    memset(start, 0, sizeof(start));
+    for(uint32_t i = 0; i < n; i++)
+        start[(indices[i] >> BLOCK_SHIFT) + 1]++;
+    for(uint32_t b = 0; b < blocks; b++)
+        start[b + 1] += start[b];
+    for(uint32_t i = 0; i < n; i++)
+        order[start[indices[i] >> BLOCK_SHIFT]++] = i;
+
+    for(uint32_t k = 0; k < n; k++)
+        dst[order[k]] = src[indices[order[k]]];
+}
+
+int main(void)
+{
+    int failed = 0;
+    double start;
+    PRNG prng;
+    uint64_t *array = malloc(MAX_ELEMENTS * sizeof(uint64_t));
+    size_t sizes[] = {1, 2, 4, 8};
+    uint32_t *indices = malloc(MAX_RECORDS * sizeof(uint32_t));
+    uint32_t *order = malloc(MAX_RECORDS * sizeof(uint32_t));
+    Record *records = malloc(MAX_RECORDS * sizeof(Record));
+    Record *copy = malloc(MAX_RECORDS * sizeof(Record));
+    Record *gathered = malloc(MAX_RECORDS * sizeof(Record));
+
+    if(!array || !indices || !order || !records || !copy || !gathered)
+    {
+        printf("Out of memory\n");
+        return 1;
+    }
+
+    /* Touch every page first so the timing doesn't include page faults */
+    memset(indices, 0, MAX_RECORDS * sizeof(uint32_t));
+    memset(order, 0, MAX_RECORDS * sizeof(uint32_t));
+    memset(gathered, 0, MAX_RECORDS * sizeof(Record));
+
+    printf("%-10s %6s %12s %12s %12s\n", "elements", "bytes", "old (s)", 
+        "new (s)", "pcg32 (s)");
+    for(uint32_t n = 1000; n <= MAX_ELEMENTS; n *= 10)
+    {
+        for(uint8_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++)
+        {
+            double oldTime = 1e9, newTime = 1e9, pcgTime = 1e9, t;
+            size_t s = sizes[k];
+
+            for(uint32_t i = 0; i < n; i++)
+                array[i] = i;
+            PRNG_Create(&prng, PRNG_TYPE_PCG32);
+            PRNG_Seed(&prng, 12345);
+            for(uint8_t r = 0; r < RUNS; r++)
+            {
+                start = Now();
+                OldShuffle(array, n, s, 12345);
+                t = Now() - start;
+                oldTime = t < oldTime ? t : oldTime;
+
+                start = Now();
+                PRNG_Shuffle(array, n, s, 12345);
+                t = Now() - start;
+                newTime = t < newTime ? t : newTime;
+
+                start = Now();
+                PRNG_ShuffleWith(&prng, array, n, s);
+                t = Now() - start;
+                pcgTime = t < pcgTime ? t : pcgTime;
+            }
+            printf("%-10u %6u %12.6f %12.6f %12.6f\n", n, (unsigned)s, 
+                oldTime, newTime, pcgTime);
+        }
+    }
+
+    printf("\n%-10s %12s %12s %12s\n", "64-byte", "old (s)", "new (s)",
+        "gather (s)");
+    for(uint32_t n = 1000; n <= MAX_RECORDS; n *= 10)
+    {
+        double oldTime = 1e9, newTime = 1e9, gatherTime = 1e9, t;
+
+        for(uint32_t i = 0; i < n; i++)
+            records[i].key = i;
+        for(uint8_t r = 0; r < RUNS; r++)
+        {
+            start = Now();
+            OldShuffle(records, n, sizeof(Record), 12345);
+            t = Now() - start;
+            oldTime = t < oldTime ? t : oldTime;
+        }
+
+        for(uint8_t r = 0; r < RUNS; r++)
+        {
+            for(uint32_t i = 0; i < n; i++)
+                records[i].key = i;
+            memcpy(copy, records, n * sizeof(Record));
+            PRNG_Create(&prng, PRNG_TYPE_XOSHIRO128SS);
+            PRNG_Seed(&prng, 12345);
+            start = Now();
+            PRNG_ShuffleWith(&prng, records, n, sizeof(Record));
+            t = Now() - start;
+            newTime = t < newTime ? t : newTime;
+
+            PRNG_Seed(&prng, 12345);
+            start = Now();
+            PRNG_ShuffleGather(&prng, copy, gathered, indices, n, 
+                sizeof(Record));
+            t = Now() - start;
+            gatherTime = t < gatherTime ? t : gatherTime;
+        }
+        printf("%-10u %12.6f %12.6f %12.6f\n", n, oldTime, newTime, gatherTime);
+
+        /* Both methods should give the same order */
+        if(memcmp(records, gathered, n * sizeof(Record)) != 0)
+        {
+            printf("Gather output does not match in place shuffle!\n");
+            failed = 1;
+        }
+    }
+
+    /* Just the copy part of the gather, plain and cache-blocked */
+    printf("\n%-10s %12s %12s\n", "64-byte", "gather (s)", "blocked (s)");
+    for(uint32_t n = 1000; n <= MAX_RECORDS; n *= 10)
+    {
+        double plainTime = 1e9, blockedTime = 1e9, t;
+
+        for(uint32_t i = 0; i < n; i++)
+        {
+            copy[i].key = i;
+            indices[i] = i;
+        }
+        PRNG_Create(&prng, PRNG_TYPE_XOSHIRO128SS);
+        PRNG_Seed(&prng, 12345);
+        PRNG_ShuffleWith(&prng, indices, n, sizeof(uint32_t));
+
+        for(uint8_t r = 0; r < RUNS; r++)
+        {
+            start = Now();
+            PlainGather(copy, gathered, indices, n);
+            t = Now() - start;
+            plainTime = t < plainTime ? t : plainTime;
+
+            start = Now();
+            BlockedGather(copy, records, indices, order, n);
+            t = Now() - start;
+            blockedTime = t < blockedTime ? t : blockedTime;
+        }
+        printf("%-10u %12.6f %12.6f\n", n, plainTime, blockedTime);
+
+        if(memcmp(records, gathered, n * sizeof(Record)) != 0)
+        {
+            printf("Blocked gather output does not match!\n");
+            failed = 1;
+        }
+    }
+
+    /* Every order of a small array should come up equally often. With 3
+    elements there are 6 orders. A chi-square above about 15 (5 degrees of
+    freedom, p = 0.01) means something is wrong. */
+    uint32_t counts[6] = {0};
+    uint32_t trials = 600000;
+    PRNG_Create(&prng, PRNG_TYPE_XOSHIRO128SS);
+    PRNG_Seed(&prng, 1);
+    for(uint32_t t = 0; t < trials; t++)
+    {
+        uint8_t small[3] = {0, 1, 2};
+        PRNG_ShuffleWith(&prng, small, 3, 1);
+        counts[small[0] * 2 + (small[1] > small[2])]++;
+    }
+    double chi = 0, expected = trials / 6.0;
+    for(uint8_t i = 0; i < 6; i++)
+        chi += (counts[i] - expected) * (counts[i] - expected) / expected;
+    printf("\nPermutations of 3 elements: chi-square = %.2f\n", chi);
+    if(chi > 15.09)
+        failed = 1;
+
+    free(array);
+    free(indices);
+    free(order);
+    free(records);
+    free(copy);
+    free(gathered);
+    return failed;
+}
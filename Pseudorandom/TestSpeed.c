@@ -0,0 +1,284 @@
+/* Program to compare the speed of PRNG_Next and PRNG_Fill - MS */
+
+/* Build from the Pseudorandom folder with:
+gcc -std=c99 -O2 TestSpeed.c
+
+PRNG.c is included here instead of being built on its own, so the old 
+bounded functions below can use the same generator functions the new ones 
+do. OldNextBounded and OldFillBounded are the modulo bias removal method 
+from before PRNG_NextBounded used multiply-shift, copied as they were. Every 
+function being timed, old and new, is called through a volatile function 
+pointer. That way none of them can be inlined into the loop and have the 
+threshold pulled out of it, and each one costs what a real call from another
+file would. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "PRNG.c"
+
+#define NUM_VALUES  1000000UL
+#define NUM_PASSES  20
+
+#define NUM_TYPES   7
+
+static uint32_t buffer[NUM_VALUES];
+static uint32_t check[NUM_VALUES];
+
+double Seconds(clock_t start, clock_t end)
+{
+    return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+// ***** The Old Method ********************************************************
+
+uint32_t OldNextBounded(PRNG *self, uint32_t lower, uint32_t upper)
+{
+    uint32_t result = 0;
+    uint32_t randMax = 0xFFFFFFFF;
+
+    if(!self->isSeeded)
+        PRNG_Seed(self, 0);
+
+    switch(self->type)
+    {
+        case PRNG_TYPE_LCG_BIG:
+            randMax = 0xFFFFFFFF;
+            break;
+        case PRNG_TYPE_LCG_SMALL:
+            randMax = LCG_SMALL_M;
+            break;
+        case PRNG_TYPE_PARK_MILLER:
+            randMax = PM_BIG_M;
+            break;
+        case PRNG_TYPE_SCHRAGE:
+            randMax = SCH_M;
+            break;
+        default:
+            randMax = 0xFFFFFFFF;
+            break;
+    }
+
+    uint32_t range = upper - lower;
+    if(range < 0xFFFFFFFF)
+        range++;
+
+    uint32_t threshold = randMax - randMax % range;
+    do {
+        switch(self->type)
+        {
+            case PRNG_TYPE_LCG_BIG:
+                result = LCGBig_Next(&(self->state.u64));
+                break;
+            case PRNG_TYPE_LCG_SMALL:
+                result = LCGSmall_Next(&(self->state.u32));
+                break;
+            case PRNG_TYPE_PARK_MILLER:
+                result = ParkMiller_Next(&(self->state.u64));
+                break;
+            case PRNG_TYPE_SCHRAGE:
+                result = Schrage_Next(&(self->state.u32));
+                break;
+            case PRNG_TYPE_XOSHIRO128SS:
+                result = Xoshiro128ss_Next(self->state.u32x4);
+                break;
+            case PRNG_TYPE_PCG32:
+                result = PCG32_Next(self->state.u64x2);
+                break;
+            case PRNG_TYPE_SPLITMIX64:
+                result = SplitMix64_Next(&(self->state.u64));
+                break;
+        }
+    } while(result >= threshold);
+
+    return (result % range) + lower;
+}
+
+/* One loop per generator, same as the old one. They only differ in which
+generator they call. */
+#define OLD_FILL_LOOP(next) \
+    for(uint32_t i = 0; i < n; i++) \
+    { \
+        do { \
+            result = next; \
+        } while(result >= threshold); \
+        out[i] = (result % range) + lower; \
+    }
+
+void OldFillBounded(PRNG *self, uint32_t *out, uint32_t n, uint32_t lower,
+    uint32_t upper)
+{
+    uint32_t result;
+    uint32_t randMax = 0xFFFFFFFF;
+
+    if(!self->isSeeded)
+        PRNG_Seed(self, 0);
+
+    switch(self->type)
+    {
+        case PRNG_TYPE_LCG_SMALL:
+            randMax = LCG_SMALL_M;
+            break;
+        case PRNG_TYPE_PARK_MILLER:
+            randMax = PM_BIG_M;
+            break;
+        case PRNG_TYPE_SCHRAGE:
+            randMax = SCH_M;
+            break;
+        default:
+            randMax = 0xFFFFFFFF;
+            break;
+    }
+
+    uint32_t range = upper - lower;
+    if(range < 0xFFFFFFFF)
+        range++;
+
+    uint32_t threshold = randMax - randMax % range;
+
+    switch(self->type)
+    {
+        case PRNG_TYPE_LCG_BIG:
+            OLD_FILL_LOOP(LCGBig_Next(&(self->state.u64)))
+            break;
+        case PRNG_TYPE_LCG_SMALL:
+            OLD_FILL_LOOP(LCGSmall_Next(&(self->state.u32)))
+            break;
+        case PRNG_TYPE_PARK_MILLER:
+            OLD_FILL_LOOP(ParkMiller_Next(&(self->state.u64)))
+            break;
+        case PRNG_TYPE_SCHRAGE:
+            OLD_FILL_LOOP(Schrage_Next(&(self->state.u32)))
+            break;
+        case PRNG_TYPE_XOSHIRO128SS:
+            OLD_FILL_LOOP(Xoshiro128ss_Next(self->state.u32x4))
+            break;
+        case PRNG_TYPE_PCG32:
+            OLD_FILL_LOOP(PCG32_Next(self->state.u64x2))
+            break;
+        case PRNG_TYPE_SPLITMIX64:
+            OLD_FILL_LOOP(SplitMix64_Next(&(self->state.u64)))
+            break;
+    }
+}
+
+// *****************************************************************************
+
+/* Out of line, the same as calling from another file */
+static uint32_t (*volatile Next)(PRNG *) = PRNG_Next;
+static void (*volatile Fill)(PRNG *, uint32_t *, uint32_t) = PRNG_Fill;
+static uint32_t (*volatile NextBounded)(PRNG *, uint32_t, uint32_t);
+static void (*volatile FillBounded)(PRNG *, uint32_t *, uint32_t, uint32_t,
+    uint32_t);
+
+double TimeNextBounded(PRNG *prng, uint32_t *out, uint32_t lower, 
+    uint32_t upper)
+{
+    clock_t start;
+
+    PRNG_Seed(prng, 1);
+    start = clock();
+    for(uint32_t p = 0; p < NUM_PASSES; p++)
+    {
+        for(uint32_t i = 0; i < NUM_VALUES; i++)
+            out[i] = NextBounded(prng, lower, upper);
+    }
+    return Seconds(start, clock());
+}
+
+double TimeFillBounded(PRNG *prng, uint32_t *out, uint32_t lower, 
+    uint32_t upper)
+{
+    clock_t start;
+
+    PRNG_Seed(prng, 1);
+    start = clock();
+    for(uint32_t p = 0; p < NUM_PASSES; p++)
+        FillBounded(prng, out, NUM_VALUES, lower, upper);
+    return Seconds(start, clock());
+}
+
+void PrintRate(const char *name, double seconds)
+{
+    double total = (double)NUM_VALUES * NUM_PASSES;
+    if(seconds <= 0.0)
+        seconds = 1.0 / CLOCKS_PER_SEC;
+    printf("  %-24s %10.2f million numbers/s\n", name, total / seconds / 1e6);
+}
+
+int main(void)
+{
+    PRNG prng;
+    clock_t start;
+    int failed = 0;
+    /* volatile so the compiler can't turn the modulo into a multiply */
+    volatile uint32_t bounds[2] = {0, 999};
+    uint32_t lower = bounds[0], upper = bounds[1];
+    PRNGType types[NUM_TYPES] = {PRNG_TYPE_LCG_BIG,
+                                 PRNG_TYPE_LCG_SMALL,
+                                 PRNG_TYPE_PARK_MILLER,
+                                 PRNG_TYPE_SCHRAGE,
+                                 PRNG_TYPE_XOSHIRO128SS,
+                                 PRNG_TYPE_PCG32,
+                                 PRNG_TYPE_SPLITMIX64};
+    char option[NUM_TYPES][14] = {"LCG Big",
+                                  "LCG Small",
+                                  "Park Miller",
+                                  "Schrage",
+                                  "Xoshiro128**",
+                                  "PCG32",
+                                  "SplitMix64"};
+
+    for(uint8_t t = 0; t < NUM_TYPES; t++)
+    {
+        printf("%s:\n", option[t]);
+        prng.type = types[t];
+
+        /* One number at a time */
+        PRNG_Seed(&prng, 1);
+        start = clock();
+        for(uint32_t p = 0; p < NUM_PASSES; p++)
+        {
+            for(uint32_t i = 0; i < NUM_VALUES; i++)
+                check[i] = Next(&prng);
+        }
+        PrintRate("PRNG_Next", Seconds(start, clock()));
+
+        PRNG_Seed(&prng, 1);
+        start = clock();
+        for(uint32_t p = 0; p < NUM_PASSES; p++)
+            Fill(&prng, buffer, NUM_VALUES);
+        PrintRate("PRNG_Fill", Seconds(start, clock()));
+
+        /* Both methods must give the exact same sequence */
+        if(memcmp(buffer, check, sizeof(buffer)) != 0)
+        {
+            printf("  PRNG_Fill output does not match PRNG_Next!\n");
+            failed = 1;
+        }
+
+        NextBounded = PRNG_NextBounded;
+        PrintRate("PRNG_NextBounded", TimeNextBounded(&prng, check, lower,
+            upper));
+        NextBounded = OldNextBounded;
+        PrintRate("Old NextBounded", TimeNextBounded(&prng, buffer, lower,
+            upper));
+
+        FillBounded = PRNG_FillBounded;
+        PrintRate("PRNG_FillBounded", TimeFillBounded(&prng, buffer, lower,
+            upper));
+
+        if(memcmp(buffer, check, sizeof(buffer)) != 0)
+        {
+            printf("  PRNG_FillBounded output does not match "
+                "PRNG_NextBounded!\n");
+            failed = 1;
+        }
+
+        FillBounded = OldFillBounded;
+        PrintRate("Old FillBounded", TimeFillBounded(&prng, buffer, lower,
+            upper));
+    }
+    return failed;
+}
@@ -0,0 +1,141 @@
+/* Program to test PRNG_SplitStreams with multiple threads - MS */
+
+/* Build with -pthread. Each thread gets its own stream from PRNG_SplitStreams
+and runs a Monte Carlo estimate of pi on its piece of the sequence. The results
+from every thread are compared against one PRNG running the whole sequence by
+itself. They should match exactly. Then the time is compared for 1, 2, 4, and
+8 threads. The time is wall clock time from clock_gettime, since clock() adds 
+up the time from every thread. That one is POSIX, not C99, hence the define. */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "PRNG.h"
+
+#define MAX_THREADS     8
+#define TOTAL_POINTS    (1UL << 25)
+#define CHUNK_SIZE      4096
+
+typedef struct WorkTag
+{
+    PRNG prng;
+    uint32_t numPoints;
+    uint32_t hits;
+    uint64_t sum;
+} Work;
+
+double Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Two random numbers make one point in the unit square. Count how many land
+inside the quarter circle. The sum of all of the numbers is kept too, so that
+we know every single number matched, not just the hit count. */
+void *MonteCarlo(void *arg)
+{
+    Work *work = arg;
+    uint32_t buffer[CHUNK_SIZE];
+    uint32_t remaining = work->numPoints * 2;
+
+    work->hits = 0;
+    work->sum = 0;
+    while(remaining > 0)
+    {
+        uint32_t n = remaining < CHUNK_SIZE ? remaining : CHUNK_SIZE;
+        PRNG_Fill(&work->prng, buffer, n);
+        for(uint32_t i = 0; i < n; i += 2)
+        {
+            double x = buffer[i] / 4294967296.0;
+            double y = buffer[i + 1] / 4294967296.0;
+            if(x * x + y * y < 1.0)
+                work->hits++;
+            work->sum += buffer[i] + (uint64_t)buffer[i + 1];
+        }
+        remaining -= n;
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    PRNG base, streams[MAX_THREADS];
+    Work work[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    int failed = 0;
+    PRNGType types[3] = {PRNG_TYPE_LCG_BIG,
+                         PRNG_TYPE_XOSHIRO128SS,
+                         PRNG_TYPE_PCG32};
+    char option[3][14] = {"LCG Big",
+                          "Xoshiro128**",
+                          "PCG32"};
+
+    for(uint8_t t = 0; t < 3; t++)
+    {
+        printf("%s:\n", option[t]);
+        double baseTime = 0;
+
+        for(uint8_t k = 1; k <= MAX_THREADS; k *= 2)
+        {
+            uint32_t pointsPerThread = TOTAL_POINTS / k;
+            uint32_t hits = 0;
+            uint64_t sum = 0;
+
+            /* One PRNG running the whole sequence. Keep track of each piece
+            so it can be compared to each thread. */
+            Work sequential[MAX_THREADS];
+            PRNG_Create(&base, types[t]);
+            PRNG_Seed(&base, 2024);
+            for(uint8_t i = 0; i < k; i++)
+            {
+                sequential[i].prng = base;
+                sequential[i].numPoints = pointsPerThread;
+                MonteCarlo(&sequential[i]);
+                base = sequential[i].prng;
+            }
+
+            /* Now split the same sequence into k streams */
+            PRNG_Create(&base, types[t]);
+            PRNG_Seed(&base, 2024);
+            PRNG_SplitStreams(&base, streams, k, (int64_t)pointsPerThread * 2);
+
+            double start = Now();
+            for(uint8_t i = 0; i < k; i++)
+            {
+                work[i].prng = streams[i];
+                work[i].numPoints = pointsPerThread;
+                pthread_create(&threads[i], NULL, MonteCarlo, &work[i]);
+            }
+            for(uint8_t i = 0; i < k; i++)
+                pthread_join(threads[i], NULL);
+            double elapsed = Now() - start;
+
+            for(uint8_t i = 0; i < k; i++)
+            {
+                hits += work[i].hits;
+                sum += work[i].sum;
+                if(work[i].hits != sequential[i].hits ||
+                    work[i].sum != sequential[i].sum)
+                {
+                    printf("  Stream %u does not match the sequential output!\n",
+                        i);
+                    failed = 1;
+                }
+            }
+
+            if(k == 1)
+                baseTime = elapsed;
+
+            printf("  %u thread(s): pi = %.6f  %.3f s  speedup %.2fx  "
+                "checksum %016llx\n", k, 4.0 * hits / (pointsPerThread * k),
+                elapsed, baseTime / elapsed, (unsigned long long)sum);
+        }
+    }
+    return failed;
+}
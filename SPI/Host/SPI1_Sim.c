@@ -0,0 +1,436 @@
+/***************************************************************************//**
+ * @brief Simulated SPI1 (Host)
+ * 
+ * @file SPI1_Sim.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A fake SPI1 master with FIFOs and a DMA controller for testing the SPI
+ * Manager on a PC. See SPI1_Sim.h for how to use it.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "SPI1_Sim.h"
+#include <stddef.h>
+
+// ***** Defines ***************************************************************
+
+
+// ***** Global Variables ******************************************************
+
+/* Assign functions to the interface */
+SPIInterface SPI1_FunctionTable = {
+    .SPI_Init = SPI1_Init,
+    .SPI_Enable = SPI1_Enable,
+    .SPI_Disable = SPI1_Disable,
+    .SPI_ReceivedDataEvent = SPI1_ReceivedDataEvent,
+    .SPI_GetReceivedByte = SPI1_GetReceivedByte,
+    .SPI_IsReceiveRegisterFull = SPI1_IsReceiveRegisterFull,
+    .SPI_TransmitRegisterEmptyEvent = SPI1_TransmitRegisterEmptyEvent,
+    .SPI_TransmitByte = SPI1_TransmitByte,
+    .SPI_IsTransmitRegisterEmpty = SPI1_IsTransmitRegisterEmpty,
+    .SPI_IsTransmitFinished = SPI1_IsTransmitFinished,
+    .SPI_GetStatus = SPI1_GetStatus,
+    .SPI_PendingEventHandler = SPI1_PendingEventHandler,
+    .SPI_SetTransmitRegisterEmptyCallback = SPI1_SetTransmitRegisterEmptyCallback,
+    .SPI_SetReceivedDataCallback = SPI1_SetReceivedDataCallback,
+    .SPI_SetSSPinFunc = SPI1_SetSSPinFunc,
+};
+
+SPIDMAInterface SPI1_DMA_FunctionTable = {
+    .SPI_DMA_StartTransfer = SPI1_DMA_StartTransfer,
+    .SPI_DMA_StopTransfer = SPI1_DMA_StopTransfer,
+    .SPI_DMA_GetAndClearEvents = SPI1_DMA_GetAndClearEvents,
+    .SPI_DMA_SetFillByte = SPI1_DMA_SetFillByte,
+};
+
+/* The SPI */
+static bool enabled;
+static uint8_t fifoSize = 4;
+static uint8_t txFifo[SPI1_SIM_MAX_FIFO], txHead, txCount;
+static uint8_t rxFifo[SPI1_SIM_MAX_FIFO], rxHead, rxCount;
+static uint8_t shiftRegister;
+static bool shifting;
+static uint32_t overruns;
+static bool useRxInterrupt, useTxInterrupt, txInterruptEnabled;
+
+/* The DMA */
+static const uint8_t *dmaTx;
+static uint8_t *dmaRx;
+static uint16_t dmaTxRemaining, dmaRxRemaining;
+static bool dmaRunning, dmaFinishedFlag;
+static uint8_t dmaFill;
+
+static uint8_t (*WireFunc)(uint8_t mosi);
+static void (*TransmitRegisterEmptyCallback)(void);
+static void (*ReceivedDataCallback)(uint8_t (*CallToGetData)(void));
+
+// ***** Static Function Prototypes ********************************************
+
+static void PushTx(uint8_t data);
+static void LoadShiftRegister(void);
+static void ServiceDMA(void);
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Simulation Functions ************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void SPI1_Sim_SetFIFOSize(uint8_t size)
+{
+    if(size < 1)
+        size = 1;
+    else if(size > SPI1_SIM_MAX_FIFO)
+        size = SPI1_SIM_MAX_FIFO;
+
+    fifoSize = size;
+    txHead = txCount = rxHead = rxCount = 0;
+    shifting = false;
+    overruns = 0;
+}
+
+// *****************************************************************************
+
+void SPI1_Sim_SetWireFunc(uint8_t (*Function)(uint8_t mosi))
+{
+    WireFunc = Function;
+}
+
+// *****************************************************************************
+
+void SPI1_Sim_Tick(void)
+{
+    uint8_t miso = 0;
+
+    ServiceDMA();
+
+    if(enabled && shifting)
+    {
+        if(WireFunc != NULL)
+            miso = WireFunc(shiftRegister);
+
+        shifting = false;
+
+        if(rxCount < fifoSize)
+        {
+            rxFifo[(rxHead + rxCount) % fifoSize] = miso;
+            rxCount++;
+        }
+        else
+        {
+            overruns++;
+        }
+        LoadShiftRegister();
+    }
+
+    ServiceDMA();
+}
+
+// *****************************************************************************
+
+bool SPI1_Sim_IsInterruptPending(void)
+{
+    return dmaFinishedFlag;
+}
+
+// *****************************************************************************
+
+uint32_t SPI1_Sim_GetOverruns(void)
+{
+    return overruns;
+}
+
+// *****************************************************************************
+
+bool SPI1_Sim_IsSPIInterruptPending(void)
+{
+    /* Each flag only counts if its interrupt is turned on */
+    return (useRxInterrupt && rxCount > 0) ||
+        (txInterruptEnabled && txCount < fifoSize);
+}
+
+// *****************************************************************************
+
+void SPI1_Sim_SPIInterrupt(void)
+{
+    if(useRxInterrupt && rxCount > 0)
+        SPI1_ReceivedDataEvent();
+
+    if(txInterruptEnabled && txCount < fifoSize)
+        SPI1_TransmitRegisterEmptyEvent();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void SPI1_Init(SPIInitType *params)
+{
+    useRxInterrupt = params->useRxInterrupt;
+    useTxInterrupt = params->useTxInterrupt;
+    txInterruptEnabled = false;
+    enabled = true;
+}
+
+// *****************************************************************************
+
+void SPI1_Enable(void)
+{
+    enabled = true;
+}
+
+// *****************************************************************************
+
+void SPI1_Disable(void)
+{
+    enabled = false;
+}
+
+// *****************************************************************************
+
+void SPI1_ReceivedDataEvent(void)
+{
+    if(ReceivedDataCallback)
+        ReceivedDataCallback(SPI1_GetReceivedByte);
+}
+
+// *****************************************************************************
+
+uint8_t SPI1_GetReceivedByte(void)
+{
+    uint8_t data = 0;
+
+    if(rxCount > 0)
+    {
+        data = rxFifo[rxHead];
+        rxHead = (rxHead + 1) % fifoSize;
+        rxCount--;
+    }
+    return data;
+}
+
+// *****************************************************************************
+
+bool SPI1_IsReceiveRegisterFull(void)
+{
+    return rxCount > 0;
+}
+
+// *****************************************************************************
+
+void SPI1_TransmitRegisterEmptyEvent(void)
+{
+    /* Like the real one, the interrupt is turned off until the next byte */
+    txInterruptEnabled = false;
+
+    if(TransmitRegisterEmptyCallback)
+        TransmitRegisterEmptyCallback();
+}
+
+// *****************************************************************************
+
+void SPI1_TransmitByte(uint8_t data)
+{
+    PushTx(data);
+
+    if(useTxInterrupt)
+        txInterruptEnabled = true;
+}
+
+// *****************************************************************************
+
+bool SPI1_IsTransmitRegisterEmpty(void)
+{
+    return txCount < fifoSize;
+}
+
+// *****************************************************************************
+
+bool SPI1_IsTransmitFinished(void)
+{
+    return txCount == 0 && !shifting;
+}
+
+// *****************************************************************************
+
+SPIStatusBits SPI1_GetStatus(void)
+{
+    SPIStatusBits status = {0};
+
+    status.busy = shifting;
+    status.txEmpty = SPI1_IsTransmitRegisterEmpty();
+    status.rxNotEmpty = SPI1_IsReceiveRegisterFull();
+    status.overflow = (overruns > 0);
+
+    return status;
+}
+
+// *****************************************************************************
+
+void SPI1_PendingEventHandler(void)
+{
+    /* Nothing ever gets put off in the simulation */
+}
+
+// *****************************************************************************
+
+void SPI1_SetTransmitRegisterEmptyCallback(void (*Function)(void))
+{
+    TransmitRegisterEmptyCallback = Function;
+}
+
+// *****************************************************************************
+
+void SPI1_SetReceivedDataCallback(void (*Function)(uint8_t (*CallToGetData)(void)))
+{
+    ReceivedDataCallback = Function;
+}
+
+// *****************************************************************************
+
+void SPI1_SetSSPinFunc(void (*Function)(bool setPinHigh))
+{
+    /* The manager does the SS pins */
+    (void)Function;
+}
+
+// *****************************************************************************
+
+void SPI1_DMA_StartTransfer(const uint8_t *txData, uint8_t *rxData, uint16_t size)
+{
+    /* Like the real one, throw out anything old first */
+    rxHead = rxCount = 0;
+
+    dmaTx = txData;
+    dmaRx = rxData;
+    dmaTxRemaining = dmaRxRemaining = size;
+    dmaFinishedFlag = false;
+    dmaRunning = true;
+    ServiceDMA();
+}
+
+// *****************************************************************************
+
+void SPI1_DMA_StopTransfer(void)
+{
+    dmaRunning = false;
+    dmaFinishedFlag = false;
+}
+
+// *****************************************************************************
+
+uint8_t SPI1_DMA_GetAndClearEvents(void)
+{
+    uint8_t events = 0;
+
+    if(dmaFinishedFlag)
+    {
+        SPI1_DMA_StopTransfer();
+        events |= SPI_DMA_EVENT_FINISHED;
+    }
+    return events;
+}
+
+// *****************************************************************************
+
+void SPI1_DMA_SetFillByte(uint8_t fill)
+{
+    dmaFill = fill;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Put a byte in the Tx FIFO
+ * 
+ * Like the real thing, if the FIFO is already full the byte is lost.
+ * 
+ * @param data  the byte
+ */
+static void PushTx(uint8_t data)
+{
+    if(txCount < fifoSize)
+    {
+        txFifo[(txHead + txCount) % fifoSize] = data;
+        txCount++;
+    }
+    LoadShiftRegister();
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Start the next byte if the shift register is free
+ */
+static void LoadShiftRegister(void)
+{
+    if(enabled && !shifting && txCount > 0)
+    {
+        shiftRegister = txFifo[txHead];
+        txHead = (txHead + 1) % fifoSize;
+        txCount--;
+        shifting = true;
+    }
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Let the DMA move whatever it can
+ * 
+ * The receive channel empties the Rx FIFO and the transmit channel fills the
+ * Tx FIFO. A NULL array is the dummy byte, so nothing gets incremented. The
+ * dummy byte that goes out is the fill byte.
+ */
+static void ServiceDMA(void)
+{
+    uint8_t data;
+
+    if(!dmaRunning)
+        return;
+
+    while(dmaRxRemaining > 0 && rxCount > 0)
+    {
+        data = SPI1_GetReceivedByte();
+        if(dmaRx != NULL)
+            *dmaRx++ = data;
+        dmaRxRemaining--;
+    }
+
+    while(dmaTxRemaining > 0 && txCount < fifoSize)
+    {
+        data = dmaFill;
+        if(dmaTx != NULL)
+            data = *dmaTx++;
+        PushTx(data);
+        dmaTxRemaining--;
+    }
+
+    if(dmaRxRemaining == 0)
+    {
+        dmaRunning = false;
+        dmaFinishedFlag = true;
+    }
+}
+
+/*
+ End of File
+ */
@@ -0,0 +1,115 @@
+/***************************************************************************//**
+ * @brief Simulated SPI1 Header (Host)
+ * 
+ * @file SPI1_Sim.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A fake SPI1 master with FIFOs and a DMA controller for testing the SPI
+ * Manager on a PC. It implements SPI1.h and SPI1_DMA.h, so it stands in for
+ * SPI1_STM32G0.c and SPI1_DMA_STM32G0.c together.
+ * 
+ * The Tx and Rx FIFOs hold however many bytes you set with
+ * SPI1_Sim_SetFIFOSize. 4 is like the G0, 1 is like the F1's single data
+ * register. A byte goes into the shift register as soon as it's free. When a
+ * byte finishes shifting, the byte that came back goes in the Rx FIFO. If the
+ * Rx FIFO is already full, it's lost and the overrun count goes up.
+ * 
+ * The DMA works like the real one. The transmit channel puts bytes in the Tx
+ * FIFO whenever there's room, the receive channel takes them out of the Rx
+ * FIFO as soon as they come in, and when the receive count gets to zero the
+ * transfer complete flag is set.
+ * 
+ * Nothing happens on its own. Call SPI1_Sim_Tick for each byte time on the
+ * wire. What's on the other end of the wire is up to you. Your function gets
+ * each byte that goes out and returns the one that comes back. When
+ * SPI1_Sim_IsInterruptPending is true, call SPI_Manager_DMAInterruptHandler,
+ * whenever you want the interrupt to have happened.
+ * 
+ * The SPI's own interrupts work the same way. Turn them on with
+ * useRxInterrupt and useTxInterrupt when you call SPI_Init. When
+ * SPI1_Sim_IsSPIInterruptPending is true, call SPI1_Sim_SPIInterrupt
+ * whenever you want the interrupt to run. It calls the received data and
+ * transmit register empty events like the real SPI1 interrupt would. Like the
+ * real one, the transmit interrupt turns itself off after each event and back
+ * on with the next byte sent.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef SPI1_SIM_H
+#define SPI1_SIM_H
+
+#include "SPI1.h"
+#include "SPI1_DMA.h"
+
+// ***** Defines ***************************************************************
+
+#define SPI1_SIM_MAX_FIFO   8
+
+// ***** Function Prototypes ***************************************************
+
+/***************************************************************************//**
+ * @brief Set how many bytes each FIFO holds and empty them
+ * 
+ * @param size  1 to SPI1_SIM_MAX_FIFO
+ */
+void SPI1_Sim_SetFIFOSize(uint8_t size);
+
+/***************************************************************************//**
+ * @brief Set the function that's on the other end of the wire
+ * 
+ * @param Function  format: uint8_t SomeFunction(uint8_t mosi)  returns miso
+ */
+void SPI1_Sim_SetWireFunc(uint8_t (*Function)(uint8_t mosi));
+
+/***************************************************************************//**
+ * @brief One byte time on the wire
+ * 
+ * The byte in the shift register goes out and the one that comes back goes in
+ * the Rx FIFO. Then the next byte starts. The DMA gets its turn before and
+ * after.
+ */
+void SPI1_Sim_Tick(void);
+
+/***************************************************************************//**
+ * @brief Check if the DMA receive channel's interrupt flag is set
+ * 
+ * @return true if SPI_Manager_DMAInterruptHandler should be called
+ */
+bool SPI1_Sim_IsInterruptPending(void);
+
+/***************************************************************************//**
+ * @brief How many bytes were lost because the Rx FIFO was full
+ * 
+ * @return uint32_t  count
+ */
+uint32_t SPI1_Sim_GetOverruns(void);
+
+/***************************************************************************//**
+ * @brief Check if the SPI's receive or transmit interrupt would go off
+ * 
+ * @return true if SPI1_Sim_SPIInterrupt should be called
+ */
+bool SPI1_Sim_IsSPIInterruptPending(void);
+
+/***************************************************************************//**
+ * @brief Run the SPI1 interrupt
+ * 
+ * Calls SPI1_ReceivedDataEvent if there's a byte in the Rx FIFO, then
+ * SPI1_TransmitRegisterEmptyEvent if the Tx interrupt is on and there's room.
+ * Only for the interrupts that were turned on with SPI_Init.
+ */
+void SPI1_Sim_SPIInterrupt(void);
+
+#endif  /* SPI1_SIM_H */
@@ -0,0 +1,394 @@
+/* Program to test the SPI Manager's interrupt mode - MS */
+
+/* Build from the SPI/Host folder with:
+gcc -std=c99 -I. -I"../Interface and Generic Manager" -I../STM32
+TestSPIInterrupt.c SPI1_Sim.c "../Interface and Generic Manager/ISPI.c"
+"../Interface and Generic Manager/SPI_Manager.c"
+
+SPI_Manager_Process is never called in this program. Everything has to be
+moved by the SPI's receive and transmit interrupts, which get there a set
+number of byte times after their flag goes up, plus a random amount. Zero
+means the interrupt is done before the next byte finishes.
+
+Three slaves share SPI1. First they all keep the bus busy. Each one has two
+transactions that queue themselves again from their finished callbacks,
+until 200 each have gone out. That shows how close to wire speed it gets.
+Then the bus is left alone most of the time, and a transaction gets queued
+every so often from the "main loop". Nothing is polling, so the queue has to
+start it right then.
+
+It's run with FIFOs like the G0 (4 bytes) and the F1 (1 byte), with and
+without the transmit interrupt, and with slow interrupts. With a 4 byte FIFO
+the interrupt can be a few bytes late and the wire never stops. With the F1's
+single register and a depth of 1, every byte waits on the interrupt. A depth
+of 2 fixes that, but only if the interrupt is never late, or the Rx register
+overflows. The other end of the wire checks every byte like TestSPIPriority
+does. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SPI1_Sim.h"
+#include "SPI_Manager.h"
+
+#define NUM_SLAVES      3
+#define JOBS_PER_SLAVE  2
+#define BUSY_COUNT      200
+#define QUIET_COUNT     300
+#define MAX_LENGTH      80
+#define WIRE_SIZE       (MAX_LENGTH + 16)
+#define MAX_TICKS       10000000UL
+
+/* A transaction with the stuff the test needs to check it. The transaction
+goes first so the callback can get back to the rest. */
+typedef struct JobTag
+{
+    SPITransaction transaction;
+    int slave;
+    uint32_t sequence;
+    uint32_t queuedAt;
+    bool queuedIdle;
+    bool pending;
+    uint8_t writeBuffer[MAX_LENGTH];
+    uint8_t readBuffer[MAX_LENGTH];
+} Job;
+
+static SPI spi;
+static SPIManager manager;
+static SPISlave slaves[NUM_SLAVES];
+static Job jobs[NUM_SLAVES][JOBS_PER_SLAVE];
+static uint32_t ticks, selectedAt;
+static bool busyPhase;
+
+/* The other end of the wire */
+static int selected;
+static uint8_t wireBytes[WIRE_SIZE];
+static uint16_t wireIndex;
+static uint32_t strayBytes, ssErrors;
+
+/* Results */
+static uint32_t queuedSequence[NUM_SLAVES], finishedSequence[NUM_SLAVES];
+static uint32_t finished[NUM_SLAVES], orderErrors, dataErrors, extraCallbacks;
+static uint32_t bytesMoved, busyBytes, interrupts, worstStart;
+
+bool QueueJob(Job *job);
+
+// ***** Callbacks *************************************************************
+
+void SetSSPin(bool setPinHigh, void *slaveContext)
+{
+    int id = (int)((SPISlave *)slaveContext - slaves) + 1;
+
+    if(!setPinHigh)
+    {
+        /* Only one at a time */
+        if(selected != 0)
+            ssErrors++;
+        selected = id;
+        selectedAt = ticks;
+        wireIndex = 0;
+    }
+    else if(selected == id)
+    {
+        selected = 0;
+    }
+    else
+    {
+        ssErrors++;
+    }
+}
+
+uint8_t Expected(int id, uint16_t index)
+{
+    return (uint8_t)(id * 53 + index * 13);
+}
+
+uint8_t Wire(uint8_t mosi)
+{
+    uint8_t miso;
+
+    if(selected == 0)
+    {
+        strayBytes++;
+        return 0xFF;
+    }
+
+    miso = Expected(selected, wireIndex);
+    if(wireIndex < WIRE_SIZE)
+        wireBytes[wireIndex] = mosi;
+    wireIndex++;
+    return miso;
+}
+
+/* The two small functions that go between the SPI and the manager */
+void SPI1TxCallback(void)
+{
+    SPI_Manager_TransmitEvent(&manager);
+}
+
+void SPI1RxCallback(uint8_t (*CallToGetData)(void))
+{
+    SPI_Manager_ReceiveEvent(&manager, CallToGetData);
+}
+
+void Finished(SPITransaction *transaction)
+{
+    Job *job = (Job *)transaction;
+    uint16_t length = transaction->numBytesToSend;
+    uint8_t data;
+
+    if(!job->pending)
+    {
+        extraCallbacks++;
+        return;
+    }
+    job->pending = false;
+    finished[job->slave]++;
+
+    if(job->sequence != finishedSequence[job->slave]++)
+        orderErrors++;
+
+    /* The SS line is already high, so what's on the wire is all this one */
+    if(transaction->numBytesToRead > length)
+        length = transaction->numBytesToRead;
+
+    if(wireIndex != length || !SPI_Manager_IsTransactionFinished(transaction))
+        dataErrors++;
+
+    for(uint16_t i = 0; i < length && i < WIRE_SIZE; i++)
+    {
+        data = (i < transaction->numBytesToSend) ? transaction->writeBuffer[i] : 0;
+        if(wireBytes[i] != data)
+            dataErrors++;
+
+        if(i < transaction->numBytesToRead &&
+            transaction->readBuffer[i] != Expected(job->slave + 1, i))
+            dataErrors++;
+    }
+    bytesMoved += length;
+
+    if(busyPhase)
+    {
+        /* Keep the bus busy from right here */
+        if(queuedSequence[job->slave] < BUSY_COUNT)
+            QueueJob(job);
+    }
+    else if(job->queuedIdle && selectedAt - job->queuedAt > worstStart)
+    {
+        worstStart = selectedAt - job->queuedAt;
+    }
+}
+
+// *****************************************************************************
+
+bool QueueJob(Job *job)
+{
+    SPITransaction *transaction = &job->transaction;
+    uint16_t numToSend, numToRead;
+
+    /* Don't touch one that's still in line */
+    if(job->pending)
+        return false;
+
+    numToSend = rand() % (MAX_LENGTH + 1);
+    numToRead = rand() % (MAX_LENGTH + 1);
+    if(numToSend == 0 && numToRead == 0)
+        numToRead = 1;
+
+    for(uint16_t i = 0; i < numToSend; i++)
+        job->writeBuffer[i] = (uint8_t)rand();
+
+    SPI_Manager_InitTransaction(transaction, job->writeBuffer, numToSend,
+        job->readBuffer, numToRead);
+    SPI_Manager_SetTransactionCallback(transaction, Finished);
+
+    job->sequence = queuedSequence[job->slave];
+    job->queuedAt = ticks;
+    job->queuedIdle = (selected == 0);
+    job->pending = true;
+
+    if(!SPI_Manager_Queue(&slaves[job->slave], transaction))
+    {
+        job->pending = false;
+        return false;
+    }
+    queuedSequence[job->slave]++;
+    return true;
+}
+
+bool AllFinished(uint32_t count)
+{
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        if(finished[k] < count || SPI_Manager_IsDeviceBusy(&slaves[k]))
+            return false;
+    }
+    return true;
+}
+
+// *****************************************************************************
+
+/* One byte time. The interrupt runs when its countdown gets to zero. With no
+delay it keeps running as long as there's something to do, like it would
+on a real micro. */
+void Tick(uint8_t delay, uint8_t jitter)
+{
+    static int countdown = -1;
+    int runs = 0;
+
+    SPI1_Sim_Tick();
+
+    while(SPI1_Sim_IsSPIInterruptPending() && runs < 8)
+    {
+        if(countdown < 0)
+            countdown = delay + rand() % (jitter + 1);
+
+        if(countdown > 0)
+        {
+            countdown--;
+            break;
+        }
+        countdown = -1;
+        SPI1_Sim_SPIInterrupt();
+        interrupts++;
+        runs++;
+    }
+    ticks++;
+}
+
+/* Returns the number of byte times it took while the bus was busy */
+uint32_t Run(uint8_t fifoSize, uint8_t fifoDepth, bool useTxInterrupt,
+    uint8_t delay, uint8_t jitter)
+{
+    SPIInitType params;
+    uint32_t busyTicks, nextQueue;
+
+    SPI1_Sim_SetFIFOSize(fifoSize);
+    SPI1_Sim_SetWireFunc(Wire);
+    SPI_Create(&spi, &SPI1_FunctionTable);
+    SPI_SetInitTypeToDefaultParams(&params);
+    params.useRxInterrupt = true;
+    params.useTxInterrupt = useTxInterrupt;
+    SPI_Init(&spi, &params);
+    SPI_SetTransmitRegisterEmptyCallback(&spi, SPI1TxCallback);
+    SPI_SetReceivedDataCallback(&spi, SPI1RxCallback);
+
+    SPI_Manager_Create(&manager, &spi);
+    SPI_Manager_SetMode(&manager, SPI_MANAGER_MODE_INTERRUPT);
+    SPI_Manager_SetFIFODepth(&manager, fifoDepth);
+
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        SPI_Manager_AddSlave(&manager, &slaves[k], NULL, NULL);
+        SPI_Manager_SetSSPinFunc(&slaves[k], SetSSPin);
+        queuedSequence[k] = finishedSequence[k] = finished[k] = 0;
+
+        for(int j = 0; j < JOBS_PER_SLAVE; j++)
+        {
+            memset(&jobs[k][j], 0, sizeof(Job));
+            jobs[k][j].slave = k;
+        }
+    }
+    SPI_Manager_Enable(&manager);
+
+    selected = 0;
+    ticks = 0;
+    strayBytes = ssErrors = orderErrors = dataErrors = extraCallbacks = 0;
+    bytesMoved = interrupts = worstStart = 0;
+    srand(1);
+
+    /* Busy. After these are queued the main loop does nothing at all. */
+    busyPhase = true;
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        for(int j = 0; j < JOBS_PER_SLAVE; j++)
+            QueueJob(&jobs[k][j]);
+    }
+
+    while(!AllFinished(BUSY_COUNT) && ticks < MAX_TICKS)
+        Tick(delay, jitter);
+
+    busyTicks = ticks;
+    busyBytes = bytesMoved;
+
+    /* Quiet */
+    busyPhase = false;
+    nextQueue = ticks + 100;
+    while(!AllFinished(BUSY_COUNT + QUIET_COUNT) && ticks < MAX_TICKS)
+    {
+        if(ticks >= nextQueue)
+        {
+            int k = rand() % NUM_SLAVES;
+            if(queuedSequence[k] < BUSY_COUNT + QUIET_COUNT)
+                QueueJob(&jobs[k][0]);
+            nextQueue = ticks + 100 + rand() % 400;
+        }
+        Tick(delay, jitter);
+    }
+    return busyTicks;
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const struct {
+        const char *name;
+        uint8_t fifoSize;
+        uint8_t fifoDepth;
+        bool useTxInterrupt;
+        uint8_t delay;
+        uint8_t jitter;
+        double mostPerByte;
+    } runs[] = {
+        { "4 byte FIFO, Rx interrupt", 4, 4, false, 0, 0, 1.05 },
+        { "4 byte FIFO, Rx and Tx, 1 to 3 bytes late", 4, 4, true, 1, 2, 1.10 },
+        { "1 byte FIFO, Rx interrupt, 1 byte late", 1, 1, false, 1, 0, 2.10 },
+        { "1 byte FIFO, depth 2, Rx and Tx interrupts", 1, 2, true, 0, 0, 1.05 },
+    };
+    uint32_t numRuns = sizeof(runs) / sizeof(runs[0]);
+    uint32_t busyTicks;
+    int failed = 0;
+    char line[80];
+
+    for(uint32_t r = 0; r < numRuns; r++)
+    {
+        busyTicks = Run(runs[r].fifoSize, runs[r].fifoDepth,
+            runs[r].useTxInterrupt, runs[r].delay, runs[r].jitter);
+
+        printf("%s\n", runs[r].name);
+        printf("  %u bytes, %.2f byte times per byte when busy, "
+            "%.2f interrupts per byte\n", bytesMoved,
+            (double)busyTicks / busyBytes, (double)interrupts / bytesMoved);
+        printf("  When quiet, SS went low %u byte times after queueing\n",
+            worstStart);
+
+        failed += Check("Everything queued finished, with no polling",
+            AllFinished(BUSY_COUNT + QUIET_COUNT) &&
+            finished[0] == queuedSequence[0] &&
+            finished[1] == queuedSequence[1] &&
+            finished[2] == queuedSequence[2]);
+        failed += Check("Each callback once, in the order queued",
+            extraCallbacks == 0 && orderErrors == 0);
+        failed += Check("Every byte out and back right",
+            dataErrors == 0 && SPI1_Sim_GetOverruns() == 0);
+        failed += Check("One slave at a time, no bytes with none selected",
+            strayBytes == 0 && ssErrors == 0);
+
+        sprintf(line, "At most %.2f byte times per byte when busy",
+            runs[r].mostPerByte);
+        failed += Check(line,
+            busyTicks <= busyBytes * runs[r].mostPerByte);
+
+        /* Queue starts it. Nothing has to come around and notice. */
+        failed += Check("Starts right away when the bus is free",
+            worstStart == 0);
+    }
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
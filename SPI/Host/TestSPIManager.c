@@ -0,0 +1,305 @@
+/* Program to test the SPI Manager's byte, burst, and DMA modes - MS */
+
+/* Build from the SPI/Host folder with:
+gcc -std=c99 -I. -I"../Interface and Generic Manager" -I../STM32
+TestSPIManager.c SPI1_Sim.c "../Interface and Generic Manager/ISPI.c"
+"../Interface and Generic Manager/SPI_Manager.c"
+
+Three slaves share SPI1. A display that only gets written to, a sensor that
+gets a short command and then sends back more than that, and a flash chip
+where the number of bytes to send and read is anything at all. Every round,
+each one gets a transfer with random lengths and random data. The same
+rounds are run in byte mode, in burst mode, and with the DMA, with FIFOs
+like the G0 (4 bytes) and like the F1 (1 byte).
+
+The other end of the wire keeps a log for each slave of when it was selected
+and every byte it saw, and sends back bytes that depend on what it got. The
+read buffers get added to the logs after each round. Every mode has to make
+the exact same logs as byte mode. The order the slaves get their turns can be
+different, since that depends on how long things take. No bytes can go out
+with no slave selected, and the Rx FIFO can never overflow.
+
+The main loop is slow. Four byte times go by on the wire each time around,
+so the wire time it takes shows how much each mode gets out of every call to
+SPI_Manager_Process. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SPI1_Sim.h"
+#include "SPI_Manager.h"
+
+#define NUM_ROUNDS      200
+#define NUM_SLAVES      3
+#define BUFFER_SIZE     300
+#define LOG_SIZE        200000UL
+#define TICKS_PER_LOOP  4
+#define SS_MARK         0xA0
+#define FILL_BYTE       0xEE
+
+static SPI spi;
+static SPIManager manager;
+static SPISlave slaves[NUM_SLAVES];
+static uint8_t writeBuffers[NUM_SLAVES][BUFFER_SIZE];
+static uint8_t readBuffers[NUM_SLAVES][BUFFER_SIZE];
+static uint16_t numToSend[NUM_SLAVES];
+static uint16_t numToRead[NUM_SLAVES];
+
+/* The other end of the wire */
+static int selected;
+static uint16_t wireIndex;
+static uint8_t lastMosi;
+static uint32_t strayBytes, ssErrors;
+
+static uint8_t logBytes[NUM_SLAVES][LOG_SIZE], byteModeLog[NUM_SLAVES][LOG_SIZE];
+static uint32_t logLength[NUM_SLAVES], byteModeLength[NUM_SLAVES];
+
+// ***** Callbacks *************************************************************
+
+void SetSSPin(bool setPinHigh, void *slaveContext)
+{
+    int id = (int)((SPISlave *)slaveContext - slaves) + 1;
+
+    if(!setPinHigh)
+    {
+        /* Only one at a time */
+        if(selected != 0)
+            ssErrors++;
+        selected = id;
+        wireIndex = 0;
+        lastMosi = 0;
+    }
+    else if(selected == id)
+    {
+        selected = 0;
+    }
+    else
+    {
+        ssErrors++;
+    }
+
+    if(logLength[id - 1] < LOG_SIZE)
+        logBytes[id - 1][logLength[id - 1]++] = SS_MARK | (setPinHigh ? 0x10 : 0);
+}
+
+uint8_t Wire(uint8_t mosi)
+{
+    uint8_t miso;
+
+    if(selected == 0)
+    {
+        strayBytes++;
+        return 0xFF;
+    }
+
+    if(logLength[selected - 1] < LOG_SIZE)
+        logBytes[selected - 1][logLength[selected - 1]++] = mosi;
+
+    /* Something that depends on the slave, where we are, and what came
+    before, so that anything out of order shows up */
+    miso = (uint8_t)(selected * 37 + wireIndex * 11) ^ lastMosi;
+    wireIndex++;
+    lastMosi = mosi;
+    return miso;
+}
+
+// *****************************************************************************
+
+void StartRound(void)
+{
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        switch(k)
+        {
+            case 0: // display
+                numToSend[k] = 1 + rand() % BUFFER_SIZE;
+                numToRead[k] = 0;
+                break;
+            case 1: // sensor
+                numToSend[k] = 1 + rand() % 2;
+                numToRead[k] = numToSend[k] + 1 + rand() % 32;
+                break;
+            default: // flash
+                numToSend[k] = rand() % 80;
+                numToRead[k] = rand() % 80;
+                if(numToSend[k] == 0 && numToRead[k] == 0)
+                    numToRead[k] = 1;
+                break;
+        }
+
+        for(uint16_t i = 0; i < numToSend[k]; i++)
+            writeBuffers[k][i] = (uint8_t)rand();
+        memset(readBuffers[k], FILL_BYTE, BUFFER_SIZE);
+
+        SPI_Manager_BeginTransfer(&slaves[k], numToSend[k], numToRead[k]);
+    }
+}
+
+bool AllFinished(void)
+{
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        if(!SPI_Manager_IsTransferFinished(&slaves[k]))
+            return false;
+    }
+    return true;
+}
+
+bool LogsMatch(void)
+{
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        if(logLength[k] != byteModeLength[k] ||
+            memcmp(logBytes[k], byteModeLog[k], logLength[k]) != 0)
+            return false;
+    }
+    return true;
+}
+
+/* Returns the number of byte times on the wire */
+uint32_t Run(SPIManagerMode mode, uint8_t fifoSize, uint8_t fifoDepth,
+    uint32_t *interrupts, uint32_t *bytes)
+{
+    uint32_t ticks = 0;
+
+    SPI1_Sim_SetFIFOSize(fifoSize);
+    SPI1_Sim_SetWireFunc(Wire);
+    SPI_Create(&spi, &SPI1_FunctionTable);
+    SPI_Manager_Create(&manager, &spi);
+    SPI_Manager_SetMode(&manager, mode);
+    SPI_Manager_SetFIFODepth(&manager, fifoDepth);
+    SPI_Manager_SetDMAInterface(&manager, &SPI1_DMA_FunctionTable);
+
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        SPI_Manager_AddSlave(&manager, &slaves[k], writeBuffers[k],
+            readBuffers[k]);
+        SPI_Manager_SetSSPinFunc(&slaves[k], SetSSPin);
+    }
+    SPI_Manager_Enable(&manager);
+
+    selected = 0;
+    strayBytes = ssErrors = 0;
+    memset(logLength, 0, sizeof(logLength));
+    *interrupts = *bytes = 0;
+
+    srand(1);
+    for(uint32_t round = 0; round < NUM_ROUNDS; round++)
+    {
+        StartRound();
+        for(int k = 0; k < NUM_SLAVES; k++)
+        {
+            uint16_t n = numToSend[k];
+            *bytes += (n > numToRead[k]) ? n : numToRead[k];
+        }
+
+        while(!AllFinished() && ticks < 100000000UL)
+        {
+            SPI_Manager_Process(&manager);
+            for(int t = 0; t < TICKS_PER_LOOP; t++)
+            {
+                SPI1_Sim_Tick();
+                if(SPI1_Sim_IsInterruptPending())
+                {
+                    (*interrupts)++;
+                    SPI_Manager_DMAInterruptHandler(&manager);
+                }
+                ticks++;
+            }
+        }
+
+        /* What came back. Including the part that wasn't supposed to be
+        written, which should still be the fill byte. */
+        for(int k = 0; k < NUM_SLAVES; k++)
+        {
+            uint16_t n = numToRead[k] + 1;
+            if(logLength[k] + n < LOG_SIZE)
+            {
+                memcpy(&logBytes[k][logLength[k]], readBuffers[k], n);
+                logLength[k] += n;
+            }
+        }
+    }
+    return ticks;
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const struct {
+        const char *name;
+        SPIManagerMode mode;
+        uint8_t fifoSize;
+        uint8_t fifoDepth;
+    } runs[] = {
+        { "Byte, 4 byte FIFO", SPI_MANAGER_MODE_BYTE, 4, 1 },
+        { "Burst, 4 byte FIFO", SPI_MANAGER_MODE_BURST, 4, 4 },
+        { "DMA, 4 byte FIFO", SPI_MANAGER_MODE_DMA, 4, 1 },
+        { "Byte, 1 byte FIFO", SPI_MANAGER_MODE_BYTE, 1, 1 },
+        { "Burst, 1 byte FIFO", SPI_MANAGER_MODE_BURST, 1, 1 },
+        { "DMA, 1 byte FIFO", SPI_MANAGER_MODE_DMA, 1, 1 },
+    };
+    uint32_t ticks, interrupts, bytes, byteModeTicks = 0;
+    uint32_t numRuns = sizeof(runs) / sizeof(runs[0]);
+    int failed = 0;
+    char line[80];
+
+    for(uint32_t r = 0; r < numRuns; r++)
+    {
+        ticks = Run(runs[r].mode, runs[r].fifoSize, runs[r].fifoDepth,
+            &interrupts, &bytes);
+
+        printf("%s\n", runs[r].name);
+        printf("  %u bytes, %u byte times (%.2f per byte), %u interrupts\n",
+            bytes, ticks, (double)ticks / bytes, interrupts);
+
+        if(r == 0)
+        {
+            memcpy(byteModeLog, logBytes, sizeof(logBytes));
+            memcpy(byteModeLength, logLength, sizeof(logLength));
+            byteModeTicks = ticks;
+            failed += Check("Every transfer finished, logs fit",
+                AllFinished() && logLength[0] < LOG_SIZE - BUFFER_SIZE);
+        }
+        else
+        {
+            failed += Check("Same bytes out and back as byte mode",
+                LogsMatch());
+        }
+
+        failed += Check("One slave at a time, no bytes with none selected",
+            strayBytes == 0 && ssErrors == 0);
+        failed += Check("The Rx FIFO never overflowed",
+            SPI1_Sim_GetOverruns() == 0);
+
+        if(runs[r].mode == SPI_MANAGER_MODE_BURST)
+        {
+            /* Byte mode takes two loops for every byte. Burst moves up to
+            the FIFO depth each loop. */
+            sprintf(line, "At least %ux faster than byte mode",
+                2 * runs[r].fifoDepth);
+            failed += Check(line,
+                ticks * 2 * runs[r].fifoDepth <= byteModeTicks + byteModeTicks / 10);
+        }
+
+        if(runs[r].mode == SPI_MANAGER_MODE_DMA)
+        {
+            /* One interrupt for each transfer, and a second one for flash
+            transfers where send and read are different and neither is
+            zero. The sensor always reads more than it sends. */
+            failed += Check("One or two interrupts per transfer",
+                interrupts >= NUM_ROUNDS * NUM_SLAVES &&
+                interrupts <= NUM_ROUNDS * (NUM_SLAVES + 2));
+            failed += Check("Wire busy almost all the time",
+                ticks < bytes + bytes / 10);
+        }
+    }
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,398 @@
+/* Program to test the SPI Manager's transaction queues and priorities - MS */
+
+/* Build from the SPI/Host folder with:
+gcc -std=c99 -I. -I"../Interface and Generic Manager" -I../STM32
+TestSPIPriority.c SPI1_Sim.c "../Interface and Generic Manager/ISPI.c"
+"../Interface and Generic Manager/SPI_Manager.c"
+
+Three slaves share SPI1, like a typical board. An IMU that has to be read
+quickly whenever its data ready line goes off, a flash chip that gets random
+reads and writes now and then, and a display that gets flushed over and over
+as fast as it can go. The display flush is cut up into 256 byte transactions.
+Each one queues the next from its finished callback.
+
+The IMU gets the highest priority (0), then the flash (1), then the display
+(2). A transaction that has started is never cut off, so the worst the IMU
+should ever have to wait is one display chunk plus its own read. That gets
+checked in burst mode and with the DMA. Then it's all run again with every
+slave at the same priority to show the difference.
+
+The other end of the wire saves every byte it sees while a slave is selected
+and sends back bytes that depend on where it is. Each finished callback
+checks that its transaction went out and came back right, that it came in
+the order it was queued for that slave, and that it was only called once. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SPI1_Sim.h"
+#include "SPI_Manager.h"
+
+#define NUM_TICKS       2000000UL
+#define TICKS_PER_LOOP  4
+#define IMU             0
+#define FLASH           1
+#define DISPLAY         2
+#define NUM_SLAVES      3
+#define IMU_SEND        1
+#define IMU_READ        14
+#define FLASH_JOBS      4
+#define FLASH_MAX       128
+#define DISPLAY_CHUNK   256
+#define DISPLAY_FRAME   (DISPLAY_CHUNK * 16)
+#define WIRE_SIZE       (DISPLAY_CHUNK + 16)
+
+/* A transaction with the stuff the test needs to check it. The transaction
+goes first so the callback can get back to the rest. */
+typedef struct JobTag
+{
+    SPITransaction transaction;
+    int slave;
+    uint32_t sequence;
+    uint32_t queuedAt;
+    bool pending;
+    uint8_t writeBuffer[FLASH_MAX];
+    uint8_t readBuffer[FLASH_MAX];
+} Job;
+
+static SPI spi;
+static SPIManager manager;
+static SPISlave slaves[NUM_SLAVES];
+static Job imuJob, displayJob, flashJobs[FLASH_JOBS];
+static uint8_t frame[DISPLAY_FRAME];
+static uint32_t frameOffset, framesDone;
+static bool stopping;
+static uint32_t ticks;
+
+/* The other end of the wire */
+static int selected;
+static uint8_t wireBytes[WIRE_SIZE];
+static uint16_t wireIndex;
+static uint32_t strayBytes, ssErrors;
+
+/* Results */
+static uint32_t queuedSequence[NUM_SLAVES], finishedSequence[NUM_SLAVES];
+static uint32_t finished[NUM_SLAVES], orderErrors, dataErrors, extraCallbacks;
+static uint32_t imuWorst, imuTotal, doubleQueues, doubleQueuesRejected;
+
+bool QueueJob(Job *job, const uint8_t *writeBuffer, uint16_t numBytesToSend,
+    uint8_t *readBuffer, uint16_t numBytesToRead);
+
+// ***** Callbacks *************************************************************
+
+void SetSSPin(bool setPinHigh, void *slaveContext)
+{
+    int id = (int)((SPISlave *)slaveContext - slaves) + 1;
+
+    if(!setPinHigh)
+    {
+        /* Only one at a time */
+        if(selected != 0)
+            ssErrors++;
+        selected = id;
+        wireIndex = 0;
+    }
+    else if(selected == id)
+    {
+        selected = 0;
+    }
+    else
+    {
+        ssErrors++;
+    }
+}
+
+uint8_t Expected(int id, uint16_t index)
+{
+    return (uint8_t)(id * 37 + index * 11);
+}
+
+uint8_t Wire(uint8_t mosi)
+{
+    uint8_t miso;
+
+    if(selected == 0)
+    {
+        strayBytes++;
+        return 0xFF;
+    }
+
+    miso = Expected(selected, wireIndex);
+    if(wireIndex < WIRE_SIZE)
+        wireBytes[wireIndex] = mosi;
+    wireIndex++;
+    return miso;
+}
+
+void Finished(SPITransaction *transaction)
+{
+    Job *job = (Job *)transaction;
+    uint16_t length = transaction->numBytesToSend;
+    uint8_t data;
+
+    if(!job->pending)
+    {
+        extraCallbacks++;
+        return;
+    }
+    job->pending = false;
+    finished[job->slave]++;
+
+    if(job->sequence != finishedSequence[job->slave]++)
+        orderErrors++;
+
+    /* The SS line is already high, so what's on the wire is all this one */
+    if(transaction->numBytesToRead > length)
+        length = transaction->numBytesToRead;
+
+    if(wireIndex != length || !SPI_Manager_IsTransactionFinished(transaction))
+        dataErrors++;
+
+    for(uint16_t i = 0; i < length && i < WIRE_SIZE; i++)
+    {
+        data = (i < transaction->numBytesToSend) ? transaction->writeBuffer[i] : 0;
+        if(wireBytes[i] != data)
+            dataErrors++;
+
+        if(i < transaction->numBytesToRead &&
+            transaction->readBuffer[i] != Expected(job->slave + 1, i))
+            dataErrors++;
+    }
+
+    if(job->slave == IMU)
+    {
+        uint32_t latency = ticks - job->queuedAt;
+        imuTotal += latency;
+        if(latency > imuWorst)
+            imuWorst = latency;
+    }
+    else if(job->slave == DISPLAY)
+    {
+        /* Keep the flush going from right here */
+        frameOffset += DISPLAY_CHUNK;
+        if(frameOffset >= DISPLAY_FRAME)
+        {
+            frameOffset = 0;
+            framesDone++;
+        }
+
+        if(!stopping)
+            QueueJob(job, &frame[frameOffset], DISPLAY_CHUNK, NULL, 0);
+    }
+}
+
+// *****************************************************************************
+
+bool QueueJob(Job *job, const uint8_t *writeBuffer, uint16_t numBytesToSend,
+    uint8_t *readBuffer, uint16_t numBytesToRead)
+{
+    SPITransaction *transaction = &job->transaction;
+
+    /* Don't touch one that's still in line */
+    if(job->pending)
+        return false;
+
+    SPI_Manager_InitTransaction(transaction, writeBuffer, numBytesToSend,
+        readBuffer, numBytesToRead);
+    SPI_Manager_SetTransactionCallback(transaction, Finished);
+
+    job->sequence = queuedSequence[job->slave];
+    job->queuedAt = ticks;
+    job->pending = true;
+
+    if(!SPI_Manager_Queue(&slaves[job->slave], transaction))
+    {
+        job->pending = false;
+        return false;
+    }
+    queuedSequence[job->slave]++;
+
+    /* Putting the same one in line twice has to fail */
+    doubleQueues++;
+    if(!SPI_Manager_Queue(&slaves[job->slave], transaction))
+        doubleQueuesRejected++;
+
+    return true;
+}
+
+/* The IMU's data ready interrupt */
+void DataReady(void)
+{
+    static const uint8_t readCommand[IMU_SEND] = { 0xBB };
+
+    /* If it's still waiting on the last one, this one gets skipped */
+    QueueJob(&imuJob, readCommand, IMU_SEND, imuJob.readBuffer, IMU_READ);
+}
+
+void FlashRequest(void)
+{
+    for(int j = 0; j < FLASH_JOBS; j++)
+    {
+        Job *job = &flashJobs[j];
+        uint16_t numToSend, numToRead;
+
+        if(job->pending)
+            continue;
+
+        numToSend = rand() % (FLASH_MAX + 1);
+        numToRead = rand() % (FLASH_MAX + 1);
+        if(numToSend == 0 && numToRead == 0)
+            numToRead = 1;
+
+        for(uint16_t i = 0; i < numToSend; i++)
+            job->writeBuffer[i] = (uint8_t)rand();
+
+        QueueJob(job, job->writeBuffer, numToSend, job->readBuffer, numToRead);
+        return;
+    }
+}
+
+// *****************************************************************************
+
+void Run(SPIManagerMode mode, bool usePriorities)
+{
+    uint32_t nextDataReady = 500, nextFlash = 300;
+
+    SPI1_Sim_SetFIFOSize(4);
+    SPI1_Sim_SetWireFunc(Wire);
+    SPI_Create(&spi, &SPI1_FunctionTable);
+    SPI_Manager_Create(&manager, &spi);
+    SPI_Manager_SetMode(&manager, mode);
+    SPI_Manager_SetFIFODepth(&manager, 4);
+    SPI_Manager_SetDMAInterface(&manager, &SPI1_DMA_FunctionTable);
+
+    for(int k = 0; k < NUM_SLAVES; k++)
+    {
+        SPI_Manager_AddSlave(&manager, &slaves[k], NULL, NULL);
+        SPI_Manager_SetSSPinFunc(&slaves[k], SetSSPin);
+        SPI_Manager_SetSlavePriority(&slaves[k], usePriorities ? k : 0);
+        queuedSequence[k] = finishedSequence[k] = finished[k] = 0;
+    }
+    SPI_Manager_Enable(&manager);
+
+    memset(&imuJob, 0, sizeof(imuJob));
+    memset(&displayJob, 0, sizeof(displayJob));
+    memset(flashJobs, 0, sizeof(flashJobs));
+    imuJob.slave = IMU;
+    displayJob.slave = DISPLAY;
+    for(int j = 0; j < FLASH_JOBS; j++)
+        flashJobs[j].slave = FLASH;
+
+    for(uint32_t i = 0; i < DISPLAY_FRAME; i++)
+        frame[i] = (uint8_t)(i * 7);
+
+    selected = 0;
+    ticks = 0;
+    stopping = false;
+    frameOffset = framesDone = 0;
+    strayBytes = ssErrors = orderErrors = dataErrors = extraCallbacks = 0;
+    imuWorst = imuTotal = doubleQueues = doubleQueuesRejected = 0;
+
+    srand(1);
+    QueueJob(&displayJob, &frame[0], DISPLAY_CHUNK, NULL, 0);
+
+    /* Stop making new requests at the end and let everything drain */
+    while(ticks < NUM_TICKS || SPI_Manager_IsDeviceBusy(&slaves[IMU]) ||
+        SPI_Manager_IsDeviceBusy(&slaves[FLASH]) ||
+        SPI_Manager_IsDeviceBusy(&slaves[DISPLAY]))
+    {
+        if(ticks >= NUM_TICKS * 2)
+            break;
+
+        stopping = (ticks >= NUM_TICKS);
+        SPI_Manager_Process(&manager);
+
+        for(int t = 0; t < TICKS_PER_LOOP; t++)
+        {
+            if(!stopping && ticks >= nextDataReady)
+            {
+                DataReady();
+                nextDataReady = ticks + 300 + rand() % 600;
+            }
+            if(!stopping && ticks >= nextFlash)
+            {
+                FlashRequest();
+                nextFlash = ticks + 200 + rand() % 1000;
+            }
+
+            SPI1_Sim_Tick();
+            if(SPI1_Sim_IsInterruptPending())
+                SPI_Manager_DMAInterruptHandler(&manager);
+            ticks++;
+        }
+    }
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const struct {
+        const char *name;
+        SPIManagerMode mode;
+        bool usePriorities;
+    } runs[] = {
+        { "Burst, with priorities", SPI_MANAGER_MODE_BURST, true },
+        { "DMA, with priorities", SPI_MANAGER_MODE_DMA, true },
+        { "Burst, all the same priority", SPI_MANAGER_MODE_BURST, false },
+        { "DMA, all the same priority", SPI_MANAGER_MODE_DMA, false },
+    };
+    uint32_t numRuns = sizeof(runs) / sizeof(runs[0]);
+    uint32_t worstWithPriorities = 0;
+    int failed = 0;
+
+    /* One display chunk that just started, then the IMU's own read. A little
+    extra for the FIFO and a couple of slow trips around the main loop. */
+    uint32_t bound = (DISPLAY_CHUNK + IMU_READ) * 5 / 4 + 4 * TICKS_PER_LOOP;
+
+    for(uint32_t r = 0; r < numRuns; r++)
+    {
+        Run(runs[r].mode, runs[r].usePriorities);
+
+        printf("%s\n", runs[r].name);
+        printf("  IMU latency: worst %u byte times, average %.1f, over %u reads\n",
+            imuWorst, (double)imuTotal / finished[IMU], finished[IMU]);
+        printf("  %u flash transactions, %u display frames\n",
+            finished[FLASH], framesDone);
+
+        failed += Check("Everything queued finished",
+            finished[IMU] == queuedSequence[IMU] &&
+            finished[FLASH] == queuedSequence[FLASH] &&
+            finished[DISPLAY] == queuedSequence[DISPLAY] &&
+            finished[IMU] > 1000 && finished[FLASH] > 1000);
+        failed += Check("Each callback once, in the order queued",
+            extraCallbacks == 0 && orderErrors == 0);
+        failed += Check("Every byte out and back right",
+            dataErrors == 0 && SPI1_Sim_GetOverruns() == 0);
+        failed += Check("One slave at a time, no bytes with none selected",
+            strayBytes == 0 && ssErrors == 0);
+        failed += Check("Queueing one that's already queued says no",
+            doubleQueuesRejected == doubleQueues);
+
+        /* The display gets whatever's left, which is most of it */
+        failed += Check("The display isn't starved",
+            framesDone * DISPLAY_FRAME > NUM_TICKS / 2);
+
+        if(runs[r].usePriorities)
+        {
+            char line[80];
+            sprintf(line, "IMU never waits more than %u byte times", bound);
+            failed += Check(line, imuWorst <= bound);
+
+            if(imuWorst > worstWithPriorities)
+                worstWithPriorities = imuWorst;
+        }
+        else
+        {
+            failed += Check("Worse for the IMU without priorities",
+                imuWorst > worstWithPriorities);
+        }
+    }
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,378 @@
+/* Program to test SPI Manager transfers made of a list of segments - MS */
+
+/* Build from the SPI/Host folder with:
+gcc -std=c99 -I. -I"../Interface and Generic Manager" -I../STM32
+TestSPISegments.c SPI1_Sim.c "../Interface and Generic Manager/ISPI.c"
+"../Interface and Generic Manager/SPI_Manager.c"
+
+First the things segments are for. A display command followed by a frame
+straight out of the frame buffer, a flash read with a command, a dummy byte,
+and a page read right into the page buffer, a flash page program, and
+clearing the display with a fill byte and no buffer at all, and two 40000
+byte segments, which is more than a 16-bit count can hold. Then a few
+hundred lists of random segments. Each one is random: send only, read only,
+both, or fill only, and some of them are empty.
+
+The other end of the wire saves every byte it sees and sends back bytes that
+depend on where it is. After each transfer, what went out has to be exactly
+the segments one after the other, what came back has to be in the right
+spot of the right read buffer, the byte after each read buffer can't be
+touched, and SS can only go low once. It's all run in byte, burst, DMA, and
+interrupt mode. In DMA mode each segment that isn't empty is one interrupt. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SPI1_Sim.h"
+#include "SPI_Manager.h"
+
+#define NUM_ROUNDS      300
+#define MAX_SEGMENTS    8
+#define MAX_LENGTH      300
+#define FRAME_SIZE      2048
+#define PAGE_SIZE       256
+#define BIG_SIZE        40000
+#define WIRE_SIZE       (2 * BIG_SIZE)
+#define POOL_SIZE       (MAX_SEGMENTS * (MAX_LENGTH + 1))
+#define TICKS_PER_LOOP  4
+#define GUARD_BYTE      0xEE
+
+static SPI spi;
+static SPIManager manager;
+static SPISlave flash;
+static SPITransaction transaction;
+static SPISegment segments[MAX_SEGMENTS];
+static uint8_t numSegments;
+
+/* Where the segments point. Read buffers get a guard byte after them. */
+static uint8_t frame[FRAME_SIZE], page[PAGE_SIZE + 1];
+static uint8_t bigWrite[BIG_SIZE], bigRead[BIG_SIZE + 1];
+static uint8_t writePool[POOL_SIZE], readPool[POOL_SIZE];
+
+/* The other end of the wire */
+static int selected, ssLows;
+static uint8_t wireBytes[WIRE_SIZE];
+static uint32_t wireIndex;
+static uint32_t strayBytes;
+
+/* Results */
+static uint32_t callbacks, interrupts, dmaInterrupts, expectedInterrupts;
+
+// ***** Callbacks *************************************************************
+
+void SetSSPin(bool setPinHigh, void *slaveContext)
+{
+    (void)slaveContext;
+
+    if(!setPinHigh)
+    {
+        ssLows++;
+        selected = 1;
+        wireIndex = 0;
+    }
+    else
+    {
+        selected = 0;
+    }
+}
+
+uint8_t Expected(uint32_t index)
+{
+    return (uint8_t)((index * 13 + 7) ^ (index >> 8));
+}
+
+uint8_t Wire(uint8_t mosi)
+{
+    uint8_t miso;
+
+    if(selected == 0)
+    {
+        strayBytes++;
+        return 0xFF;
+    }
+
+    miso = Expected(wireIndex);
+    if(wireIndex < WIRE_SIZE)
+        wireBytes[wireIndex] = mosi;
+    wireIndex++;
+    return miso;
+}
+
+void SPI1TxCallback(void)
+{
+    SPI_Manager_TransmitEvent(&manager);
+}
+
+void SPI1RxCallback(uint8_t (*CallToGetData)(void))
+{
+    SPI_Manager_ReceiveEvent(&manager, CallToGetData);
+}
+
+void Finished(SPITransaction *t)
+{
+    (void)t;
+    callbacks++;
+}
+
+// *****************************************************************************
+
+SPISegment Segment(const uint8_t *writeBuffer, uint8_t *readBuffer,
+    uint16_t length, uint8_t fill)
+{
+    SPISegment segment = { writeBuffer, readBuffer, length, fill };
+
+    if(readBuffer != NULL)
+        readBuffer[length] = GUARD_BYTE;
+
+    if(length > 0)
+        expectedInterrupts++;
+
+    return segment;
+}
+
+/* Make a random list. Each segment gets its own spot in the pools. */
+void RandomSegments(void)
+{
+    numSegments = 1 + rand() % MAX_SEGMENTS;
+
+    for(uint8_t i = 0; i < numSegments; i++)
+    {
+        uint8_t *writeBuffer = &writePool[i * (MAX_LENGTH + 1)];
+        uint8_t *readBuffer = &readPool[i * (MAX_LENGTH + 1)];
+        uint16_t length = rand() % (MAX_LENGTH + 1);
+
+        if(rand() % 5 == 0)
+            length = 0;
+
+        for(uint16_t j = 0; j < length; j++)
+            writeBuffer[j] = (uint8_t)rand();
+
+        switch(rand() % 4)
+        {
+            case 0: // send only
+                segments[i] = Segment(writeBuffer, NULL, length, 0);
+                break;
+            case 1: // read only
+                segments[i] = Segment(NULL, readBuffer, length, (uint8_t)rand());
+                break;
+            case 2: // both
+                segments[i] = Segment(writeBuffer, readBuffer, length, 0);
+                break;
+            default: // fill only
+                segments[i] = Segment(NULL, NULL, length, (uint8_t)rand());
+                break;
+        }
+    }
+
+    /* Something has to go out */
+    if(segments[0].length == 0)
+    {
+        segments[0].length = 1;
+        if(segments[0].readBuffer != NULL)
+            segments[0].readBuffer[1] = GUARD_BYTE;
+        expectedInterrupts++;
+    }
+}
+
+/* Compare the wire and the read buffers to the list */
+bool TransferMatches(void)
+{
+    uint32_t position = 0;
+    bool match = (ssLows == 1 && selected == 0);
+
+    for(uint8_t i = 0; i < numSegments; i++)
+    {
+        const SPISegment *segment = &segments[i];
+
+        for(uint16_t j = 0; j < segment->length; j++, position++)
+        {
+            uint8_t mosi = segment->writeBuffer != NULL ?
+                segment->writeBuffer[j] : segment->fill;
+
+            if(position >= wireIndex || wireBytes[position] != mosi)
+                match = false;
+
+            if(segment->readBuffer != NULL &&
+                segment->readBuffer[j] != Expected(position))
+                match = false;
+        }
+
+        if(segment->readBuffer != NULL &&
+            segment->readBuffer[segment->length] != GUARD_BYTE)
+            match = false;
+    }
+
+    return match && position == wireIndex;
+}
+
+/* Start the list, either the simple way or queued with a callback */
+bool Transfer(bool useQueue)
+{
+    uint32_t loops = 0;
+
+    ssLows = 0;
+    if(useQueue)
+    {
+        SPI_Manager_InitTransactionV(&transaction, segments, numSegments);
+        SPI_Manager_SetTransactionCallback(&transaction, Finished);
+        SPI_Manager_Queue(&flash, &transaction);
+    }
+    else
+    {
+        SPI_Manager_BeginTransferV(&flash, segments, numSegments);
+    }
+
+    while(SPI_Manager_IsDeviceBusy(&flash) && loops++ < 1000000)
+    {
+        SPI_Manager_Process(&manager);
+        for(int t = 0; t < TICKS_PER_LOOP; t++)
+        {
+            SPI1_Sim_Tick();
+            if(SPI1_Sim_IsInterruptPending())
+            {
+                dmaInterrupts++;
+                SPI_Manager_DMAInterruptHandler(&manager);
+            }
+            while(SPI1_Sim_IsSPIInterruptPending())
+            {
+                interrupts++;
+                SPI1_Sim_SPIInterrupt();
+            }
+        }
+    }
+
+    if(useQueue)
+        return SPI_Manager_IsTransactionFinished(&transaction);
+    else
+        return SPI_Manager_IsTransferFinished(&flash);
+}
+
+// *****************************************************************************
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int Run(SPIManagerMode mode)
+{
+    static const uint8_t writeMemory[] = { 0x2C };
+    static const uint8_t readPage[] = { 0x03, 0x00, 0x12, 0x00 };
+    static const uint8_t programPage[] = { 0x02, 0x00, 0x12, 0x00 };
+    SPIInitType params;
+    int failed = 0;
+    bool allGood = true;
+
+    SPI1_Sim_SetFIFOSize(4);
+    SPI1_Sim_SetWireFunc(Wire);
+    SPI_Create(&spi, &SPI1_FunctionTable);
+    SPI_SetInitTypeToDefaultParams(&params);
+    params.useRxInterrupt = (mode == SPI_MANAGER_MODE_INTERRUPT);
+    SPI_Init(&spi, &params);
+    SPI_SetTransmitRegisterEmptyCallback(&spi, SPI1TxCallback);
+    SPI_SetReceivedDataCallback(&spi, SPI1RxCallback);
+
+    SPI_Manager_Create(&manager, &spi);
+    SPI_Manager_SetMode(&manager, mode);
+    SPI_Manager_SetFIFODepth(&manager, 4);
+    SPI_Manager_SetDMAInterface(&manager, &SPI1_DMA_FunctionTable);
+    SPI_Manager_AddSlave(&manager, &flash, NULL, NULL);
+    SPI_Manager_SetSSPinFunc(&flash, SetSSPin);
+    SPI_Manager_Enable(&manager);
+
+    callbacks = interrupts = dmaInterrupts = expectedInterrupts = 0;
+    strayBytes = 0;
+    srand(1);
+
+    for(uint16_t i = 0; i < FRAME_SIZE; i++)
+        frame[i] = (uint8_t)(i * 3);
+
+    /* Display command, then the whole frame */
+    numSegments = 2;
+    segments[0] = Segment(writeMemory, NULL, sizeof(writeMemory), 0);
+    segments[1] = Segment(frame, NULL, FRAME_SIZE, 0);
+    failed += Check("Display command and frame",
+        Transfer(false) && TransferMatches());
+
+    /* Flash read. Command, a dummy byte, then the page. */
+    numSegments = 3;
+    segments[0] = Segment(readPage, NULL, sizeof(readPage), 0);
+    segments[1] = Segment(NULL, NULL, 1, 0xFF);
+    segments[2] = Segment(NULL, page, PAGE_SIZE, 0xFF);
+    failed += Check("Flash read with a dummy byte",
+        Transfer(false) && TransferMatches());
+
+    /* Flash page program from the page that was just read */
+    numSegments = 2;
+    segments[0] = Segment(programPage, NULL, sizeof(programPage), 0);
+    segments[1] = Segment(page, NULL, PAGE_SIZE, 0);
+    failed += Check("Flash page program",
+        Transfer(true) && TransferMatches() && callbacks == 1);
+
+    /* Clear the display with one color */
+    numSegments = 2;
+    segments[0] = Segment(writeMemory, NULL, sizeof(writeMemory), 0);
+    segments[1] = Segment(NULL, NULL, FRAME_SIZE, 0x1F);
+    failed += Check("Clear the display with a fill byte",
+        Transfer(true) && TransferMatches() && callbacks == 2);
+
+    /* More than 65535 bytes in all. Each segment still fits in a DMA count. */
+    for(uint32_t i = 0; i < BIG_SIZE; i++)
+        bigWrite[i] = (uint8_t)(i * 5 + 1);
+    numSegments = 2;
+    segments[0] = Segment(bigWrite, NULL, BIG_SIZE, 0);
+    segments[1] = Segment(NULL, bigRead, BIG_SIZE, 0xA5);
+    failed += Check("Two 40000 byte segments, 80000 in all",
+        Transfer(false) && TransferMatches() && wireIndex == 2 * BIG_SIZE);
+
+    for(uint32_t round = 0; round < NUM_ROUNDS; round++)
+    {
+        RandomSegments();
+        if(!Transfer(round & 1) || !TransferMatches())
+            allGood = false;
+    }
+    failed += Check("Random lists of segments", allGood);
+    failed += Check("Each queued one called back once",
+        callbacks == 2 + NUM_ROUNDS / 2);
+    failed += Check("No bytes with SS high, no overflows",
+        strayBytes == 0 && SPI1_Sim_GetOverruns() == 0);
+
+    if(mode == SPI_MANAGER_MODE_DMA)
+    {
+        printf("  %u DMA interrupts\n", dmaInterrupts);
+        failed += Check("One DMA interrupt for each segment",
+            dmaInterrupts == expectedInterrupts);
+    }
+
+    if(mode == SPI_MANAGER_MODE_INTERRUPT)
+    {
+        failed += Check("Moved by the SPI interrupts",
+            interrupts > 0 && dmaInterrupts == 0);
+    }
+    return failed;
+}
+
+int main(void)
+{
+    static const struct {
+        const char *name;
+        SPIManagerMode mode;
+    } runs[] = {
+        { "Byte", SPI_MANAGER_MODE_BYTE },
+        { "Burst", SPI_MANAGER_MODE_BURST },
+        { "DMA", SPI_MANAGER_MODE_DMA },
+        { "Interrupt", SPI_MANAGER_MODE_INTERRUPT },
+    };
+    uint32_t numRuns = sizeof(runs) / sizeof(runs[0]);
+    int failed = 0;
+
+    for(uint32_t r = 0; r < numRuns; r++)
+    {
+        printf("%s\n", runs[r].name);
+        failed += Run(runs[r].mode);
+    }
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
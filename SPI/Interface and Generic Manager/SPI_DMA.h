@@ -0,0 +1,87 @@
+/***************************************************************************//**
+ * @brief SPI DMA Interface Header
+ * 
+ * @file SPI_DMA.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A small function table for moving a whole SPI transfer with the DMA
+ * controller. This goes along side your regular SPI. Set up the mode and
+ * everything else with SPI_Init like normal. The SPI Manager uses this when
+ * you put it in DMA mode (see SPI_Manager.h), so most of the time you won't
+ * call these yourself.
+ * 
+ * A transfer uses two DMA channels. The transmit channel feeds the SPI from
+ * one array while the receive channel empties it into another. Either array
+ * can be NULL. If there's nothing to send, the same fill byte (normally
+ * zero) gets sent over and over. If you don't want what comes back, it all
+ * gets written to the same throw away byte. Only the receive channel's
+ * transfer complete interrupt is used. The last byte to come in is the last byte to go out, so when that
+ * happens the whole transfer is done, and it's safe to set the SS line high.
+ * 
+ * Each implementation (SPI1_DMA_STM32G0.c, SPI1_DMA_STM32F1.c, or the
+ * simulated one for testing on a PC) fills in the table.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef SPI_DMA_H
+#define SPI_DMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ***** Defines ***************************************************************
+
+/* Events returned by GetAndClearEvents. Finished is the transfer complete
+flag of the receive channel. */
+#define SPI_DMA_EVENT_FINISHED      0x01
+
+// ***** Global Variables ******************************************************
+
+typedef struct SPIDMAInterfaceTag
+{
+    /*  These are the functions that will be called. You will create your own
+    interface object for your class that will have these function signatures.
+    Set each of your functions equal to one of these pointers */
+    void (*SPI_DMA_StartTransfer)(const uint8_t *, uint8_t *, uint16_t);
+    void (*SPI_DMA_StopTransfer)(void);
+    uint8_t (*SPI_DMA_GetAndClearEvents)(void);
+    void (*SPI_DMA_SetFillByte)(uint8_t);
+} SPIDMAInterface;
+
+/**
+ * Description of the functions for the implementation:
+ * 
+ * StartTransfer  Set up the receive channel to write to the receive array
+ *                and the transmit channel to read from the transmit array,
+ *                both in normal mode with the same count. If the transmit
+ *                array is NULL, send the fill byte without incrementing. If
+ *                the receive array is NULL, write to a dummy byte without
+ *                incrementing. Throw out anything old in the receive register
+ *                first. Turn on the receive channel's transfer complete
+ *                interrupt, and start receive before transmit.
+ * 
+ * StopTransfer  Turn both channels off and turn off DMA in the SPI
+ * 
+ * GetAndClearEvents  Check and clear the interrupt flags. Return any of the
+ *                    SPI_DMA_EVENT flags that were set. When the transfer is
+ *                    finished, turn off the channels so they can be loaded
+ *                    again.
+ * 
+ * SetFillByte  Set the byte that gets sent over and over when the transmit
+ *              array is NULL. It starts out as zero. This one is optional.
+ *              If it's NULL, zeros go out.
+ */
+
+#endif  /* SPI_DMA_H */
@@ -34,6 +34,26 @@ static bool spiManagerEnabled; // @todo enable/disable
 
 static void SPI_Manager_DevicePush(SPISlave *self, SPISlave *endOfList);
 
+static uint32_t SPI_Manager_TransferLength(SPITransaction *self);
+
+static SPISlave *SPI_Manager_Arbitrate(SPIManager *self);
+
+static SPISlave *SPI_Manager_NextSlave(SPIManager *self);
+
+static void SPI_Manager_StartNext(SPIManager *self);
+
+static void SPI_Manager_FlushReceive(SPIManager *self);
+
+static uint8_t SPI_Manager_NextByteToSend(SPISlave *self);
+
+static void SPI_Manager_SaveReceivedByte(SPISlave *self, uint8_t data);
+
+static void SPI_Manager_Burst(SPIManager *self, SPISlave *slave);
+
+static void SPI_Manager_StartDMA(SPIManager *self, SPISlave *slave);
+
+static void SPI_Manager_FinishTransfer(SPISlave *self);
+
 // *****************************************************************************
 
 void SPI_Manager_Create(SPIManager *self, SPI *peripheral)
@@ -42,6 +62,9 @@ void SPI_Manager_Create(SPIManager *self, SPI *peripheral)
     self->endOfList = NULL;
     self->device = NULL;
     self->busy = false; // @todo busy flag isn't used right now
+    self->mode = SPI_MANAGER_MODE_BYTE;
+    self->fifoDepth = 1;
+    self->dma = NULL;
 }
 
 // *****************************************************************************
@@ -51,11 +74,15 @@ void SPI_Manager_AddSlave(SPIManager *self, SPISlave *slave, uint8_t *writeBuffe
     slave->manager = self;
     slave->writeBuffer = writeBuffer;
     slave->readBuffer = readBuffer;
-    slave->numBytesToRead = 0;
-    slave->numBytesToSend = 0;
+    slave->current = NULL;
+    slave->queueHead = NULL;
+    slave->queueTail = NULL;
     slave->readWriteCount = 0;
+    slave->txCount = 0;
     slave->state = SPI_STATE_IDLE;
+    slave->priority = 0;
     slave->transferFinished = false;
+    SPI_Manager_InitTransaction(&slave->transfer, writeBuffer, 0, readBuffer, 0);
 
     if(self->endOfList == NULL)
     {
@@ -77,7 +104,7 @@ void SPI_Manager_AddSlave(SPIManager *self, SPISlave *slave, uint8_t *writeBuffe
 
 bool SPI_Manager_IsDeviceBusy(SPISlave *self)
 {
-    if(self->state == SPI_STATE_IDLE)
+    if(self->state == SPI_STATE_IDLE && self->queueHead == NULL)
         return false;
     else
         return true;
@@ -87,17 +114,30 @@ bool SPI_Manager_IsDeviceBusy(SPISlave *self)
 
 void SPI_Manager_BeginTransfer(SPISlave *self, uint16_t numBytesToSend, uint16_t numBytesToRead)
 {
-    if(self->state != SPI_STATE_IDLE || (numBytesToRead == 0 && numBytesToSend == 0))
+    /* The old way is just a transaction that goes with the slave. Don't touch
+    it while it's still in line. */
+    if(self->transfer.queued)
         return;
 
-    if(self->writeBuffer != NULL)
-        self->numBytesToSend = numBytesToSend;
+    SPI_Manager_InitTransaction(&self->transfer, self->writeBuffer,
+        numBytesToSend, self->readBuffer, numBytesToRead);
 
-    if(self->readBuffer != NULL)
-        self->numBytesToRead = numBytesToRead;
+    if(SPI_Manager_Queue(self, &self->transfer))
+        self->transferFinished = false;
+}
 
-    self->transferFinished = false;
-    self->state = SPI_STATE_RQ_START; // request start
+// *****************************************************************************
+
+void SPI_Manager_BeginTransferV(SPISlave *self, const SPISegment *segments,
+    uint8_t numSegments)
+{
+    if(self->transfer.queued)
+        return;
+
+    SPI_Manager_InitTransactionV(&self->transfer, segments, numSegments);
+
+    if(SPI_Manager_Queue(self, &self->transfer))
+        self->transferFinished = false;
 }
 
 // *****************************************************************************
@@ -111,95 +151,118 @@ bool SPI_Manager_IsTransferFinished(SPISlave *self)
 
 void SPI_Manager_Process(SPIManager *self)
 {
-    /* Go round-robin through the list of devices. Right now, I'm only going to 
-    deal with SPI master mode. */
+    SPISlave *slave;
+    SPITransaction *transaction;
+
+    /* Right now, I'm only going to deal with SPI master mode. */
     // @todo add check for master mode, and eventually add slave mode
     // @todo busy flag isn't used yet. I may want to replace it with a state for the peripheral instead
-    if(self->device != NULL)
+    if(self->device == NULL)
+        return;
+
+    if(self->mode == SPI_MANAGER_MODE_INTERRUPT)
     {
-        switch(self->device->state)
-        {
-            case SPI_STATE_RQ_START:
-                /* Begin transfer. Set slave select line low */
-                if(self->device->SetSSPin != NULL)
-                    (self->device->SetSSPin)(false, self->device);
-                self->device->state = SPI_STATE_SEND_BYTE;
-                break;
-            case SPI_STATE_SEND_BYTE:
-                if(self->device->readWriteCount < self->device->numBytesToSend)
+        /* The interrupts do everything. This only gets things going again if
+        the mode was changed while something was queued. */
+        SPI_Manager_StartNext(self);
+        return;
+    }
+
+    if(self->device->state == SPI_STATE_IDLE)
+    {
+        /* The bus is free. Pick who goes next. */
+        SPI_MANAGER_ENTER_CRITICAL();
+        slave = SPI_Manager_NextSlave(self);
+        SPI_MANAGER_EXIT_CRITICAL();
+
+        if(slave == NULL)
+            return;
+    }
+
+    slave = self->device;
+    transaction = slave->current;
+
+    switch(slave->state)
+    {
+        case SPI_STATE_RQ_START:
+            /* Begin transfer. Set slave select line low */
+            if(slave->SetSSPin != NULL)
+                (slave->SetSSPin)(false, slave);
+
+            /* Anything left over in the receive register would throw off
+            every byte after it */
+            SPI_Manager_FlushReceive(self);
+
+            if(self->mode == SPI_MANAGER_MODE_DMA && self->dma != NULL)
+            {
+                /* Change the state first. The interrupt could come
+                before StartDMA returns. */
+                slave->state = SPI_STATE_DMA_BUSY;
+                SPI_Manager_StartDMA(self, slave);
+            }
+            else if(self->mode != SPI_MANAGER_MODE_BYTE)
+            {
+                /* No reason to wait for the next call */
+                slave->state = SPI_STATE_BURST;
+                SPI_Manager_Burst(self, slave);
+            }
+            else
+            {
+                slave->state = SPI_STATE_SEND_BYTE;
+            }
+            break;
+        case SPI_STATE_SEND_BYTE:
+            SPI_TransmitByte(self->peripheral, 
+                SPI_Manager_NextByteToSend(slave));
+            slave->state = SPI_STATE_RECEIVE_BYTE;
+            break;
+        case SPI_STATE_RECEIVE_BYTE:
+            /* In master mode there is always a receive after a send, so 
+            I can use a single read/write index count. However, we do have 
+            to wait until the transmission is fully finished first before 
+            reading the data. If there is no master input, the get received 
+            byte function will just return zero. Which is what it would do 
+            if there was no data anyway. */
+
+            /* @todo try by just checking using the getreceivedbyte function 
+            by itself. As long as RXNE is cleared beforehand, we should be 
+            able to just watch it. */
+            if(SPI_IsReceiveRegisterFull(self->peripheral))
+            {
+                SPI_Manager_SaveReceivedByte(slave, 
+                    SPI_GetReceivedByte(self->peripheral));
+
+                if(slave->readWriteCount < SPI_Manager_TransferLength(transaction))
                 {
-                    SPI_TransmitByte(self->peripheral, 
-                        self->device->writeBuffer[self->device->readWriteCount]);
+                    /* There are more bytes to send */
+                    slave->state = SPI_STATE_SEND_BYTE;
                 }
                 else
                 {
-                    /* Send empty data out for a slave read */
-                    SPI_TransmitByte(self->peripheral, 0);
-                }
-                self->device->state = SPI_STATE_RECEIVE_BYTE;
-                break;
-            case SPI_STATE_RECEIVE_BYTE:
-                /* In master mode there is always a receive after a send, so 
-                I can use a single read/write index count. However, we do have 
-                to wait until the transmission is fully finished first before 
-                reading the data. If there is no master input, the get received 
-                byte function will just return zero. Which is what it would do 
-                if there was no data anyway. */
-
-                /* @todo try by just checking using the getreceivedbyte function 
-                by itself. As long as RXNE is cleared beforehand, we should be 
-                able to just watch it. */
-
-                /* Add option for no read buffer */
-                if(SPI1_IsReceiveRegisterFull(self->peripheral))
-                {
-                    uint8_t data = SPI_GetReceivedByte(self->peripheral);
-
-                    if(self->device->readWriteCount < self->device->numBytesToRead)
-                    {
-                        self->device->readBuffer[self->device->readWriteCount] = data;
-                    }
-                    self->device->readWriteCount++;
-                    
-                    if(self->device->readWriteCount < self->device->numBytesToSend ||
-                        self->device->readWriteCount < self->device->numBytesToRead)
-                    {
-                        /* There are more bytes to send */
-                        self->device->state = SPI_STATE_SEND_BYTE;
-                    }
-                    else
-                    {
-                        /* Transfer finished */
-                        if(self->device->SetSSPin != NULL)
-                            (self->device->SetSSPin)(true, self->device);
-                        
-                        self->device->transferFinished = true;
-                        self->device->state = SPI_STATE_IDLE;
-                        self->device = self->device->next;
-                    }
+                    SPI_Manager_FinishTransfer(slave);
                 }
-                // @todo get received byte try again count?
-                break;
-            case SPI_STATE_IDLE:
-                /* Nothing to do. Go to next device. */
-                self->device = self->device->next;
-                break;
-        } // end switch
-    }
-    else
-    {
-        /* No device found */
-        self->device = self->device->next;
-    }
+            }
+            // @todo get received byte try again count?
+            break;
+        case SPI_STATE_BURST:
+            SPI_Manager_Burst(self, slave);
+            break;
+        case SPI_STATE_DMA_BUSY:
+        case SPI_STATE_INTERRUPT_BUSY:
+            /* Wait here. The interrupt will finish the transfer. */
+            break;
+        case SPI_STATE_IDLE:
+            /* Nothing to do */
+            break;
+    } // end switch
 }
 
 // *****************************************************************************
 
 void SPI_Manager_Enable(SPIManager *self)
 {
-    if(!SPI_IsEnabled())
-        SPI_Enable(self->peripheral);
-    
+    SPI_Enable(self->peripheral);
+
     spiManagerEnabled = true;
 }
 
@@ -217,6 +280,196 @@ void SPI_Manager_SetSSPinFunc(SPISlave *self, void (*Function)(bool setPinHigh,
     self->SetSSPin = Function;
 }
 
+// *****************************************************************************
+
+void SPI_Manager_SetMode(SPIManager *self, SPIManagerMode mode)
+{
+    self->mode = mode;
+}
+
+// *****************************************************************************
+
+void SPI_Manager_SetFIFODepth(SPIManager *self, uint8_t depth)
+{
+    if(depth == 0)
+        depth = 1;
+
+    self->fifoDepth = depth;
+}
+
+// *****************************************************************************
+
+void SPI_Manager_SetDMAInterface(SPIManager *self, SPIDMAInterface *dma)
+{
+    self->dma = dma;
+}
+
+// *****************************************************************************
+
+void SPI_Manager_DMAInterruptHandler(SPIManager *self)
+{
+    SPISlave *slave = self->device;
+
+    if(self->dma == NULL || self->dma->SPI_DMA_GetAndClearEvents == NULL)
+        return;
+
+    if(!((self->dma->SPI_DMA_GetAndClearEvents)() & SPI_DMA_EVENT_FINISHED))
+        return;
+
+    /* Process doesn't move on while a slave is waiting on the DMA, so the
+    current device is the one that's finished */
+    if(slave == NULL || slave->state != SPI_STATE_DMA_BUSY)
+        return;
+
+    /* The part that just finished ends at txCount */
+    slave->readWriteCount = slave->txCount;
+
+    if(slave->readWriteCount < SPI_Manager_TransferLength(slave->current))
+        SPI_Manager_StartDMA(self, slave);
+    else
+        SPI_Manager_FinishTransfer(slave);
+}
+
+// *****************************************************************************
+
+void SPI_Manager_TransmitEvent(SPIManager *self)
+{
+    SPISlave *slave = self->device;
+
+    if(slave == NULL || slave->state != SPI_STATE_INTERRUPT_BUSY)
+        return;
+
+    /* Same as burst mode. Fill the Tx FIFO as far as we're allowed to and
+    pick up anything that's come back while we're here. */
+    SPI_Manager_Burst(self, slave);
+
+    if(slave->state == SPI_STATE_IDLE)
+        SPI_Manager_StartNext(self);
+}
+
+// *****************************************************************************
+
+void SPI_Manager_ReceiveEvent(SPIManager *self, uint8_t (*CallToGetData)(void))
+{
+    SPISlave *slave = self->device;
+    uint8_t data;
+
+    /* This has to be read no matter what, or the interrupt will keep
+    coming back */
+    data = CallToGetData();
+
+    if(slave == NULL || slave->state != SPI_STATE_INTERRUPT_BUSY ||
+        slave->readWriteCount >= slave->txCount)
+    {
+        return;
+    }
+
+    SPI_Manager_SaveReceivedByte(slave, data);
+
+    /* One out means there's room for one more to go in */
+    SPI_Manager_Burst(self, slave);
+
+    if(slave->state == SPI_STATE_IDLE)
+        SPI_Manager_StartNext(self);
+}
+
+// *****************************************************************************
+
+void SPI_Manager_InitTransaction(SPITransaction *self, const uint8_t *writeBuffer,
+    uint16_t numBytesToSend, uint8_t *readBuffer, uint16_t numBytesToRead)
+{
+    if(writeBuffer == NULL)
+        numBytesToSend = 0;
+
+    if(readBuffer == NULL)
+        numBytesToRead = 0;
+
+    self->next = NULL;
+    self->writeBuffer = writeBuffer;
+    self->readBuffer = readBuffer;
+    self->numBytesToSend = numBytesToSend;
+    self->numBytesToRead = numBytesToRead;
+    self->segments = NULL;
+    self->numSegments = 0;
+    self->queued = false;
+    self->finished = false;
+    self->FinishedCallback = NULL;
+}
+
+// *****************************************************************************
+
+void SPI_Manager_InitTransactionV(SPITransaction *self,
+    const SPISegment *segments, uint8_t numSegments)
+{
+    SPI_Manager_InitTransaction(self, NULL, 0, NULL, 0);
+
+    if(segments == NULL)
+        numSegments = 0;
+
+    self->segments = segments;
+    self->numSegments = numSegments;
+}
+
+// *****************************************************************************
+
+void SPI_Manager_SetTransactionCallback(SPITransaction *self,
+    void (*Function)(SPITransaction *transaction))
+{
+    self->FinishedCallback = Function;
+}
+
+// *****************************************************************************
+
+bool SPI_Manager_Queue(SPISlave *self, SPITransaction *transaction)
+{
+    bool retVal = false;
+
+    /* A DMA transfer of nothing would never finish */
+    if(SPI_Manager_TransferLength(transaction) == 0)
+        return false;
+
+    SPI_MANAGER_ENTER_CRITICAL();
+    if(!transaction->queued)
+    {
+        transaction->queued = true;
+        transaction->finished = false;
+        transaction->next = NULL;
+
+        if(self->queueTail == NULL)
+            self->queueHead = transaction;
+        else
+            self->queueTail->next = transaction;
+
+        self->queueTail = transaction;
+        retVal = true;
+    }
+    SPI_MANAGER_EXIT_CRITICAL();
+
+    /* Nobody is polling in interrupt mode, so if the bus is free this one
+    has to get it started */
+    if(retVal && self->manager != NULL &&
+        self->manager->mode == SPI_MANAGER_MODE_INTERRUPT)
+    {
+        SPI_Manager_StartNext(self->manager);
+    }
+
+    return retVal;
+}
+
+// *****************************************************************************
+
+bool SPI_Manager_IsTransactionFinished(SPITransaction *self)
+{
+    return self->finished;
+}
+
+// *****************************************************************************
+
+void SPI_Manager_SetSlavePriority(SPISlave *self, uint8_t priority)
+{
+    self->priority = priority;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //                                                                            //
 // ***** Local Functions *****************************************************//
@@ -232,6 +485,386 @@ static void SPI_Manager_DevicePush(SPISlave *self, SPISlave *endOfList)
     endOfList->next = self;
 }
 
+/***************************************************************************//**
+ * @brief The total number of bytes that have to go out
+ * 
+ * In master mode there is always a receive for every send, so it's whichever
+ * one is longer.
+ * 
+ * @param self  pointer to the SPITransaction
+ * 
+ * @return uint32_t  number of bytes
+ */
+static uint32_t SPI_Manager_TransferLength(SPITransaction *self)
+{
+    uint32_t length = 0;
+
+    if(self->segments != NULL)
+    {
+        for(uint8_t i = 0; i < self->numSegments; i++)
+            length += self->segments[i].length;
+
+        return length;
+    }
+
+    if(self->numBytesToSend > self->numBytesToRead)
+        return self->numBytesToSend;
+    else
+        return self->numBytesToRead;
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Pick the next slave to use the bus
+ * 
+ * The highest priority (lowest number) slave with something queued wins.
+ * Start looking at the one after the last slave that went, so that slaves
+ * with the same priority take turns.
+ * 
+ * @param self  pointer to the SPIManager
+ * 
+ * @return SPISlave*  the slave, or NULL if nobody has anything queued
+ */
+static SPISlave *SPI_Manager_Arbitrate(SPIManager *self)
+{
+    SPISlave *slave = self->device->next;
+    SPISlave *best = NULL;
+
+    do
+    {
+        if(slave->queueHead != NULL &&
+            (best == NULL || slave->priority < best->priority))
+        {
+            best = slave;
+        }
+        slave = slave->next;
+    } while(slave != self->device->next);
+
+    return best;
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Take the next transaction off the queue of whoever goes next
+ * 
+ * Call this with the critical section on. The slave is left in the request
+ * start state with its counts reset, and it becomes the current device.
+ * 
+ * @param self  pointer to the SPIManager
+ * 
+ * @return SPISlave*  the slave, or NULL if nobody has anything queued
+ */
+static SPISlave *SPI_Manager_NextSlave(SPIManager *self)
+{
+    SPISlave *slave = SPI_Manager_Arbitrate(self);
+
+    if(slave == NULL)
+        return NULL;
+
+    slave->current = slave->queueHead;
+    slave->queueHead = slave->queueHead->next;
+    if(slave->queueHead == NULL)
+        slave->queueTail = NULL;
+
+    slave->readWriteCount = 0;
+    slave->txCount = 0;
+    slave->txSegment = 0;
+    slave->txOffset = 0;
+    slave->rxSegment = 0;
+    slave->rxOffset = 0;
+    slave->state = SPI_STATE_RQ_START; // request start
+    self->device = slave;
+
+    return slave;
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Start the next transaction in interrupt mode
+ * 
+ * If the bus is free, pick the next slave, set SS low, and fill the Tx FIFO.
+ * From then on the Rx and Tx interrupts keep it going. This can be called
+ * from your code or from inside an interrupt, so the whole thing is in the
+ * critical section. Otherwise two of them could start at once.
+ * 
+ * @param self  pointer to the SPIManager
+ */
+static void SPI_Manager_StartNext(SPIManager *self)
+{
+    SPISlave *slave;
+
+    SPI_MANAGER_ENTER_CRITICAL();
+    while(self->device != NULL && self->device->state == SPI_STATE_IDLE)
+    {
+        slave = SPI_Manager_NextSlave(self);
+        if(slave == NULL)
+            break;
+
+        if(slave->SetSSPin != NULL)
+            (slave->SetSSPin)(false, slave);
+
+        SPI_Manager_FlushReceive(self);
+
+        /* If the SPI is fast enough, a short one could be all the way done
+        before Burst returns. Then go around again. */
+        slave->state = SPI_STATE_INTERRUPT_BUSY;
+        SPI_Manager_Burst(self, slave);
+    }
+    SPI_MANAGER_EXIT_CRITICAL();
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Throw out anything in the receive register
+ * 
+ * @param self  pointer to the SPIManager
+ */
+static void SPI_Manager_FlushReceive(SPIManager *self)
+{
+    uint8_t count = 0;
+
+    /* The count is just in case the flag gets stuck for some reason */
+    while(SPI_IsReceiveRegisterFull(self->peripheral) && count < 8)
+    {
+        SPI_GetReceivedByte(self->peripheral);
+        count++;
+    }
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Get the next byte to go out and move ahead one
+ * 
+ * Without segments it's the next byte of the write buffer, or a zero once
+ * that runs out. With segments it's the next byte of whatever segment we're
+ * in, or the segment's fill byte if it doesn't have a write buffer.
+ * 
+ * @param self  pointer to the SPISlave
+ * 
+ * @return uint8_t  the byte
+ */
+static uint8_t SPI_Manager_NextByteToSend(SPISlave *self)
+{
+    SPITransaction *transaction = self->current;
+    const SPISegment *segment;
+    uint8_t data = 0;
+
+    if(transaction->segments == NULL)
+    {
+        /* Send empty data out for a slave read */
+        if(self->txCount < transaction->numBytesToSend)
+            data = transaction->writeBuffer[self->txCount];
+    }
+    else
+    {
+        /* Go to the next segment that has something left. Empty ones get
+        skipped. */
+        while(self->txSegment < transaction->numSegments &&
+            self->txOffset >= transaction->segments[self->txSegment].length)
+        {
+            self->txSegment++;
+            self->txOffset = 0;
+        }
+
+        if(self->txSegment < transaction->numSegments)
+        {
+            segment = &transaction->segments[self->txSegment];
+            if(segment->writeBuffer != NULL)
+                data = segment->writeBuffer[self->txOffset];
+            else
+                data = segment->fill;
+
+            self->txOffset++;
+        }
+    }
+    self->txCount++;
+    return data;
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Put a byte that came back where it goes and move ahead one
+ * 
+ * If there's no read buffer for this spot, it gets thrown out.
+ * 
+ * @param self  pointer to the SPISlave
+ * 
+ * @param data  the byte
+ */
+static void SPI_Manager_SaveReceivedByte(SPISlave *self, uint8_t data)
+{
+    SPITransaction *transaction = self->current;
+    const SPISegment *segment;
+
+    if(transaction->segments == NULL)
+    {
+        if(self->readWriteCount < transaction->numBytesToRead)
+            transaction->readBuffer[self->readWriteCount] = data;
+    }
+    else
+    {
+        while(self->rxSegment < transaction->numSegments &&
+            self->rxOffset >= transaction->segments[self->rxSegment].length)
+        {
+            self->rxSegment++;
+            self->rxOffset = 0;
+        }
+
+        if(self->rxSegment < transaction->numSegments)
+        {
+            segment = &transaction->segments[self->rxSegment];
+            if(segment->readBuffer != NULL)
+                segment->readBuffer[self->rxOffset] = data;
+
+            self->rxOffset++;
+        }
+    }
+    self->readWriteCount++;
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Move as many bytes as we can without waiting
+ * 
+ * Fill the Tx FIFO, then empty the Rx FIFO, over and over until neither one
+ * can go any further. Never get more than fifoDepth bytes ahead, or the Rx
+ * FIFO could overflow before we get back to it.
+ * 
+ * @param self  pointer to the SPIManager
+ * 
+ * @param slave  the slave with the transfer going
+ */
+static void SPI_Manager_Burst(SPIManager *self, SPISlave *slave)
+{
+    uint32_t length = SPI_Manager_TransferLength(slave->current);
+    bool keepGoing = true;
+
+    while(keepGoing)
+    {
+        keepGoing = false;
+
+        while(slave->txCount < length &&
+            slave->txCount - slave->readWriteCount < self->fifoDepth &&
+            SPI_IsTransmitRegisterEmpty(self->peripheral))
+        {
+            SPI_TransmitByte(self->peripheral, 
+                SPI_Manager_NextByteToSend(slave));
+            keepGoing = true;
+        }
+
+        while(slave->readWriteCount < slave->txCount &&
+            SPI_IsReceiveRegisterFull(self->peripheral))
+        {
+            SPI_Manager_SaveReceivedByte(slave, 
+                SPI_GetReceivedByte(self->peripheral));
+            keepGoing = true;
+        }
+    }
+
+    if(slave->readWriteCount >= length)
+        SPI_Manager_FinishTransfer(slave);
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Start the DMA on the next part of the transfer
+ * 
+ * The DMA can't switch from a real array to a dummy byte partway through. So
+ * if the number of bytes to send and read are different, the first part has
+ * both, and the second part has only the one that's longer. With a list of
+ * segments, each segment is its own part. Either way a part is never more 
+ * than 65535 bytes, so it always fits in the DMA count, even when the whole
+ * transfer doesn't.
+ * 
+ * @param self  pointer to the SPIManager
+ * 
+ * @param slave  the slave with the transfer going
+ */
+static void SPI_Manager_StartDMA(SPIManager *self, SPISlave *slave)
+{
+    SPITransaction *transaction = slave->current;
+    const SPISegment *segment;
+    uint32_t start = slave->readWriteCount;
+    uint32_t end = SPI_Manager_TransferLength(transaction);
+    const uint8_t *txData = NULL;
+    uint8_t *rxData = NULL;
+    uint8_t fill = 0;
+
+    if(transaction->segments != NULL)
+    {
+        /* Skip anything empty. A zero count would never finish. */
+        while(transaction->segments[slave->rxSegment].length == 0)
+            slave->rxSegment++;
+
+        segment = &transaction->segments[slave->rxSegment];
+        slave->rxSegment++;
+
+        txData = segment->writeBuffer;
+        rxData = segment->readBuffer;
+        fill = segment->fill;
+        end = start + segment->length;
+    }
+    else if(start < transaction->numBytesToSend && start < transaction->numBytesToRead)
+    {
+        /* Both. Stop wherever the shorter one does. */
+        end = transaction->numBytesToSend;
+        if(transaction->numBytesToRead < end)
+            end = transaction->numBytesToRead;
+    }
+
+    if(transaction->segments == NULL && start < transaction->numBytesToSend)
+        txData = &transaction->writeBuffer[start];
+
+    if(transaction->segments == NULL && start < transaction->numBytesToRead)
+        rxData = &transaction->readBuffer[start];
+
+    slave->txCount = end;
+
+    if(self->dma->SPI_DMA_SetFillByte != NULL)
+        (self->dma->SPI_DMA_SetFillByte)(fill);
+
+    if(self->dma->SPI_DMA_StartTransfer != NULL)
+        (self->dma->SPI_DMA_StartTransfer)(txData, rxData, (uint16_t)(end - start));
+}
+
+// *****************************************************************************
+
+/***************************************************************************//**
+ * @brief Set the SS line high and mark the transaction finished
+ * 
+ * Everything is cleaned up before the callback is called, so it's free to
+ * queue the same transaction again, or another one.
+ * 
+ * @param self  pointer to the SPISlave
+ */
+static void SPI_Manager_FinishTransfer(SPISlave *self)
+{
+    SPITransaction *transaction = self->current;
+
+    if(self->SetSSPin != NULL)
+        (self->SetSSPin)(true, self);
+
+    transaction->queued = false;
+    transaction->finished = true;
+
+    if(transaction == &self->transfer)
+        self->transferFinished = true;
+
+    self->current = NULL;
+    self->state = SPI_STATE_IDLE;
+
+    if(transaction->FinishedCallback != NULL)
+        (transaction->FinishedCallback)(transaction);
+}
+
 /*
  End of File
  */
\ No newline at end of file
@@ -10,6 +10,94 @@
  * @details
  *      // TODO details
  * 
+ * There are four ways the manager can move the bytes. Pick one with
+ * SPI_Manager_SetMode. Whichever one you pick, what goes out and what comes
+ * back is the same.
+ * 
+ * Byte  One byte each time SPI_Manager_Process is called. It sends a byte on
+ *       one call and picks up the received byte on a later one. This is the
+ *       default. It works with any SPI, but it can't go any faster than your
+ *       main loop.
+ * 
+ * Burst  Each call to SPI_Manager_Process keeps the Tx FIFO full and reads
+ *        the Rx FIFO in the same pass, until it has to wait on the wire. It
+ *        never gets more bytes ahead than the Rx FIFO can hold, which you
+ *        tell it with SPI_Manager_SetFIFODepth. The STM32G0 can hold 4 bytes.
+ *        The F1 only has a single Rx register, so leave it at 1, or use 2 if
+ *        nothing can interrupt you for a whole byte time.
+ * 
+ * DMA  The DMA moves the whole transfer and you get one interrupt at the end.
+ *      Call SPI_Manager_DMAInterruptHandler from the interrupt for the DMA
+ *      receive channel. Give the manager the DMA function table for your SPI
+ *      with SPI_Manager_SetDMAInterface (see SPI_DMA.h). If the number of
+ *      bytes to send and read aren't the same, and neither is zero, the
+ *      transfer is split in two, so it's two interrupts. The first part has
+ *      both, the second has only the one that's longer.
+ * 
+ * Interrupt  The SPI's own interrupts move the bytes and you never have to
+ *            call SPI_Manager_Process. Queueing a transaction starts it if
+ *            the bus is free. Each receive interrupt picks up a byte and puts
+ *            the next one in, and the last one starts the next transaction
+ *            right from the interrupt. The receive interrupt has to be on
+ *            (useRxInterrupt). The transmit interrupt is optional. It keeps
+ *            the Tx FIFO topped off a little sooner. Set the FIFO depth like
+ *            burst mode, as long as your interrupt can always get there
+ *            before the Rx FIFO fills up. Your SPI's callbacks don't have any
+ *            arguments, so make two small functions that call the events for
+ *            your manager. See the example below.
+ * 
+ * Each slave has a queue of transactions. A transaction is a small struct of
+ * yours that says what to send, where to put what comes back, and what
+ * function to call when it's done. Queue as many as you want with
+ * SPI_Manager_Queue and go do something else. They go out in the order you
+ * queued them, each one with its own SS low and high. Don't touch one until
+ * it's finished. SPI_Manager_BeginTransfer still works like it always has. It
+ * uses a transaction that's built into the slave, with the slave's buffers.
+ * 
+ * When the bus is free, the manager picks the slave with the highest priority
+ * (lowest number) that has something queued. Slaves with the same priority
+ * take turns. A transaction that has started is never stopped, so the longest
+ * a slave has to wait is for one transaction from a lower priority slave,
+ * plus everything queued at higher priority. Break up big things like a
+ * display flush into a few transactions so something important can get in
+ * between them. Just like the scheduler, a high priority slave that always
+ * has something queued will starve everything below it.
+ * 
+ * A transaction can also be a list of segments, each with its own write
+ * buffer, read buffer, and length. SS stays low from the first byte of the
+ * first one to the last byte of the last one. A segment with only a write
+ * buffer sends and throws out what comes back, one with only a read buffer
+ * sends its fill byte and keeps what comes back, and one with neither just
+ * sends the fill byte, for things like dummy cycles or clearing a display
+ * with one color. So a command and the data that goes with it can come
+ * right out of the arrays they're already in instead of being copied into
+ * one. The segments aren't copied either, so leave the list alone until the
+ * transaction is finished. In DMA mode each segment is its own DMA transfer
+ * and its own interrupt. Each segment can be up to 65535 bytes, but the 
+ * whole list can add up to more than that, like a big frame buffer split 
+ * into a few segments.
+ * 
+ * @section example_code Example Code (Interrupt Mode)
+ *      SPI mySPI;
+ *      SPIManager myManager;
+ * 
+ *      void MyTxCallback(void)
+ *      {
+ *          SPI_Manager_TransmitEvent(&myManager);
+ *      }
+ * 
+ *      void MyRxCallback(uint8_t (*CallToGetData)(void))
+ *      {
+ *          SPI_Manager_ReceiveEvent(&myManager, CallToGetData);
+ *      }
+ * 
+ *      // After SPI_Init with useRxInterrupt (and maybe useTxInterrupt) on
+ *      SPI_Manager_Create(&myManager, &mySPI);
+ *      SPI_Manager_SetMode(&myManager, SPI_MANAGER_MODE_INTERRUPT);
+ *      SPI_Manager_SetFIFODepth(&myManager, 4);
+ *      SPI_SetTransmitRegisterEmptyCallback(&mySPI, MyTxCallback);
+ *      SPI_SetReceivedDataCallback(&mySPI, MyRxCallback);
+ * 
  * @section license License
  * SPDX-FileCopyrightText: © 2022 Matthew Spinks
  * SPDX-License-Identifier: Zlib
@@ -24,9 +112,22 @@
 #define SPI_MANAGER_H
 
 #include "ISPI.h"
+#include "SPI_DMA.h"
 
 // ***** Defines ***************************************************************
 
+/* Transactions can be queued from an interrupt, like a finished callback.
+These go around the parts that change a queue. In interrupt mode they also
+go around starting a transaction, and a finished callback can end up inside
+one, so make them save and restore the interrupt state instead of just
+turning interrupts back on. */
+#ifndef SPI_MANAGER_ENTER_CRITICAL
+#define SPI_MANAGER_ENTER_CRITICAL()
+#endif
+
+#ifndef SPI_MANAGER_EXIT_CRITICAL
+#define SPI_MANAGER_EXIT_CRITICAL()
+#endif
 
 // ***** Global Variables ******************************************************
 
@@ -35,10 +136,45 @@ typedef enum SPISlaveStateTag
     SPI_STATE_IDLE = 0,
     SPI_STATE_RQ_START,
     SPI_STATE_SEND_BYTE,
-    SPI_STATE_RECEIVE_BYTE
+    SPI_STATE_RECEIVE_BYTE,
+    SPI_STATE_BURST,
+    SPI_STATE_DMA_BUSY,
+    SPI_STATE_INTERRUPT_BUSY
 } SPISlaveState;
 
+typedef enum SPIManagerModeTag
+{
+    SPI_MANAGER_MODE_BYTE = 0,
+    SPI_MANAGER_MODE_BURST,
+    SPI_MANAGER_MODE_DMA,
+    SPI_MANAGER_MODE_INTERRUPT
+} SPIManagerMode;
+
 typedef struct SPISlaveTag SPISlave;
+typedef struct SPIManagerTag SPIManager;
+typedef struct SPITransactionTag SPITransaction;
+
+typedef struct SPISegmentTag
+{
+    const uint8_t *writeBuffer;
+    uint8_t *readBuffer;
+    uint16_t length;
+    uint8_t fill;
+} SPISegment;
+
+struct SPITransactionTag
+{
+    SPITransaction *next;
+    const uint8_t *writeBuffer;
+    uint8_t *readBuffer;
+    uint16_t numBytesToSend;
+    uint16_t numBytesToRead;
+    const SPISegment *segments;
+    uint8_t numSegments;
+    bool queued;
+    bool finished;
+    void (*FinishedCallback)(SPITransaction *transaction);
+};
 
 // @todo add callback function pointers like in old I2C library?
 struct SPISlaveTag
@@ -48,26 +184,83 @@ struct SPISlaveTag
     SPIManager *manager;
     uint8_t *writeBuffer;
     uint8_t *readBuffer;
-    uint16_t numBytesToSend;
-    uint16_t numBytesToRead;
-    uint16_t readWriteCount; // @todo might go back to my old method of making a private struct
+    SPITransaction transfer;
+    SPITransaction *current;
+    SPITransaction *queueHead;
+    SPITransaction *queueTail;
+    uint32_t readWriteCount; // @todo might go back to my old method of making a private struct
+    uint32_t txCount;
+    uint16_t txOffset;
+    uint16_t rxOffset;
+    uint8_t txSegment;
+    uint8_t rxSegment;
     SPISlaveState state;
+    uint8_t priority;
     bool transferFinished;
 };
 
-typedef struct SPIManagerTag
+struct SPIManagerTag
 {
     SPI *peripheral;
     SPISlave *endOfList; // circular linked list
     SPISlave *device;
     bool busy;
     // @todo is the busy flag needed? The SPI manager is just using each slave device's SPISlaveState
-} SPIManager;
+    SPIManagerMode mode;
+    uint8_t fifoDepth;
+    SPIDMAInterface *dma;
+};
 
 /**
  * Description of struct members:
  * // TODO description
  * 
+ * writeBuffer, readBuffer (segment)  Either one can be NULL. Without a
+ *                                    write buffer the fill byte goes out.
+ *                                    Without a read buffer what comes back
+ *                                    is thrown out.
+ * 
+ * length  Bytes in the segment. Zero is allowed and gets skipped. The
+ *         total of all of them can be more than 65535.
+ * 
+ * fill  What to send when there's no write buffer
+ * 
+ * next (transaction)  The next one in the queue
+ * 
+ * segments  A list of segments to go out one after the other with SS low
+ *           the whole time. NULL for a normal transaction.
+ * 
+ * queued  It's in a queue or going out right now. It can't be queued again.
+ * 
+ * finished  Set when the last byte has come back and SS is high
+ * 
+ * transfer  The transaction SPI_Manager_BeginTransfer uses
+ * 
+ * current  The transaction going out right now. NULL if there isn't one.
+ * 
+ * queueHead, queueTail  Transactions waiting. First in, first out.
+ * 
+ * priority  0 is the highest
+ * 
+ * readWriteCount  Bytes that have gone all the way out and back. In DMA mode,
+ *                 where the current part of the transfer starts. These two
+ *                 are 32-bit since a list of segments can add up to more
+ *                 than 16 bits can count.
+ * 
+ * txCount  Bytes put in the Tx register so far. In DMA mode, where the
+ *          current part of the transfer ends.
+ * 
+ * txSegment, txOffset  Where the next byte to send comes from
+ * 
+ * rxSegment, rxOffset  Where the next byte that comes back goes. In DMA
+ *                      mode, rxSegment is the next segment to start.
+ * 
+ * mode  Byte, burst, DMA, or interrupt
+ * 
+ * fifoDepth  Most bytes burst or interrupt mode can have sent that haven't
+ *            come back yet
+ * 
+ * dma  The DMA function table. DMA mode does burst instead if there isn't one.
  */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +279,22 @@ bool SPI_Manager_IsDeviceBusy(SPISlave *self);
 
 void SPI_Manager_BeginTransfer(SPISlave *self, uint16_t numBytesToSend, uint16_t numBytesToRead);
 
+/***************************************************************************//**
+ * @brief Start a transfer made of a list of segments
+ * 
+ * Like SPI_Manager_BeginTransfer, but instead of the slave's buffers it uses
+ * your list of segments, with SS low across all of them. Check it with
+ * SPI_Manager_IsTransferFinished.
+ * 
+ * @param self  pointer to the SPISlave
+ * 
+ * @param segments  your array of SPISegment. Don't change it until finished.
+ * 
+ * @param numSegments  how many are in the array
+ */
+void SPI_Manager_BeginTransferV(SPISlave *self, const SPISegment *segments,
+    uint8_t numSegments);
+
 bool SPI_Manager_IsTransferFinished(SPISlave *self);
 
 void SPI_Manager_Process(SPIManager *self);
@@ -96,4 +305,150 @@ void SPI_Manager_Disable(SPIManager *self);
 
 void SPI_Manager_SetSSPinFunc(SPISlave *self, void (*Function)(bool setPinHigh, void *slaveContext));
 
+/***************************************************************************//**
+ * @brief Choose how the bytes get moved
+ * 
+ * Only change this when there isn't a transfer going.
+ * 
+ * @param self  pointer to the SPIManager you are using
+ * 
+ * @param mode  SPI_MANAGER_MODE_BYTE, SPI_MANAGER_MODE_BURST, 
+ *              SPI_MANAGER_MODE_DMA, or SPI_MANAGER_MODE_INTERRUPT
+ */
+void SPI_Manager_SetMode(SPIManager *self, SPIManagerMode mode);
+
+/***************************************************************************//**
+ * @brief Tell burst mode how many bytes the Rx FIFO can hold
+ * 
+ * Burst mode won't get more bytes ahead than this, so the Rx FIFO can't
+ * overflow. The default is 1.
+ * 
+ * @param self  pointer to the SPIManager you are using
+ * 
+ * @param depth  bytes. 4 for the STM32G0.
+ */
+void SPI_Manager_SetFIFODepth(SPIManager *self, uint8_t depth);
+
+/***************************************************************************//**
+ * @brief Give the manager the DMA functions for your SPI
+ * 
+ * @param self  pointer to the SPIManager you are using
+ * 
+ * @param dma  pointer to the function table, like SPI1_DMA_FunctionTable
+ */
+void SPI_Manager_SetDMAInterface(SPIManager *self, SPIDMAInterface *dma);
+
+/***************************************************************************//**
+ * @brief Finish a DMA transfer
+ * 
+ * Call this from the interrupt for the DMA receive channel. When the transfer
+ * is done, the SS line is set high and the slave is finished. The next call
+ * to SPI_Manager_Process moves on to the next slave.
+ * 
+ * @param self  pointer to the SPIManager you are using
+ */
+void SPI_Manager_DMAInterruptHandler(SPIManager *self);
+
+/***************************************************************************//**
+ * @brief The Tx register is empty (interrupt mode)
+ * 
+ * Call this from your SPI's transmit register empty callback. It puts in as
+ * many bytes as the FIFO depth allows.
+ * 
+ * @param self  pointer to the SPIManager you are using
+ */
+void SPI_Manager_TransmitEvent(SPIManager *self);
+
+/***************************************************************************//**
+ * @brief A byte has come in (interrupt mode)
+ * 
+ * Call this from your SPI's received data callback. It saves the byte, puts
+ * in the next one, and when the transaction is done it sets SS high, calls
+ * the finished callback, and starts the next one.
+ * 
+ * @param self  pointer to the SPIManager you are using
+ * 
+ * @param CallToGetData  the function your SPI's callback was given
+ */
+void SPI_Manager_ReceiveEvent(SPIManager *self, uint8_t (*CallToGetData)(void));
+
+/***************************************************************************//**
+ * @brief Set up a transaction
+ * 
+ * Either buffer can be NULL. If there's nothing to send, zeros go out. The
+ * received bytes line up with the sent bytes. If you send a one byte command
+ * and want four bytes back, read five and skip the first.
+ * 
+ * @param self  pointer to your SPITransaction
+ * 
+ * @param writeBuffer  what to send
+ * 
+ * @param numBytesToSend  how many bytes to send
+ * 
+ * @param readBuffer  where to put what comes back
+ * 
+ * @param numBytesToRead  how many bytes to keep
+ */
+void SPI_Manager_InitTransaction(SPITransaction *self, const uint8_t *writeBuffer,
+    uint16_t numBytesToSend, uint8_t *readBuffer, uint16_t numBytesToRead);
+
+/***************************************************************************//**
+ * @brief Set up a transaction made of a list of segments
+ * 
+ * The bytes of each segment go out right after the one before it, with SS
+ * low the whole time.
+ * 
+ * @param self  pointer to your SPITransaction
+ * 
+ * @param segments  your array of SPISegment. Don't change it until finished.
+ * 
+ * @param numSegments  how many are in the array
+ */
+void SPI_Manager_InitTransactionV(SPITransaction *self,
+    const SPISegment *segments, uint8_t numSegments);
+
+/***************************************************************************//**
+ * @brief Set a function to be called when a transaction is finished
+ * 
+ * This is called after SS is set high. You can queue the same transaction
+ * again, or another one, from here. In DMA mode this is called from the DMA
+ * interrupt, and in interrupt mode from the SPI interrupt.
+ * 
+ * @param self  pointer to your SPITransaction
+ * 
+ * @param Function  format: void SomeFunction(SPITransaction *transaction)
+ */
+void SPI_Manager_SetTransactionCallback(SPITransaction *self,
+    void (*Function)(SPITransaction *transaction));
+
+/***************************************************************************//**
+ * @brief Put a transaction at the end of a slave's queue
+ * 
+ * @param self  pointer to the SPISlave
+ * 
+ * @param transaction  pointer to your SPITransaction
+ * 
+ * @return true if it was queued. False if it's already queued or it has
+ *         nothing to send or read.
+ */
+bool SPI_Manager_Queue(SPISlave *self, SPITransaction *transaction);
+
+/***************************************************************************//**
+ * @brief Check if a transaction is finished
+ * 
+ * @param self  pointer to your SPITransaction
+ * 
+ * @return true if finished
+ */
+bool SPI_Manager_IsTransactionFinished(SPITransaction *self);
+
+/***************************************************************************//**
+ * @brief Set how important a slave is
+ * 
+ * @param self  pointer to the SPISlave
+ * 
+ * @param priority  0 is the highest. Everybody starts at 0.
+ */
+void SPI_Manager_SetSlavePriority(SPISlave *self, uint8_t priority);
+
 #endif  /* SPI_MANAGER_H */
\ No newline at end of file
@@ -0,0 +1,60 @@
+/***************************************************************************//**
+ * @brief SPI1 DMA Implementation Header (Non-Processor Specific)
+ * 
+ * @file SPI1_DMA.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A header for the register side of the SPI DMA functions (SPI_DMA.h)
+ * for SPI1. The function table SPI1_DMA_FunctionTable is declared and defined
+ * in the .c file for your processor. Give it to SPI_Manager_SetDMAInterface.
+ * 
+ * Set up SPI1 with SPI_Init first, like normal. These functions only take
+ * care of the DMA and the interrupt that goes with it.
+ * 
+ * @see SPI_DMA.h for a description of what each function should do.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef SPI1_DMA_H
+#define SPI1_DMA_H
+
+#include "SPI_DMA.h"
+
+// ***** Defines ***************************************************************
+
+
+// ***** Global Variables ******************************************************
+
+/* Declare and define this variable in your implementation's .c file */
+extern SPIDMAInterface SPI1_DMA_FunctionTable;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/* See SPI_DMA.h for a description of what each function should do. */
+
+void SPI1_DMA_StartTransfer(const uint8_t *txData, uint8_t *rxData, uint16_t size);
+
+void SPI1_DMA_StopTransfer(void);
+
+uint8_t SPI1_DMA_GetAndClearEvents(void);
+
+void SPI1_DMA_SetFillByte(uint8_t fill);
+
+#endif  /* SPI1_DMA_H */
@@ -0,0 +1,178 @@
+/***************************************************************************//**
+ * @brief SPI1 DMA Implementation (STM32G0)
+ * 
+ * @file SPI1_DMA_STM32G0.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      The register side of the SPI DMA functions for SPI1 on the STM32G0.
+ * DMA1 channel 3 is used for receive and channel 4 for transmit, so that they
+ * stay out of the way of the UART1 DMA on channels 1 and 2. The G0 lets any
+ * channel go with any peripheral through the DMAMUX, so if you want to use
+ * different channels, change the defines at the top.
+ * 
+ * Only the receive channel has an interrupt. SPI_Manager_DMAInterruptHandler
+ * needs to be called from the DMA1_Channel2_3 interrupt. Turn that on in the
+ * NVIC yourself.
+ * 
+ * The SPI has to be set up for 8-bit data with the Rx FIFO threshold at 8
+ * bits (FRXTH), which is what SPI1_Init does. With 8-bit DMA on both sides
+ * there's no data packing, so odd counts don't need LDMATX or LDMARX.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "SPI1_DMA.h"
+#include <stddef.h> // needed for NULL
+
+/* Include processor specific header files here */
+#include "stm32g071xx.h"
+
+// ***** Defines ***************************************************************
+
+/* Peripheral addresses and registers */
+#define SPI_ADDR        SPI1
+#define DMA_ADDR        DMA1
+#define DMA_CLK_REG     RCC->AHBENR
+#define DMA_CLK_EN_MSK  RCC_AHBENR_DMAEN
+
+/* Receive channel */
+#define RX_CHANNEL      DMA1_Channel3
+#define RX_MUX          DMAMUX1_Channel2 // DMAMUX channel = DMA channel - 1
+#define RX_REQUEST      16               // SPI1_RX. Ref man table 59
+#define RX_FLAGS        (DMA_ISR_TCIF3)
+#define RX_CLEAR        (DMA_IFCR_CGIF3)
+
+/* Transmit channel */
+#define TX_CHANNEL      DMA1_Channel4
+#define TX_MUX          DMAMUX1_Channel3
+#define TX_REQUEST      17               // SPI1_TX
+#define TX_CLEAR        (DMA_IFCR_CGIF4)
+
+// ***** Global Variables ******************************************************
+
+/* Assign functions to the interface */
+SPIDMAInterface SPI1_DMA_FunctionTable = {
+    .SPI_DMA_StartTransfer = SPI1_DMA_StartTransfer,
+    .SPI_DMA_StopTransfer = SPI1_DMA_StopTransfer,
+    .SPI_DMA_GetAndClearEvents = SPI1_DMA_GetAndClearEvents,
+    .SPI_DMA_SetFillByte = SPI1_DMA_SetFillByte,
+};
+
+/* Where the DMA goes when there's nothing to send or nowhere to put it */
+static uint8_t dummyTx = 0;
+static uint8_t dummyRx;
+
+// ***** Static Function Prototypes ********************************************
+
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void SPI1_DMA_StartTransfer(const uint8_t *txData, uint8_t *rxData, uint16_t size)
+{
+    volatile uint8_t throwAway;
+
+    DMA_CLK_REG |= DMA_CLK_EN_MSK;
+
+    /* The channels have to be off to change anything */
+    RX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    TX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    RX_MUX->CCR = RX_REQUEST;
+    TX_MUX->CCR = TX_REQUEST;
+
+    /* Anything left in the Rx FIFO would be the first thing the DMA grabs,
+    and everything after it would be off by one */
+    while(SPI_ADDR->SR & SPI_SR_RXNE)
+        throwAway = *(volatile uint8_t *)&SPI_ADDR->DR;
+    (void)throwAway;
+
+    /* Peripheral to memory, 8-bit both sides, transfer complete interrupt.
+    Only increment the memory if it's a real array. */
+    RX_CHANNEL->CPAR = (uint32_t)&SPI_ADDR->DR;
+    RX_CHANNEL->CNDTR = size;
+    if(rxData != NULL)
+    {
+        RX_CHANNEL->CMAR = (uint32_t)rxData;
+        RX_CHANNEL->CCR = DMA_CCR_MINC | DMA_CCR_TCIE;
+    }
+    else
+    {
+        RX_CHANNEL->CMAR = (uint32_t)&dummyRx;
+        RX_CHANNEL->CCR = DMA_CCR_TCIE;
+    }
+
+    /* Memory to peripheral, 8-bit both sides, no interrupts */
+    TX_CHANNEL->CPAR = (uint32_t)&SPI_ADDR->DR;
+    TX_CHANNEL->CNDTR = size;
+    if(txData != NULL)
+    {
+        TX_CHANNEL->CMAR = (uint32_t)txData;
+        TX_CHANNEL->CCR = DMA_CCR_DIR | DMA_CCR_MINC;
+    }
+    else
+    {
+        TX_CHANNEL->CMAR = (uint32_t)&dummyTx;
+        TX_CHANNEL->CCR = DMA_CCR_DIR;
+    }
+    DMA_ADDR->IFCR = RX_CLEAR | TX_CLEAR;
+
+    /* The order is important. Ref man 32.5.9 (Communication using DMA). Rx
+    DMA first, then the channels, then Tx DMA. */
+    SPI_ADDR->CR2 |= SPI_CR2_RXDMAEN;
+    RX_CHANNEL->CCR |= DMA_CCR_EN;
+    TX_CHANNEL->CCR |= DMA_CCR_EN;
+    SPI_ADDR->CR2 |= SPI_CR2_TXDMAEN;
+}
+
+// *****************************************************************************
+
+void SPI1_DMA_StopTransfer(void)
+{
+    /* And the other way around to stop */
+    RX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    TX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    SPI_ADDR->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+    DMA_ADDR->IFCR = RX_CLEAR | TX_CLEAR;
+}
+
+// *****************************************************************************
+
+uint8_t SPI1_DMA_GetAndClearEvents(void)
+{
+    uint8_t events = 0;
+
+    if(DMA_ADDR->ISR & RX_FLAGS)
+    {
+        /* Normal mode stops by itself, but the channels have to be turned off
+        before they can be loaded again */
+        SPI1_DMA_StopTransfer();
+        events |= SPI_DMA_EVENT_FINISHED;
+    }
+
+    return events;
+}
+
+// *****************************************************************************
+
+void SPI1_DMA_SetFillByte(uint8_t fill)
+{
+    dummyTx = fill;
+}
+
+/*
+ End of File
+ */
@@ -111,7 +111,7 @@ void SPI1_Init(SPIInitType *params)
     SPI_ADDR->CR1 &= ~SPI_CR1_DFF;
 
     /* Set the baud rate. Pclk / prescale */
-    SPI_ADDR->CR1 &= SPI_CR1_BR;
+    SPI_ADDR->CR1 &= ~SPI_CR1_BR;
     SPI_ADDR->CR1 |= (SPI_PRESCALE << 3);
 
     if(role == SPI_ROLE_MASTER)
@@ -229,7 +229,7 @@ void SPI1_ReceivedDataEvent(void)
 uint8_t SPI1_GetReceivedByte(void)
 {
     /* data is right aligned */
-    uint8_t data = (uint8_t)(SPI_ADDR->DR << 8);
+    uint8_t data = (uint8_t)SPI_ADDR->DR;
 
     return data;
 }
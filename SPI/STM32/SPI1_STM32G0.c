@@ -55,15 +55,15 @@ SPIInterface SPI1_FunctionTable = {
 };
 
 static bool useRxInterrupt = false, useTxInterrupt = false;
-SPIRole role = SPI_ROLE_MASTER;
-SPIMode mode = SPI_MODE_0;
-SPISSControl ssControl = SPI_SS_NONE;
+static SPIRole role = SPI_ROLE_MASTER;
+static SPIMode mode = SPI_MODE_0;
+static SPISSControl ssControl = SPI_SS_NONE;
 static bool lockTxFinishedEvent = false, txFinishedEventPending = false,
     lockRxReceivedEvent = false;
 
 // local function pointers
 static void (*TransmitRegisterEmptyCallback)(void);
-static void (*ReceivedDataCallback)(uint8_t data);
+static void (*ReceivedDataCallback)(uint8_t (*CallToGetData)(void));
 static void (*SetSSPin)(bool setHigh);
 
 // ***** Static Function Prototypes ********************************************
@@ -79,9 +79,11 @@ static void (*SetSSPin)(bool setHigh);
 
 void SPI1_Init(SPIInitType *params)
 {
-        role = params->role;
+    role = params->role;
     mode = params->mode;
     ssControl = params->ssControl;
+    useRxInterrupt = params->useRxInterrupt;
+    useTxInterrupt = params->useTxInterrupt;
 
     /* Peripheral clock must be enabled before you can write any registers */
     SPI_CLK_REG |= SPI_CLK_EN_MSK;
@@ -207,8 +209,9 @@ void SPI1_ReceivedDataEvent(void)
 
 uint8_t SPI1_GetReceivedByte(void)
 {
-    /* data is right aligned */
-    uint8_t data = (uint8_t)(SPI_ADDR->DR << 8);
+    /* Data is right aligned. The read has to be 8-bit, or the FIFO will
+    give us two bytes at once (data packing) */
+    uint8_t data = *(volatile uint8_t *)&SPI_ADDR->DR;
 
     return data;
 }
@@ -228,7 +231,7 @@ bool SPI1_IsReceiveRegisterFull(void)
 
 // *****************************************************************************
 
-void SPI1_TransmitFinishedEvent(void)
+void SPI1_TransmitRegisterEmptyEvent(void)
 {
     /* This will prevent recursive calls if we call transmit byte function from
     within the transmit interrupt callback. This requires the pending event
@@ -247,13 +250,15 @@ void SPI1_TransmitFinishedEvent(void)
     {
         TransmitRegisterEmptyCallback();
     }
+    lockTxFinishedEvent = false;
 }
 
 // *****************************************************************************
 
 void SPI1_TransmitByte(uint8_t data)
 {
-    SPI_ADDR->DR = data;
+    /* Same as the read. A 16-bit write would put two bytes in the FIFO. */
+    *(volatile uint8_t *)&SPI_ADDR->DR = data;
 
     /* Enable transmit interrupt here if needed */
     if(useTxInterrupt)
@@ -319,7 +324,7 @@ void SPI1_PendingEventHandler(void)
     if(txFinishedEventPending && !lockTxFinishedEvent)
     {
         txFinishedEventPending = false;
-        SPI1_TransmitFinishedEvent();
+        SPI1_TransmitRegisterEmptyEvent();
     }
 }
 
@@ -332,7 +337,7 @@ void SPI1_SetTransmitRegisterEmptyCallback(void (*Function)(void))
 
 // *****************************************************************************
 
-void SPI1_SetReceivedDataCallback(void (*Function)(uint8_t data))
+void SPI1_SetReceivedDataCallback(void (*Function)(uint8_t (*CallToGetData)(void)))
 {
     ReceivedDataCallback = Function;
 }
@@ -0,0 +1,144 @@
+/* Program to test the one-shot, periodic, and timestamp modes of Timer - MS */
+
+/* A periodic timer is run three ways: polled with Timer_Tick, in a TimerWheel,
+and in timestamp mode against a fake tick counter. All three must finish on
+the exact same ticks. Then ticks are skipped on purpose to make sure every
+version catches up without drifting. Returns non-zero if anything is off. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Timer.h"
+
+#define PERIOD_MS       7
+#define TICK_MS         1
+#define NUM_TICKS       1000
+#define LONG_PERIOD_MS  100000UL
+
+static uint32_t ticks;
+static uint32_t finishTick[3][NUM_TICKS];
+static uint32_t finishCount[3];
+static Timer timers[3];
+static TimerWheel wheel;
+
+uint32_t GetTicks(void)
+{
+    return ticks;
+}
+
+void Finished(void *timerContext)
+{
+    Timer *timer = timerContext;
+    uint32_t which = timer - timers;
+
+    /* The wheel knows exactly which tick it is on, even in the middle of 
+    catching up */
+    if(which == 1)
+        finishTick[which][finishCount[which]++] = TimerWheel_GetTime(&wheel);
+    else
+        finishTick[which][finishCount[which]++] = ticks;
+    Timer_ClearFlag(timer);
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-48s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    Timer oneShot;
+    int failed = 0;
+
+    TimerWheel_Init(&wheel);
+    Timer_InitMs(&timers[0], PERIOD_MS, TICK_MS);
+    Timer_InitMs(&timers[1], PERIOD_MS, TICK_MS);
+    TimerWheel_Add(&wheel, &timers[1]);
+    Timer_InitTimestamp(&timers[2], PERIOD_MS, TICK_MS, GetTicks);
+    for(uint8_t i = 0; i < 3; i++)
+    {
+        Timer_SetMode(&timers[i], TIMER_PERIODIC);
+        Timer_SetFinishedCallback(&timers[i], Finished);
+    }
+
+    /* Start all of them at tick 0. The polled one doesn't actually load its
+    count until the first tick, but it still finishes on the same tick. */
+    for(uint8_t i = 0; i < 3; i++)
+        Timer_Start(&timers[i]);
+
+    printf("Periodic, one tick at a time\n");
+    for(uint32_t t = 0; t < NUM_TICKS / 2; t++)
+    {
+        ticks++;
+        Timer_Tick(&timers[0]);
+        TimerWheel_Tick(&wheel);
+        Timer_Tick(&timers[2]);
+    }
+
+    /* Now skip ahead in uneven steps. The timestamp timer only gets looked at
+    once in a while, which should be fine. */
+    printf("Periodic, skipping ticks\n");
+    for(uint32_t t = NUM_TICKS / 2; t < NUM_TICKS; )
+    {
+        uint32_t step = 1 + (t * 7) % 23;
+        if(t + step > NUM_TICKS)
+            step = NUM_TICKS - t;
+        ticks += step;
+        t += step;
+        Timer_TickMultiple(&timers[0], step);
+        TimerWheel_TickMultiple(&wheel, step);
+        Timer_IsFinished(&timers[2]);
+    }
+
+    uint32_t expected = NUM_TICKS / PERIOD_MS;
+    failed += Check("Polled timer finished once per period",
+        finishCount[0] == expected);
+    failed += Check("Wheel timer finished once per period",
+        finishCount[1] == expected);
+    failed += Check("Timestamp timer finished once per period",
+        finishCount[2] == expected);
+
+    /* The other two get their callbacks in the middle of a big step, so only 
+    the ones from the single steps can be compared to the wheel */
+    int sameTicks = 1;
+    for(uint32_t i = 0; i < expected; i++)
+    {
+        if(finishTick[1][i] != (i + 1) * PERIOD_MS)
+            sameTicks = 0;
+        if(finishTick[1][i] <= NUM_TICKS / 2 && (finishTick[0][i] !=
+            finishTick[1][i] || finishTick[2][i] != finishTick[1][i]))
+            sameTicks = 0;
+    }
+    failed += Check("Finished on the right ticks", sameTicks);
+    failed += Check("Count stays in phase",
+        Timer_GetCount(&timers[0]) == NUM_TICKS % PERIOD_MS &&
+        Timer_GetCount(&timers[1]) == NUM_TICKS % PERIOD_MS &&
+        Timer_GetCount(&timers[2]) == NUM_TICKS % PERIOD_MS);
+
+    /* One-shot with a period that wouldn't fit in 16 bits */
+    printf("One-shot, 32-bit period\n");
+    Timer_InitMs(&oneShot, LONG_PERIOD_MS, TICK_MS);
+    Timer_SetFinishedCallback(&oneShot, NULL);
+    Timer_Start(&oneShot);
+    Timer_TickMultiple(&oneShot, LONG_PERIOD_MS - 1);
+    failed += Check("Still running one tick before the end",
+        Timer_IsRunning(&oneShot) && !Timer_IsFinished(&oneShot));
+    Timer_TickMultiple(&oneShot, 10);
+    failed += Check("Finished and stopped",
+        !Timer_IsRunning(&oneShot) && Timer_IsFinished(&oneShot));
+    failed += Check("Period kept all 32 bits",
+        Timer_GetPeriod(&oneShot) == LONG_PERIOD_MS);
+
+    /* Timestamp one-shot across the counter rolling over */
+    printf("Timestamp, tick counter rolls over\n");
+    ticks = 0xFFFFFFF0;
+    Timer_InitTimestamp(&oneShot, 0x20, TICK_MS, GetTicks);
+    Timer_Start(&oneShot);
+    ticks += 0x1F;
+    failed += Check("Still running before the end", Timer_IsRunning(&oneShot));
+    ticks += 1;
+    failed += Check("Finished after the roll over", Timer_IsFinished(&oneShot));
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,140 @@
+/* Program to compare the timer wheel against calling Timer_Tick on every timer
+- MS */
+
+/* 10,000 timers get random periods from 1 ms to 5 seconds. Every time one
+finishes, its callback starts it again. The same thing is run twice, once by
+calling Timer_Tick on every timer every tick, and once with a TimerWheel. The
+number of times each timer finished must be the same both ways. Build with
+-DTIMER_WHEEL_SIZE=1024 or similar to try out different wheel sizes. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Timer.h"
+
+#define NUM_TIMERS      10000
+#define MAX_PERIOD_MS   5000
+#define NUM_TICKS       100000UL
+#define TICK_MS         1
+
+static Timer timers[NUM_TIMERS];
+static uint16_t periods[NUM_TIMERS];
+static uint32_t polledCount[NUM_TIMERS];
+static uint32_t wheelCount[NUM_TIMERS];
+static uint32_t *finishCount;
+static uint32_t millis;
+
+uint32_t GetMillis(void)
+{
+    return millis;
+}
+
+double Now(void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+void Restart(void *timerContext)
+{
+    Timer *timer = timerContext;
+    finishCount[timer - timers]++;
+    Timer_ClearFlag(timer);
+    Timer_Start(timer);
+}
+
+void Setup(TimerWheel *wheel)
+{
+    for(uint32_t i = 0; i < NUM_TIMERS; i++)
+    {
+        Timer_InitMs(&timers[i], periods[i], TICK_MS);
+        Timer_SetFinishedCallback(&timers[i], Restart);
+        if(wheel)
+            TimerWheel_Add(wheel, &timers[i]);
+        Timer_Start(&timers[i]);
+    }
+}
+
+int main(void)
+{
+    TimerWheel wheel;
+    double start, polledTime, wheelTime;
+    uint64_t total = 0;
+    int failed = 0;
+
+    srand(1);
+    for(uint32_t i = 0; i < NUM_TIMERS; i++)
+        periods[i] = 1 + rand() % MAX_PERIOD_MS;
+
+    /* The old way */
+    finishCount = polledCount;
+    Setup(NULL);
+    start = Now();
+    for(uint32_t t = 0; t < NUM_TICKS; t++)
+    {
+        for(uint32_t i = 0; i < NUM_TIMERS; i++)
+            Timer_Tick(&timers[i]);
+    }
+    polledTime = Now() - start;
+
+    /* Now the wheel */
+    finishCount = wheelCount;
+    TimerWheel_Init(&wheel);
+    Setup(&wheel);
+    start = Now();
+    for(uint32_t t = 0; t < NUM_TICKS; t++)
+        TimerWheel_Tick(&wheel);
+    wheelTime = Now() - start;
+
+    for(uint32_t i = 0; i < NUM_TIMERS; i++)
+    {
+        total += wheelCount[i];
+        if(polledCount[i] != wheelCount[i])
+        {
+            printf("Timer %u finished %u times polled, %u times with the "
+                "wheel\n", i, polledCount[i], wheelCount[i]);
+            failed = 1;
+        }
+    }
+
+    /* Stopping and starting should also work in the middle of things. Take 
+    the callback off so the finished flag stays set. */
+    Timer_SetFinishedCallback(&timers[0], NULL);
+    Timer_Stop(&timers[0]);
+    if(Timer_IsRunning(&timers[0]) || Timer_GetCount(&timers[0]) >= periods[0])
+        failed = 1;
+    Timer_Start(&timers[0]);
+    for(uint32_t t = 0; t < periods[0]; t++)
+        TimerWheel_Tick(&wheel);
+    if(!Timer_IsFinished(&timers[0]))
+        failed = 1;
+
+    /* A timestamp timer with junk left in its wheel links can't get into the
+    wheel, and stopping it can't touch the wheel either */
+    Timer stamp;
+    memset(&stamp, 0xA5, sizeof(stamp));
+    Timer_InitTimestamp(&stamp, 10, TICK_MS, GetMillis);
+    TimerWheel_Add(&wheel, &stamp);
+    Timer_Start(&stamp);
+    Timer_Stop(&stamp);
+    Timer_Start(&stamp);
+    millis += 10;
+    if(stamp.wheel != NULL || !Timer_IsFinished(&stamp))
+        failed = 1;
+    Timer_ClearFlag(&timers[0]);
+    Timer_Start(&timers[0]);
+    for(uint32_t t = 0; t < periods[0]; t++)
+        TimerWheel_Tick(&wheel);
+    if(!Timer_IsFinished(&timers[0]))
+        failed = 1;
+
+    printf("%u timers, %lu ticks, %llu callbacks, wheel size %u\n", NUM_TIMERS,
+        NUM_TICKS, (unsigned long long)total, TIMER_WHEEL_SIZE);
+    printf("  Timer_Tick on every timer: %8.3f s (%6.1f ns per tick)\n",
+        polledTime, polledTime / NUM_TICKS * 1e9);
+    printf("  TimerWheel_Tick:           %8.3f s (%6.1f ns per tick)\n",
+        wheelTime, wheelTime / NUM_TICKS * 1e9);
+    printf("%s\n", failed ? "FAIL" : "PASS");
+
+    return failed;
+}
@@ -9,6 +9,8 @@
  * @date 1/17/19    Modified to use OOP
  * @date 10/1/21    Updated documention
  * @date 2/21/22    Added doxygen
+ * @date 10/18/26   Added the timer wheel
+ * @date 10/18/26   32-bit periods, periodic mode, and timestamp mode
  * 
  * @details
  *      A simple, free-running timer that is great for blinking LED's, buttons,
@@ -16,6 +18,15 @@
  * call the tick function. The function expects you to give the tick rate in 
  * milliseconds.
  * 
+ * The timer wheel is a hashed wheel. Each timer remembers the tick it will 
+ * finish on and goes in the slot for that tick, modulo the number of slots. A 
+ * timer with a period longer than the wheel just gets skipped over until the 
+ * wheel comes back around to the right tick.
+ * 
+ * In timestamp mode, the timer doesn't count anything. It saves the tick it 
+ * will finish on and compares that against the free-running tick counter 
+ * whenever you ask it something. Nothing has to happen on each tick.
+ * 
  * @section license License
  * SPDX-FileCopyrightText: © 2014 Matthew Spinks
  * SPDX-License-Identifier: Zlib
@@ -26,39 +37,115 @@
  * 
  ******************************************************************************/
 
+#include <stddef.h>
 #include "Timer.h"
 
 // ***** Defines ***************************************************************
 
+#define TIMER_WHEEL_MASK        (TIMER_WHEEL_SIZE - 1)
+
+/* The slot number for a timer that is in the expired list */
+#define TIMER_SLOT_EXPIRED      0xFFFF
 
 // ***** Global Variables ******************************************************
 
 
 // ***** Static Function Prototypes ********************************************
 
+static void Timer_Update(Timer *self, uint32_t ticks);
+static void Timer_CheckTimestamp(Timer *self);
+static void Timer_Finish(Timer *self);
+static void TimerWheel_Link(TimerWheel *self, Timer *timer, uint16_t slot);
+static void TimerWheel_Unlink(TimerWheel *self, Timer *timer);
 
 // *****************************************************************************
 
-void Timer_InitMs(Timer *self, uint16_t periodMs, uint16_t tickMs)
+void Timer_InitMs(Timer *self, uint32_t periodMs, uint16_t tickMs)
 {
     if(tickMs != 0)
         self->period = periodMs / tickMs;
 
     self->flags.all = 0;
+    self->wheel = NULL;
+    self->getTicksFunc = NULL;
+}
+
+// *****************************************************************************
+
+void Timer_InitTimestamp(Timer *self, uint32_t periodMs, uint16_t tickMs, 
+    TimerGetTicksFunc GetTicks)
+{
+    Timer_InitMs(self, periodMs, tickMs);
+
+    /* The difference between the finish tick and the current tick is 
+    looked at as a signed number, so the period has to stay under 2^31 */
+    if(self->period > INT32_MAX)
+        self->period = INT32_MAX;
+
+    self->getTicksFunc = GetTicks;
+}
+
+// *****************************************************************************
+
+void Timer_SetMode(Timer *self, TimerMode mode)
+{
+    if(mode == TIMER_PERIODIC)
+        self->flags.periodic = 1;
+    else
+        self->flags.periodic = 0;
 }
 
 // *****************************************************************************
 
 void Timer_Start(Timer *self)
 {
-    if(self->period != 0)
+    if(self->period == 0)
+        return;
+
+    if(self->getTicksFunc)
+    {
+        /* Just remember when it finishes */
+        self->expireTick = self->getTicksFunc() + self->period;
+        self->flags.active = 1;
+    }
+    else if(self->wheel)
+    {
+        /* No need to wait for the next tick like below. The timer goes right 
+        into the slot it will finish on. Starting it again restarts it. */
+        TimerWheel *wheel = self->wheel;
+
+        if(self->flags.active)
+            TimerWheel_Unlink(wheel, self);
+
+        self->expireTick = wheel->now + self->period;
+        self->flags.active = 1;
+        TimerWheel_Link(wheel, self, self->expireTick & TIMER_WHEEL_MASK);
+    }
+    else
+    {
         self->flags.start = 1;
+    }
 }
 
 // *****************************************************************************
 
 void Timer_Stop(Timer *self)
 {
+    /* Same order as Timer_Start. A timestamp timer is never linked into a 
+    wheel, so it must not get unlinked from one. */
+    if(self->getTicksFunc && self->flags.active)
+    {
+        Timer_CheckTimestamp(self);
+        if(self->flags.active)
+            self->count = self->expireTick - self->getTicksFunc();
+    }
+    else if(self->wheel && self->flags.active)
+    {
+        /* Keep the count where it stopped, same as the regular timer */
+        self->count = self->expireTick - self->wheel->now;
+        TimerWheel_Unlink(self->wheel, self);
+    }
+
     self->flags.start = 0;
     self->flags.active = 0;
 }
@@ -67,6 +154,24 @@ void Timer_Stop(Timer *self)
 
 void Timer_Tick(Timer *self)
 {
+    Timer_TickMultiple(self, 1);
+}
+
+// *****************************************************************************
+
+void Timer_TickMultiple(Timer *self, uint32_t ticks)
+{
+    // Timers in a wheel get updated by TimerWheel_Tick instead
+    if(self->wheel)
+        return;
+
+    // Timestamp timers only need to look at the clock
+    if(self->getTicksFunc)
+    {
+        Timer_CheckTimestamp(self);
+        return;
+    }
+
     // Check to see if timer is active and ready to start
     if(self->flags.start && self->period != 0)
     {
@@ -77,32 +182,29 @@ void Timer_Tick(Timer *self)
     
     // Update active timers
     if(self->flags.active)
-    {
-        self->count--;
-        
-        if(self->count == 0)
-        {
-            self->flags.active = 0;
-            self->flags.expired = 1;
-            
-            if(self->timerCallbackFunc)
-            {
-                self->timerCallbackFunc(self);
-            }
-        }
-    }
+        Timer_Update(self, ticks);
 }
 
 // *****************************************************************************
 
-uint16_t Timer_GetCount(Timer *self)
+uint32_t Timer_GetCount(Timer *self)
 {
+    if(self->wheel && self->flags.active)
+        return self->period - (self->expireTick - self->wheel->now);
+
+    if(self->getTicksFunc && self->flags.active)
+    {
+        Timer_CheckTimestamp(self);
+        if(self->flags.active)
+            return self->period - (self->expireTick - self->getTicksFunc());
+    }
+
     return (self->period - self->count);
 }
 
 // *****************************************************************************
 
-uint16_t Timer_GetPeriod(Timer *self)
+uint32_t Timer_GetPeriod(Timer *self)
 {
     return self->period;
 }
@@ -111,6 +213,9 @@ uint16_t Timer_GetPeriod(Timer *self)
 
 bool Timer_IsRunning(Timer *self)
 {
+    if(self->getTicksFunc)
+        Timer_CheckTimestamp(self);
+
     if(self->flags.active)
         return true;
     else
@@ -121,6 +226,9 @@ bool Timer_IsRunning(Timer *self)
 
 bool Timer_IsFinished(Timer *self)
 {
+    if(self->getTicksFunc)
+        Timer_CheckTimestamp(self);
+
     if(self->flags.expired)
         return true;
     else
@@ -141,6 +249,270 @@ void Timer_SetFinishedCallback(Timer *self, TimerCallbackFunc Function)
     self->timerCallbackFunc = Function;
 }
 
+// *****************************************************************************
+
+void TimerWheel_Init(TimerWheel *self)
+{
+    for(uint16_t i = 0; i < TIMER_WHEEL_SIZE; i++)
+        self->slots[i] = NULL;
+
+    self->expired = NULL;
+    self->now = 0;
+}
+
+// *****************************************************************************
+
+void TimerWheel_Add(TimerWheel *self, Timer *timer)
+{
+    /* A timestamp timer already knows when it finishes. It doesn't need a
+    wheel, and Timer_Start would never put it in one. */
+    if(timer->getTicksFunc)
+        return;
+
+    if(timer->wheel)
+        TimerWheel_Remove(timer);
+
+    timer->flags.start = 0;
+    timer->flags.active = 0;
+    timer->wheel = self;
+}
+
+// *****************************************************************************
+
+void TimerWheel_Remove(Timer *timer)
+{
+    if(timer->wheel == NULL)
+        return;
+
+    Timer_Stop(timer);
+    timer->wheel = NULL;
+}
+
+// *****************************************************************************
+
+void TimerWheel_Tick(TimerWheel *self)
+{
+    Timer *timer, *next;
+
+    self->now++;
+
+    /* Move everything that finishes on this tick over to the expired list 
+    first. Once the slot is done, it doesn't matter what the callbacks do to 
+    it. */
+    timer = self->slots[self->now & TIMER_WHEEL_MASK];
+    while(timer)
+    {
+        next = timer->next;
+        if(timer->expireTick == self->now)
+        {
+            TimerWheel_Unlink(self, timer);
+            TimerWheel_Link(self, timer, TIMER_SLOT_EXPIRED);
+        }
+        timer = next;
+    }
+
+    /* Take them off one at a time. If a callback stops a timer that hasn't 
+    had its turn yet, it just gets removed from this list and won't finish. If 
+    a callback starts a timer again, it goes back into the wheel. */
+    while(self->expired)
+    {
+        timer = self->expired;
+        TimerWheel_Unlink(self, timer);
+        timer->flags.expired = 1;
+
+        if(timer->flags.periodic)
+        {
+            /* Going from the old finish tick instead of now means a periodic 
+            timer never drifts */
+            timer->expireTick += timer->period;
+            TimerWheel_Link(self, timer, timer->expireTick & TIMER_WHEEL_MASK);
+        }
+        else
+        {
+            timer->count = 0;
+            timer->flags.active = 0;
+        }
+
+        if(timer->timerCallbackFunc)
+        {
+            timer->timerCallbackFunc(timer);
+        }
+    }
+}
+
+// *****************************************************************************
+
+void TimerWheel_TickMultiple(TimerWheel *self, uint32_t ticks)
+{
+    /* Every slot in between still has to be looked at. But a slot with 
+    nothing in it is cheap. */
+    while(ticks-- > 0)
+        TimerWheel_Tick(self);
+}
+
+// *****************************************************************************
+
+uint32_t TimerWheel_GetNextDeadline(TimerWheel *self)
+{
+    uint32_t soonest = TIMER_NO_DEADLINE;
+
+    if(self->expired)
+        return 0;
+
+    /* Anything found in slot i is either i ticks away or at least one whole 
+    trip around the wheel further. So once the soonest one found so far is 
+    i or less, nothing in the later slots can beat it. */
+    for(uint32_t i = 1; i <= TIMER_WHEEL_SIZE; i++)
+    {
+        Timer *timer = self->slots[(self->now + i) & TIMER_WHEEL_MASK];
+        while(timer)
+        {
+            uint32_t ticks = timer->expireTick - self->now;
+            if(ticks < soonest)
+                soonest = ticks;
+            timer = timer->next;
+        }
+
+        if(soonest <= i)
+            break;
+    }
+    return soonest;
+}
+
+// *****************************************************************************
+
+uint32_t TimerWheel_GetTime(TimerWheel *self)
+{
+    return self->now;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Count down a running timer
+ * 
+ * If more ticks went by than what was left on the count, the timer finishes. 
+ * A periodic timer reloads and keeps going with whatever ticks are left over, 
+ * so it will finish once for every period that went by. 
+ * 
+ * @param self  pointer to the Timer that you are using
+ * 
+ * @param ticks  number of ticks that went by
+ */
+static void Timer_Update(Timer *self, uint32_t ticks)
+{
+    while(self->flags.active && ticks >= self->count)
+    {
+        ticks -= self->count;
+        self->count = 0;
+        Timer_Finish(self);
+
+        /* The callback could have stopped the timer or started it again. A 
+        one-shot timer that gets started again will start on the next tick 
+        like normal. */
+        if(!self->flags.periodic || self->flags.start)
+            return;
+    }
+
+    if(self->flags.active)
+        self->count -= ticks;
+}
+
+/***************************************************************************//**
+ * @brief Compare a timestamp timer against the tick counter
+ * 
+ * @param self  pointer to the Timer that you are using
+ */
+static void Timer_CheckTimestamp(Timer *self)
+{
+    if(!self->flags.active || self->getTicksFunc == NULL)
+        return;
+
+    uint32_t now = self->getTicksFunc();
+
+    /* Signed, so that it still works when the tick counter rolls over */
+    while(self->flags.active && (int32_t)(now - self->expireTick) >= 0)
+    {
+        /* Going from the old finish tick keeps a periodic timer from 
+        drifting. If we fell behind, it finishes once for each period. */
+        if(self->flags.periodic)
+            self->expireTick += self->period;
+        else
+            self->count = 0;
+
+        Timer_Finish(self);
+    }
+}
+
+/***************************************************************************//**
+ * @brief Set the flags and call the callback when a timer finishes
+ * 
+ * @param self  pointer to the Timer that you are using
+ */
+static void Timer_Finish(Timer *self)
+{
+    if(self->flags.periodic)
+        self->count = self->period;
+    else
+        self->flags.active = 0;
+
+    self->flags.expired = 1;
+
+    if(self->timerCallbackFunc)
+    {
+        self->timerCallbackFunc(self);
+    }
+}
+
+/***************************************************************************//**
+ * @brief Put a timer at the front of a slot
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ * 
+ * @param timer  pointer to the Timer
+ * 
+ * @param slot  slot number, or TIMER_SLOT_EXPIRED for the expired list
+ */
+static void TimerWheel_Link(TimerWheel *self, Timer *timer, uint16_t slot)
+{
+    Timer **head = (slot == TIMER_SLOT_EXPIRED) ? &self->expired : 
+        &self->slots[slot];
+
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = *head;
+    if(*head)
+        (*head)->prev = timer;
+    *head = timer;
+}
+
+/***************************************************************************//**
+ * @brief Take a timer out of whichever slot it is in
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ * 
+ * @param timer  pointer to the Timer
+ */
+static void TimerWheel_Unlink(TimerWheel *self, Timer *timer)
+{
+    if(timer->prev)
+        timer->prev->next = timer->next;
+    else if(timer->slot == TIMER_SLOT_EXPIRED)
+        self->expired = timer->next;
+    else
+        self->slots[timer->slot] = timer->next;
+
+    if(timer->next)
+        timer->next->prev = timer->prev;
+
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
 /*
  End of File
  */
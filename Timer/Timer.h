@@ -9,6 +9,8 @@
  * @date 1/17/19    Modified to use OOP
  * @date 10/1/21    Updated documention
  * @date 2/21/22    Added doxygen
+ * @date 10/18/26   Added the timer wheel
+ * @date 10/18/26   32-bit periods, periodic mode, and timestamp mode
  * 
  * @details
  *      A generic, free-running timer to do whatever you need. To create a
@@ -38,6 +40,30 @@
  * function prototype, call SetFinishedCallback and give it your function as an 
  * argument.
  * 
+ * If you have a lot of timers, calling Timer_Tick on every one of them every 
+ * millisecond adds up, even when none of them are close to finishing. For that 
+ * there is the TimerWheel. Add your timers to a wheel and call TimerWheel_Tick 
+ * once per tick instead. Each timer is put in a slot based on the tick it will 
+ * finish on, so each tick only looks at the timers in one slot. Starting and 
+ * stopping a timer is just adding or removing it from a linked list. Once a 
+ * timer is added to a wheel, Timer_Start, Timer_Stop, Timer_IsFinished, and 
+ * the callback all work the same way as before. Timer_Tick does nothing to a 
+ * timer that belongs to a wheel.
+ * 
+ * By default a timer is one-shot. It stops when it finishes. Use 
+ * Timer_SetMode to make it periodic instead. A periodic timer reloads itself 
+ * and keeps running, and the expired flag gets set again every period. If you 
+ * miss some ticks, call Timer_TickMultiple with the number of ticks that went 
+ * by. A periodic timer will finish once for every period that was missed, so 
+ * it won't drift.
+ * 
+ * There is also a timestamp mode. Instead of counting, the timer saves the 
+ * tick it will finish on and compares it against a free-running tick counter 
+ * that you provide, like a SysTick count. The timer is checked whenever you 
+ * call Timer_Tick, Timer_IsFinished, Timer_IsRunning, or Timer_GetCount, and 
+ * the callback happens from there. A timer that nobody is looking at costs 
+ * nothing. The period must be less than 2^31 ticks.
+ * 
  * @section example_code Example_Code
  *      Timer startUpTimer;
  *      Timer_InitMs(&startupTimer, STARTUP_TIME_MS, TICK_1MS);
@@ -48,6 +74,18 @@
  *          // do some stuff
  *      }
  * 
+ *      // With a wheel, call TimerWheel_Tick every 1 ms instead of Timer_Tick
+ *      TimerWheel wheel;
+ *      TimerWheel_Init(&wheel);
+ *      Timer_InitMs(&startupTimer, STARTUP_TIME_MS, TICK_1MS);
+ *      TimerWheel_Add(&wheel, &startupTimer);
+ *      Timer_Start(&startupTimer);
+ * 
+ *      // Timestamp mode, where GetMillis returns a free-running 1 ms counter
+ *      Timer_InitTimestamp(&blinkTimer, BLINK_TIME_MS, TICK_1MS, GetMillis);
+ *      Timer_SetMode(&blinkTimer, TIMER_PERIODIC);
+ *      Timer_Start(&blinkTimer);
+ * 
  * @section license License
  * SPDX-FileCopyrightText: © 2014 Matthew Spinks
  * SPDX-License-Identifier: Zlib
@@ -68,6 +106,15 @@
 
 // ***** Defines ***************************************************************
 
+/* The number of slots in a TimerWheel. It must be a power of two. Timers with 
+a period longer than this still work, they just get looked at once every time 
+the wheel goes around. More slots means fewer timers in each slot. */
+#ifndef TIMER_WHEEL_SIZE
+#define TIMER_WHEEL_SIZE    64
+#endif
+
+/* Returned by TimerWheel_GetNextDeadline when nothing is running */
+#define TIMER_NO_DEADLINE   0xFFFFFFFF
 
 // ***** Global Variables ******************************************************
 
@@ -76,17 +123,37 @@ initiated the callback. This is so that you can service multiple Timer
 callbacks with the same function if you desire. */
 typedef void (*TimerCallbackFunc)(void *timerContext); 
 
+/* For timestamp mode. Returns a free-running tick count. */
+typedef uint32_t (*TimerGetTicksFunc)(void);
+
+typedef enum TimerModeTag
+{
+    TIMER_ONE_SHOT = 0,
+    TIMER_PERIODIC,
+} TimerMode;
+
+struct TimerWheelTag;
+
 typedef struct TimerTag
 {
     TimerCallbackFunc timerCallbackFunc;
-    uint16_t period;
-    uint16_t count;
+    TimerGetTicksFunc getTicksFunc;
+    uint32_t period;
+    uint32_t count;
+
+    /* Only used when the timer belongs to a TimerWheel */
+    struct TimerWheelTag *wheel;
+    struct TimerTag *next;
+    struct TimerTag *prev;
+    uint32_t expireTick;
+    uint16_t slot;
     
     union {
         struct {
             unsigned start      :1;
             unsigned active     :1;
             unsigned expired    :1;
+            unsigned periodic   :1;
             unsigned            :0; // fill to nearest byte
         };
         uint8_t all;
@@ -109,6 +176,34 @@ typedef struct TimerTag
  * 
  * expired  This flag is set whenever the timer period reaches the specified 
  *          count. You must clear this flag yourself
+ * 
+ * periodic When this is set, the timer reloads itself when it finishes
+ * 
+ * getTicksFunc The free-running tick counter for timestamp mode, or NULL
+ * 
+ * wheel    The TimerWheel this timer belongs to, or NULL
+ * 
+ * next, prev   Links to the other timers in the same slot of the wheel
+ * 
+ * expireTick   The tick that the timer will finish on, for the wheel or for
+ *              timestamp mode
+ * 
+ * slot     Which slot of the wheel the timer is in
+ */
+
+typedef struct TimerWheelTag
+{
+    Timer *slots[TIMER_WHEEL_SIZE];
+    Timer *expired;
+    uint32_t now;
+} TimerWheel;
+
+/** slots    Each slot is a list of the timers that finish on a tick that 
+ *           lands on that slot
+ * 
+ *  expired  Timers that have finished and are waiting for their callback
+ * 
+ *  now      The number of ticks since the wheel was initialized
  */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,7 +224,37 @@ typedef struct TimerTag
  * 
  * @param tickMs  how often you plan to call the Timer Tick function
  */
-void Timer_InitMs(Timer *self, uint16_t periodMs, uint16_t tickMs);
+void Timer_InitMs(Timer *self, uint32_t periodMs, uint16_t tickMs);
+
+/***************************************************************************//**
+ * @brief Initialize a Timer object in timestamp mode.
+ * 
+ * The timer compares against the tick counter instead of counting. The tick 
+ * rate should be how fast the GetTicks counter goes up. You don't have to call 
+ * Timer_Tick, but you can if you want the callback to happen on time.
+ * 
+ * @param self  pointer to the Timer that you are using
+ * 
+ * @param periodMs  the period of the timer in milliseconds
+ * 
+ * @param tickMs  how many milliseconds each count of GetTicks is
+ * 
+ * @param GetTicks  format: uint32_t SomeFunction(void)
+ */
+void Timer_InitTimestamp(Timer *self, uint32_t periodMs, uint16_t tickMs, 
+    TimerGetTicksFunc GetTicks);
+
+/***************************************************************************//**
+ * @brief Choose one-shot or periodic.
+ * 
+ * Call this after initializing the timer. A one-shot timer stops when it 
+ * finishes. A periodic timer reloads and keeps going until you stop it.
+ * 
+ * @param self  pointer to the Timer that you are using
+ * 
+ * @param mode  TIMER_ONE_SHOT or TIMER_PERIODIC
+ */
+void Timer_SetMode(Timer *self, TimerMode mode);
 
 /***************************************************************************//**
  * @brief Start the timer.
@@ -158,6 +283,18 @@ void Timer_Stop(Timer *self);
  */
 void Timer_Tick(Timer *self);
 
+/***************************************************************************//**
+ * @brief Update the timer after missing some ticks.
+ * 
+ * Same as calling Timer_Tick that many times, only faster. A periodic timer 
+ * will finish once for every period that went by.
+ * 
+ * @param self  pointer to the Timer that you are using
+ * 
+ * @param ticks  the number of ticks that went by
+ */
+void Timer_TickMultiple(Timer *self, uint32_t ticks);
+
 /***************************************************************************//**
  * @brief Get the count of the timer.
  * 
@@ -168,7 +305,7 @@ void Timer_Tick(Timer *self);
  *
  * @return  the current value of the count
  */
-uint16_t Timer_GetCount(Timer *self);
+uint32_t Timer_GetCount(Timer *self);
 
 /***************************************************************************//**
  * @brief Get the period of the timer.
@@ -177,7 +314,7 @@ uint16_t Timer_GetCount(Timer *self);
  *
  * @return  value of the period (in ticks)
  */
-uint16_t Timer_GetPeriod(Timer *self);
+uint32_t Timer_GetPeriod(Timer *self);
 
 /***************************************************************************//**
  * @brief Check if timer is running.
@@ -219,4 +356,81 @@ void Timer_ClearFlag(Timer *self);
  */
 void Timer_SetFinishedCallback(Timer *self, TimerCallbackFunc Function);
 
+/***************************************************************************//**
+ * @brief Initialize a TimerWheel
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ */
+void TimerWheel_Init(TimerWheel *self);
+
+/***************************************************************************//**
+ * @brief Give a Timer to a TimerWheel
+ * 
+ * Call this after Timer_InitMs. The tick rate you gave Timer_InitMs should be 
+ * how often you call TimerWheel_Tick. After this, the timer is started and 
+ * stopped with Timer_Start and Timer_Stop like normal. If the timer is 
+ * already running, it will be stopped first. Timers made with 
+ * Timer_InitTimestamp are left alone, since they don't need ticks at all.
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ * 
+ * @param timer  pointer to the Timer to add
+ */
+void TimerWheel_Add(TimerWheel *self, Timer *timer);
+
+/***************************************************************************//**
+ * @brief Take a Timer back out of its TimerWheel
+ * 
+ * The timer is stopped. After this, it goes back to using Timer_Tick.
+ * 
+ * @param timer  pointer to the Timer to remove
+ */
+void TimerWheel_Remove(Timer *timer);
+
+/***************************************************************************//**
+ * @brief Update every timer in the wheel
+ * 
+ * Call this at the tick rate you gave Timer_InitMs. Only the timers in one 
+ * slot are looked at. Callbacks are called from here. It's safe to start or 
+ * stop any timer from inside a callback.
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ */
+void TimerWheel_Tick(TimerWheel *self);
+
+/***************************************************************************//**
+ * @brief Update the wheel after missing some ticks
+ * 
+ * Every timer that should have finished in that time will finish, in order. 
+ * Periodic timers finish once for each period.
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ * 
+ * @param ticks  the number of ticks that went by
+ */
+void TimerWheel_TickMultiple(TimerWheel *self, uint32_t ticks);
+
+/***************************************************************************//**
+ * @brief Get the number of ticks until the next timer in the wheel finishes
+ * 
+ * Useful if you want to sleep until then instead of ticking. The slots are 
+ * looked at in order starting from the next tick, so this stops as soon as it 
+ * finds the soonest one. If every timer is more than one trip around the 
+ * wheel away, every timer gets looked at.
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ *
+ * @return  number of ticks, or TIMER_NO_DEADLINE if no timers are running
+ */
+uint32_t TimerWheel_GetNextDeadline(TimerWheel *self);
+
+/***************************************************************************//**
+ * @brief Get the number of ticks since the wheel was initialized
+ * 
+ * @param self  pointer to the TimerWheel that you are using
+ *
+ * @return  the tick count. It rolls over after 2^32 ticks
+ */
+uint32_t TimerWheel_GetTime(TimerWheel *self);
+
 #endif /* TIMER_H */
\ No newline at end of file
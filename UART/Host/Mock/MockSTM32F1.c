@@ -0,0 +1,32 @@
+/***************************************************************************//**
+ * @brief Stand In STM32F1 Registers For Testing On A PC
+ * 
+ * @file MockSTM32F1.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      The register blocks for stm32f10x_map.h in this folder
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#include "stm32f10x_map.h"
+
+// ***** Global Variables ******************************************************
+
+USART_TypeDef MockUSART1, MockUSART2, MockUSART3, MockUART4, MockUART5;
+RCC_TypeDef MockRCC;
+
+/*
+ End of File
+ */
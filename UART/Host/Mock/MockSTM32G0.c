@@ -0,0 +1,207 @@
+/***************************************************************************//**
+ * @brief Stand In STM32G0 Registers For Testing On A PC
+ * 
+ * @file MockSTM32G0.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * @date 10/18/26  Added the loopback so the real driver can move data
+ * 
+ * @details
+ *      The register blocks for stm32g071xx.h in this folder, and the loopback
+ * that plays the part of the USART1 hardware. See stm32g071xx.h for how to
+ * use it.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#include "stm32g071xx.h"
+#include <stdbool.h>
+
+// ***** Defines ***************************************************************
+
+#define FIFO_SIZE   8
+
+/* Nothing the driver writes to TDR is more than 9 bits, so this means nothing
+has been written since the last sync */
+#define TDR_EMPTY   0xFFFFFFFF
+
+typedef struct FifoTag
+{
+    uint8_t data[FIFO_SIZE];
+    uint8_t head;
+    uint8_t count;
+} Fifo;
+
+// ***** Global Variables ******************************************************
+
+USART_TypeDef MockG0USART1;
+RCC_TypeDef MockG0RCC;
+
+/* The "hardware" */
+static bool loopbackOn = false;
+static Fifo txFifo, rxFifo;
+static uint32_t overrunCount;
+
+/* How many bytes left in the Tx FIFO sets TXFT, for each TXFTCFG value. 1/8,
+1/4, 1/2, 3/4, 7/8, and empty. */
+static const uint8_t txThresholdLUT[8] = {1, 2, 4, 6, 7, 0, 0, 0};
+
+// ***** Static Function Prototypes ********************************************
+
+static void FifoPut(Fifo *fifo, uint8_t data);
+static uint8_t FifoGet(Fifo *fifo);
+static void UpdateFlags(void);
+
+// *****************************************************************************
+
+void MockG0_Sync(void)
+{
+    USART_TypeDef *regs = &MockG0USART1;
+
+    if(!loopbackOn)
+        return;
+
+    /* Same as the real one, writing TDR with the FIFO full is ignored */
+    if(regs->TDR != TDR_EMPTY)
+    {
+        if(txFifo.count < FIFO_SIZE && (regs->CR1 & USART_CR1_UE) &&
+            (regs->CR1 & USART_CR1_TE))
+        {
+            FifoPut(&txFifo, (uint8_t)regs->TDR);
+            regs->ISR &= ~USART_ISR_TC;
+        }
+        regs->TDR = TDR_EMPTY;
+    }
+
+    if(regs->ICR & USART_ICR_TCCF)
+        regs->ISR &= ~USART_ISR_TC;
+    regs->ICR = 0;
+
+    UpdateFlags();
+}
+
+// *****************************************************************************
+
+uint32_t MockG0_ReadRDR(void)
+{
+    if(loopbackOn && rxFifo.count > 0)
+    {
+        MockG0USART1.RDR_[0] = FifoGet(&rxFifo);
+        UpdateFlags();
+    }
+    return 0;
+}
+
+// *****************************************************************************
+
+void MockG0_LoopbackReset(void)
+{
+    loopbackOn = true;
+    txFifo.head = txFifo.count = 0;
+    rxFifo.head = rxFifo.count = 0;
+    overrunCount = 0;
+    MockG0USART1.TDR = TDR_EMPTY;
+    MockG0USART1.ICR = 0;
+    MockG0USART1.ISR |= USART_ISR_TC;
+    UpdateFlags();
+}
+
+// *****************************************************************************
+
+void MockG0_LoopbackTick(void)
+{
+    USART_TypeDef *regs = &MockG0USART1;
+    uint8_t data;
+
+    /* Pick up the last thing the driver wrote */
+    MockG0_Sync();
+
+    if(txFifo.count == 0 || !(regs->CR1 & USART_CR1_UE) ||
+        !(regs->CR1 & USART_CR1_TE))
+        return;
+
+    data = FifoGet(&txFifo);
+    if(txFifo.count == 0)
+        regs->ISR |= USART_ISR_TC;
+
+    if(regs->CR1 & USART_CR1_RE)
+    {
+        if(rxFifo.count == FIFO_SIZE)
+            overrunCount++;
+        else
+            FifoPut(&rxFifo, data);
+    }
+    UpdateFlags();
+}
+
+// *****************************************************************************
+
+uint32_t MockG0_LoopbackGetOverrunCount(void)
+{
+    return overrunCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Put a byte on the end of a FIFO. Check that it isn't full.
+ */
+static void FifoPut(Fifo *fifo, uint8_t data)
+{
+    fifo->data[(fifo->head + fifo->count) % FIFO_SIZE] = data;
+    fifo->count++;
+}
+
+/***************************************************************************//**
+ * @brief Take a byte from the front of a FIFO. Check that it isn't empty.
+ */
+static uint8_t FifoGet(Fifo *fifo)
+{
+    uint8_t data = fifo->data[fifo->head];
+    fifo->head = (fifo->head + 1) % FIFO_SIZE;
+    fifo->count--;
+    return data;
+}
+
+/***************************************************************************//**
+ * @brief Set the FIFO flags in ISR from how full the FIFO's are
+ * 
+ * TXFNF is set while there's room in the Tx FIFO. TXFT is set when it's down
+ * to the threshold in TXFTCFG. RXFNE is set while there's something in the 
+ * Rx FIFO. The rest of ISR is left alone.
+ */
+static void UpdateFlags(void)
+{
+    USART_TypeDef *regs = &MockG0USART1;
+    uint32_t config = (regs->CR3 & USART_CR3_TXFTCFG) >> USART_CR3_TXFTCFG_Pos;
+    uint32_t flags = regs->ISR & ~(USART_ISR_TXE_TXFNF | USART_ISR_TXFT |
+        USART_ISR_RXNE_RXFNE);
+
+    if(txFifo.count < FIFO_SIZE)
+        flags |= USART_ISR_TXE_TXFNF;
+
+    if(txFifo.count <= txThresholdLUT[config])
+        flags |= USART_ISR_TXFT;
+
+    if(rxFifo.count > 0)
+        flags |= USART_ISR_RXNE_RXFNE;
+
+    regs->ISR = flags;
+}
+
+/*
+ End of File
+ */
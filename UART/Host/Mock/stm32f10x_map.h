@@ -0,0 +1,99 @@
+/***************************************************************************//**
+ * @brief Stand In STM32F1 Register Header For Testing On A PC
+ * 
+ * @file stm32f10x_map.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      Just enough of the real stm32f10x_map.h for the UART driver. The 
+ * register blocks are plain variables (in MockSTM32F1.c) instead of fixed 
+ * addresses, so a test program can set the status bits and look at what the 
+ * driver wrote. The bit values are the same as the real ones. Put this folder
+ * ahead of the real header in the include path.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef STM32F10X_MAP_H
+#define STM32F10X_MAP_H
+
+#include <stdint.h>
+
+// ***** Defines ***************************************************************
+
+#define USART1      (&MockUSART1)
+#define USART2      (&MockUSART2)
+#define USART3      (&MockUSART3)
+#define UART4       (&MockUART4)
+#define UART5       (&MockUART5)
+#define RCC         (&MockRCC)
+
+#define USART_SR_PE         0x0001
+#define USART_SR_FE         0x0002
+#define USART_SR_NE         0x0004
+#define USART_SR_ORE        0x0008
+#define USART_SR_IDLE       0x0010
+#define USART_SR_RXNE       0x0020
+#define USART_SR_TC         0x0040
+#define USART_SR_TXE        0x0080
+
+#define USART_CR1_RE        0x0004
+#define USART_CR1_TE        0x0008
+#define USART_CR1_IDLEIE    0x0010
+#define USART_CR1_RXNEIE    0x0020
+#define USART_CR1_TCIE      0x0040
+#define USART_CR1_TXEIE     0x0080
+#define USART_CR1_PS        0x0200
+#define USART_CR1_PCE       0x0400
+#define USART_CR1_M         0x1000
+#define USART_CR1_UE        0x2000
+
+#define USART_CR2_STOP      0x3000
+#define USART_CR2_STOP_0    0x1000
+#define USART_CR2_STOP_1    0x2000
+
+#define USART_CR3_DMAR      0x0040
+#define USART_CR3_DMAT      0x0080
+#define USART_CR3_RTSE      0x0100
+#define USART_CR3_CTSE      0x0200
+
+#define RCC_APB2ENR_USART1EN    0x00004000
+#define RCC_APB1ENR_USART2EN    0x00020000
+#define RCC_APB1ENR_USART3EN    0x00040000
+#define RCC_APB1ENR_UART4EN     0x00080000
+#define RCC_APB1ENR_UART5EN     0x00100000
+
+// ***** Global Variables ******************************************************
+
+typedef struct
+{
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t GTPR;
+} USART_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t AHBENR;
+    volatile uint32_t APB2ENR;
+    volatile uint32_t APB1ENR;
+} RCC_TypeDef;
+
+extern USART_TypeDef MockUSART1, MockUSART2, MockUSART3, MockUART4, MockUART5;
+extern RCC_TypeDef MockRCC;
+
+#endif  /* STM32F10X_MAP_H */
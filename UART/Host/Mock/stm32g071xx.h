@@ -0,0 +1,153 @@
+/***************************************************************************//**
+ * @brief Stand In STM32G0 Register Header For Testing On A PC
+ * 
+ * @file stm32g071xx.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * @date 10/18/26  Added the loopback so the real driver can move data
+ * 
+ * @details
+ *      Just enough of the real stm32g071xx.h for the USART1 driver. Same idea
+ * as stm32f10x_map.h in this folder. The register blocks are plain variables
+ * in MockSTM32G0.c and the bit values are the same as the real ones.
+ * 
+ * The registers just sit there until you call MockG0_LoopbackReset. After
+ * that, USART1 acts like it has its Tx pin wired back to its Rx pin, with an
+ * 8 byte FIFO each way. To make that work without changing the driver, every
+ * use of USART1 calls MockG0_Sync first. It takes whatever was written to TDR
+ * since last time and puts it in the Tx FIFO, handles ICR, and updates the
+ * ISR flags. RDR is a macro that pops the Rx FIFO each time it's used. Call
+ * MockG0_LoopbackTick to move one character across the wire. Nothing calls
+ * the interrupt for you. Check the flags and call the events from your test
+ * the same way the real USART1 interrupt would.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef STM32G071XX_H
+#define STM32G071XX_H
+
+#include <stdint.h>
+
+// ***** Defines ***************************************************************
+
+#define USART1      (MockG0_Sync(), &MockG0USART1)
+#define RCC         (&MockG0RCC)
+
+#define USART_CR1_UE                0x00000001
+#define USART_CR1_RE                0x00000004
+#define USART_CR1_TE                0x00000008
+#define USART_CR1_RXNEIE_RXFNEIE    0x00000020
+#define USART_CR1_TXEIE_TXFNFIE     0x00000080
+#define USART_CR1_PS                0x00000200
+#define USART_CR1_PCE               0x00000400
+#define USART_CR1_M0                0x00001000
+#define USART_CR1_OVER8             0x00008000
+#define USART_CR1_M1                0x10000000
+#define USART_CR1_M                 (USART_CR1_M0 | USART_CR1_M1)
+#define USART_CR1_FIFOEN            0x20000000
+
+#define USART_CR2_STOP_0            0x00001000
+#define USART_CR2_STOP_1            0x00002000
+#define USART_CR2_ABREN             0x00100000
+#define USART_CR2_ABRMODE_Pos       21
+#define USART_CR2_ABRMODE           0x00600000
+
+#define USART_CR3_RTSE              0x00000100
+#define USART_CR3_CTSE              0x00000200
+#define USART_CR3_TXFTIE            0x00800000
+#define USART_CR3_TXFTCFG_Pos       29
+#define USART_CR3_TXFTCFG           0xE0000000
+
+#define USART_RQR_ABRRQ             0x00000001
+
+#define USART_ISR_RXNE_RXFNE        0x00000020
+#define USART_ISR_TC                0x00000040
+#define USART_ISR_TXE_TXFNF         0x00000080
+#define USART_ISR_ABRE              0x00004000
+#define USART_ISR_ABRF              0x00008000
+#define USART_ISR_TXFT              0x08000000
+
+#define USART_ICR_TCCF              0x00000040
+
+#define USART_PRESC_PRESCALER       0x0000000F
+
+#define RCC_APBENR2_USART1EN        0x00004000
+
+// ***** Global Variables ******************************************************
+
+typedef struct
+{
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t BRR;
+    volatile uint32_t GTPR;
+    volatile uint32_t RTOR;
+    volatile uint32_t RQR;
+    volatile uint32_t ISR;
+    volatile uint32_t ICR;
+    volatile uint32_t RDR_[1];   // use RDR, see below
+    volatile uint32_t TDR;
+    volatile uint32_t PRESC;
+} USART_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t AHBENR;
+    volatile uint32_t APBENR1;
+    volatile uint32_t APBENR2;
+} RCC_TypeDef;
+
+extern USART_TypeDef MockG0USART1;
+extern RCC_TypeDef MockG0RCC;
+
+/* Reading RDR takes the next byte out of the Rx FIFO */
+#define RDR         RDR_[MockG0_ReadRDR()]
+
+// ***** Function Prototypes ***************************************************
+
+/***************************************************************************//**
+ * @brief Bring the registers up to date. USART1 calls this for you.
+ * 
+ * Does nothing until MockG0_LoopbackReset is called.
+ */
+void MockG0_Sync(void);
+
+/***************************************************************************//**
+ * @brief Put the next byte from the Rx FIFO in RDR. The RDR macro calls this.
+ * 
+ * @return uint32_t  always 0, the index into RDR_
+ */
+uint32_t MockG0_ReadRDR(void);
+
+/***************************************************************************//**
+ * @brief Turn on the loopback, empty both FIFO's, and clear the overruns
+ */
+void MockG0_LoopbackReset(void);
+
+/***************************************************************************//**
+ * @brief One character time. Move one byte from the Tx FIFO to the Rx FIFO
+ * 
+ * Nothing moves unless UE and TE are set. If RE isn't set, the byte is lost.
+ * If the Rx FIFO is full, the byte is lost and it counts as an overrun.
+ */
+void MockG0_LoopbackTick(void);
+
+/***************************************************************************//**
+ * @brief Get the number of bytes lost because the Rx FIFO was full
+ * 
+ * @return uint32_t  number of overruns
+ */
+uint32_t MockG0_LoopbackGetOverrunCount(void);
+
+#endif  /* STM32G071XX_H */
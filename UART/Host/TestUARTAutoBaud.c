@@ -0,0 +1,156 @@
+/* Program to test the timer auto baud with the STM32F1 driver - MS */
+
+/* Build from the UART/Host folder with:
+gcc -std=c99 -IMock -I. -I../Interface -I../STM32 -I"../../Hardware Timer (PWM)/Interface"
+TestUARTAutoBaud.c Mock/MockSTM32F1.c ../STM32/UART_STM32F1.c
+../STM32/UART_STM32F1_Ports.c ../Interface/IUART.c ../Interface/UART_AutoBaud.c
+"../../Hardware Timer (PWM)/Interface/IHardwareTimer.c"
+
+The F1 can't do auto baud on its own, so this is the timer way. A pretend
+timer counts at 72 MHz. The other end sends 0x55 over and over, at a bunch of
+baud rates, with its clock off by up to 1%, like an RC oscillator. Each edge
+gets to the interrupt a random number of ticks late. The usual baud rates
+should come out exactly. Odd ones like 31250 (MIDI) can't be rounded to
+anything, so they should come out as close as the delay allows. That's the
+most the delay can change (plus a tick for the timer) over the 9 bits between
+the first and last edge, times the rounding in the BRR, plus 100 ppm for
+rounding to whole baud rates. The timer count rolls over in the middle of a
+lot of them. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "UART2.h"
+#include "UART_AutoBaud.h"
+
+#define TIMER_HZ        72000000UL
+#define UART_CLK_HZ     36000000UL
+#define MAX_LATENCY     12          // ticks
+#define TRIES           500
+
+static UART uart;
+static HWTimer timer;
+static UARTAutoBaud autoBaud;
+static uint16_t timerCount;
+
+// ***** Pretend Timer *********************************************************
+
+uint16_t FakeTimer_GetCount(void)
+{
+    return timerCount;
+}
+
+HWTimerInterface FakeTimer_FunctionTable = {
+    .HWTimer_GetCount = FakeTimer_GetCount,
+};
+
+// *****************************************************************************
+
+/* Send one 0x55 starting at startTick. Every bit flips, so there's an edge at
+every bit, and the stop bit makes ten. */
+void SendSync(double startTick, double ticksPerBit)
+{
+    for(uint8_t k = 0; k < UART_AUTO_BAUD_EDGES_0x55; k++)
+    {
+        double edge = startTick + k * ticksPerBit;
+        timerCount = (uint16_t)((uint32_t)edge + rand() % (MAX_LATENCY + 1));
+        UART_AutoBaud_EdgeEvent(&autoBaud);
+    }
+}
+
+double RandomOffset(double maxPercent)
+{
+    return (rand() / (double)RAND_MAX * 2.0 - 1.0) * maxPercent / 100.0;
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const uint32_t standard[] = { 1200, 9600, 19200, 57600, 115200,
+        230400, 460800, 921600, 1000000 };
+    static const uint32_t odd[] = { 31250, 100000, 290000, 750000 };
+    uint32_t wrongStandard = 0, wrongOdd = 0, notDone = 0;
+    double worstOdd = 0;
+    int failed = 0;
+    char line[80];
+
+    srand(1);
+    UART_Create(&uart, &UART2_FunctionTable);
+    HWTimer_Create(&timer, NULL, &FakeTimer_FunctionTable);
+    UART_AutoBaud_Create(&autoBaud, &uart, UART_CLK_HZ, &timer, TIMER_HZ);
+
+    for(uint8_t b = 0; b < sizeof(standard) / sizeof(standard[0]); b++)
+    {
+        for(uint16_t t = 0; t < TRIES; t++)
+        {
+            double baud = standard[b] * (1.0 + RandomOffset(1.0));
+            UART_AutoBaud_Start(&autoBaud, UART_AUTO_BAUD_EDGES_0x55);
+            SendSync(rand() % 65536, TIMER_HZ / baud);
+            if(UART_AutoBaud_GetStatus(&autoBaud) != UART_AUTO_BAUD_DONE)
+                notDone++;
+            else if(UART_AutoBaud_GetBaudRate(&autoBaud) != standard[b] ||
+                UART_AutoBaud_GetBRGValue(&autoBaud) !=
+                UART_ComputeBRGValue(&uart, standard[b], UART_CLK_HZ))
+                wrongStandard++;
+        }
+    }
+
+    for(uint8_t b = 0; b < sizeof(odd) / sizeof(odd[0]); b++)
+    {
+        for(uint16_t t = 0; t < TRIES; t++)
+        {
+            double baud = odd[b] * (1.0 + RandomOffset(0.1));
+            double error, allowed;
+            UART_AutoBaud_Start(&autoBaud, UART_AUTO_BAUD_EDGES_0x55);
+            SendSync(rand() % 65536, TIMER_HZ / baud);
+            if(UART_AutoBaud_GetStatus(&autoBaud) != UART_AUTO_BAUD_DONE)
+            {
+                notDone++;
+                continue;
+            }
+            /* Compare what the UART will really run at */
+            error = UART_ComputeActualBaudRate(&uart,
+                UART_AutoBaud_GetBRGValue(&autoBaud), UART_CLK_HZ) / baud - 1.0;
+            if(error < 0)
+                error = -error;
+            allowed = (1.0 + (MAX_LATENCY + 1) /
+                (9.0 * TIMER_HZ / baud - MAX_LATENCY - 1)) *
+                (1.0 + 0.5 / (UART_CLK_HZ / baud - 1.0)) - 1.0 + 0.0001;
+            if(error / allowed > worstOdd)
+                worstOdd = error / allowed;
+            if(error > allowed)
+                wrongOdd++;
+        }
+    }
+
+    printf("Timer auto baud, %u tries each\n", TRIES);
+    failed += Check("Every one finished", notDone == 0);
+    failed += Check("Usual baud rates +/- 1% come out exact",
+        wrongStandard == 0);
+    sprintf(line, "Odd ones as close as the delay allows (worst %.0f%%)",
+        worstOdd * 100);
+    failed += Check(line, wrongOdd == 0);
+
+    printf("Errors\n");
+    UART_AutoBaud_Start(&autoBaud, UART_AUTO_BAUD_EDGES_0x55);
+    SendSync(0, 1.0);
+    failed += Check("Faster than the timer can tell is an error",
+        UART_AutoBaud_GetStatus(&autoBaud) == UART_AUTO_BAUD_ERROR);
+
+    UART_AutoBaud_Start(&autoBaud, UART_AUTO_BAUD_MAX_EDGES + 1);
+    failed += Check("Too many edges is an error",
+        UART_AutoBaud_GetStatus(&autoBaud) == UART_AUTO_BAUD_ERROR);
+
+    UART_AutoBaud_Create(&autoBaud, &uart, UART_CLK_HZ, NULL, 0);
+    UART_AutoBaud_Start(&autoBaud, UART_AUTO_BAUD_EDGES_0x55);
+    failed += Check("No timer and a UART that can't do it is an error",
+        UART_AutoBaud_GetStatus(&autoBaud) == UART_AUTO_BAUD_ERROR &&
+        UART_AutoBaud_GetBRGValue(&autoBaud) == 0);
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
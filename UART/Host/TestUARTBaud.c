@@ -0,0 +1,216 @@
+/* Program to test the G0 baud rate search and auto baud - MS */
+
+/* Build from the UART/Host folder with:
+gcc -std=c99 -IMock -I. -I../Interface -I../STM32 -I"../../Hardware Timer (PWM)/Interface"
+TestUARTBaud.c Mock/MockSTM32G0.c ../STM32/UART1_STM32G0.c
+../Interface/IUART.c ../Interface/UART_AutoBaud.c
+"../../Hardware Timer (PWM)/Interface/IHardwareTimer.c" -lm
+
+Build it again with -DOVER8=1 to test it with oversampling by 8. Then the BRR
+holds USARTDIV, which counts half clocks, but without bit 0. Anything the ref
+man way of rounding 2 * clk / baud would pick, the hardware cuts off, so the
+search has to land on the nearest even one.
+
+For a bunch of baud rates and clocks, the BRG value from ComputeBRGValue is
+checked against every prescaler and the BRR values around the best one for
+each. Nothing should be closer. The table shows the error the old way (no
+prescaler, fraction cut off) and the new way. Then the auto baud goes through
+UART_AutoBaud with the stand in registers playing the part of the UART. */
+
+#include <stdio.h>
+#include <math.h>
+#include "UART1.h"
+#include "UART_AutoBaud.h"
+#include "stm32g071xx.h"
+
+static UART uart;
+static UARTAutoBaud autoBaud;
+
+static const uint16_t prescalers[12] = {1,2,4,6,8,10,12,16,32,64,128,256};
+
+/* With OVER8, USARTDIV counts half clocks */
+static bool over8;
+static uint32_t divPerClock;
+
+// *****************************************************************************
+
+/* USARTDIV from the BRR, the way the hardware sees it. With OVER8, BRR[2:0]
+is USARTDIV[3:1], so bit 0 is always 0. */
+uint32_t DivFromBRR(uint32_t BRR)
+{
+    if(over8)
+        return (BRR & 0xFFF0) | ((BRR & 0x0007) << 1);
+    else
+        return BRR;
+}
+
+/* Error in ppm for a prescaler and USARTDIV, with floats so it doesn't depend
+on the integer math being tested */
+double ErrorPPM(uint32_t clk, uint32_t presc, uint32_t div, uint32_t baud)
+{
+    double actual = (double)clk * divPerClock / ((double)prescalers[presc] * div);
+    return fabs(actual - baud) / baud * 1e6;
+}
+
+/* The best any prescaler and BRR could do */
+double BestPossible(uint32_t clk, uint32_t baud)
+{
+    double best = 1e12;
+
+    for(uint32_t p = 0; p < 12; p++)
+    {
+        uint32_t center = (uint32_t)((uint64_t)clk * divPerClock / (prescalers[p] * baud));
+        for(uint32_t div = (center > 1) ? center - 1 : 1; div <= center + 1; div++)
+        {
+            if(div < 16 || div > 0xFFFF || (over8 && (div & 1)))
+                continue;
+            if(ErrorPPM(clk, p, div, baud) < best)
+                best = ErrorPPM(clk, p, div, baud);
+        }
+    }
+    return best;
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const uint32_t clocks[] = { 64000000UL, 16000000UL, 1000000UL };
+    static const uint32_t bauds[] = { 110, 300, 1200, 9600, 19200, 57600,
+        115200, 230400, 460800, 921600, 1000000, 2000000, 3000000, 4000000 };
+    UARTInitType params;
+    uint32_t BRGValue, worseThanBest = 0, worseThanOld = 0, wrongActual = 0;
+    uint32_t tooFast = 0, tested = 0;
+    int failed = 0;
+
+    UART_Create(&uart, &UART1_FunctionTable);
+
+    /* Find out which way the driver was built */
+    UART_SetInitTypeToDefaultParams(&params);
+    UART_SetInitBRGValue(&params, 556);
+    UART_Init(&uart, &params);
+    over8 = (USART1->CR1 & USART_CR1_OVER8) != 0;
+    divPerClock = over8 ? 2 : 1;
+    printf("Oversampling by %u\n", over8 ? 8 : 16);
+
+    printf("%10s %10s %6s %8s %12s %12s\n", "clock", "baud", "presc", "BRR",
+        "old ppm", "new ppm");
+    for(uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        for(uint8_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++)
+        {
+            uint32_t clk = clocks[c], baud = bauds[b];
+            uint32_t oldDiv = clk / baud * divPerClock, presc, BRR;
+            double newError, oldError;
+            int32_t reported;
+
+            BRGValue = UART_ComputeBRGValue(&uart, baud, clk);
+            if((uint64_t)clk * divPerClock / baud < 16)
+            {
+                /* Less than 16 clocks a bit (8 with OVER8) can't be done */
+                tooFast += (BRGValue != 0);
+                continue;
+            }
+            tested++;
+            presc = BRGValue >> 16;
+            BRR = BRGValue & 0xFFFF;
+            newError = ErrorPPM(clk, presc, DivFromBRR(BRR), baud);
+            reported = UART_ComputeBaudErrorPPM(&uart, baud, clk);
+
+            /* The old way wrote clk / baud into a 16-bit register */
+            if(oldDiv > 0xFFFF)
+                oldError = ErrorPPM(clk, 0, oldDiv & 0xFFFF, baud);
+            else
+                oldError = ErrorPPM(clk, 0, oldDiv, baud);
+
+            printf("%10u %10u %6u %8u %12.0f %12.0f\n", clk, baud,
+                prescalers[presc], BRR, oldError, newError);
+
+            if(newError > BestPossible(clk, baud) + 0.001)
+                worseThanBest++;
+            if(newError > oldError + 0.001)
+                worseThanOld++;
+            /* The reported error is rounded to a whole baud */
+            if(fabs(fabs((double)reported) - newError) > 500000.0 / baud + 1)
+                wrongActual++;
+        }
+    }
+
+    printf("BRG search\n");
+    failed += Check("Nothing closer with any prescaler or BRR",
+        worseThanBest == 0);
+    failed += Check("Never worse than the old way", worseThanOld == 0);
+    failed += Check("Reported ppm matches the BRG value", wrongActual == 0);
+    failed += Check("0 when USARTDIV would be less than 16",
+        tooFast == 0 && tested > 30);
+    failed += Check("300 baud at 64 MHz needs a prescaler",
+        (UART_ComputeBRGValue(&uart, 300, 64000000UL) >> 16) != 0);
+    if(over8)
+    {
+        /* 2 * 64 MHz / 115200 = 1111.1. The ref man way would write 1111 as
+        BRR 0x453, which the hardware reads as 1110 (+1001 ppm). 1112 is 
+        -800 ppm. */
+        failed += Check("115200 at 64 MHz: BRR 0x454, not cut off to 1110",
+            UART_ComputeBRGValue(&uart, 115200, 64000000UL) == 0x454);
+        failed += Check("BRR[3] is always clear",
+            (UART_ComputeBRGValue(&uart, 115200, 64000000UL) & 0x0008) == 0);
+    }
+    else
+    {
+        failed += Check("115200 at 64 MHz: no prescaler, BRR 556",
+            UART_ComputeBRGValue(&uart, 115200, 64000000UL) == 556);
+    }
+
+    /* Init puts the prescaler where it goes */
+    UART_SetInitTypeToDefaultParams(&params);
+    BRGValue = UART_ComputeBRGValue(&uart, 300, 64000000UL);
+    UART_SetInitBRGValue(&params, BRGValue);
+    UART_Init(&uart, &params);
+    failed += Check("Init splits the BRG value into PRESC and BRR",
+        USART1->PRESC == (BRGValue >> 16) && USART1->BRR == (BRGValue & 0xFFFF));
+    failed += Check("Actual baud rate from the BRG value",
+        UART_ComputeActualBaudRate(&uart, BRGValue, 64000000UL) == 300);
+
+    printf("Hardware auto baud\n");
+    UART_AutoBaud_Create(&autoBaud, &uart, 64000000UL, NULL, 0);
+    failed += Check("Idle before it's started",
+        UART_GetAutoBaudStatus(&uart, NULL) == UART_AUTO_BAUD_IDLE);
+
+    USART1->RQR = 0;
+    UART_AutoBaud_Start(&autoBaud, 0);
+    failed += Check("Start turns on ABR for 0x55 and asks for a new one",
+        (USART1->CR2 & USART_CR2_ABREN) &&
+        (USART1->CR2 & USART_CR2_ABRMODE) == USART_CR2_ABRMODE &&
+        (USART1->RQR & USART_RQR_ABRRQ) && (USART1->CR1 & USART_CR1_UE));
+    failed += Check("Busy until the UART says it's done",
+        UART_AutoBaud_GetStatus(&autoBaud) == UART_AUTO_BAUD_BUSY &&
+        UART_AutoBaud_GetBaudRate(&autoBaud) == 0);
+
+    /* The UART found 57600 (115200 with OVER8) with the prescaler that Init
+    left */
+    USART1->PRESC = 0;
+    USART1->BRR = over8 ? 0x453 : 1111;
+    USART1->ISR |= USART_ISR_ABRF;
+    failed += Check("Done, with the BRR the UART found",
+        UART_AutoBaud_GetStatus(&autoBaud) == UART_AUTO_BAUD_DONE &&
+        UART_AutoBaud_GetBRGValue(&autoBaud) == (over8 ? 0x453u : 1111u) &&
+        UART_AutoBaud_GetBaudRate(&autoBaud) == (over8 ? 115315u : 57606u));
+
+    UART_AutoBaud_Start(&autoBaud, 0);
+    USART1->ISR |= USART_ISR_ABRE;
+    failed += Check("Error when the UART couldn't do it",
+        UART_AutoBaud_GetStatus(&autoBaud) == UART_AUTO_BAUD_ERROR);
+
+    USART1->ISR = 0;
+    UART_Init(&uart, &params);
+    failed += Check("Init turns it back off",
+        !(USART1->CR2 & USART_CR2_ABREN) &&
+        UART_GetAutoBaudStatus(&uart, NULL) == UART_AUTO_BAUD_IDLE);
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
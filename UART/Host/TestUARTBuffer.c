@@ -0,0 +1,293 @@
+/* Program to test the block transmit and receive functions in IUART with the
+real STM32G0 driver - MS */
+
+/* Build from the UART/Host folder with:
+gcc -std=c99 -IMock -I. -I../Interface -I../STM32 TestUARTBuffer.c
+Mock/MockSTM32G0.c ../STM32/UART1_STM32G0.c ../Interface/IUART.c
+
+The driver is UART1_STM32G0.c itself, running on the stand in registers with
+the loopback turned on, so the Tx pin is wired back to the Rx pin and both
+have an 8 byte FIFO. The same 1000 bytes get sent around one byte at a time
+and then with TransmitBuffer and ReceiveBuffer. Every tick is one character
+time on the wire. The interrupt only gets to run every so many ticks, like it
+would if the processor was busy with something else. With one byte per
+interrupt, the wire sits there waiting on the interrupt. With the FIFO it
+shouldn't have to. Flow control is set to callbacks the whole time so we can
+count how many times the CTS pin gets checked. */
+
+#include <stdio.h>
+#include <string.h>
+#include "UART1.h"
+#include "stm32g071xx.h"
+
+#define NUM_BYTES       1000
+#define MAX_TICKS       (NUM_BYTES * 20)
+
+static UART uart;
+static uint8_t txData[NUM_BYTES], rxData[NUM_BYTES];
+static uint16_t txIndex, rxIndex;
+static bool ctsHigh;
+static uint32_t ctsChecks, txFinishedCalls, rxFinishedCalls;
+static uint16_t rxFinishedCount;
+static uint32_t interrupts;
+
+typedef struct ResultTag
+{
+    uint32_t ticks;
+    uint32_t interrupts;
+    uint32_t ctsChecks;
+    bool dataGood;
+} Result;
+
+// ***** Callbacks *************************************************************
+
+bool IsCTSPinLow(void)
+{
+    ctsChecks++;
+    return !ctsHigh;
+}
+
+void SetRTSPin(bool setPinHigh)
+{
+    (void)setPinHigh;
+}
+
+/* One byte at a time */
+void TransmitNextByte(void)
+{
+    if(txIndex < NUM_BYTES)
+        UART_TransmitByte(&uart, txData[txIndex++]);
+}
+
+void ReceiveOneByte(uint8_t (*CallToGetData)(void))
+{
+    uint8_t data = CallToGetData();
+
+    if(rxIndex < NUM_BYTES)
+        rxData[rxIndex++] = data;
+}
+
+/* Block at a time */
+void TransmitBufferFinished(void)
+{
+    txFinishedCalls++;
+}
+
+void ReceiveBufferFinished(uint16_t numBytes)
+{
+    rxFinishedCalls++;
+    rxFinishedCount = numBytes;
+}
+
+/* What the USART1 interrupt has to look like on the real thing. The block
+transmit turns off TXFNFIE and waits on the FIFO threshold interrupt, so TXFT
+has to call the transmit event too. Returns true if it did anything. */
+bool USART1_IRQHandler(void)
+{
+    uint32_t isr = USART1->ISR, cr1 = USART1->CR1, cr3 = USART1->CR3;
+    bool rxFlag = (cr1 & USART_CR1_RXNEIE_RXFNEIE) && (isr & USART_ISR_RXNE_RXFNE);
+    bool txFlag = ((cr1 & USART_CR1_TXEIE_TXFNFIE) && (isr & USART_ISR_TXE_TXFNF)) ||
+        ((cr3 & USART_CR3_TXFTIE) && (isr & USART_ISR_TXFT));
+
+    if(!rxFlag && !txFlag)
+        return false;
+
+    interrupts++;
+    if(rxFlag)
+        UART1_ReceivedDataEvent();
+    if(txFlag)
+        UART1_TransmitRegisterEmptyEvent();
+    return true;
+}
+
+// *****************************************************************************
+
+void Setup(void)
+{
+    UARTInitType params;
+
+    MockG0_LoopbackReset();
+    UART_Create(&uart, &UART1_FunctionTable);
+    UART_SetInitTypeParams(&params, UART_ONE_P, UART_NO_PARITY, false,
+        UART_FLOW_CALLBACKS, true, true);
+    UART_SetInitBRGValue(&params, UART_ComputeBRGValue(&uart, 115200,
+        16000000UL));
+    UART_Init(&uart, &params);
+    UART_SetIsCTSPinLowFunc(&uart, IsCTSPinLow);
+    UART_SetRTSPinFunc(&uart, SetRTSPin);
+    UART_SetTransmitRegisterEmptyCallback(&uart, TransmitNextByte);
+    UART_SetReceivedDataCallback(&uart, ReceiveOneByte);
+    UART_SetTransmitBufferFinishedCallback(&uart, TransmitBufferFinished);
+    UART_SetReceiveBufferFinishedCallback(&uart, ReceiveBufferFinished);
+
+    memset(rxData, 0, sizeof(rxData));
+    txIndex = rxIndex = 0;
+    ctsHigh = false;
+    ctsChecks = txFinishedCalls = rxFinishedCalls = rxFinishedCount = 0;
+    interrupts = 0;
+}
+
+/* Run the wire and the interrupt until Done says so. Returns the ticks */
+uint32_t RunUntil(uint8_t interruptEvery, bool (*Done)(void))
+{
+    uint32_t tick = 0;
+
+    while(!Done() && tick < MAX_TICKS)
+    {
+        tick++;
+        MockG0_LoopbackTick();
+        if(tick % interruptEvery == 0)
+            USART1_IRQHandler();
+        UART_PendingEventHandler(&uart);
+    }
+    return tick;
+}
+
+void RunTicks(uint16_t ticks)
+{
+    while(ticks--)
+    {
+        MockG0_LoopbackTick();
+        USART1_IRQHandler();
+        UART_PendingEventHandler(&uart);
+    }
+}
+
+bool ByteModeDone(void)
+{
+    return rxIndex == NUM_BYTES;
+}
+
+bool BufferModeDone(void)
+{
+    return rxFinishedCalls > 0 && txFinishedCalls > 0;
+}
+
+Result RunByteMode(uint8_t interruptEvery)
+{
+    Result result;
+
+    Setup();
+    TransmitNextByte();
+    result.ticks = RunUntil(interruptEvery, ByteModeDone);
+    result.interrupts = interrupts;
+    result.ctsChecks = ctsChecks;
+    result.dataGood = memcmp(txData, rxData, NUM_BYTES) == 0 &&
+        MockG0_LoopbackGetOverrunCount() == 0;
+    return result;
+}
+
+Result RunBufferMode(uint8_t interruptEvery)
+{
+    Result result;
+
+    Setup();
+    UART_ReceiveBuffer(&uart, rxData, NUM_BYTES);
+    UART_TransmitBuffer(&uart, txData, NUM_BYTES);
+    result.ticks = RunUntil(interruptEvery, BufferModeDone);
+    result.interrupts = interrupts;
+    result.ctsChecks = ctsChecks;
+    result.dataGood = memcmp(txData, rxData, NUM_BYTES) == 0 &&
+        MockG0_LoopbackGetOverrunCount() == 0 && txFinishedCalls == 1 &&
+        rxFinishedCalls == 1 && rxFinishedCount == NUM_BYTES;
+    return result;
+}
+
+void PrintResult(const char *name, uint8_t interruptEvery, Result *r)
+{
+    printf("  %-12s %6u %12.2f %12.2f %12.2f\n", name, interruptEvery,
+        (double)r->ticks / NUM_BYTES, (double)r->interrupts / NUM_BYTES,
+        (double)r->ctsChecks / NUM_BYTES);
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    int failed = 0;
+    Result byte1, byte4, buffer1, buffer4;
+
+    for(uint16_t i = 0; i < NUM_BYTES; i++)
+        txData[i] = (uint8_t)(i * 7 + 3);
+
+    byte1 = RunByteMode(1);
+    byte4 = RunByteMode(4);
+    buffer1 = RunBufferMode(1);
+    buffer4 = RunBufferMode(4);
+
+    printf("%u bytes through the G0 driver\n", NUM_BYTES);
+    printf("  %-12s %6s %12s %12s %12s\n", "mode", "every", "ticks/byte",
+        "irq/byte", "cts/byte");
+    PrintResult("byte", 1, &byte1);
+    PrintResult("byte", 4, &byte4);
+    PrintResult("buffer", 1, &buffer1);
+    PrintResult("buffer", 4, &buffer4);
+    printf("\n");
+
+    failed += Check("Byte at a time gets everything",
+        byte1.dataGood && byte4.dataGood);
+    failed += Check("Buffer gets everything, callbacks called once",
+        buffer1.dataGood && buffer4.dataGood);
+    failed += Check("Buffer keeps the wire busy with a slow interrupt",
+        buffer4.ticks <= NUM_BYTES + 16 && byte4.ticks >= 3 * NUM_BYTES);
+    failed += Check("Buffer takes fewer interrupts",
+        buffer4.interrupts <= NUM_BYTES / 4 + 4 &&
+        buffer4.interrupts < byte4.interrupts / 3);
+    failed += Check("CTS checked once per refill instead of every byte",
+        byte1.ctsChecks >= NUM_BYTES && buffer4.ctsChecks <= NUM_BYTES / 4 + 4);
+
+    /* Only one at a time */
+    Setup();
+    UART_ReceiveBuffer(&uart, rxData, NUM_BYTES);
+    UART_TransmitBuffer(&uart, txData, NUM_BYTES);
+    failed += Check("Can't start another one while busy",
+        !UART_TransmitBuffer(&uart, txData, 10) &&
+        !UART_ReceiveBuffer(&uart, rxData, 10));
+
+    /* The driver is still going from that one, so let it finish */
+    RunUntil(1, BufferModeDone);
+
+    /* CTS goes high part way through. Nothing should move until it goes low
+    again, then it should pick right back up. */
+    Setup();
+    UART_ReceiveBuffer(&uart, rxData, NUM_BYTES);
+    UART_TransmitBuffer(&uart, txData, NUM_BYTES);
+    RunTicks(100);
+    ctsHigh = true;
+    RunTicks(100);
+    uint16_t stuckAt = UART_ReceiveBufferStop(&uart);
+    UART_ReceiveBuffer(&uart, rxData + stuckAt, NUM_BYTES - stuckAt);
+    RunTicks(100);
+    bool stopped = (UART_ReceiveBufferStop(&uart) == 0);
+    UART_ReceiveBuffer(&uart, rxData + stuckAt, NUM_BYTES - stuckAt);
+    ctsHigh = false;
+    RunUntil(1, BufferModeDone);
+    failed += Check("Waits while CTS is high, then finishes",
+        stuckAt > 0 && stuckAt < NUM_BYTES && stopped &&
+        memcmp(txData, rxData, NUM_BYTES) == 0);
+
+    /* Not knowing how many are coming */
+    Setup();
+    UART_ReceiveBuffer(&uart, rxData, 50);
+    UART_TransmitBuffer(&uart, txData, 10);
+    RunTicks(20);
+    failed += Check("Stop gives back what came in so far",
+        rxFinishedCalls == 0 && UART_ReceiveBufferStop(&uart) == 10 &&
+        memcmp(txData, rxData, 10) == 0);
+
+    /* Something that doesn't have the block functions */
+    UARTInterface emptyTable = {0};
+    UART other;
+    UART_Create(&other, &emptyTable);
+    failed += Check("Missing from the table just returns false",
+        !UART_TransmitBuffer(&other, txData, 10) &&
+        !UART_ReceiveBuffer(&other, rxData, 10) &&
+        UART_ReceiveBufferStop(&other) == 0);
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
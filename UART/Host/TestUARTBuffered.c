@@ -0,0 +1,214 @@
+/* Program to test the buffered UART with the loopback UART - MS */
+
+/* Build from the UART/Host folder with:
+gcc -std=c99 -I. -I../Interface -I../STM32 -I../../Buffer TestUARTBuffered.c
+UART1_Loopback.c ../Interface/IUART.c ../Interface/UART_Buffered.c
+../../Buffer/Buffer.c
+
+The same 2000 bytes get written and read back around the loopback. Every tick
+is one character time on the wire. The interrupt only gets to run every so
+many ticks, like it would if the processor was busy with something else. It's
+run with a 1 byte FIFO, like a UART that only has a data register, and with
+the full 8 byte FIFO. The main loop writes whatever fits and reads whatever is
+there every tick. The table shows how many ticks, interrupts, overruns, and
+events it took, and the high water marks of both Buffers. With only a data
+register, a slow interrupt means received bytes get lost. With the FIFO the
+interrupt can be late and still pick up several bytes each time. */
+
+#include <stdio.h>
+#include <string.h>
+#include "UART1_Loopback.h"
+#include "UART_Buffered.h"
+
+#define NUM_BYTES       2000
+#define MAX_TICKS       (NUM_BYTES * 20)
+#define ARRAY_SIZE      64
+
+static UART uart;
+static UARTBuffered bufferedUART;
+static uint8_t txArray[ARRAY_SIZE], rxArray[ARRAY_SIZE];
+static uint8_t txData[NUM_BYTES], rxData[NUM_BYTES];
+static uint16_t txIndex, rxIndex;
+static bool ctsHigh;
+
+typedef struct ResultTag
+{
+    uint32_t ticks;
+    uint32_t interrupts;
+    uint32_t overruns;
+    UARTBufferedStats stats;
+    bool dataGood;
+} Result;
+
+// ***** Callbacks *************************************************************
+
+bool IsCTSPinLow(void)
+{
+    return !ctsHigh;
+}
+
+void TransmitCallback(void)
+{
+    UART_Buffered_TransmitEvent(&bufferedUART);
+}
+
+void ReceiveCallback(uint8_t (*CallToGetData)(void))
+{
+    UART_Buffered_ReceiveEvent(&bufferedUART, CallToGetData);
+}
+
+// *****************************************************************************
+
+void Setup(uint8_t fifoDepth, UARTFlowControl flowControl, uint8_t txSize,
+    uint8_t rxSize)
+{
+    UARTInitType params;
+
+    UART_Create(&uart, &UART1_FunctionTable);
+    UART_SetInitTypeParams(&params, UART_ONE_P, UART_NO_PARITY, false,
+        flowControl, true, true);
+    UART_SetInitBRGValue(&params, UART_ComputeBRGValue(&uart, 115200,
+        16000000UL));
+    UART_Init(&uart, &params);
+    UART1_Loopback_SetFifoDepth(fifoDepth);
+    UART_SetIsCTSPinLowFunc(&uart, IsCTSPinLow);
+    UART_SetTransmitRegisterEmptyCallback(&uart, TransmitCallback);
+    UART_SetReceivedDataCallback(&uart, ReceiveCallback);
+    UART_Buffered_Create(&bufferedUART, &uart, txArray, txSize, rxArray,
+        rxSize);
+
+    memset(rxData, 0, sizeof(rxData));
+    txIndex = rxIndex = 0;
+    ctsHigh = false;
+}
+
+Result Stream(uint8_t fifoDepth, uint8_t interruptEvery)
+{
+    Result result;
+    uint32_t tick = 0;
+
+    Setup(fifoDepth, UART_FLOW_NONE, ARRAY_SIZE, ARRAY_SIZE);
+
+    while(rxIndex + UART1_Loopback_GetOverrunCount() < NUM_BYTES &&
+        tick < MAX_TICKS)
+    {
+        txIndex += UART_Buffered_Write(&bufferedUART, &txData[txIndex],
+            NUM_BYTES - txIndex);
+
+        tick++;
+        UART1_Loopback_Tick();
+        if(tick % interruptEvery == 0)
+            UART1_Loopback_Interrupt();
+
+        rxIndex += UART_Buffered_Read(&bufferedUART, &rxData[rxIndex],
+            NUM_BYTES - rxIndex);
+    }
+
+    result.ticks = tick;
+    result.interrupts = UART1_Loopback_GetInterruptCount();
+    result.overruns = UART1_Loopback_GetOverrunCount();
+    result.stats = *UART_Buffered_GetStats(&bufferedUART);
+    result.dataGood = (rxIndex == NUM_BYTES) &&
+        memcmp(txData, rxData, NUM_BYTES) == 0;
+    return result;
+}
+
+void PrintResult(uint8_t fifoDepth, uint8_t interruptEvery, Result r)
+{
+    printf("%5u %10u %8.2f %8.3f %9u %8u %8u %6u %6u\n", fifoDepth,
+        interruptEvery, (double)r.ticks / NUM_BYTES,
+        (double)r.interrupts / NUM_BYTES, r.overruns, r.stats.transmitEvents,
+        r.stats.receiveEvents, r.stats.txHighWater, r.stats.rxHighWater);
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    int failed = 0;
+    Result byteFast, byteSlow, fifoFast, fifoSlow;
+    uint16_t accepted, count;
+
+    for(uint16_t i = 0; i < NUM_BYTES; i++)
+        txData[i] = (uint8_t)(i * 7 + 3);
+
+    byteFast = Stream(1, 1);
+    byteSlow = Stream(1, 4);
+    fifoFast = Stream(8, 1);
+    fifoSlow = Stream(8, 4);
+
+    printf("depth  irq every  ticks/B   irqs/B  overruns  tx evts  rx evts  tx hw  rx hw\n");
+    PrintResult(1, 1, byteFast);
+    PrintResult(1, 4, byteSlow);
+    PrintResult(8, 1, fifoFast);
+    PrintResult(8, 4, fifoSlow);
+    printf("\n");
+
+    failed += Check("Every byte came back in order, nothing overran",
+        byteFast.dataGood && fifoFast.dataGood && fifoSlow.dataGood &&
+        byteFast.overruns + fifoFast.overruns + fifoSlow.overruns == 0);
+    failed += Check("Slow interrupt without FIFO overruns the receiver",
+        byteSlow.overruns > 0 && !byteSlow.dataGood);
+    failed += Check("Stats count every byte both ways",
+        fifoSlow.stats.bytesSent == NUM_BYTES &&
+        fifoSlow.stats.bytesReceived == NUM_BYTES &&
+        fifoSlow.stats.receiveOverflows == 0);
+    failed += Check("Slow interrupt with FIFO keeps the wire busy",
+        fifoSlow.ticks < NUM_BYTES + NUM_BYTES / 20);
+    failed += Check("FIFO takes several bytes per interrupt",
+        fifoSlow.interrupts * 3 < NUM_BYTES);
+    failed += Check("High water marks stay inside the arrays",
+        fifoSlow.stats.txHighWater <= ARRAY_SIZE - 1 &&
+        fifoSlow.stats.rxHighWater <= ARRAY_SIZE - 1);
+
+    /* Write only takes what fits. The UART gets its share right away. */
+    Setup(8, UART_FLOW_NONE, 16, 16);
+    accepted = UART_Buffered_Write(&bufferedUART, txData, 40);
+    failed += Check("Write takes only what fits in the Buffer",
+        accepted == 15 && UART_Buffered_GetTransmitSpace(&bufferedUART) == 8);
+
+    /* Nobody reads, so the receive Buffer fills and the rest are counted */
+    Setup(8, UART_FLOW_NONE, 64, 16);
+    accepted = UART_Buffered_Write(&bufferedUART, txData, 40);
+    for(uint16_t i = 0; i < 100; i++)
+    {
+        UART1_Loopback_Tick();
+        UART1_Loopback_Interrupt();
+    }
+    count = UART_Buffered_Read(&bufferedUART, rxData, sizeof(rxData));
+    failed += Check("Full receive Buffer counts what it drops",
+        accepted == 40 && count == 15 &&
+        UART_Buffered_GetStats(&bufferedUART)->receiveOverflows == 25 &&
+        UART_Buffered_GetStats(&bufferedUART)->rxHighWater == 15 &&
+        memcmp(txData, rxData, 15) == 0);
+
+    /* CTS high stops everything. Calling the event from the main loop gets it
+    going again once CTS comes back. */
+    Setup(8, UART_FLOW_CALLBACKS, 64, 64);
+    ctsHigh = true;
+    UART_Buffered_Write(&bufferedUART, txData, 20);
+    for(uint16_t i = 0; i < 20; i++)
+    {
+        UART1_Loopback_Tick();
+        UART1_Loopback_Interrupt();
+    }
+    count = UART_Buffered_GetReceivedCount(&bufferedUART);
+    ctsHigh = false;
+    UART_Buffered_TransmitEvent(&bufferedUART);
+    for(uint16_t i = 0; i < 40; i++)
+    {
+        UART1_Loopback_Tick();
+        UART1_Loopback_Interrupt();
+    }
+    failed += Check("Nothing sent while CTS is high, all of it after",
+        count == 0 && UART_Buffered_IsTransmitIdle(&bufferedUART) &&
+        UART_Buffered_Read(&bufferedUART, rxData, sizeof(rxData)) == 20 &&
+        memcmp(txData, rxData, 20) == 0);
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,172 @@
+/* Program to test the UART DMA library with the simulated DMA - MS */
+
+/* Build from the UART/Host folder with:
+gcc -std=c99 -I. -I../Interface -I../STM32 -I../../Buffer TestUARTDMA.c
+UART1_DMA_Sim.c ../Interface/UART_DMA.c ../../Buffer/Buffer.c
+
+A stream of messages comes in, each a random length, with the line going
+idle after each one. The interrupt doesn't get to run right away. It runs a
+random number of bytes later, like it would if something else had the
+processor. The main loop reads the Buffer every so often. Everything that was
+sent has to come out of the Buffer in order, with nothing lost, and there
+should be a lot fewer interrupts than bytes. The end of each message should
+show up at the idle line, not when the DMA array fills up. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "UART1_DMA_Sim.h"
+
+#define NUM_MESSAGES        2000
+#define MAX_MESSAGE         100
+#define DMA_SIZE            64
+#define RX_SIZE             255
+#define MAX_LATENCY         16      // less than half the DMA array
+#define READ_EVERY          50
+
+static UARTDMA dma;
+static Buffer rxBuffer;
+static uint8_t dmaArray[DMA_SIZE], rxArray[RX_SIZE];
+static uint32_t interrupts, callbacks, bytesReported, txFinishedCalls;
+
+/* What's coming out of the Buffer gets checked against what went in */
+static uint8_t nextSent, nextExpected;
+static uint32_t bytesSent, bytesRead, readErrors;
+
+// ***** Callbacks *************************************************************
+
+void ReceivedData(uint16_t numBytes)
+{
+    callbacks++;
+    bytesReported += numBytes;
+}
+
+void TransmitFinished(void)
+{
+    txFinishedCalls++;
+}
+
+// *****************************************************************************
+
+void Interrupt(void)
+{
+    if(UART1_DMA_Sim_IsInterruptPending())
+    {
+        interrupts++;
+        UART_DMA_InterruptHandler(&dma);
+    }
+}
+
+void ReadBuffer(void)
+{
+    while(Buffer_IsNotEmpty(&rxBuffer))
+    {
+        if(Buffer_ReadByte(&rxBuffer) != nextExpected++)
+            readErrors++;
+        bytesRead++;
+    }
+}
+
+void Setup(void)
+{
+    Buffer_Init(&rxBuffer, rxArray, RX_SIZE);
+    UART_DMA_Create(&dma, &UART1_DMA_FunctionTable);
+    UART_DMA_SetReceivedDataCallback(&dma, ReceivedData);
+    UART_DMA_SetTransmitFinishedCallback(&dma, TransmitFinished);
+    UART_DMA_StartReceive(&dma, dmaArray, DMA_SIZE, &rxBuffer);
+    interrupts = callbacks = bytesReported = txFinishedCalls = 0;
+    nextSent = nextExpected = 0;
+    bytesSent = bytesRead = readErrors = 0;
+}
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    int failed = 0;
+    uint32_t lateMessages = 0;
+
+    srand(1);
+    Setup();
+
+    for(uint32_t m = 0; m < NUM_MESSAGES; m++)
+    {
+        uint16_t length = 1 + rand() % MAX_MESSAGE;
+        int32_t interruptIn = -1;
+
+        for(uint16_t i = 0; i < length; i++)
+        {
+            UART1_DMA_Sim_ReceiveByte(nextSent++);
+            bytesSent++;
+
+            if(UART1_DMA_Sim_IsInterruptPending() && interruptIn < 0)
+                interruptIn = rand() % MAX_LATENCY;
+            if(interruptIn == 0)
+                Interrupt();
+            if(interruptIn >= 0)
+                interruptIn--;
+
+            if(bytesSent % READ_EVERY == 0)
+                ReadBuffer();
+        }
+
+        /* The line goes quiet. Take the interrupt right away this time so we
+        can see that the whole message made it. */
+        UART1_DMA_Sim_LineIdle();
+        Interrupt();
+        if(bytesReported != bytesSent)
+            lateMessages++;
+    }
+    ReadBuffer();
+
+    printf("%u messages, %u bytes, %u interrupts (%.3f per byte)\n\n",
+        NUM_MESSAGES, bytesSent, interrupts, (double)interrupts / bytesSent);
+
+    failed += Check("Every byte came out of the Buffer in order",
+        bytesRead == bytesSent && readErrors == 0 &&
+        !Buffer_DidOverflow(&rxBuffer));
+    failed += Check("Callbacks added up to every byte",
+        bytesReported == bytesSent && callbacks <= interrupts);
+    failed += Check("Whole message there as soon as the line went idle",
+        lateMessages == 0);
+    failed += Check("Far fewer interrupts than bytes",
+        interrupts < bytesSent / 10);
+
+    /* Transmit goes around the loopback */
+    static uint8_t txData[200];
+    Setup();
+    for(uint16_t i = 0; i < sizeof(txData); i++)
+        txData[i] = nextSent++;
+    bool started = UART_DMA_Transmit(&dma, txData, sizeof(txData));
+    bool secondStarted = UART_DMA_Transmit(&dma, txData, 10);
+    for(uint16_t i = 0; i < sizeof(txData); i++)
+    {
+        UART1_DMA_Sim_Tick();
+        Interrupt();
+    }
+    UART1_DMA_Sim_LineIdle();
+    Interrupt();
+    bytesSent = sizeof(txData);
+    ReadBuffer();
+    failed += Check("Transmit sends the whole array with one callback",
+        started && txFinishedCalls == 1 && !UART_DMA_IsTransmitBusy(&dma) &&
+        bytesRead == bytesSent && readErrors == 0);
+    failed += Check("Can't start a transmit while one is going",
+        !secondStarted);
+
+    /* Stopping should pick up the last few bytes even without an interrupt */
+    Setup();
+    for(uint16_t i = 0; i < 10; i++)
+        UART1_DMA_Sim_ReceiveByte(nextSent++);
+    UART_DMA_StopReceive(&dma);
+    UART1_DMA_Sim_ReceiveByte(nextSent++);
+    failed += Check("Stop copies what's left, then nothing else comes in",
+        Buffer_GetCount(&rxBuffer) == 10 && bytesReported == 10);
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,230 @@
+/* Program to test the STM32F1 UART driver against stand in registers - MS */
+
+/* Build from the UART/Host folder with:
+gcc -std=c99 -IMock -I. -I../Interface -I../STM32 TestUARTSTM32F1.c
+Mock/MockSTM32F1.c ../STM32/UART_STM32F1.c ../STM32/UART_STM32F1_Ports.c
+../Interface/IUART.c
+
+All five ports share one driver now, with a struct for each. This sets each
+one up differently through its function table and checks that each one wrote
+only its own registers and clock bit, and that the callbacks, CTS, and the
+locks for one port don't get mixed up with another. UART4 and UART5 are in
+the stand in header, so they get made too. */
+
+#include <stdio.h>
+#include <string.h>
+#include "UART_STM32F1.h"
+#include "UART1.h"
+#include "UART2.h"
+#include "UART3.h"
+
+#define NUM_PORTS   5
+
+static UART uart[NUM_PORTS];
+static UARTInterface *tables[NUM_PORTS] = { &UART1_FunctionTable,
+    &UART2_FunctionTable, &UART3_FunctionTable, &UART4_FunctionTable,
+    &UART5_FunctionTable };
+static USART_TypeDef *regs[NUM_PORTS] = { USART1, USART2, USART3, UART4,
+    UART5 };
+
+/* Which port's callback was called, and what it got */
+static int rxPort = -1, txPort = -1, txCalls;
+static uint8_t rxByte;
+static bool ctsLow[NUM_PORTS];
+
+// ***** Callbacks *************************************************************
+
+void ReceivedData1(uint8_t (*CallToGetData)(void))
+{
+    rxPort = 0;
+    rxByte = CallToGetData();
+}
+
+void ReceivedData2(uint8_t (*CallToGetData)(void))
+{
+    rxPort = 1;
+    rxByte = CallToGetData();
+}
+
+void ReceivedData4(uint8_t (*CallToGetData)(void))
+{
+    rxPort = 3;
+    rxByte = CallToGetData();
+}
+
+void TransmitEmpty1(void)
+{
+    txPort = 0;
+    txCalls++;
+    /* Sending from inside the callback must not call us again right away */
+    UART_TransmitByte(&uart[0], 0x55);
+    USART1->SR |= USART_SR_TXE;
+    if(USART1->CR1 & USART_CR1_TXEIE)
+        UART1_TransmitRegisterEmptyEvent();
+}
+
+void TransmitEmpty3(void)
+{
+    txPort = 2;
+    txCalls++;
+}
+
+bool IsCTSLow2(void) { return ctsLow[1]; }
+bool IsCTSLow3(void) { return ctsLow[2]; }
+
+// *****************************************************************************
+
+int Check(const char *name, int condition)
+{
+    printf("  %-52s %s\n", name, condition ? "ok" : "FAIL");
+    return condition ? 0 : 1;
+}
+
+int main(void)
+{
+    static const uint32_t baud[NUM_PORTS] = { 115200, 9600, 57600, 19200,
+        38400 };
+    static const uint32_t pclk[NUM_PORTS] = { 72000000UL, 36000000UL,
+        36000000UL, 36000000UL, 36000000UL };
+    UARTInitType params;
+    int failed = 0;
+    bool good;
+    char line[80];
+
+    printf("Setup\n");
+    for(int k = 0; k < NUM_PORTS; k++)
+    {
+        /* Junk in the registers to start, like after a reset into code that
+        already used them */
+        regs[k]->CR1 = USART_CR1_M | USART_CR1_PCE;
+        regs[k]->CR2 = USART_CR2_STOP_1;
+
+        UART_Create(&uart[k], tables[k]);
+        UART_SetInitTypeToDefaultParams(&params);
+        UART_SetInitBRGValue(&params, UART_ComputeBRGValue(&uart[k], baud[k],
+            pclk[k]));
+        params.useRxInterrupt = (k != 2);
+        params.useTxInterrupt = (k == 0 || k == 2);
+        if(k == 1)
+            params.flowControl = UART_FLOW_CALLBACKS;
+        if(k == 2)
+        {
+            params.flowControl = UART_FLOW_CALLBACKS;
+            params.use9Bit = true;
+            params.stopBits = UART_TWO_P;
+            params.parity = UART_ODD_PARITY;
+        }
+        if(k == 4)
+            params.flowControl = UART_FLOW_HARDWARE;
+        UART_Init(&uart[k], &params);
+    }
+
+    failed += Check("115200 at 72 MHz is 0x271 (39.0625)", USART1->BRR == 0x271);
+    failed += Check("9600 at 36 MHz is 0xEA6 (234.375)", USART2->BRR == 0xEA6);
+
+    good = true;
+    for(int k = 0; k < NUM_PORTS; k++)
+    {
+        uint32_t on = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+        if((regs[k]->CR1 & on) != on)
+            good = false;
+        if(((regs[k]->CR1 & USART_CR1_RXNEIE) != 0) != (k != 2))
+            good = false;
+    }
+    failed += Check("Every port on, receive interrupt only where asked",
+        good);
+
+    failed += Check("UART3: 9 bit, odd parity, two stop bits",
+        (USART3->CR1 & (USART_CR1_M | USART_CR1_PCE | USART_CR1_PS)) ==
+        (USART_CR1_M | USART_CR1_PCE | USART_CR1_PS) &&
+        (USART3->CR2 & USART_CR2_STOP) == USART_CR2_STOP_1);
+    failed += Check("The others: 8 bit, no parity, one stop bit",
+        !(USART1->CR1 & (USART_CR1_M | USART_CR1_PCE)) &&
+        !(UART4->CR1 & (USART_CR1_M | USART_CR1_PCE)) &&
+        !(USART2->CR2 & USART_CR2_STOP));
+    failed += Check("Hardware flow control only on UART5",
+        (UART5->CR3 & (USART_CR3_CTSE | USART_CR3_RTSE)) ==
+        (USART_CR3_CTSE | USART_CR3_RTSE) &&
+        !(USART1->CR3 & USART_CR3_CTSE) && !(UART4->CR3 & USART_CR3_CTSE));
+    failed += Check("Clocks: USART1 on APB2, the rest on APB1",
+        MockRCC.APB2ENR == RCC_APB2ENR_USART1EN &&
+        MockRCC.APB1ENR == (RCC_APB1ENR_USART2EN | RCC_APB1ENR_USART3EN |
+        RCC_APB1ENR_UART4EN | RCC_APB1ENR_UART5EN));
+
+    printf("Receive\n");
+    UART_SetReceivedDataCallback(&uart[0], ReceivedData1);
+    UART_SetReceivedDataCallback(&uart[1], ReceivedData2);
+    UART_SetReceivedDataCallback(&uart[3], ReceivedData4);
+
+    USART2->DR = 0x22;
+    USART2->SR |= USART_SR_RXNE;
+    UART2_ReceivedDataEvent();
+    failed += Check("UART2 event reads UART2 and calls its callback",
+        rxPort == 1 && rxByte == 0x22);
+
+    UART4->DR = 0x44;
+    UART_ReceivedDataEvent(&uart[3]);
+    failed += Check("UART4 through the table reads UART4",
+        rxPort == 3 && rxByte == 0x44);
+
+    rxPort = -1;
+    UART_ReceivedDataEvent(&uart[4]);
+    failed += Check("UART5 with no callback does nothing", rxPort == -1);
+
+    printf("Transmit\n");
+    UART_SetTransmitRegisterEmptyCallback(&uart[0], TransmitEmpty1);
+    UART_SetTransmitRegisterEmptyCallback(&uart[2], TransmitEmpty3);
+    UART_SetIsCTSPinLowFunc(&uart[1], IsCTSLow2);
+    UART_SetIsCTSPinLowFunc(&uart[2], IsCTSLow3);
+
+    USART1->SR = USART_SR_TC;
+    UART_TransmitByte(&uart[0], 0xA1);
+    failed += Check("UART1 write goes to its DR and turns on TXEIE",
+        USART1->DR == 0xA1 && (USART1->CR1 & USART_CR1_TXEIE) &&
+        !(USART1->SR & USART_SR_TC) && USART2->DR == 0x22);
+
+    ctsLow[1] = false;
+    ctsLow[2] = true;
+    USART2->DR = 0;
+    UART_TransmitByte(&uart[1], 0xB2);
+    UART_TransmitByte(&uart[2], 0xC3);
+    failed += Check("CTS high holds UART2 but not UART3",
+        USART2->DR == 0 && USART3->DR == 0xC3);
+    ctsLow[1] = true;
+    UART_TransmitByte(&uart[1], 0xB2);
+    failed += Check("UART2 sends once its CTS goes low", USART2->DR == 0xB2);
+    failed += Check("No TXEIE where the transmit interrupt is off",
+        !(USART2->CR1 & USART_CR1_TXEIE));
+
+    /* UART1's callback sends another byte and the event comes right back.
+    It gets held until the pending event handler. */
+    txCalls = 0;
+    USART1->SR |= USART_SR_TXE;
+    UART1_TransmitRegisterEmptyEvent();
+    failed += Check("UART1 callback sending again is held, not nested",
+        txCalls == 1 && USART1->DR == 0x55);
+
+    /* While UART1 has one pending, UART3 still goes through */
+    UART_TransmitRegisterEmptyEvent(&uart[2]);
+    failed += Check("UART1 pending doesn't hold up UART3",
+        txCalls == 2 && txPort == 2);
+
+    UART3_PendingEventHandler();
+    sprintf(line, "UART3 handler leaves UART1 pending (%d calls)", txCalls);
+    failed += Check(line, txCalls == 2);
+    UART1_PendingEventHandler();
+    failed += Check("UART1 handler runs the held event", txCalls == 3 &&
+        txPort == 0);
+
+    printf("Disable\n");
+    USART1->SR |= USART_SR_TC;
+    UART_TransmitDisable(&uart[0]);
+    UART_ReceiveDisable(&uart[3]);
+    failed += Check("Only the port you turn off goes off",
+        !(USART1->CR1 & USART_CR1_TE) && (USART1->CR1 & USART_CR1_RE) &&
+        !(UART4->CR1 & USART_CR1_RE) && (USART2->CR1 & USART_CR1_TE) &&
+        (UART5->CR1 & USART_CR1_RE));
+
+    printf("%s\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,173 @@
+/***************************************************************************//**
+ * @brief Simulated UART1 DMA (Host)
+ * 
+ * @file UART1_DMA_Sim.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A fake DMA controller for testing the UART DMA library on a PC. See 
+ * UART1_DMA_Sim.h for how to use it.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "UART1_DMA_Sim.h"
+#include <stddef.h>
+
+// ***** Defines ***************************************************************
+
+
+// ***** Global Variables ******************************************************
+
+/* Assign functions to the interface */
+UARTDMAInterface UART1_DMA_FunctionTable = {
+    .UART_DMA_StartReceive = UART1_DMA_StartReceive,
+    .UART_DMA_StopReceive = UART1_DMA_StopReceive,
+    .UART_DMA_GetReceiveRemaining = UART1_DMA_GetReceiveRemaining,
+    .UART_DMA_StartTransmit = UART1_DMA_StartTransmit,
+    .UART_DMA_GetAndClearEvents = UART1_DMA_GetAndClearEvents,
+};
+
+/* Receive channel */
+static uint8_t *rxArray;
+static uint16_t rxSize, rxCount;    // rxCount is CNDTR
+static bool rxEnabled, halfFlag, fullFlag, idleFlag, idleArmed;
+
+/* Transmit channel */
+static const uint8_t *txData;
+static uint16_t txSize, txIndex;
+static bool txEnabled, txFullFlag;
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Simulation Functions ************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void UART1_DMA_Sim_ReceiveByte(uint8_t data)
+{
+    if(!rxEnabled)
+        return;
+
+    rxArray[rxSize - rxCount] = data;
+    rxCount--;
+    idleArmed = true;
+
+    if(rxCount == rxSize / 2)
+        halfFlag = true;
+
+    if(rxCount == 0)
+    {
+        fullFlag = true;
+        rxCount = rxSize; // circular mode reloads
+    }
+}
+
+// *****************************************************************************
+
+void UART1_DMA_Sim_LineIdle(void)
+{
+    if(idleArmed)
+    {
+        idleFlag = true;
+        idleArmed = false;
+    }
+}
+
+// *****************************************************************************
+
+void UART1_DMA_Sim_Tick(void)
+{
+    if(!txEnabled)
+        return;
+
+    UART1_DMA_Sim_ReceiveByte(txData[txIndex++]);
+
+    if(txIndex == txSize)
+    {
+        txEnabled = false;
+        txFullFlag = true;
+    }
+}
+
+// *****************************************************************************
+
+bool UART1_DMA_Sim_IsInterruptPending(void)
+{
+    return halfFlag || fullFlag || idleFlag || txFullFlag;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void UART1_DMA_StartReceive(uint8_t *dmaArray, uint16_t size)
+{
+    rxArray = dmaArray;
+    rxSize = rxCount = size;
+    halfFlag = fullFlag = idleFlag = idleArmed = false;
+    rxEnabled = true;
+}
+
+// *****************************************************************************
+
+void UART1_DMA_StopReceive(void)
+{
+    rxEnabled = false;
+    halfFlag = fullFlag = idleFlag = false;
+}
+
+// *****************************************************************************
+
+uint16_t UART1_DMA_GetReceiveRemaining(void)
+{
+    return rxCount;
+}
+
+// *****************************************************************************
+
+void UART1_DMA_StartTransmit(const uint8_t *data, uint16_t size)
+{
+    txData = data;
+    txSize = size;
+    txIndex = 0;
+    txFullFlag = false;
+    txEnabled = true;
+}
+
+// *****************************************************************************
+
+uint8_t UART1_DMA_GetAndClearEvents(void)
+{
+    uint8_t events = 0;
+
+    if(idleFlag || halfFlag || fullFlag)
+    {
+        idleFlag = halfFlag = fullFlag = false;
+        events |= UART_DMA_EVENT_RECEIVE;
+    }
+
+    if(txFullFlag)
+    {
+        txFullFlag = false;
+        events |= UART_DMA_EVENT_TX_FINISHED;
+    }
+
+    return events;
+}
+
+/*
+ End of File
+ */
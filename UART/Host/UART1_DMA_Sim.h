@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * @brief Simulated UART1 DMA Header (Host)
+ * 
+ * @file UART1_DMA_Sim.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A fake DMA controller and UART for testing the UART DMA library on a 
+ * PC. It implements UART1_DMA.h, so it stands in for UART1_DMA_STM32G0.c. The
+ * receive channel works like the real one in circular mode. It writes each 
+ * byte into the array, counts down, sets the half and full flags, and starts
+ * over. The transmit channel is wired back to the receive side, like a 
+ * loopback.
+ * 
+ * Nothing happens on its own. Call UART1_DMA_Sim_ReceiveByte to have a byte
+ * show up on the Rx pin, UART1_DMA_Sim_LineIdle when the line goes quiet, and
+ * UART1_DMA_Sim_Tick to have the transmit channel send one byte. When
+ * UART1_DMA_Sim_IsInterruptPending is true, call UART_DMA_InterruptHandler, 
+ * whenever you want the interrupt to have happened.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef UART1_DMA_SIM_H
+#define UART1_DMA_SIM_H
+
+#include "UART1_DMA.h"
+
+// ***** Function Prototypes ***************************************************
+
+/***************************************************************************//**
+ * @brief A byte comes in on the Rx pin
+ * 
+ * If the receive channel is running, it goes in the DMA array. If not, it's
+ * lost.
+ * 
+ * @param data  the byte
+ */
+void UART1_DMA_Sim_ReceiveByte(uint8_t data);
+
+/***************************************************************************//**
+ * @brief The Rx line has been quiet for one character time
+ * 
+ * Like the real thing, the idle flag only gets set once after some data has
+ * come in.
+ */
+void UART1_DMA_Sim_LineIdle(void);
+
+/***************************************************************************//**
+ * @brief One character time for the transmit channel
+ * 
+ * Sends the next byte of a transmit, if there is one, back into the receive
+ * side. When the last one goes, the transfer complete flag is set.
+ */
+void UART1_DMA_Sim_Tick(void);
+
+/***************************************************************************//**
+ * @brief Check if any enabled interrupt flags are set
+ * 
+ * @return true if UART_DMA_InterruptHandler should be called
+ */
+bool UART1_DMA_Sim_IsInterruptPending(void);
+
+#endif  /* UART1_DMA_SIM_H */
@@ -0,0 +1,590 @@
+/***************************************************************************//**
+ * @brief UART Loopback Stand-In (Host)
+ * 
+ * @file UART1_Loopback.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A fake UART1 with the Tx wired back to the Rx. The FIFO's stand in for
+ * the registers on the STM32G0 and the functions work the same way the ones
+ * in UART1_STM32G0.c do, so code that runs here should run there. The baud
+ * rate doesn't mean anything here, so ComputeBRGValue just divides.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "UART1_Loopback.h"
+#include <stddef.h> // needed for NULL
+
+// ***** Defines ***************************************************************
+
+#define FIFO_SIZE       UART1_LOOPBACK_FIFO_SIZE
+#define TX_THRESHOLD    (fifoDepth / 2)
+
+typedef struct FifoTag
+{
+    uint8_t data[FIFO_SIZE];
+    uint8_t head;
+    uint8_t count;
+} Fifo;
+
+// ***** Global Variables ******************************************************
+
+/* Assign functions to the interface */
+UARTInterface UART1_FunctionTable = {
+    .UART_ComputeBRGValue = UART1_ComputeBRGValue,
+    .UART_Init = UART1_Init,
+    .UART_ReceivedDataEvent = UART1_ReceivedDataEvent,
+    .UART_GetReceivedByte = UART1_GetReceivedByte,
+    .UART_IsReceiveRegisterFull = UART1_IsReceiveRegisterFull,
+    .UART_IsReceiveUsingInterrupts = UART1_IsReceiveUsingInterrupts,
+    .UART_ReceiveEnable = UART1_ReceiveEnable,
+    .UART_ReceiveDisable = UART1_ReceiveDisable,
+    .UART_TransmitRegisterEmptyEvent = UART1_TransmitRegisterEmptyEvent,
+    .UART_TransmitByte = UART1_TransmitByte,
+    .UART_IsTransmitRegisterEmpty = UART1_IsTransmitRegisterEmpty,
+    .UART_IsTransmitFinished = UART1_IsTransmitFinished,
+    .UART_IsTransmitUsingInterrupts = UART1_IsTransmitUsingInterrupts,
+    .UART_TransmitEnable = UART1_TransmitEnable,
+    .UART_TransmitDisable = UART1_TransmitDisable,
+    .UART_PendingEventHandler = UART1_PendingEventHandler,
+    .UART_SetTransmitRegisterEmptyCallback = UART1_SetTransmitRegisterEmptyCallback,
+    .UART_SetReceivedDataCallback = UART1_SetReceivedDataCallback,
+    .UART_SetIsCTSPinLowFunc = UART1_SetIsCTSPinLowFunc,
+    .UART_SetRTSPinFunc = UART1_SetRTSPinFunc,
+    .UART_TransmitBuffer = UART1_TransmitBuffer,
+    .UART_ReceiveBuffer = UART1_ReceiveBuffer,
+    .UART_ReceiveBufferStop = UART1_ReceiveBufferStop,
+    .UART_SetTransmitBufferFinishedCallback = UART1_SetTransmitBufferFinishedCallback,
+    .UART_SetReceiveBufferFinishedCallback = UART1_SetReceiveBufferFinishedCallback,
+};
+
+/* The "hardware" */
+static Fifo txFifo, rxFifo;
+static bool txEnabled, rxEnabled;
+static bool txInterruptEnabled, txThresholdInterruptEnabled, rxInterruptEnabled;
+static uint32_t interruptCount, overrunCount;
+static uint8_t fifoDepth = FIFO_SIZE;
+
+static bool useRxInterrupt = false, useTxInterrupt = false;
+static UARTFlowControl flowControl = UART_FLOW_NONE;
+static bool lockTxFinishedEvent = false, txFinishedEventPending = false,
+    lockRxReceivedEvent = false;
+
+// block transmit and receive
+static const uint8_t *txBuffer;
+static uint8_t *rxBuffer;
+static uint16_t txBufferSize, txBufferCount, rxBufferMax, rxBufferCount;
+static bool txBufferActive = false, txBufferWaitingOnCTS = false,
+    rxBufferActive = false;
+
+// local function pointers
+static void (*TransmitRegisterEmptyCallback)(void);
+static void (*ReceivedDataCallback)(uint8_t (*CallToGetData)(void));
+static bool (*IsCTSPinLow)(void);
+static void (*SetRTSPin)(bool setHigh);
+static void (*TransmitBufferFinishedCallback)(void);
+static void (*ReceiveBufferFinishedCallback)(uint16_t numBytes);
+
+// ***** Static Function Prototypes ********************************************
+
+static void FifoPut(Fifo *fifo, uint8_t data);
+static uint8_t FifoGet(Fifo *fifo);
+static void TransmitBufferRefill(void);
+static void ReceiveBufferDrain(void);
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Loopback Functions **************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void UART1_Loopback_Reset(void)
+{
+    txFifo.head = txFifo.count = 0;
+    rxFifo.head = rxFifo.count = 0;
+    txInterruptEnabled = txThresholdInterruptEnabled = false;
+    rxInterruptEnabled = false;
+    interruptCount = overrunCount = 0;
+    txBufferActive = txBufferWaitingOnCTS = rxBufferActive = false;
+    lockTxFinishedEvent = txFinishedEventPending = false;
+    lockRxReceivedEvent = false;
+}
+
+// *****************************************************************************
+
+void UART1_Loopback_Tick(void)
+{
+    if(txFifo.count == 0 || !txEnabled)
+        return;
+
+    uint8_t data = FifoGet(&txFifo);
+
+    if(!rxEnabled)
+        return;
+
+    if(rxFifo.count == fifoDepth)
+        overrunCount++;
+    else
+        FifoPut(&rxFifo, data);
+}
+
+// *****************************************************************************
+
+bool UART1_Loopback_Interrupt(void)
+{
+    bool rxFlag = rxInterruptEnabled && rxFifo.count > 0;
+    bool txFlag = (txInterruptEnabled && txFifo.count < fifoDepth) ||
+        (txThresholdInterruptEnabled && txFifo.count <= TX_THRESHOLD);
+
+    if(!rxFlag && !txFlag)
+        return false;
+
+    /* One interrupt vector for both, like the real thing */
+    interruptCount++;
+    if(rxFlag)
+        UART1_ReceivedDataEvent();
+    if(txFlag)
+        UART1_TransmitRegisterEmptyEvent();
+    return true;
+}
+
+// *****************************************************************************
+
+uint32_t UART1_Loopback_GetInterruptCount(void)
+{
+    return interruptCount;
+}
+
+// *****************************************************************************
+
+uint32_t UART1_Loopback_GetOverrunCount(void)
+{
+    return overrunCount;
+}
+
+// *****************************************************************************
+
+void UART1_Loopback_SetFifoDepth(uint8_t depth)
+{
+    if(depth == 0 || depth > FIFO_SIZE)
+        depth = FIFO_SIZE;
+
+    fifoDepth = depth;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t UART1_ComputeBRGValue(uint32_t desiredBaudRate, uint32_t pclkInHz)
+{
+    if(desiredBaudRate == 0)
+        return 0;
+
+    return pclkInHz / desiredBaudRate;
+}
+
+// *****************************************************************************
+
+void UART1_Init(UARTInitType *params)
+{
+    if(params->BRGValue == 0)
+        return;
+
+    flowControl = params->flowControl;
+    useRxInterrupt = params->useRxInterrupt;
+    useTxInterrupt = params->useTxInterrupt;
+
+    UART1_Loopback_Reset();
+    rxInterruptEnabled = useRxInterrupt;
+    rxEnabled = true;
+    txEnabled = true;
+}
+
+// *****************************************************************************
+
+void UART1_ReceivedDataEvent(void)
+{
+    if(rxBufferActive)
+    {
+        ReceiveBufferDrain();
+        if(rxBufferCount >= rxBufferMax)
+        {
+            rxBufferActive = false;
+            if(!useRxInterrupt)
+                rxInterruptEnabled = false;
+
+            if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+                SetRTSPin(true);
+
+            if(ReceiveBufferFinishedCallback)
+                ReceiveBufferFinishedCallback(rxBufferCount);
+        }
+        return;
+    }
+
+    if(lockRxReceivedEvent == true)
+        return;
+
+    lockRxReceivedEvent = true;
+
+    if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+        SetRTSPin(true);
+
+    if(ReceivedDataCallback)
+        ReceivedDataCallback(UART1_GetReceivedByte);
+
+    lockRxReceivedEvent = false;
+}
+
+// *****************************************************************************
+
+uint8_t UART1_GetReceivedByte(void)
+{
+    uint8_t data = 0;
+
+    if(rxFifo.count > 0)
+        data = FifoGet(&rxFifo);
+
+    if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+        SetRTSPin(false);
+
+    return data;
+}
+
+// *****************************************************************************
+
+bool UART1_IsReceiveRegisterFull(void)
+{
+    bool rxFull = (rxFifo.count > 0);
+
+    if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+        SetRTSPin(rxFull);
+
+    return rxFull;
+}
+
+// *****************************************************************************
+
+bool UART1_IsReceiveUsingInterrupts(void)
+{
+    return useRxInterrupt;
+}
+
+// *****************************************************************************
+
+void UART1_ReceiveEnable(void)
+{
+    rxEnabled = true;
+
+    if(useRxInterrupt)
+        rxInterruptEnabled = true;
+
+    if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+        SetRTSPin(false);
+}
+
+// *****************************************************************************
+
+void UART1_ReceiveDisable(void)
+{
+    rxEnabled = false;
+
+    if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+        SetRTSPin(true);
+}
+
+// *****************************************************************************
+
+void UART1_TransmitRegisterEmptyEvent(void)
+{
+    if(txBufferActive)
+    {
+        if(txBufferCount < txBufferSize)
+        {
+            TransmitBufferRefill();
+        }
+        else
+        {
+            txThresholdInterruptEnabled = false;
+            txBufferActive = false;
+            if(TransmitBufferFinishedCallback)
+                TransmitBufferFinishedCallback();
+        }
+        return;
+    }
+
+    if(lockTxFinishedEvent == true)
+    {
+        txFinishedEventPending = true;
+        return;
+    }
+    lockTxFinishedEvent = true;
+
+    txInterruptEnabled = false;
+
+    if(TransmitRegisterEmptyCallback)
+        TransmitRegisterEmptyCallback();
+
+    lockTxFinishedEvent = false;
+}
+
+// *****************************************************************************
+
+void UART1_TransmitByte(uint8_t data)
+{
+    if(flowControl == UART_FLOW_CALLBACKS && IsCTSPinLow != NULL &&
+        IsCTSPinLow() == false)
+    {
+        return; // CTS was high
+    }
+
+    /* Writing to a full FIFO does nothing, same as the real one */
+    if(txFifo.count < fifoDepth)
+        FifoPut(&txFifo, data);
+
+    if(useTxInterrupt)
+        txInterruptEnabled = true;
+}
+
+// *****************************************************************************
+
+bool UART1_IsTransmitRegisterEmpty(void)
+{
+    bool txReady = (txFifo.count < fifoDepth);
+
+    if(flowControl == UART_FLOW_CALLBACKS && IsCTSPinLow != NULL &&
+        IsCTSPinLow() == false)
+    {
+        txReady = false;
+    }
+
+    return txReady;
+}
+
+// *****************************************************************************
+
+bool UART1_IsTransmitFinished(void)
+{
+    bool txReady = (txFifo.count == 0);
+
+    if(flowControl == UART_FLOW_CALLBACKS && IsCTSPinLow != NULL &&
+        IsCTSPinLow() == false)
+    {
+        txReady = false;
+    }
+
+    return txReady;
+}
+
+// *****************************************************************************
+
+bool UART1_IsTransmitUsingInterrupts(void)
+{
+    return useTxInterrupt;
+}
+
+// *****************************************************************************
+
+void UART1_TransmitEnable(void)
+{
+    txEnabled = true;
+
+    if(useTxInterrupt && txFifo.count == fifoDepth)
+        txInterruptEnabled = true;
+}
+
+// *****************************************************************************
+
+void UART1_TransmitDisable(void)
+{
+    /* The real one waits here for the transmission to finish. There's no one
+    to move the bytes out while we wait, so just drop them. */
+    txFifo.count = 0;
+    txEnabled = false;
+}
+
+// *****************************************************************************
+
+void UART1_PendingEventHandler(void)
+{
+    if(txBufferWaitingOnCTS && (IsCTSPinLow == NULL || IsCTSPinLow()))
+    {
+        txBufferWaitingOnCTS = false;
+        TransmitBufferRefill();
+    }
+
+    if(txFinishedEventPending && !lockTxFinishedEvent)
+    {
+        txFinishedEventPending = false;
+        UART1_TransmitRegisterEmptyEvent();
+    }
+}
+
+// *****************************************************************************
+
+void UART1_SetTransmitRegisterEmptyCallback(void (*Function)(void))
+{
+    TransmitRegisterEmptyCallback = Function;
+}
+
+// *****************************************************************************
+
+void UART1_SetReceivedDataCallback(void (*Function)(uint8_t (*CallToGetData)(void)))
+{
+    ReceivedDataCallback = Function;
+}
+
+// *****************************************************************************
+
+void UART1_SetIsCTSPinLowFunc(bool (*Function)(void))
+{
+    IsCTSPinLow = Function;
+}
+
+// *****************************************************************************
+
+void UART1_SetRTSPinFunc(void (*Function)(bool setPinHigh))
+{
+    SetRTSPin = Function;
+}
+
+// *****************************************************************************
+
+bool UART1_TransmitBuffer(const uint8_t *data, uint16_t size)
+{
+    if(txBufferActive || size == 0)
+        return false;
+
+    txBuffer = data;
+    txBufferSize = size;
+    txBufferCount = 0;
+    txBufferActive = true;
+    TransmitBufferRefill();
+    return true;
+}
+
+// *****************************************************************************
+
+bool UART1_ReceiveBuffer(uint8_t *dst, uint16_t max)
+{
+    if(rxBufferActive || max == 0)
+        return false;
+
+    rxBuffer = dst;
+    rxBufferMax = max;
+    rxBufferCount = 0;
+    rxBufferActive = true;
+
+    if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+        SetRTSPin(false);
+
+    rxInterruptEnabled = true;
+    return true;
+}
+
+// *****************************************************************************
+
+uint16_t UART1_ReceiveBufferStop(void)
+{
+    if(!rxBufferActive)
+        return 0;
+
+    rxInterruptEnabled = false;
+    ReceiveBufferDrain();
+    rxBufferActive = false;
+
+    if(useRxInterrupt)
+        rxInterruptEnabled = true;
+
+    return rxBufferCount;
+}
+
+// *****************************************************************************
+
+void UART1_SetTransmitBufferFinishedCallback(void (*Function)(void))
+{
+    TransmitBufferFinishedCallback = Function;
+}
+
+// *****************************************************************************
+
+void UART1_SetReceiveBufferFinishedCallback(void (*Function)(uint16_t numBytes))
+{
+    ReceiveBufferFinishedCallback = Function;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Add a byte to the end of a FIFO. Check that it isn't full first.
+ */
+static void FifoPut(Fifo *fifo, uint8_t data)
+{
+    fifo->data[(fifo->head + fifo->count) % FIFO_SIZE] = data;
+    fifo->count++;
+}
+
+/***************************************************************************//**
+ * @brief Take a byte from the front of a FIFO. Check that it isn't empty.
+ */
+static uint8_t FifoGet(Fifo *fifo)
+{
+    uint8_t data = fifo->data[fifo->head];
+    fifo->head = (fifo->head + 1) % FIFO_SIZE;
+    fifo->count--;
+    return data;
+}
+
+/***************************************************************************//**
+ * @brief Put as much of the transmit buffer into the FIFO as will fit
+ */
+static void TransmitBufferRefill(void)
+{
+    if(flowControl == UART_FLOW_CALLBACKS && IsCTSPinLow != NULL &&
+        IsCTSPinLow() == false)
+    {
+        txThresholdInterruptEnabled = false;
+        txBufferWaitingOnCTS = true;
+        return;
+    }
+
+    while(txBufferCount < txBufferSize && txFifo.count < fifoDepth)
+    {
+        FifoPut(&txFifo, txBuffer[txBufferCount++]);
+    }
+
+    txThresholdInterruptEnabled = true;
+}
+
+/***************************************************************************//**
+ * @brief Move everything waiting in the receive FIFO to the receive buffer
+ */
+static void ReceiveBufferDrain(void)
+{
+    while(rxBufferCount < rxBufferMax && rxFifo.count > 0)
+    {
+        rxBuffer[rxBufferCount++] = FifoGet(&rxFifo);
+    }
+}
+
+/*
+ End of File
+ */
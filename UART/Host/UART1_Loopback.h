@@ -0,0 +1,88 @@
+/***************************************************************************//**
+ * @brief UART Loopback Stand-In Header (Host)
+ * 
+ * @file UART1_Loopback.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A fake UART1 for testing code on a PC. It implements every function in
+ * UART1.h, so it can be used in place of the real one, with the Tx pin wired
+ * straight back to the Rx pin. Both directions have an 8 byte FIFO just like
+ * the STM32G0, or you can make them smaller with UART1_Loopback_SetFifoDepth.
+ * 
+ * Nothing happens on its own. Call UART1_Loopback_Tick to move one character
+ * across the wire. Call UART1_Loopback_Interrupt wherever the interrupt would
+ * go off. It checks the same things the real interrupt would and calls the
+ * event functions for you. The time between the two is how long the
+ * processor took to get to the interrupt.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef UART1_LOOPBACK_H
+#define UART1_LOOPBACK_H
+
+#include "UART1.h"
+
+// ***** Defines ***************************************************************
+
+#define UART1_LOOPBACK_FIFO_SIZE    8
+
+// ***** Function Prototypes ***************************************************
+
+/***************************************************************************//**
+ * @brief Empty both FIFO's, turn off interrupts, and clear the counts
+ */
+void UART1_Loopback_Reset(void);
+
+/***************************************************************************//**
+ * @brief One character time. Move one byte from the Tx FIFO to the Rx FIFO
+ * 
+ * If the receiver is disabled the byte is lost. If the Rx FIFO is full, the
+ * byte is lost and it counts as an overrun.
+ */
+void UART1_Loopback_Tick(void);
+
+/***************************************************************************//**
+ * @brief Run the interrupt if any of the enabled interrupt flags are set
+ * 
+ * @return true if the interrupt ran
+ */
+bool UART1_Loopback_Interrupt(void);
+
+/***************************************************************************//**
+ * @brief Get the number of times the interrupt ran since the last reset
+ * 
+ * @return uint32_t  number of interrupts
+ */
+uint32_t UART1_Loopback_GetInterruptCount(void);
+
+/***************************************************************************//**
+ * @brief Get the number of bytes lost because the Rx FIFO was full
+ * 
+ * @return uint32_t  number of overruns
+ */
+uint32_t UART1_Loopback_GetOverrunCount(void);
+
+/***************************************************************************//**
+ * @brief Change how deep the FIFO's are
+ * 
+ * Use 1 to act like a UART with a single data register, like the STM32F1.
+ * The default is the full 8 bytes. It takes effect on the next byte, so call
+ * it right after a reset.
+ * 
+ * @param depth  1 to UART1_LOOPBACK_FIFO_SIZE
+ */
+void UART1_Loopback_SetFifoDepth(uint8_t depth);
+
+#endif  /* UART1_LOOPBACK_H */
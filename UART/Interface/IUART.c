@@ -10,6 +10,8 @@
  * @date 3/3/22    Redesigned function table
  * @date 6/13/22   Changed compute baud rate function and flow control
  * @date 7/31/22   Added handler for pending transmit interrupt
+ * @date 10/18/26  Added block transmit and receive functions
+ * @date 10/18/26  Added actual baud rate, baud rate error, and auto baud
  * 
  * @details
  *      The counterpart for the UART interface library. The create function 
@@ -314,6 +316,134 @@ void UART_SetRTSPinFunc(UART *self, void (*Function)(bool))
     }
 }
 
+// *****************************************************************************
+
+bool UART_TransmitBuffer(UART *self, const uint8_t *data, uint16_t size)
+{
+    if(self->interface->UART_TransmitBuffer != NULL && data != NULL)
+    {
+        return (self->interface->UART_TransmitBuffer)(data, size);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// *****************************************************************************
+
+bool UART_ReceiveBuffer(UART *self, uint8_t *dst, uint16_t max)
+{
+    if(self->interface->UART_ReceiveBuffer != NULL && dst != NULL)
+    {
+        return (self->interface->UART_ReceiveBuffer)(dst, max);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// *****************************************************************************
+
+uint16_t UART_ReceiveBufferStop(UART *self)
+{
+    if(self->interface->UART_ReceiveBufferStop != NULL)
+    {
+        return (self->interface->UART_ReceiveBufferStop)();
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+// *****************************************************************************
+
+void UART_SetTransmitBufferFinishedCallback(UART *self, void (*Function)(void))
+{
+    if(self->interface->UART_SetTransmitBufferFinishedCallback != NULL)
+    {
+        (self->interface->UART_SetTransmitBufferFinishedCallback)(Function);
+    }
+}
+
+// *****************************************************************************
+
+void UART_SetReceiveBufferFinishedCallback(UART *self, void (*Function)(uint16_t numBytes))
+{
+    if(self->interface->UART_SetReceiveBufferFinishedCallback != NULL)
+    {
+        (self->interface->UART_SetReceiveBufferFinishedCallback)(Function);
+    }
+}
+
+// *****************************************************************************
+
+uint32_t UART_ComputeActualBaudRate(UART *self, uint32_t BRGValue, uint32_t clkInHz)
+{
+    if(self->interface->UART_ComputeActualBaudRate != NULL)
+    {
+        return (self->interface->UART_ComputeActualBaudRate)(BRGValue, clkInHz);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+// *****************************************************************************
+
+int32_t UART_ComputeBaudErrorPPM(UART *self, uint32_t desiredBaudRate, uint32_t clkInHz)
+{
+    uint32_t BRGValue, actual;
+    int64_t difference;
+
+    if(desiredBaudRate == 0)
+        return UART_BAUD_ERROR_UNKNOWN;
+
+    BRGValue = UART_ComputeBRGValue(self, desiredBaudRate, clkInHz);
+    if(BRGValue == 0)
+        return UART_BAUD_ERROR_UNKNOWN;
+
+    actual = UART_ComputeActualBaudRate(self, BRGValue, clkInHz);
+    if(actual == 0)
+        return UART_BAUD_ERROR_UNKNOWN;
+
+    /* It's only done once when you set things up, so I'm not too worried 
+    about the 64-bit math */
+    difference = ((int64_t)actual - (int64_t)desiredBaudRate) * 1000000;
+    return (int32_t)(difference / (int64_t)desiredBaudRate);
+}
+
+// *****************************************************************************
+
+bool UART_AutoBaudStart(UART *self)
+{
+    if(self->interface->UART_AutoBaudStart != NULL)
+    {
+        return (self->interface->UART_AutoBaudStart)();
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// *****************************************************************************
+
+UARTAutoBaudStatus UART_GetAutoBaudStatus(UART *self, uint32_t *retBRGValue)
+{
+    if(self->interface->UART_GetAutoBaudStatus != NULL)
+    {
+        return (self->interface->UART_GetAutoBaudStatus)(retBRGValue);
+    }
+    else
+    {
+        return UART_AUTO_BAUD_IDLE;
+    }
+}
+
 /*
  End of File
  */
\ No newline at end of file
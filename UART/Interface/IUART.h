@@ -10,6 +10,8 @@
  * @date 3/3/22    Redesigned to use function table. Also added new parameters
  * @date 6/13/22   Changed compute baud rate function and flow control
  * @date 7/31/22   Added handler for pending transmit interrupt
+ * @date 10/18/26  Added block transmit and receive functions
+ * @date 10/18/26  Added actual baud rate, baud rate error, and auto baud
  * 
  * @details
  *      An interface for a UART library to be used with different processors.
@@ -28,6 +30,15 @@
  * UART1 on one processor, but UART3 on a different processor. The code that 
  * uses "bluetoothUART" never has to change though.
  * 
+ * Moving one byte per call is fine at slow baud rates, but every byte costs an
+ * interrupt, a trip through the function table, and a check of the flow 
+ * control pins. If your implementation has them, the TransmitBuffer and 
+ * ReceiveBuffer functions will move a whole block at once. They start the 
+ * transfer and return right away. The interrupt does the rest, several bytes 
+ * at a time if there is a FIFO, and a callback tells you when it is done. 
+ * Implementations that don't have them leave them NULL, and the functions
+ * just return false.
+ * 
  * Declare your UARTInterface object as extern in your UART implementation's
  * header file. This is so whatever file does the initialization can set the
  * function table. Then, in your implementation's .c file declare and 
@@ -51,6 +62,19 @@
  * hardcoding a precomputed value, and then give it to the UART_SetBRGValue 
  * function. After this, you are ready to call UART_Init.
  * 
+ * Most of the time the clock doesn't divide evenly into the baud rate you 
+ * want, so you get something a little off. If your implementation has 
+ * ComputeActualBaudRate, UART_ComputeBaudErrorPPM will tell you how far off 
+ * in parts per million. Both ends together can be off a few percent before 
+ * bytes start getting garbled, less with 9 bits or parity. The faster you go,
+ * the fewer clocks there are in each bit and the worse it gets, so check it
+ * before you turn up the baud rate.
+ * 
+ * Some UARTs can figure out the baud rate on their own from a character that
+ * the other end sends first. If yours can, AutoBaudStart turns that on and 
+ * GetAutoBaudStatus tells you when it's done. If not, see UART_AutoBaud.h 
+ * for a way to do it with a timer.
+ * 
  * @section example_code Example Code
  *      UART myUART, anotherUART;
  *      UART_Create(&myUART, &UART1_FunctionTable);
@@ -83,6 +107,8 @@
 
 // ***** Defines ***************************************************************
 
+/* From UART_ComputeBaudErrorPPM when it can't tell */
+#define UART_BAUD_ERROR_UNKNOWN     INT32_MAX
 
 // ***** Global Variables ******************************************************
 
@@ -109,6 +135,14 @@ typedef enum UARTFlowControlTag
     UART_FLOW_SOFTWARE
 } UARTFlowControl;
 
+typedef enum UARTAutoBaudStatusTag
+{
+    UART_AUTO_BAUD_IDLE = 0,
+    UART_AUTO_BAUD_BUSY,
+    UART_AUTO_BAUD_DONE,
+    UART_AUTO_BAUD_ERROR
+} UARTAutoBaudStatus;
+
 typedef struct UARTInitTypeTag
 {
     uint32_t BRGValue;
@@ -145,6 +179,14 @@ typedef struct UARTInterfaceTag
     void (*UART_SetReceivedDataCallback)(void (*Function)(uint8_t (*CallToGetData)(void)));
     void (*UART_SetIsCTSPinLowFunc)(bool (*Function)(void));
     void (*UART_SetRTSPinFunc)(void (*Function)(bool));
+    bool (*UART_TransmitBuffer)(const uint8_t *, uint16_t);
+    bool (*UART_ReceiveBuffer)(uint8_t *, uint16_t);
+    uint16_t (*UART_ReceiveBufferStop)(void);
+    void (*UART_SetTransmitBufferFinishedCallback)(void (*Function)(void));
+    void (*UART_SetReceiveBufferFinishedCallback)(void (*Function)(uint16_t));
+    uint32_t (*UART_ComputeActualBaudRate)(uint32_t, uint32_t);
+    bool (*UART_AutoBaudStart)(void);
+    UARTAutoBaudStatus (*UART_GetAutoBaudStatus)(uint32_t *);
 } UARTInterface;
 
 typedef struct UARTTag
@@ -543,4 +585,149 @@ void UART_SetIsCTSPinLowFunc(UART *self, bool (*Function)(void));
  */
 void UART_SetRTSPinFunc(UART *self, void (*Function)(bool setPinHigh));
 
+/***************************************************************************//**
+ * @brief Start sending a block of data without waiting for it to finish
+ * 
+ * Load as much of the data as the hardware will take, then let the transmit
+ * interrupt load the rest. The TransmitRegisterEmptyEvent function must be 
+ * called from your interrupt for this to work, whether or not useTxInterrupt 
+ * was set. The data must not change until the transmit buffer finished 
+ * callback is called. If you are using callbacks for flow control, the CTS pin
+ * is checked once each time the interrupt loads more data instead of every 
+ * byte. If CTS is high, the transfer waits until PendingEventHandler sees it
+ * go low again.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @param data  pointer to the data to send
+ * 
+ * @param size  number of bytes to send
+ * 
+ * @return true if the transfer was started, false if one is already going or
+ *         it isn't implemented
+ */
+bool UART_TransmitBuffer(UART *self, const uint8_t *data, uint16_t size);
+
+/***************************************************************************//**
+ * @brief Start receiving a block of data without waiting for it
+ * 
+ * Every byte that comes in is placed into your array, until max bytes have
+ * been received. Then the receive buffer finished callback is called. The
+ * ReceivedDataEvent function must be called from your interrupt for this to 
+ * work, whether or not useRxInterrupt was set. While the receive is going, 
+ * the received data callback is not called. If you don't know how many bytes
+ * are coming, use ReceiveBufferStop to end it early.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @param dst  pointer to the array to put the data in
+ * 
+ * @param max  number of bytes to receive
+ * 
+ * @return true if the receive was started, false if one is already going or
+ *         it isn't implemented
+ */
+bool UART_ReceiveBuffer(UART *self, uint8_t *dst, uint16_t max);
+
+/***************************************************************************//**
+ * @brief Stop receiving a block early
+ * 
+ * Anything still waiting in the hardware is moved to your array first. The 
+ * receive buffer finished callback is not called.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @return uint16_t  the number of bytes that were received
+ */
+uint16_t UART_ReceiveBufferStop(UART *self);
+
+/***************************************************************************//**
+ * @brief Set a function to be called when a transmit buffer is finished
+ * 
+ * This is called from the interrupt after the last byte has been loaded into
+ * the hardware. You can reuse your data or start another transfer from here.
+ * The last few bytes may still be going out on the wire. Use 
+ * IsTransmitFinished if you need to know when they are done.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @param Function  format: void SomeFunction(void)
+ */
+void UART_SetTransmitBufferFinishedCallback(UART *self, void (*Function)(void));
+
+/***************************************************************************//**
+ * @brief Set a function to be called when a receive buffer is full
+ * 
+ * This is called from the interrupt. You can start another receive from here.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @param Function  format: void SomeFunction(uint16_t numBytes)
+ */
+void UART_SetReceiveBufferFinishedCallback(UART *self, void (*Function)(uint16_t numBytes));
+
+/***************************************************************************//**
+ * @brief Return the baud rate you will really get from a BRG value
+ * 
+ * The opposite of ComputeBRGValue. Rounded to the nearest whole baud.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @param BRGValue  a value from ComputeBRGValue or GetAutoBaudStatus
+ * 
+ * @param clkInHz  the frequency of your UART peripherals clock in Hertz
+ * 
+ * @return uint32_t  the baud rate, or 0 if it isn't implemented
+ */
+uint32_t UART_ComputeActualBaudRate(UART *self, uint32_t BRGValue, uint32_t clkInHz);
+
+/***************************************************************************//**
+ * @brief How far off the baud rate will be, in parts per million
+ * 
+ * Computes the BRG value for the baud rate you want, then the baud rate that
+ * BRG value really gives you. Positive means faster than you asked for. 
+ * Since the actual baud rate is rounded to a whole number, this can be off by
+ * 500000 / desiredBaudRate ppm, which is about 4 at 115200. It doesn't count
+ * how far off your clock is.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @param desiredBaudRate  the baud rate you want
+ * 
+ * @param clkInHz  the frequency of your UART peripherals clock in Hertz
+ * 
+ * @return int32_t  the error in ppm. UART_BAUD_ERROR_UNKNOWN if the baud rate
+ *                  can't be made or ComputeActualBaudRate isn't implemented
+ */
+int32_t UART_ComputeBaudErrorPPM(UART *self, uint32_t desiredBaudRate, uint32_t clkInHz);
+
+/***************************************************************************//**
+ * @brief Have the UART find the baud rate from the next character
+ * 
+ * Call UART_Init first. The UART measures the next character that comes in 
+ * and sets its own baud rate. Which character it expects depends on your 
+ * implementation. Usually it's 0x55 ('U'). That character may or may not 
+ * show up as received data, so ignore anything that comes in until 
+ * GetAutoBaudStatus says it's done. Calling this again starts over.
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @return true if it started, false if this UART can't do it
+ */
+bool UART_AutoBaudStart(UART *self);
+
+/***************************************************************************//**
+ * @brief See if the auto baud is done
+ * 
+ * @param self  pointer to the UART you are using
+ * 
+ * @param retBRGValue  if it's done, the BRG value the UART found is put here.
+ *                     Give it to ComputeActualBaudRate to get the baud rate,
+ *                     or save it for UART_Init next time. Can be NULL.
+ * 
+ * @return UARTAutoBaudStatus  IDLE if it was never started or this UART can't 
+ *                             do it, BUSY, DONE, or ERROR
+ */
+UARTAutoBaudStatus UART_GetAutoBaudStatus(UART *self, uint32_t *retBRGValue);
+
 #endif  /* IUART_H */
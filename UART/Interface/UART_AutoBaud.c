@@ -0,0 +1,218 @@
+/***************************************************************************//**
+ * @brief UART Auto Baud
+ * 
+ * @file UART_AutoBaud.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      See UART_AutoBaud.h
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "UART_AutoBaud.h"
+#include <stddef.h>
+
+// ***** Defines ***************************************************************
+
+
+// ***** Global Variables ******************************************************
+
+/* The usual baud rates that a measured one gets rounded to */
+static const uint32_t standardBaudRates[] = { 1200, 2400, 4800, 9600, 14400,
+    19200, 28800, 38400, 57600, 76800, 115200, 230400, 250000, 460800, 500000,
+    921600, 1000000, 2000000 };
+
+// ***** Static Function Prototypes ********************************************
+
+static void Finish(UARTAutoBaud *self);
+static uint32_t SnapToStandard(uint32_t baudRate);
+
+// *****************************************************************************
+
+void UART_AutoBaud_Create(UARTAutoBaud *self, UART *uart, uint32_t uartClkInHz,
+    HWTimer *timer, uint32_t timerClkInHz)
+{
+    self->uart = uart;
+    self->timer = timer;
+    self->uartClkInHz = uartClkInHz;
+    self->timerClkInHz = timerClkInHz;
+    self->status = UART_AUTO_BAUD_IDLE;
+    self->useHardware = false;
+    self->BRGValue = 0;
+    self->baudRate = 0;
+}
+
+// *****************************************************************************
+
+void UART_AutoBaud_Start(UARTAutoBaud *self, uint8_t numEdges)
+{
+    self->BRGValue = 0;
+    self->baudRate = 0;
+
+    /* Let the UART do it if it can */
+    self->useHardware = UART_AutoBaudStart(self->uart);
+    if(self->useHardware)
+    {
+        self->status = UART_AUTO_BAUD_BUSY;
+        return;
+    }
+
+    /* Need at least three edges to tell a bit from two bits */
+    if(self->timer == NULL || self->timerClkInHz == 0 || numEdges < 3 ||
+        numEdges > UART_AUTO_BAUD_MAX_EDGES)
+    {
+        self->status = UART_AUTO_BAUD_ERROR;
+        return;
+    }
+
+    self->edgesNeeded = numEdges;
+    self->edgeCount = 0;
+    self->status = UART_AUTO_BAUD_BUSY;
+}
+
+// *****************************************************************************
+
+void UART_AutoBaud_EdgeEvent(UARTAutoBaud *self)
+{
+    uint16_t now;
+
+    if(self->useHardware || self->status != UART_AUTO_BAUD_BUSY)
+        return;
+
+    now = HWTimer_GetCount(self->timer);
+
+    /* The timer is free running, so this works across an overflow */
+    if(self->edgeCount > 0)
+        self->intervals[self->edgeCount - 1] = now - self->lastEdge;
+
+    self->lastEdge = now;
+    self->edgeCount++;
+
+    if(self->edgeCount >= self->edgesNeeded)
+        Finish(self);
+}
+
+// *****************************************************************************
+
+UARTAutoBaudStatus UART_AutoBaud_GetStatus(UARTAutoBaud *self)
+{
+    if(self->useHardware && self->status == UART_AUTO_BAUD_BUSY)
+    {
+        self->status = UART_GetAutoBaudStatus(self->uart, &self->BRGValue);
+
+        if(self->status == UART_AUTO_BAUD_DONE)
+        {
+            self->baudRate = UART_ComputeActualBaudRate(self->uart,
+                self->BRGValue, self->uartClkInHz);
+        }
+        else if(self->status == UART_AUTO_BAUD_IDLE)
+        {
+            /* Somebody turned it off on us */
+            self->status = UART_AUTO_BAUD_ERROR;
+        }
+    }
+    return self->status;
+}
+
+// *****************************************************************************
+
+uint32_t UART_AutoBaud_GetBaudRate(UARTAutoBaud *self)
+{
+    return (self->status == UART_AUTO_BAUD_DONE) ? self->baudRate : 0;
+}
+
+// *****************************************************************************
+
+uint32_t UART_AutoBaud_GetBRGValue(UARTAutoBaud *self)
+{
+    return (self->status == UART_AUTO_BAUD_DONE) ? self->BRGValue : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Work out the baud rate from the edges
+ * 
+ * The shortest gap is about one bit, but only to within the interrupt delay.
+ * The whole span is a lot more ticks, so it's more accurate. Use the shortest
+ * gap to figure out how many bits each gap was, then divide the span by the 
+ * total. Rounding each gap on its own, instead of the whole span at once, 
+ * lets the delay change a lot more between edges. Called from the 
+ * interrupt, but only once per character.
+ */
+static void Finish(UARTAutoBaud *self)
+{
+    uint32_t span = 0, numBits = 0, baudRate;
+    uint16_t shortest = UINT16_MAX;
+    uint8_t numIntervals = self->edgesNeeded - 1;
+
+    for(uint8_t i = 0; i < numIntervals; i++)
+    {
+        span += self->intervals[i];
+        if(self->intervals[i] < shortest)
+            shortest = self->intervals[i];
+    }
+
+    /* Less than two ticks a bit is too fast for the timer to tell */
+    if(shortest < 2)
+    {
+        self->status = UART_AUTO_BAUD_ERROR;
+        return;
+    }
+
+    for(uint8_t i = 0; i < numIntervals; i++)
+        numBits += (self->intervals[i] + shortest / 2) / shortest;
+
+    baudRate = (uint32_t)(((uint64_t)self->timerClkInHz * numBits + span / 2) /
+        span);
+    baudRate = SnapToStandard(baudRate);
+
+    self->BRGValue = UART_ComputeBRGValue(self->uart, baudRate, self->uartClkInHz);
+    if(self->BRGValue == 0)
+    {
+        self->status = UART_AUTO_BAUD_ERROR;
+        return;
+    }
+    self->baudRate = baudRate;
+    self->status = UART_AUTO_BAUD_DONE;
+}
+
+/***************************************************************************//**
+ * @brief Round to the closest usual baud rate, if one is close enough
+ * 
+ * @param baudRate  the measured baud rate
+ * 
+ * @return uint32_t  the usual one, or the same baud rate if none are close
+ */
+static uint32_t SnapToStandard(uint32_t baudRate)
+{
+    for(uint8_t i = 0; i < sizeof(standardBaudRates) / sizeof(standardBaudRates[0]); i++)
+    {
+        uint32_t standard = standardBaudRates[i];
+        uint32_t difference = (baudRate > standard) ? baudRate - standard :
+            standard - baudRate;
+
+        if((uint64_t)difference * 1000000 <= (uint64_t)standard * UART_AUTO_BAUD_SNAP_PPM)
+            return standard;
+    }
+    return baudRate;
+}
+
+/*
+ End of File
+ */
@@ -0,0 +1,209 @@
+/***************************************************************************//**
+ * @brief UART Auto Baud Header
+ * 
+ * @file UART_AutoBaud.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      Finds the baud rate of whatever is talking to us, for any UART that 
+ * uses the IUART interface. If the UART can do it on its own (see 
+ * UART_AutoBaudStart in IUART.h), that is what gets used. If it can't, it's 
+ * done with a timer from IHardwareTimer instead.
+ * 
+ * For the timer way, you need an interrupt on both edges of the RX pin, and
+ * a timer that counts freely through all 16 bits. Call UART_AutoBaud_EdgeEvent
+ * from the pin interrupt. It reads the timer count at every edge. The other 
+ * end sends a character that we know the number of edges in. 0x55 ('U') is 
+ * best. With 8 data bits and no parity, it's a start bit and then every bit 
+ * flips, so there are 10 edges, all one bit apart. The shortest time 
+ * between two edges is about one bit. Each gap is divided by that and 
+ * rounded to get how many bits it was. Then the time from the first edge to 
+ * the last is divided by the total number of bits. The delay getting into 
+ * the interrupt only matters at the first and last edge, so the result is 
+ * good to a small fraction of a bit. The delay just can't change by more 
+ * than about a fifth of a bit from one edge to the next. If the result comes
+ * out within UART_AUTO_BAUD_SNAP_PPM of one of the usual baud rates, it's 
+ * rounded to that one.
+ * 
+ * Any character works as long as it has at least one single bit somewhere 
+ * and you give the right number of edges. 0x55 is just the most accurate.
+ * 
+ * When it's done, UART_AutoBaud_GetBRGValue has the value for UART_Init. The
+ * UART doesn't change on its own with the timer way, so call UART_Init with 
+ * it. The sync character itself will most likely come in garbled. Ignore it.
+ * 
+ * @section example_code Example Code
+ *      UARTAutoBaud myAutoBaud;
+ *      UART_AutoBaud_Create(&myAutoBaud, &myUART, 64000000UL, &myTimer, 1000000UL);
+ *      UART_AutoBaud_Start(&myAutoBaud, UART_AUTO_BAUD_EDGES_0x55);
+ * 
+ *      // RX pin interrupt, both edges
+ *      UART_AutoBaud_EdgeEvent(&myAutoBaud);
+ * 
+ *      // main loop
+ *      if(UART_AutoBaud_GetStatus(&myAutoBaud) == UART_AUTO_BAUD_DONE)
+ *      {
+ *          UART_SetInitBRGValue(&params, UART_AutoBaud_GetBRGValue(&myAutoBaud));
+ *          UART_Init(&myUART, &params);
+ *      }
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#ifndef UART_AUTOBAUD_H
+#define UART_AUTOBAUD_H
+
+// ***** Includes **************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "IUART.h"
+#include "IHardwareTimer.h"
+
+// ***** Defines ***************************************************************
+
+/* Edges in 0x55 with 8 data bits, counting the start bit and the stop bit */
+#define UART_AUTO_BAUD_EDGES_0x55   10
+
+/* The most edges a sync character can have */
+#ifndef UART_AUTO_BAUD_MAX_EDGES
+#define UART_AUTO_BAUD_MAX_EDGES    20
+#endif
+
+/* How close a measured baud rate has to be to a usual one to be rounded to 
+it. 30000 is 3%. Set to 0 to never round. */
+#ifndef UART_AUTO_BAUD_SNAP_PPM
+#define UART_AUTO_BAUD_SNAP_PPM     30000
+#endif
+
+// ***** Global Variables ******************************************************
+
+typedef struct UARTAutoBaudTag
+{
+    UART *uart;
+    HWTimer *timer;
+    uint32_t uartClkInHz;
+    uint32_t timerClkInHz;
+    uint16_t intervals[UART_AUTO_BAUD_MAX_EDGES - 1];
+    uint16_t lastEdge;
+    uint8_t edgesNeeded;
+    volatile uint8_t edgeCount;
+    bool useHardware;
+    volatile UARTAutoBaudStatus status;
+    uint32_t BRGValue;
+    uint32_t baudRate;
+} UARTAutoBaud;
+
+/**
+ * Description of struct members:
+ * 
+ * uart  The UART we are finding the baud rate for
+ * 
+ * timer  The timer for when the UART can't do it. Can be NULL if it can.
+ * 
+ * uartClkInHz  The UART's clock, for computing the BRG value
+ * 
+ * timerClkInHz  How fast the timer counts
+ * 
+ * intervals  Timer ticks between each edge and the one before it
+ * 
+ * lastEdge  Timer count at the last edge
+ * 
+ * edgesNeeded, edgeCount  How many edges are in the sync character and how
+ *                         many we've seen
+ * 
+ * useHardware  The UART is doing it, not the timer
+ * 
+ * status  Idle, busy, done, or error
+ * 
+ * BRGValue, baudRate  The answer
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Function Prototypes *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Link a UART, and a timer if needed
+ * 
+ * @param self  pointer to the UARTAutoBaud you are using
+ * 
+ * @param uart  the UART. Call UART_Init first.
+ * 
+ * @param uartClkInHz  the UART's clock in Hertz
+ * 
+ * @param timer  a free running 16-bit timer, or NULL if the UART can do auto
+ *               baud itself
+ * 
+ * @param timerClkInHz  how fast the timer counts in Hertz. The faster the
+ *                      better, but one character has to fit in 65535 ticks.
+ */
+void UART_AutoBaud_Create(UARTAutoBaud *self, UART *uart, uint32_t uartClkInHz,
+    HWTimer *timer, uint32_t timerClkInHz);
+
+/***************************************************************************//**
+ * @brief Start looking for the baud rate
+ * 
+ * If the UART can do it, it's told to. If not, the next numEdges calls to 
+ * EdgeEvent are measured. Calling this again starts over.
+ * 
+ * @param self  pointer to the UARTAutoBaud you are using
+ * 
+ * @param numEdges  edges in the sync character, like UART_AUTO_BAUD_EDGES_0x55.
+ *                  Up to UART_AUTO_BAUD_MAX_EDGES. Not used if the UART 
+ *                  does it.
+ */
+void UART_AutoBaud_Start(UARTAutoBaud *self, uint8_t numEdges);
+
+/***************************************************************************//**
+ * @brief Call this from the RX pin interrupt on every edge
+ * 
+ * Read the timer as early in your interrupt as you can. Does nothing unless
+ * we are using the timer and looking for the baud rate.
+ * 
+ * @param self  pointer to the UARTAutoBaud you are using
+ */
+void UART_AutoBaud_EdgeEvent(UARTAutoBaud *self);
+
+/***************************************************************************//**
+ * @brief See if it's done
+ * 
+ * @param self  pointer to the UARTAutoBaud you are using
+ * 
+ * @return UARTAutoBaudStatus  IDLE, BUSY, DONE, or ERROR. ERROR means the 
+ *                             edges didn't make sense or the baud rate can't
+ *                             be made with this UART.
+ */
+UARTAutoBaudStatus UART_AutoBaud_GetStatus(UARTAutoBaud *self);
+
+/***************************************************************************//**
+ * @brief Get the baud rate that was found
+ * 
+ * @param self  pointer to the UARTAutoBaud you are using
+ * 
+ * @return uint32_t  the baud rate, or 0 if it isn't done
+ */
+uint32_t UART_AutoBaud_GetBaudRate(UARTAutoBaud *self);
+
+/***************************************************************************//**
+ * @brief Get the BRG value for the baud rate that was found
+ * 
+ * @param self  pointer to the UARTAutoBaud you are using
+ * 
+ * @return uint32_t  the value for UART_SetInitBRGValue, or 0 if it isn't done
+ */
+uint32_t UART_AutoBaud_GetBRGValue(UARTAutoBaud *self);
+
+#endif  /* UART_AUTOBAUD_H */
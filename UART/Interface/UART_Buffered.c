@@ -0,0 +1,210 @@
+/***************************************************************************//**
+ * @brief Buffered UART
+ * 
+ * @file UART_Buffered.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      Moves bytes between two Buffers and a UART. The transmit side doesn't
+ * need a flag to know if it's running. Whoever gets there first, the write or
+ * the interrupt, loads the UART until it's full or there's nothing left. The
+ * Buffer keeps everything in order either way. The critical section is there
+ * so that the two can't both be in the Buffer at once.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "UART_Buffered.h"
+#include <stddef.h>
+
+// ***** Defines ***************************************************************
+
+
+// ***** Global Variables ******************************************************
+
+
+// ***** Static Function Prototypes ********************************************
+
+static void LoadTransmitter(UARTBuffered *self);
+static void StoreReceivedByte(UARTBuffered *self, uint8_t data);
+
+// *****************************************************************************
+
+void UART_Buffered_Create(UARTBuffered *self, UART *uart, uint8_t *txArray,
+    uint8_t txSize, uint8_t *rxArray, uint8_t rxSize)
+{
+    self->uart = uart;
+    self->txSize = txSize;
+    Buffer_Init(&self->txBuffer, txArray, txSize);
+    Buffer_Init(&self->rxBuffer, rxArray, rxSize);
+    UART_Buffered_ResetStats(self);
+}
+
+// *****************************************************************************
+
+uint16_t UART_Buffered_Write(UARTBuffered *self, const uint8_t *data, uint16_t numBytes)
+{
+    uint16_t space;
+    uint8_t count;
+
+    if(data == NULL || numBytes == 0)
+        return 0;
+
+    UART_BUFFERED_ENTER_CRITICAL();
+
+    /* Only take what fits. We don't want the Buffer's overflow here. */
+    space = self->txSize - 1 - Buffer_GetCount(&self->txBuffer);
+    if(numBytes > space)
+        numBytes = space;
+
+    Buffer_WriteBytes(&self->txBuffer, data, numBytes);
+
+    count = Buffer_GetCount(&self->txBuffer);
+    if(count > self->stats.txHighWater)
+        self->stats.txHighWater = count;
+
+    LoadTransmitter(self);
+
+    UART_BUFFERED_EXIT_CRITICAL();
+
+    return numBytes;
+}
+
+// *****************************************************************************
+
+uint16_t UART_Buffered_Read(UARTBuffered *self, uint8_t *dst, uint16_t max)
+{
+    uint16_t numBytes;
+
+    if(dst == NULL)
+        return 0;
+
+    UART_BUFFERED_ENTER_CRITICAL();
+    numBytes = Buffer_ReadBytes(&self->rxBuffer, dst, max);
+    UART_BUFFERED_EXIT_CRITICAL();
+
+    return numBytes;
+}
+
+// *****************************************************************************
+
+uint16_t UART_Buffered_GetReceivedCount(UARTBuffered *self)
+{
+    return Buffer_GetCount(&self->rxBuffer);
+}
+
+// *****************************************************************************
+
+uint16_t UART_Buffered_GetTransmitSpace(UARTBuffered *self)
+{
+    return self->txSize - 1 - Buffer_GetCount(&self->txBuffer);
+}
+
+// *****************************************************************************
+
+bool UART_Buffered_IsTransmitIdle(UARTBuffered *self)
+{
+    return !Buffer_IsNotEmpty(&self->txBuffer);
+}
+
+// *****************************************************************************
+
+void UART_Buffered_TransmitEvent(UARTBuffered *self)
+{
+    self->stats.transmitEvents++;
+    LoadTransmitter(self);
+}
+
+// *****************************************************************************
+
+void UART_Buffered_ReceiveEvent(UARTBuffered *self, uint8_t (*CallToGetData)(void))
+{
+    self->stats.receiveEvents++;
+
+    /* The first one comes from the function we were given. That's the one
+    that clears the flag on some processors. */
+    if(CallToGetData != NULL)
+        StoreReceivedByte(self, CallToGetData());
+
+    /* If there's a FIFO, empty it now so we don't get another interrupt */
+    while(UART_IsReceiveRegisterFull(self->uart))
+    {
+        StoreReceivedByte(self, UART_GetReceivedByte(self->uart));
+    }
+}
+
+// *****************************************************************************
+
+const UARTBufferedStats *UART_Buffered_GetStats(UARTBuffered *self)
+{
+    return &self->stats;
+}
+
+// *****************************************************************************
+
+void UART_Buffered_ResetStats(UARTBuffered *self)
+{
+    self->stats.bytesSent = 0;
+    self->stats.bytesReceived = 0;
+    self->stats.transmitEvents = 0;
+    self->stats.receiveEvents = 0;
+    self->stats.receiveOverflows = 0;
+    self->stats.txHighWater = 0;
+    self->stats.rxHighWater = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Give the UART bytes until it's full or the Buffer is empty
+ * 
+ * IsTransmitRegisterEmpty also checks CTS, so this stops when CTS goes high.
+ */
+static void LoadTransmitter(UARTBuffered *self)
+{
+    while(Buffer_IsNotEmpty(&self->txBuffer) &&
+        UART_IsTransmitRegisterEmpty(self->uart))
+    {
+        UART_TransmitByte(self->uart, Buffer_ReadByte(&self->txBuffer));
+        self->stats.bytesSent++;
+    }
+}
+
+/***************************************************************************//**
+ * @brief Put a byte in the receive Buffer, or count it as lost if it's full
+ */
+static void StoreReceivedByte(UARTBuffered *self, uint8_t data)
+{
+    uint8_t count;
+
+    if(Buffer_IsFull(&self->rxBuffer))
+    {
+        self->stats.receiveOverflows++;
+        return;
+    }
+
+    Buffer_WriteByte(&self->rxBuffer, data);
+    self->stats.bytesReceived++;
+
+    count = Buffer_GetCount(&self->rxBuffer);
+    if(count > self->stats.rxHighWater)
+        self->stats.rxHighWater = count;
+}
+
+/*
+ End of File
+ */
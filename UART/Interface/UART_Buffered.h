@@ -0,0 +1,255 @@
+/***************************************************************************//**
+ * @brief Buffered UART Header
+ * 
+ * @file UART_Buffered.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      Interrupt driven transmit and receive queues for any UART that uses the
+ * IUART interface. Before this, every program I wrote made its own transmit
+ * and receive Buffers and its own callbacks to move bytes in and out of them.
+ * This does that for you.
+ * 
+ * You give it two arrays. It makes a transmit Buffer and a receive Buffer out
+ * of them. UART_Buffered_Write puts data in the transmit Buffer and loads the
+ * UART with as much as it will take right away. After that, every transmit
+ * interrupt loads as many bytes as the UART will take. If the UART has a
+ * FIFO, that could be several bytes each time. Every receive interrupt reads out every
+ * byte the UART has and puts them in the receive Buffer. UART_Buffered_Read
+ * gets them back out.
+ * 
+ * Both the transmit and receive interrupt must be turned on (useTxInterrupt
+ * and useRxInterrupt). Your UART's callbacks can't have any arguments, so you
+ * will need to make two small functions that call the events for your
+ * object. See the example below.
+ * 
+ * There are statistics kept for each object. The high water marks tell you
+ * the most that was ever in each Buffer, so you can tell if your arrays are
+ * too big or too small. The event counts tell you how many interrupts it
+ * took to move your data.
+ * 
+ * The Buffers are shared between the interrupt and your code. Define
+ * UART_BUFFERED_ENTER_CRITICAL and UART_BUFFERED_EXIT_CRITICAL to turn off
+ * and on the UART interrupt (or all interrupts) for your processor.
+ * 
+ * @section example_code Example Code
+ *      UART myUART;
+ *      UARTBuffered myBufferedUART;
+ *      uint8_t txArray[64], rxArray[64];
+ * 
+ *      void MyTxCallback(void)
+ *      {
+ *          UART_Buffered_TransmitEvent(&myBufferedUART);
+ *      }
+ * 
+ *      void MyRxCallback(uint8_t (*CallToGetData)(void))
+ *      {
+ *          UART_Buffered_ReceiveEvent(&myBufferedUART, CallToGetData);
+ *      }
+ * 
+ *      // After UART_Init with both interrupts turned on
+ *      UART_Buffered_Create(&myBufferedUART, &myUART, txArray, 64, rxArray, 64);
+ *      UART_SetTransmitRegisterEmptyCallback(&myUART, MyTxCallback);
+ *      UART_SetReceivedDataCallback(&myUART, MyRxCallback);
+ *      UART_Buffered_Write(&myBufferedUART, (uint8_t *)"Hello", 5);
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#ifndef UART_BUFFERED_H
+#define UART_BUFFERED_H
+
+// ***** Includes **************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "IUART.h"
+#include "Buffer.h"
+
+// ***** Defines ***************************************************************
+
+/* Block and unblock the UART interrupt */
+#ifndef UART_BUFFERED_ENTER_CRITICAL
+#define UART_BUFFERED_ENTER_CRITICAL()
+#endif
+
+#ifndef UART_BUFFERED_EXIT_CRITICAL
+#define UART_BUFFERED_EXIT_CRITICAL()
+#endif
+
+// ***** Global Variables ******************************************************
+
+typedef struct UARTBufferedStatsTag
+{
+    uint32_t bytesSent;
+    uint32_t bytesReceived;
+    uint32_t transmitEvents;
+    uint32_t receiveEvents;
+    uint32_t receiveOverflows;
+    uint8_t txHighWater;
+    uint8_t rxHighWater;
+} UARTBufferedStats;
+
+typedef struct UARTBufferedTag
+{
+    UART *uart;
+    Buffer txBuffer;
+    Buffer rxBuffer;
+    uint8_t txSize;
+    UARTBufferedStats stats;
+} UARTBuffered;
+
+/**
+ * Description of struct members:
+ * 
+ * uart  The UART that does the actual work
+ * 
+ * txBuffer  Data waiting to be sent
+ * 
+ * rxBuffer  Data that has been received, waiting for you to read it
+ * 
+ * txSize  Size of the transmit array. The Buffer holds one less than this.
+ * 
+ * bytesSent, bytesReceived  Bytes that went through the UART
+ * 
+ * transmitEvents, receiveEvents  How many times the events were called. This
+ *                                is how many interrupts it took.
+ * 
+ * receiveOverflows  Bytes that were lost because the receive Buffer was full
+ * 
+ * txHighWater, rxHighWater  The most that was ever in each Buffer
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Function Prototypes *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Set up the Buffers and link them to a UART
+ * 
+ * The UART should already be initialized with both interrupts turned on.
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @param uart  pointer to the UART to use
+ * 
+ * @param txArray  array for the transmit Buffer
+ * 
+ * @param txSize  size of the transmit array
+ * 
+ * @param rxArray  array for the receive Buffer
+ * 
+ * @param rxSize  size of the receive array
+ */
+void UART_Buffered_Create(UARTBuffered *self, UART *uart, uint8_t *txArray,
+    uint8_t txSize, uint8_t *rxArray, uint8_t rxSize);
+
+/***************************************************************************//**
+ * @brief Put data in the transmit Buffer and start sending
+ * 
+ * This doesn't wait. If there isn't room for all of it, only what fits is
+ * taken.
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @param data  pointer to the data to send
+ * 
+ * @param numBytes  how many bytes to send
+ * 
+ * @return uint16_t  how many bytes were taken
+ */
+uint16_t UART_Buffered_Write(UARTBuffered *self, const uint8_t *data, uint16_t numBytes);
+
+/***************************************************************************//**
+ * @brief Get received data out of the receive Buffer
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @param dst  where to put the data
+ * 
+ * @param max  the most bytes you want
+ * 
+ * @return uint16_t  how many bytes you got
+ */
+uint16_t UART_Buffered_Read(UARTBuffered *self, uint8_t *dst, uint16_t max);
+
+/***************************************************************************//**
+ * @brief Get the number of bytes waiting in the receive Buffer
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @return uint16_t  number of bytes
+ */
+uint16_t UART_Buffered_GetReceivedCount(UARTBuffered *self);
+
+/***************************************************************************//**
+ * @brief Get the number of bytes the transmit Buffer has room for
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @return uint16_t  number of bytes
+ */
+uint16_t UART_Buffered_GetTransmitSpace(UARTBuffered *self);
+
+/***************************************************************************//**
+ * @brief Check if everything has been handed to the UART
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @return true if the transmit Buffer is empty
+ */
+bool UART_Buffered_IsTransmitIdle(UARTBuffered *self);
+
+/***************************************************************************//**
+ * @brief Load the UART from the transmit Buffer
+ * 
+ * Call this from your UART's transmit register empty callback. It keeps
+ * loading until the UART is full or the Buffer is empty. If you use CTS, the
+ * UART won't take anything while CTS is high and the interrupt stops, so call
+ * this from your main loop as well to get it going again.
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ */
+void UART_Buffered_TransmitEvent(UARTBuffered *self);
+
+/***************************************************************************//**
+ * @brief Move everything the UART has into the receive Buffer
+ * 
+ * Call this from your UART's received data callback and pass along the
+ * function it gave you.
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @param CallToGetData  the function from your received data callback
+ */
+void UART_Buffered_ReceiveEvent(UARTBuffered *self, uint8_t (*CallToGetData)(void));
+
+/***************************************************************************//**
+ * @brief Get the statistics
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ * 
+ * @return const UARTBufferedStats*  pointer to the statistics
+ */
+const UARTBufferedStats *UART_Buffered_GetStats(UARTBuffered *self);
+
+/***************************************************************************//**
+ * @brief Set all of the statistics back to zero
+ * 
+ * @param self  pointer to the UARTBuffered you are using
+ */
+void UART_Buffered_ResetStats(UARTBuffered *self);
+
+#endif  /* UART_BUFFERED_H */
@@ -0,0 +1,203 @@
+/***************************************************************************//**
+ * @brief UART DMA
+ * 
+ * @file UART_DMA.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      The processor independent part of the UART DMA library. The function
+ * table takes care of the registers. This part keeps track of where we are in
+ * the circular DMA array and moves the new data to the Buffer.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#include "UART_DMA.h"
+#include <stddef.h>
+
+// ***** Defines ***************************************************************
+
+
+// ***** Global Variables ******************************************************
+
+
+// ***** Static Function Prototypes ********************************************
+
+static void CopyNewData(UARTDMA *self);
+
+// *****************************************************************************
+
+void UART_DMA_Create(UARTDMA *self, UARTDMAInterface *interface)
+{
+    self->interface = interface;
+    self->rxBuffer = NULL;
+    self->rxActive = false;
+    self->txBusy = false;
+    self->ReceivedDataCallback = NULL;
+    self->TransmitFinishedCallback = NULL;
+}
+
+// *****************************************************************************
+
+void UART_DMA_StartReceive(UARTDMA *self, uint8_t *dmaArray, uint16_t size, Buffer *rxBuffer)
+{
+    if(dmaArray == NULL || rxBuffer == NULL || size == 0 || self->rxActive)
+        return;
+
+    self->dmaArray = dmaArray;
+    self->dmaArraySize = size;
+    self->rxBuffer = rxBuffer;
+    self->readPosition = 0;
+    self->rxActive = true;
+
+    if(self->interface->UART_DMA_StartReceive != NULL)
+    {
+        (self->interface->UART_DMA_StartReceive)(dmaArray, size);
+    }
+}
+
+// *****************************************************************************
+
+void UART_DMA_StopReceive(UARTDMA *self)
+{
+    if(!self->rxActive)
+        return;
+
+    if(self->interface->UART_DMA_StopReceive != NULL)
+    {
+        (self->interface->UART_DMA_StopReceive)();
+    }
+
+    /* The DMA is stopped, so whatever it has now is all there is */
+    CopyNewData(self);
+    self->rxActive = false;
+}
+
+// *****************************************************************************
+
+bool UART_DMA_Transmit(UARTDMA *self, const uint8_t *data, uint16_t size)
+{
+    if(self->txBusy || data == NULL || size == 0 ||
+        self->interface->UART_DMA_StartTransmit == NULL)
+    {
+        return false;
+    }
+
+    self->txBusy = true;
+    (self->interface->UART_DMA_StartTransmit)(data, size);
+    return true;
+}
+
+// *****************************************************************************
+
+bool UART_DMA_IsTransmitBusy(UARTDMA *self)
+{
+    return self->txBusy;
+}
+
+// *****************************************************************************
+
+void UART_DMA_InterruptHandler(UARTDMA *self)
+{
+    uint8_t events = 0;
+
+    if(self->interface->UART_DMA_GetAndClearEvents != NULL)
+    {
+        events = (self->interface->UART_DMA_GetAndClearEvents)();
+    }
+
+    /* It doesn't matter which one it was. Idle line, half, or full, they all
+    mean go see how far the DMA got. */
+    if((events & UART_DMA_EVENT_RECEIVE) && self->rxActive)
+    {
+        CopyNewData(self);
+    }
+
+    if(events & UART_DMA_EVENT_TX_FINISHED)
+    {
+        self->txBusy = false;
+        if(self->TransmitFinishedCallback)
+            self->TransmitFinishedCallback();
+    }
+}
+
+// *****************************************************************************
+
+void UART_DMA_SetReceivedDataCallback(UARTDMA *self, void (*Function)(uint16_t numBytes))
+{
+    self->ReceivedDataCallback = Function;
+}
+
+// *****************************************************************************
+
+void UART_DMA_SetTransmitFinishedCallback(UARTDMA *self, void (*Function)(void))
+{
+    self->TransmitFinishedCallback = Function;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Copy everything between the last read and the DMA to the Buffer
+ * 
+ * The DMA count register counts down, so the DMA's position in the array is
+ * the size minus what's remaining. Right when it reloads, remaining is the
+ * size, which puts us back at 0. If the DMA went all the way around and came
+ * back to the same spot, it looks the same as nothing coming in. That's why
+ * the half and full interrupts are used.
+ */
+static void CopyNewData(UARTDMA *self)
+{
+    uint16_t remaining = 0, position, numBytes;
+
+    if(self->interface->UART_DMA_GetReceiveRemaining != NULL)
+    {
+        remaining = (self->interface->UART_DMA_GetReceiveRemaining)();
+    }
+
+    if(remaining == 0 || remaining > self->dmaArraySize)
+        position = 0;
+    else
+        position = self->dmaArraySize - remaining;
+
+    if(position == self->readPosition)
+        return;
+
+    if(position > self->readPosition)
+    {
+        numBytes = position - self->readPosition;
+        Buffer_WriteBytes(self->rxBuffer, &self->dmaArray[self->readPosition],
+            numBytes);
+    }
+    else
+    {
+        /* It wrapped around. Copy up to the end then from the beginning */
+        numBytes = self->dmaArraySize - self->readPosition;
+        Buffer_WriteBytes(self->rxBuffer, &self->dmaArray[self->readPosition],
+            numBytes);
+        Buffer_WriteBytes(self->rxBuffer, self->dmaArray, position);
+        numBytes += position;
+    }
+    self->readPosition = position;
+
+    if(self->ReceivedDataCallback)
+        self->ReceivedDataCallback(numBytes);
+}
+
+/*
+ End of File
+ */
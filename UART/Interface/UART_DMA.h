@@ -0,0 +1,228 @@
+/***************************************************************************//**
+ * @brief UART DMA Header
+ * 
+ * @file UART_DMA.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      Moves UART data with the DMA controller instead of one interrupt for
+ * every byte. This goes along side your regular UART. Set up the baud rate and
+ * everything else with UART_Init like normal, then let this take over moving
+ * the data.
+ * 
+ * For receive, the DMA writes into an array of yours over and over in
+ * circular mode. The DMA half transfer and transfer complete interrupts, and
+ * the UART idle line interrupt all call UART_DMA_InterruptHandler. Every time
+ * it is called, it looks at how far the DMA has gotten since the last time
+ * and copies that whole span into a Buffer of yours, then calls the received
+ * data callback to tell you how many bytes came in. The idle line interrupt
+ * means you get the end of a message as soon as the line goes quiet, instead
+ * of waiting for the array to fill up. The half and full interrupts make sure
+ * we look at least twice each time around the array, so the DMA can't lap us.
+ * 
+ * For transmit, the DMA sends straight out of your array. Don't change it
+ * until the transmit finished callback is called.
+ * 
+ * The register stuff is kept in a small function table, UARTDMAInterface, so
+ * that this file doesn't care which processor it's on. Each implementation
+ * (UART1_DMA_STM32G0.c, UART1_DMA_STM32F1.c, or the simulated one for testing
+ * on a PC) fills in the table.
+ * 
+ * @section example_code Example Code
+ *      UARTDMA myDMA;
+ *      Buffer rxBuffer;
+ *      uint8_t rxArray[128], dmaArray[64];
+ *      Buffer_Init(&rxBuffer, rxArray, sizeof(rxArray));
+ *      UART_DMA_Create(&myDMA, &UART1_DMA_FunctionTable);
+ *      UART_DMA_SetReceivedDataCallback(&myDMA, MyReceiveFunction);
+ *      UART_DMA_StartReceive(&myDMA, dmaArray, sizeof(dmaArray), &rxBuffer);
+ * 
+ *      // in the USART1 and both DMA channel interrupts:
+ *      UART_DMA_InterruptHandler(&myDMA);
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#ifndef UART_DMA_H
+#define UART_DMA_H
+
+// ***** Includes **************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Buffer.h"
+
+// ***** Defines ***************************************************************
+
+/* Events returned by GetAndClearEvents. Receive is any of the idle line, half
+transfer, or transfer complete flags. Transmit finished is the transfer
+complete flag of the transmit channel. */
+#define UART_DMA_EVENT_RECEIVE          0x01
+#define UART_DMA_EVENT_TX_FINISHED      0x02
+
+// ***** Global Variables ******************************************************
+
+typedef struct UARTDMAInterfaceTag
+{
+    /*  These are the functions that will be called. You will create your own
+    interface object for your class that will have these function signatures.
+    Set each of your functions equal to one of these pointers */
+    void (*UART_DMA_StartReceive)(uint8_t *, uint16_t);
+    void (*UART_DMA_StopReceive)(void);
+    uint16_t (*UART_DMA_GetReceiveRemaining)(void);
+    void (*UART_DMA_StartTransmit)(const uint8_t *, uint16_t);
+    uint8_t (*UART_DMA_GetAndClearEvents)(void);
+} UARTDMAInterface;
+
+typedef struct UARTDMATag
+{
+    UARTDMAInterface *interface;
+    Buffer *rxBuffer;
+    uint8_t *dmaArray;
+    uint16_t dmaArraySize;
+    uint16_t readPosition;
+    bool rxActive;
+    bool txBusy;
+    void (*ReceivedDataCallback)(uint16_t numBytes);
+    void (*TransmitFinishedCallback)(void);
+} UARTDMA;
+
+/**
+ * Description of struct members:
+ * 
+ * interface  The table of register functions for your processor
+ * 
+ * rxBuffer  Where the received data ends up
+ * 
+ * dmaArray  The array the DMA writes into in circular mode
+ * 
+ * readPosition  How far into dmaArray we've copied out so far
+ * 
+ * For the implementation:
+ * 
+ * StartReceive  Set up the receive channel in circular mode with the array
+ *               and size given. Turn on the half transfer, transfer complete,
+ *               and idle line interrupts. Turn on DMA receive in the UART.
+ * 
+ * StopReceive  Turn all of that back off
+ * 
+ * GetReceiveRemaining  Return the DMA's count register (CNDTR). It counts
+ *                      down from the size to 1, then reloads.
+ * 
+ * StartTransmit  Set up the transmit channel in normal mode with the transfer
+ *                complete interrupt and start it
+ * 
+ * GetAndClearEvents  Check and clear the interrupt flags. Return any of the
+ *                    UART_DMA_EVENT flags that were set.
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Function Prototypes *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Combine the object and function table
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ * 
+ * @param interface  pointer to the function table for your processor
+ */
+void UART_DMA_Create(UARTDMA *self, UARTDMAInterface *interface);
+
+/***************************************************************************//**
+ * @brief Start receiving into a Buffer using the DMA in circular mode
+ * 
+ * The DMA array doesn't need to be very big. It only needs to hold what can
+ * come in during half of the array plus however long your interrupt might
+ * take to get to it. The Buffer is where the data goes after that, and that
+ * is what you read from.
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ * 
+ * @param dmaArray  the array for the DMA to write to
+ * 
+ * @param size  size of the array
+ * 
+ * @param rxBuffer  the Buffer to put the data in
+ */
+void UART_DMA_StartReceive(UARTDMA *self, uint8_t *dmaArray, uint16_t size, Buffer *rxBuffer);
+
+/***************************************************************************//**
+ * @brief Stop receiving
+ * 
+ * Anything the DMA already has is copied to the Buffer first.
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ */
+void UART_DMA_StopReceive(UARTDMA *self);
+
+/***************************************************************************//**
+ * @brief Start sending an array using the DMA
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ * 
+ * @param data  pointer to the data. Don't change it until you get the
+ *              transmit finished callback.
+ * 
+ * @param size  number of bytes to send
+ * 
+ * @return true if it started, false if a transmit is already going
+ */
+bool UART_DMA_Transmit(UARTDMA *self, const uint8_t *data, uint16_t size);
+
+/***************************************************************************//**
+ * @brief Check if a transmit is still going
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ * 
+ * @return true if busy
+ */
+bool UART_DMA_IsTransmitBusy(UARTDMA *self);
+
+/***************************************************************************//**
+ * @brief Handle the receive and transmit events
+ * 
+ * Call this from the UART interrupt and from the interrupts for both DMA
+ * channels. It asks the implementation which flags were set, copies any new
+ * data into the Buffer, and calls the callbacks.
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ */
+void UART_DMA_InterruptHandler(UARTDMA *self);
+
+/***************************************************************************//**
+ * @brief Set a function to be called when new data has been put in the Buffer
+ * 
+ * This is called from the interrupt.
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ * 
+ * @param Function  format: void SomeFunction(uint16_t numBytes)
+ */
+void UART_DMA_SetReceivedDataCallback(UARTDMA *self, void (*Function)(uint16_t numBytes));
+
+/***************************************************************************//**
+ * @brief Set a function to be called when a transmit is finished
+ * 
+ * This is called from the interrupt once the DMA has handed the last byte to
+ * the UART. You can start another transmit from here.
+ * 
+ * @param self  pointer to the UARTDMA you are using
+ * 
+ * @param Function  format: void SomeFunction(void)
+ */
+void UART_DMA_SetTransmitFinishedCallback(UARTDMA *self, void (*Function)(void));
+
+#endif  /* UART_DMA_H */
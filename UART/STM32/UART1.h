@@ -10,6 +10,8 @@
  * @date 3/5/22    Changed to use function table and match new interface
  * @date 6/12/22   Changed compute baud rate function
  * @date 7/31/22   Added handler for pending transmit interrupt
+ * @date 10/18/26  Added block transmit and receive functions
+ * @date 10/18/26  Added actual baud rate and auto baud
  * 
  * @details
  *      A header for a UART peripheral that implements the IUART interface. 
@@ -97,4 +99,27 @@ void UART1_SetIsCTSPinLowFunc(bool (*Function)(void));
 
 void UART1_SetRTSPinFunc(void (*Function)(bool setPinHigh));
 
+/* These are optional. So far only the G0 has them. If your implementation
+doesn't, leave them out of the function table. */
+
+bool UART1_TransmitBuffer(const uint8_t *data, uint16_t size);
+
+bool UART1_ReceiveBuffer(uint8_t *dst, uint16_t max);
+
+uint16_t UART1_ReceiveBufferStop(void);
+
+void UART1_SetTransmitBufferFinishedCallback(void (*Function)(void));
+
+void UART1_SetReceiveBufferFinishedCallback(void (*Function)(uint16_t numBytes));
+
+/* The G0 and F1 have this one */
+
+uint32_t UART1_ComputeActualBaudRate(uint32_t BRGValue, uint32_t pclkInHz);
+
+/* The F1 doesn't have auto baud, only the G0 */
+
+bool UART1_AutoBaudStart(void);
+
+UARTAutoBaudStatus UART1_GetAutoBaudStatus(uint32_t *retBRGValue);
+
 #endif  /* UART1_H */
@@ -0,0 +1,62 @@
+/***************************************************************************//**
+ * @brief UART1 DMA Implementation Header (Non-Processor Specific)
+ * 
+ * @file UART1_DMA.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      A header for the register side of the UART DMA library (UART_DMA.h) for
+ * UART1. The function table UART1_DMA_FunctionTable is declared and defined
+ * in the .c file for your processor. Give it to UART_DMA_Create.
+ * 
+ * Set up UART1 with UART_Init first, like normal. These functions only take
+ * care of the DMA and the interrupts that go with it.
+ * 
+ * @see UART_DMA.h for a description of what each function should do.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef UART1_DMA_H
+#define UART1_DMA_H
+
+#include "UART_DMA.h"
+
+// ***** Defines ***************************************************************
+
+
+// ***** Global Variables ******************************************************
+
+/* Declare and define this variable in your implementation's .c file */
+extern UARTDMAInterface UART1_DMA_FunctionTable;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/* See UART_DMA.h for a description of what each function should do. */
+
+void UART1_DMA_StartReceive(uint8_t *dmaArray, uint16_t size);
+
+void UART1_DMA_StopReceive(void);
+
+uint16_t UART1_DMA_GetReceiveRemaining(void);
+
+void UART1_DMA_StartTransmit(const uint8_t *data, uint16_t size);
+
+uint8_t UART1_DMA_GetAndClearEvents(void);
+
+#endif  /* UART1_DMA_H */
@@ -0,0 +1,176 @@
+/***************************************************************************//**
+ * @brief UART1 DMA Implementation (STM32F1)
+ * 
+ * @file UART1_DMA_STM32F1.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      The register side of the UART DMA library for USART1 on the STM32F1.
+ * On the F1 the channels are fixed. USART1 receive is DMA1 channel 5 and 
+ * transmit is DMA1 channel 4.
+ * 
+ * UART_DMA_InterruptHandler needs to be called from the USART1 interrupt (for
+ * the idle line), the DMA1_Channel5 interrupt, and the DMA1_Channel4 
+ * interrupt. Turn those on in the NVIC yourself.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#include "UART1_DMA.h"
+
+/* Include processor specific header files here */
+#include "stm32f10x_map.h"
+
+// ***** Defines ***************************************************************
+
+/* Peripheral addresses and registers */
+#define UART_ADDR       USART1
+#define DMA_ADDR        DMA1
+#define DMA_CLK_REG     RCC->AHBENR
+#define DMA_CLK_EN_MSK  RCC_AHBENR_DMA1EN
+
+/* Receive channel */
+#define RX_CHANNEL      DMA1_Channel5
+#define RX_FLAGS        (DMA_ISR_HTIF5 | DMA_ISR_TCIF5)
+#define RX_CLEAR        (DMA_IFCR_CGIF5)
+
+/* Transmit channel */
+#define TX_CHANNEL      DMA1_Channel4
+#define TX_FLAGS        (DMA_ISR_TCIF4)
+#define TX_CLEAR        (DMA_IFCR_CGIF4)
+
+// ***** Global Variables ******************************************************
+
+/* Assign functions to the interface */
+UARTDMAInterface UART1_DMA_FunctionTable = {
+    .UART_DMA_StartReceive = UART1_DMA_StartReceive,
+    .UART_DMA_StopReceive = UART1_DMA_StopReceive,
+    .UART_DMA_GetReceiveRemaining = UART1_DMA_GetReceiveRemaining,
+    .UART_DMA_StartTransmit = UART1_DMA_StartTransmit,
+    .UART_DMA_GetAndClearEvents = UART1_DMA_GetAndClearEvents,
+};
+
+// ***** Static Function Prototypes ********************************************
+
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void UART1_DMA_StartReceive(uint8_t *dmaArray, uint16_t size)
+{
+    volatile uint32_t throwAway;
+
+    DMA_CLK_REG |= DMA_CLK_EN_MSK;
+
+    /* The channel has to be off to change anything */
+    RX_CHANNEL->CCR &= ~DMA_CCR_EN;
+
+    RX_CHANNEL->CPAR = (uint32_t)&UART_ADDR->DR;
+    RX_CHANNEL->CMAR = (uint32_t)dmaArray;
+    RX_CHANNEL->CNDTR = size;
+
+    /* Peripheral to memory, 8-bit both sides, increment memory, circular, 
+    half and full transfer interrupts */
+    RX_CHANNEL->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE;
+    DMA_ADDR->IFCR = RX_CLEAR;
+    RX_CHANNEL->CCR |= DMA_CCR_EN;
+
+    /* The idle flag is cleared by reading SR then DR. Do it now or we'll get
+    one right away */
+    throwAway = UART_ADDR->SR;
+    throwAway = UART_ADDR->DR;
+    (void)throwAway;
+    UART_ADDR->CR1 |= USART_CR1_IDLEIE;
+    UART_ADDR->CR3 |= USART_CR3_DMAR;
+}
+
+// *****************************************************************************
+
+void UART1_DMA_StopReceive(void)
+{
+    UART_ADDR->CR3 &= ~USART_CR3_DMAR;
+    UART_ADDR->CR1 &= ~USART_CR1_IDLEIE;
+    RX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    DMA_ADDR->IFCR = RX_CLEAR;
+}
+
+// *****************************************************************************
+
+uint16_t UART1_DMA_GetReceiveRemaining(void)
+{
+    return (uint16_t)RX_CHANNEL->CNDTR;
+}
+
+// *****************************************************************************
+
+void UART1_DMA_StartTransmit(const uint8_t *data, uint16_t size)
+{
+    DMA_CLK_REG |= DMA_CLK_EN_MSK;
+
+    TX_CHANNEL->CCR &= ~DMA_CCR_EN;
+
+    TX_CHANNEL->CPAR = (uint32_t)&UART_ADDR->DR;
+    TX_CHANNEL->CMAR = (uint32_t)data;
+    TX_CHANNEL->CNDTR = size;
+
+    /* Memory to peripheral, 8-bit both sides, increment memory, transfer
+    complete interrupt */
+    TX_CHANNEL->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_TCIE;
+    DMA_ADDR->IFCR = TX_CLEAR;
+
+    UART_ADDR->SR &= ~USART_SR_TC;
+    UART_ADDR->CR3 |= USART_CR3_DMAT;
+    TX_CHANNEL->CCR |= DMA_CCR_EN;
+}
+
+// *****************************************************************************
+
+uint8_t UART1_DMA_GetAndClearEvents(void)
+{
+    uint8_t events = 0;
+    volatile uint32_t throwAway;
+
+    /* Reading DR to clear the idle flag is safe here. The DMA has already 
+    taken the last byte, or RXNE would be set and the line wouldn't be idle */
+    if((UART_ADDR->CR1 & USART_CR1_IDLEIE) && (UART_ADDR->SR & USART_SR_IDLE))
+    {
+        throwAway = UART_ADDR->DR;
+        (void)throwAway;
+        events |= UART_DMA_EVENT_RECEIVE;
+    }
+
+    if(DMA_ADDR->ISR & RX_FLAGS)
+    {
+        DMA_ADDR->IFCR = RX_CLEAR;
+        events |= UART_DMA_EVENT_RECEIVE;
+    }
+
+    if(DMA_ADDR->ISR & TX_FLAGS)
+    {
+        /* Normal mode stops by itself, but the channel has to be turned off
+        before it can be loaded again */
+        DMA_ADDR->IFCR = TX_CLEAR;
+        TX_CHANNEL->CCR &= ~DMA_CCR_EN;
+        UART_ADDR->CR3 &= ~USART_CR3_DMAT;
+        events |= UART_DMA_EVENT_TX_FINISHED;
+    }
+
+    return events;
+}
+
+/*
+ End of File
+ */
@@ -0,0 +1,174 @@
+/***************************************************************************//**
+ * @brief UART1 DMA Implementation (STM32G0)
+ * 
+ * @file UART1_DMA_STM32G0.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      The register side of the UART DMA library for USART1 on the STM32G0.
+ * DMA1 channel 1 is used for receive and channel 2 for transmit. The G0 lets 
+ * any channel go with any peripheral through the DMAMUX, so if you want to 
+ * use different channels, change the defines at the top.
+ * 
+ * UART_DMA_InterruptHandler needs to be called from the USART1 interrupt (for
+ * the idle line), the DMA1_Channel1 interrupt, and the DMA1_Channel2_3 
+ * interrupt. Turn those on in the NVIC yourself.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#include "UART1_DMA.h"
+
+/* Include processor specific header files here */
+#include "stm32g071xx.h"
+
+// ***** Defines ***************************************************************
+
+/* Peripheral addresses and registers */
+#define UART_ADDR       USART1
+#define DMA_ADDR        DMA1
+#define DMA_CLK_REG     RCC->AHBENR
+#define DMA_CLK_EN_MSK  RCC_AHBENR_DMAEN
+
+/* Receive channel */
+#define RX_CHANNEL      DMA1_Channel1
+#define RX_MUX          DMAMUX1_Channel0 // DMAMUX channel = DMA channel - 1
+#define RX_REQUEST      50               // USART1_RX. Ref man table 59
+#define RX_FLAGS        (DMA_ISR_HTIF1 | DMA_ISR_TCIF1)
+#define RX_CLEAR        (DMA_IFCR_CGIF1)
+
+/* Transmit channel */
+#define TX_CHANNEL      DMA1_Channel2
+#define TX_MUX          DMAMUX1_Channel1
+#define TX_REQUEST      51               // USART1_TX
+#define TX_FLAGS        (DMA_ISR_TCIF2)
+#define TX_CLEAR        (DMA_IFCR_CGIF2)
+
+// ***** Global Variables ******************************************************
+
+/* Assign functions to the interface */
+UARTDMAInterface UART1_DMA_FunctionTable = {
+    .UART_DMA_StartReceive = UART1_DMA_StartReceive,
+    .UART_DMA_StopReceive = UART1_DMA_StopReceive,
+    .UART_DMA_GetReceiveRemaining = UART1_DMA_GetReceiveRemaining,
+    .UART_DMA_StartTransmit = UART1_DMA_StartTransmit,
+    .UART_DMA_GetAndClearEvents = UART1_DMA_GetAndClearEvents,
+};
+
+// ***** Static Function Prototypes ********************************************
+
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+void UART1_DMA_StartReceive(uint8_t *dmaArray, uint16_t size)
+{
+    DMA_CLK_REG |= DMA_CLK_EN_MSK;
+
+    /* The channel has to be off to change anything */
+    RX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    RX_MUX->CCR = RX_REQUEST;
+
+    RX_CHANNEL->CPAR = (uint32_t)&UART_ADDR->RDR;
+    RX_CHANNEL->CMAR = (uint32_t)dmaArray;
+    RX_CHANNEL->CNDTR = size;
+
+    /* Peripheral to memory, 8-bit both sides, increment memory, circular, 
+    half and full transfer interrupts */
+    RX_CHANNEL->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE;
+    DMA_ADDR->IFCR = RX_CLEAR;
+    RX_CHANNEL->CCR |= DMA_CCR_EN;
+
+    /* Clear the idle flag first or we'll get one right away */
+    UART_ADDR->ICR = USART_ICR_IDLECF;
+    UART_ADDR->CR1 |= USART_CR1_IDLEIE;
+    UART_ADDR->CR3 |= USART_CR3_DMAR;
+}
+
+// *****************************************************************************
+
+void UART1_DMA_StopReceive(void)
+{
+    UART_ADDR->CR3 &= ~USART_CR3_DMAR;
+    UART_ADDR->CR1 &= ~USART_CR1_IDLEIE;
+    RX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    DMA_ADDR->IFCR = RX_CLEAR;
+}
+
+// *****************************************************************************
+
+uint16_t UART1_DMA_GetReceiveRemaining(void)
+{
+    return (uint16_t)RX_CHANNEL->CNDTR;
+}
+
+// *****************************************************************************
+
+void UART1_DMA_StartTransmit(const uint8_t *data, uint16_t size)
+{
+    DMA_CLK_REG |= DMA_CLK_EN_MSK;
+
+    TX_CHANNEL->CCR &= ~DMA_CCR_EN;
+    TX_MUX->CCR = TX_REQUEST;
+
+    TX_CHANNEL->CPAR = (uint32_t)&UART_ADDR->TDR;
+    TX_CHANNEL->CMAR = (uint32_t)data;
+    TX_CHANNEL->CNDTR = size;
+
+    /* Memory to peripheral, 8-bit both sides, increment memory, transfer
+    complete interrupt */
+    TX_CHANNEL->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_TCIE;
+    DMA_ADDR->IFCR = TX_CLEAR;
+
+    UART_ADDR->ICR = USART_ICR_TCCF;
+    UART_ADDR->CR3 |= USART_CR3_DMAT;
+    TX_CHANNEL->CCR |= DMA_CCR_EN;
+}
+
+// *****************************************************************************
+
+uint8_t UART1_DMA_GetAndClearEvents(void)
+{
+    uint8_t events = 0;
+
+    if((UART_ADDR->CR1 & USART_CR1_IDLEIE) && (UART_ADDR->ISR & USART_ISR_IDLE))
+    {
+        UART_ADDR->ICR = USART_ICR_IDLECF;
+        events |= UART_DMA_EVENT_RECEIVE;
+    }
+
+    if(DMA_ADDR->ISR & RX_FLAGS)
+    {
+        DMA_ADDR->IFCR = RX_CLEAR;
+        events |= UART_DMA_EVENT_RECEIVE;
+    }
+
+    if(DMA_ADDR->ISR & TX_FLAGS)
+    {
+        /* Normal mode stops by itself, but the channel has to be turned off
+        before it can be loaded again */
+        DMA_ADDR->IFCR = TX_CLEAR;
+        TX_CHANNEL->CCR &= ~DMA_CCR_EN;
+        UART_ADDR->CR3 &= ~USART_CR3_DMAT;
+        events |= UART_DMA_EVENT_TX_FINISHED;
+    }
+
+    return events;
+}
+
+/*
+ End of File
+ */
@@ -9,10 +9,49 @@
  * @date 6/13/22   Changed compute baud rate function
  * @date 6/25/22   Updated receive callback function
  * @date 7/31/22   Added checks and handler for recursive function calls
+ * @date 10/18/26  Added block transmit and receive using the FIFO
+ * @date 10/18/26  Compute baud rate picks the prescaler now. Added auto baud
  * 
  * @details
  *      // TODO Add details, 9-bit, parity, software flow control
  * 
+ * The FIFO is turned on during init. For the one byte at a time functions it
+ * doesn't change much, except that the Tx register "empty" flag now means the
+ * FIFO isn't full. The block functions TransmitBuffer and ReceiveBuffer use 
+ * it to move up to 8 bytes every interrupt. For transmit, the FIFO threshold 
+ * interrupt (TXFTIE) is used so that we only get interrupted when the FIFO is
+ * half empty, then we fill it back up. For receive, every byte waiting in the
+ * FIFO is read out on each interrupt. For either one to work, the 
+ * TransmitRegisterEmptyEvent and ReceivedDataEvent functions must be called 
+ * from the USART1 interrupt. Be careful with the transmit side. During a
+ * block transmit TXFNFIE is off and only TXFTIE is on, so your interrupt has
+ * to call TransmitRegisterEmptyEvent when USART_ISR_TXFT is set, not only
+ * when USART_ISR_TXE_TXFNF is set. Otherwise the transmit stops after the
+ * first FIFO full. Something like this:
+ * 
+ *      void USART1_IRQHandler(void)
+ *      {
+ *          uint32_t isr = USART1->ISR, cr1 = USART1->CR1;
+ * 
+ *          if((cr1 & USART_CR1_RXNEIE_RXFNEIE) && (isr & USART_ISR_RXNE_RXFNE))
+ *              UART_ReceivedDataEvent(&myUART);
+ * 
+ *          if(((cr1 & USART_CR1_TXEIE_TXFNFIE) && (isr & USART_ISR_TXE_TXFNF)) ||
+ *              ((USART1->CR3 & USART_CR3_TXFTIE) && (isr & USART_ISR_TXFT)))
+ *              UART_TransmitRegisterEmptyEvent(&myUART);
+ *      }
+ * 
+ * ComputeBRGValue tries every prescaler and keeps the one that gets closest
+ * to the baud rate you want. The prescaler goes in the upper bits of the BRG
+ * value (BRG_PRESC_Pos) and Init puts it in the PRESC register, so you don't 
+ * have to pick one yourself anymore. 
+ * 
+ * AutoBaudStart uses the UART's own auto baud rate detection. Init has to be
+ * called first with some BRG value to turn the UART on. Which character it 
+ * looks for is AUTO_BAUD_MODE at the top. 0x55 ('U') is the best one, since 
+ * it measures the whole character instead of one or two bits. The character
+ * used for it may show up as received data. Ignore it.
+ * 
  * Example Code:
  *      UART myUART;
  *      UART_Create(&myUART, &UART1_FunctionTable);
@@ -39,31 +78,33 @@
 
 // ***** Defines ***************************************************************
 
-enum {
-    UART1_PRE_NO_DIV = 0,
-    UART1_PRE_DIV_2,
-    UART1_PRE_DIV_4,
-    UART1_PRE_DIV_6,
-    UART1_PRE_DIV_8,
-    UART1_PRE_DIV_10,
-    UART1_PRE_DIV_12,
-    UART1_PRE_DIV_16,
-    UART1_PRE_DIV_32,
-    UART1_PRE_DIV_64,
-    UART1_PRE_DIV_128,
-    UART1_PRE_DIV_256};
-
 // ----- User selectable values ------------------------------------------------
-#define UART_PRESCALE UART1_PRE_NO_DIV // choose from the enum
+#ifndef OVER8
 #define OVER8         0                // 0 = oversample 16, 1 = oversample 8
+#endif
+#define TX_FIFO_THRESHOLD 2            // TXFTCFG, 2 = interrupt at half full
+#define AUTO_BAUD_MODE 3               // ABRMOD, 0 = start bit, 1 = falling
+                                       // edges, 2 = 0x7F, 3 = 0x55
 // -----------------------------------------------------------------------------
 
+/* The prescaler is kept above the BRR in the BRG value */
+#define BRG_PRESC_Pos       16
+#define BRG_BRR_MASK        0xFFFF
+
+/* USARTDIV counts clocks, or half clocks with OVER8. Either way it has to be
+at least 16, so with OVER8 each bit is at least 8 clocks. With OVER8 the BRR
+doesn't have room for USARTDIV[0], so it can only be even. */
+#define UART_DIV_PER_CLOCK  (OVER8 ? 2 : 1)
+#define MIN_UART_DIV        16
+#define MAX_UART_DIV        0xFFFF
+
 /* Peripheral addresses and registers */
 #define UART_ADDR       USART1
 #define UART_CLK_REG    RCC->APBENR2
 #define UART_CLK_EN_MSK RCC_APBENR2_USART1EN
 
-static const uint8_t preLUT[16] = {0,2,4,6,8,10,12,16,32,64,128,256};
+/* What each PRESC value divides by. This has to be uint16_t for the 256. */
+static const uint16_t preLUT[12] = {1,2,4,6,8,10,12,16,32,64,128,256};
 
 // ***** Global Variables ******************************************************
 
@@ -89,6 +130,14 @@ UARTInterface UART1_FunctionTable = {
     .UART_SetReceivedDataCallback = UART1_SetReceivedDataCallback,
     .UART_SetIsCTSPinLowFunc = UART1_SetIsCTSPinLowFunc,
     .UART_SetRTSPinFunc = UART1_SetRTSPinFunc,
+    .UART_TransmitBuffer = UART1_TransmitBuffer,
+    .UART_ReceiveBuffer = UART1_ReceiveBuffer,
+    .UART_ReceiveBufferStop = UART1_ReceiveBufferStop,
+    .UART_SetTransmitBufferFinishedCallback = UART1_SetTransmitBufferFinishedCallback,
+    .UART_SetReceiveBufferFinishedCallback = UART1_SetReceiveBufferFinishedCallback,
+    .UART_ComputeActualBaudRate = UART1_ComputeActualBaudRate,
+    .UART_AutoBaudStart = UART1_AutoBaudStart,
+    .UART_GetAutoBaudStatus = UART1_GetAutoBaudStatus,
 };
 
 static bool use9Bit = false, useRxInterrupt = false, useTxInterrupt = false;
@@ -98,15 +147,26 @@ static UARTParity parity = UART_NO_PARITY;
 static bool lockTxFinishedEvent = false, txFinishedEventPending = false,
     lockRxReceivedEvent = false;
 
+// block transmit and receive
+static const uint8_t *txBuffer;
+static uint8_t *rxBuffer;
+static uint16_t txBufferSize, txBufferCount, rxBufferMax, rxBufferCount;
+static bool txBufferActive = false, txBufferWaitingOnCTS = false, 
+    rxBufferActive = false;
+
 // local function pointers
 static void (*TransmitRegisterEmptyCallback)(void);
 static void (*ReceivedDataCallback)(uint8_t (*CallToGetData)(void));
 static bool (*IsCTSPinLow)(void);
 static void (*SetRTSPin)(bool setHigh);
+static void (*TransmitBufferFinishedCallback)(void);
+static void (*ReceiveBufferFinishedCallback)(uint16_t numBytes);
 
 // ***** Static Function Prototypes ********************************************
 
-/* Put static function prototypes here */
+static void TransmitBufferRefill(void);
+static void ReceiveBufferDrain(void);
+static uint32_t ErrorInPPM(uint32_t clk, uint32_t divisor, uint32_t desiredBaudRate);
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -117,24 +177,80 @@ static void (*SetRTSPin)(bool setHigh);
 
 uint32_t UART1_ComputeBRGValue(uint32_t desiredBaudRate, uint32_t pclkInHz)
 {
+    uint32_t BRGValue = 0, leastError = UINT32_MAX;
+
     if(desiredBaudRate == 0)
         return 0;
 
-    uint32_t uartDiv;
-
-    if(OVER8) 
+    /* The old way was to pick the prescaler yourself and then cut off the
+    fraction of the clock divided by the baud rate. Cutting it off instead of
+    rounding can be almost a whole clock off, and at high baud rates there 
+    aren't many clocks in a bit. So now we round, and try every prescaler. 
+    Without the prescaler the BRR has the most resolution, so it usually 
+    wins. The bigger ones are for when the baud rate is so slow the BRR won't 
+    fit in 16 bits. On a tie, the smaller prescaler wins. 
+    
+    With OVER8, USARTDIV is 2 * clk / baud, but BRR[2:0] only holds 
+    USARTDIV[3:1]. The ref man example rounds 2 * clk / baud and lets the 
+    register drop bit 0, which really cuts off half a clock. So we round to 
+    the nearest whole clock and then double it, which is the nearest USARTDIV
+    the register can hold. */
+    for(uint8_t i = 0; i < sizeof(preLUT) / sizeof(preLUT[0]); i++)
     {
-        uartDiv = (uint32_t)(2 * pclkInHz / preLUT[UART_PRESCALE]) / desiredBaudRate;
-        // BRR[2:0] = lower 4 bits shifted one to the right. Ref man page 1018
-        uint32_t BRRLowerByte = (uartDiv & 0x000F) >> 1;
-        uartDiv &= 0xFFF0;
-        uartDiv |= BRRLowerByte;
+        uint64_t divisor = (uint64_t)desiredBaudRate * preLUT[i];
+        uint64_t uartDiv = ((pclkInHz + divisor / 2) / divisor) * UART_DIV_PER_CLOCK;
+        uint32_t error, BRR;
+
+        if(uartDiv < MIN_UART_DIV || uartDiv > MAX_UART_DIV)
+            continue;
+
+        error = ErrorInPPM(pclkInHz, (uint32_t)uartDiv * preLUT[i], desiredBaudRate);
+        if(error >= leastError)
+            continue;
+
+        if(OVER8)
+        {
+            /* BRR[2:0] = USARTDIV[3:0] shifted one to the right. BRR[3] 
+            stays clear. Bit 0 is always 0 here, so nothing is lost. Ref man
+            page 1018 */
+            BRR = (uint32_t)((uartDiv & 0xFFF0) | ((uartDiv & 0x000F) >> 1));
+        }
+        else
+        {
+            BRR = (uint32_t)uartDiv;
+        }
+
+        leastError = error;
+        BRGValue = ((uint32_t)i << BRG_PRESC_Pos) | BRR;
+
+        if(error == 0)
+            break;
     }
+    return BRGValue;
+}
+
+// *****************************************************************************
+
+uint32_t UART1_ComputeActualBaudRate(uint32_t BRGValue, uint32_t pclkInHz)
+{
+    uint32_t presc = BRGValue >> BRG_PRESC_Pos;
+    uint32_t BRR = BRGValue & BRG_BRR_MASK;
+    uint32_t divisor;
+
+    if(presc >= sizeof(preLUT) / sizeof(preLUT[0]))
+        return 0;
+
+    /* Back to USARTDIV, which is in half clocks with OVER8 */
+    if(OVER8)
+        divisor = (BRR & 0xFFF0) | ((BRR & 0x0007) << 1);
     else
-    {
-        uartDiv = (uint32_t)(pclkInHz / preLUT[UART_PRESCALE]) / desiredBaudRate;
-    }
-    return uartDiv;
+        divisor = BRR;
+
+    divisor *= preLUT[presc];
+    if(divisor == 0)
+        return 0;
+
+    return (uint32_t)(((uint64_t)pclkInHz * UART_DIV_PER_CLOCK + divisor / 2) / divisor);
 }
 
 // *****************************************************************************
@@ -159,6 +275,11 @@ void UART1_Init(UARTInitType *params)
 
     /* Turn off tx/rx interrupts and other bits that I'm going to adjust */
     UART_ADDR->CR1 &= ~(USART_CR1_RXNEIE_RXFNEIE | USART_CR1_TXEIE_TXFNFIE | USART_CR1_M | USART_CR1_M0 | USART_CR1_PCE);
+    UART_ADDR->CR3 &= ~(USART_CR3_TXFTIE | USART_CR3_TXFTCFG);
+
+    /* Use the FIFO. It can only be turned on while the UART is off */
+    UART_ADDR->CR1 |= USART_CR1_FIFOEN;
+    UART_ADDR->CR3 |= (TX_FIFO_THRESHOLD << USART_CR3_TXFTCFG_Pos);
 
     /* Set number of data bits, stop bits, and parity */
     if(use9Bit)
@@ -203,14 +324,18 @@ void UART1_Init(UARTInitType *params)
         UART_ADDR->CR3 &= ~(USART_CR3_CTSE | USART_CR3_RTSE);
     }
 
-    /* Set prescale and baud rate. Use the defines at the top */
+    /* Set prescale and baud rate. The prescaler is in the upper bits of the
+    BRG value. See ComputeBRGValue. */
     UART_ADDR->PRESC &= ~USART_PRESC_PRESCALER;
-    UART_ADDR->PRESC |= UART_PRESCALE;
+    UART_ADDR->PRESC |= (params->BRGValue >> BRG_PRESC_Pos) & USART_PRESC_PRESCALER;
+
+    /* A BRG value given to us means we aren't looking for one anymore */
+    UART_ADDR->CR2 &= ~(USART_CR2_ABREN | USART_CR2_ABRMODE);
 
     UART_ADDR->CR1 &= ~USART_CR1_OVER8;
     if(OVER8) UART_ADDR->CR1 |= USART_CR1_OVER8;
 
-    UART_ADDR->BRR = (uint16_t)(params->BRGValue);
+    UART_ADDR->BRR = params->BRGValue & BRG_BRR_MASK;
 
     /* If you turn on the transmit interrupt during initialization, it could
     fire off repeatedly. It's best to turn it on after placing data in the 
@@ -228,6 +353,25 @@ void UART1_Init(UARTInitType *params)
 
 void UART1_ReceivedDataEvent(void)
 {
+    if(rxBufferActive)
+    {
+        ReceiveBufferDrain();
+        if(rxBufferCount >= rxBufferMax)
+        {
+            rxBufferActive = false;
+            if(!useRxInterrupt)
+                UART_ADDR->CR1 &= ~USART_CR1_RXNEIE_RXFNEIE;
+
+            /* Not ready for more until somebody gives us another buffer */
+            if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+                SetRTSPin(true);
+
+            if(ReceiveBufferFinishedCallback)
+                ReceiveBufferFinishedCallback(rxBufferCount);
+        }
+        return;
+    }
+
     if(lockRxReceivedEvent == true)
     {
         /* Prevent the possibility of another interrupt from somehow calling us 
@@ -254,7 +398,7 @@ void UART1_ReceivedDataEvent(void)
 
 uint8_t UART1_GetReceivedByte(void)
 {
-    uint8_t data = UART_ADDR->TDR;
+    uint8_t data = UART_ADDR->RDR;
 
     /* RTS is asserted (low) whenever we are ready to receive data. It is 
     deasserted (high) when the receive register is full */
@@ -328,6 +472,24 @@ void UART1_ReceiveDisable(void)
 
 void UART1_TransmitRegisterEmptyEvent(void)
 {
+    /* The callback is called from here instead of the refill, so it always 
+    happens in the interrupt, even if the whole thing fit in the FIFO. */
+    if(txBufferActive)
+    {
+        if(txBufferCount < txBufferSize)
+        {
+            TransmitBufferRefill();
+        }
+        else
+        {
+            UART_ADDR->CR3 &= ~USART_CR3_TXFTIE;
+            txBufferActive = false;
+            if(TransmitBufferFinishedCallback)
+                TransmitBufferFinishedCallback();
+        }
+        return;
+    }
+
     /* This will prevent recursive calls if we call transmit byte function from
     within the transmit interrupt callback. This requires the pending event
     handler function to be called to catch the txFinishedEventPending flag. */
@@ -448,6 +610,14 @@ void UART1_TransmitDisable(void)
 
 void UART1_PendingEventHandler(void)
 {
+    /* The transmit interrupt is off while we wait, so nothing can get in the
+    way of this */
+    if(txBufferWaitingOnCTS && (IsCTSPinLow == NULL || IsCTSPinLow()))
+    {
+        txBufferWaitingOnCTS = false;
+        TransmitBufferRefill();
+    }
+
     if(txFinishedEventPending && !lockTxFinishedEvent)
     {
         txFinishedEventPending = false;
@@ -483,6 +653,185 @@ void UART1_SetRTSPinFunc(void (*Function)(bool setPinHigh))
     SetRTSPin = Function;
 }
 
+// *****************************************************************************
+
+bool UART1_TransmitBuffer(const uint8_t *data, uint16_t size)
+{
+    if(txBufferActive || size == 0)
+        return false;
+
+    txBuffer = data;
+    txBufferSize = size;
+    txBufferCount = 0;
+    txBufferActive = true;
+
+    /* Clear the transmission complete flag, then fill up the FIFO. The 
+    threshold interrupt will take it from here. */
+    UART_ADDR->ICR |= USART_ICR_TCCF;
+    TransmitBufferRefill();
+    return true;
+}
+
+// *****************************************************************************
+
+bool UART1_ReceiveBuffer(uint8_t *dst, uint16_t max)
+{
+    if(rxBufferActive || max == 0)
+        return false;
+
+    rxBuffer = dst;
+    rxBufferMax = max;
+    rxBufferCount = 0;
+    rxBufferActive = true;
+
+    /* Ready to receive. The RTS pin only changes once per block */
+    if(flowControl == UART_FLOW_CALLBACKS && SetRTSPin != NULL)
+        SetRTSPin(false);
+
+    UART_ADDR->CR1 |= USART_CR1_RXNEIE_RXFNEIE;
+    return true;
+}
+
+// *****************************************************************************
+
+uint16_t UART1_ReceiveBufferStop(void)
+{
+    if(!rxBufferActive)
+        return 0;
+
+    /* Turn off the interrupt first so it can't get in the middle of this */
+    UART_ADDR->CR1 &= ~USART_CR1_RXNEIE_RXFNEIE;
+    ReceiveBufferDrain();
+    rxBufferActive = false;
+
+    if(useRxInterrupt)
+        UART_ADDR->CR1 |= USART_CR1_RXNEIE_RXFNEIE;
+
+    return rxBufferCount;
+}
+
+// *****************************************************************************
+
+void UART1_SetTransmitBufferFinishedCallback(void (*Function)(void))
+{
+    TransmitBufferFinishedCallback = Function;
+}
+
+// *****************************************************************************
+
+void UART1_SetReceiveBufferFinishedCallback(void (*Function)(uint16_t numBytes))
+{
+    ReceiveBufferFinishedCallback = Function;
+}
+
+// *****************************************************************************
+
+bool UART1_AutoBaudStart(void)
+{
+    /* ABREN and ABRMODE can only be changed while the UART is off */
+    UART_ADDR->CR1 &= ~USART_CR1_UE;
+    UART_ADDR->CR2 &= ~USART_CR2_ABRMODE;
+    UART_ADDR->CR2 |= USART_CR2_ABREN | (AUTO_BAUD_MODE << USART_CR2_ABRMODE_Pos);
+    UART_ADDR->CR1 |= USART_CR1_UE;
+
+    /* Clear the last result and get ready for the next character */
+    UART_ADDR->RQR = USART_RQR_ABRRQ;
+    return true;
+}
+
+// *****************************************************************************
+
+UARTAutoBaudStatus UART1_GetAutoBaudStatus(uint32_t *retBRGValue)
+{
+    if(!(UART_ADDR->CR2 & USART_CR2_ABREN))
+        return UART_AUTO_BAUD_IDLE;
+
+    /* ABRF gets set when it fails too, so check for the error first */
+    if(UART_ADDR->ISR & USART_ISR_ABRE)
+        return UART_AUTO_BAUD_ERROR;
+
+    if(!(UART_ADDR->ISR & USART_ISR_ABRF))
+        return UART_AUTO_BAUD_BUSY;
+
+    /* The UART wrote the BRR itself. Put it together with the prescaler the 
+    same way ComputeBRGValue does. */
+    if(retBRGValue != NULL)
+    {
+        *retBRGValue = ((UART_ADDR->PRESC & USART_PRESC_PRESCALER) << BRG_PRESC_Pos) |
+            (UART_ADDR->BRR & BRG_BRR_MASK);
+    }
+    return UART_AUTO_BAUD_DONE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Local Functions *****************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************//**
+ * @brief Put as much of the transmit buffer into the FIFO as will fit
+ * 
+ * The next refill comes from the TXFT interrupt, which the USART1 interrupt
+ * has to pass on to TransmitRegisterEmptyEvent. CTS is only checked once for
+ * the whole refill. If it's high, the interrupt
+ * is turned off and the pending event handler will start us back up.
+ */
+static void TransmitBufferRefill(void)
+{
+    if(flowControl == UART_FLOW_CALLBACKS && IsCTSPinLow != NULL &&
+        IsCTSPinLow() == false)
+    {
+        UART_ADDR->CR3 &= ~USART_CR3_TXFTIE;
+        txBufferWaitingOnCTS = true;
+        return;
+    }
+
+    while(txBufferCount < txBufferSize && (UART_ADDR->ISR & USART_ISR_TXE_TXFNF))
+    {
+        UART_ADDR->TDR = txBuffer[txBufferCount++];
+    }
+
+    UART_ADDR->CR3 |= USART_CR3_TXFTIE;
+}
+
+/***************************************************************************//**
+ * @brief Move everything waiting in the receive FIFO to the receive buffer
+ */
+static void ReceiveBufferDrain(void)
+{
+    while(rxBufferCount < rxBufferMax && (UART_ADDR->ISR & USART_ISR_RXNE_RXFNE))
+    {
+        rxBuffer[rxBufferCount++] = UART_ADDR->RDR;
+    }
+}
+
+/***************************************************************************//**
+ * @brief How far off a divisor is from the baud rate we want
+ * 
+ * The divisor is the prescaler times USARTDIV, so the actual baud rate is
+ * clk * UART_DIV_PER_CLOCK / divisor. The difference between that and the one
+ * we want, in parts per million, is 
+ * |clk * UART_DIV_PER_CLOCK - desired * divisor| / (desired * divisor) * 1000000.
+ * This is only used when setting up, so the 64-bit math is fine.
+ * 
+ * @param clk  the clock before the prescaler
+ * 
+ * @param divisor  the prescaler times USARTDIV
+ * 
+ * @param desiredBaudRate  the baud rate we want
+ * 
+ * @return uint32_t  the error in ppm, always positive
+ */
+static uint32_t ErrorInPPM(uint32_t clk, uint32_t divisor, uint32_t desiredBaudRate)
+{
+    uint64_t target = (uint64_t)desiredBaudRate * divisor;
+    uint64_t actual = (uint64_t)clk * UART_DIV_PER_CLOCK;
+    uint64_t difference = (actual > target) ? actual - target : target - actual;
+
+    return (uint32_t)((difference * 1000000 + target / 2) / target);
+}
+
 /*
  End of File
  */
\ No newline at end of file
@@ -10,6 +10,7 @@
  * @date 3/5/22    Changed to use function table and match new interface
  * @date 6/12/22   Changed compute baud rate function
  * @date 7/31/22   Added handler for pending transmit interrupt
+ * @date 10/18/26  Added actual baud rate
  * 
  * @details
  *      A header for a UART peripheral that implements the IUART interface. 
@@ -97,4 +98,9 @@ void UART2_SetIsCTSPinLowFunc(bool (*Function)(void));
 
 void UART2_SetRTSPinFunc(void (*Function)(bool setPinHigh));
 
+/* Optional. If your implementation doesn't have it, leave it out of the 
+function table. */
+
+uint32_t UART2_ComputeActualBaudRate(uint32_t BRGValue, uint32_t pclkInHz);
+
 #endif  /* UART2_H */
@@ -0,0 +1,397 @@
+/***************************************************************************//**
+ * @brief UART Driver Implementation (STM32F1, any port)
+ * 
+ * @file UART_STM32F1.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 3/12/22   Original creation (G0 implementation)
+ * @date 6/13/22   Ported settings for F1
+ * @date 6/25/22   Updated receive callback function
+ * @date 7/31/22   Added checks and handler for recursive function calls
+ * @date 10/18/26  One driver for all ports. Was UART1_STM32F1.c, 
+ *                 UART2_STM32F1.c, and UART3_STM32F1.c
+ * @date 10/18/26  Baud rate is rounded with integer math now. Added actual 
+ *                 baud rate
+ * 
+ * @details
+ *      See UART_STM32F1.h. The code is the same as the old UART1 file, but
+ * every register and variable goes through self now.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2022 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#include "UART_STM32F1.h"
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Interface Functions *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t UART_STM32F1_ComputeBRGValue(uint32_t desiredBaudRate, uint32_t pclkInHz)
+{
+    uint32_t uartDiv;
+
+    if(desiredBaudRate == 0)
+        return 0;
+
+    /* USART1 clock comes from PCLK2, all other USART's use PCLK1.
+    Baud rate equations: Reference manual section 27.3.4. Page 798
+
+    The reference manual splits USARTDIV into a "mantissa" and a 4-bit 
+    fraction, then puts them back together in BRR as mantissa << 4 | fraction.
+    That's just USARTDIV * 16, which is the clock divided by the baud rate. 
+    So all we need is that, rounded to the nearest. I used to do this with 
+    floats and modf, with a carry for when the fraction rounded up to 16. 
+    Rounding the whole thing at once gets the same answer without any of 
+    that. */
+    uartDiv = (pclkInHz + desiredBaudRate / 2) / desiredBaudRate;
+
+    /* The mantissa has to be at least 1, and BRR is only 16 bits */
+    if(uartDiv < 16 || uartDiv > 0xFFFF)
+        return 0;
+
+    return uartDiv;
+}
+
+// *****************************************************************************
+
+uint32_t UART_STM32F1_ComputeActualBaudRate(uint32_t BRGValue, uint32_t pclkInHz)
+{
+    BRGValue &= 0xFFFF;
+
+    if(BRGValue == 0)
+        return 0;
+
+    return (pclkInHz + BRGValue / 2) / BRGValue;
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_Init(UARTSTM32F1 *self, UARTInitType *params)
+{
+    if(params->BRGValue == 0)
+        return;
+
+    self->use9Bit = params->use9Bit;
+    self->flowControl = params->flowControl;
+    self->stopBits = params->stopBits;
+    self->parity = params->parity;
+    self->useRxInterrupt = params->useRxInterrupt;
+    self->useTxInterrupt = params->useTxInterrupt;
+
+    /* Peripheral clock must be enabled before you can write any registers */
+    *self->clockEnableRegister |= self->clockEnableMask;
+
+    /* Turn off module before making changes */
+    self->regs->CR1 &= ~USART_CR1_UE;
+
+    /* Turn off tx/rx interrupts and other bits that I'm going to adjust */
+    self->regs->CR1 &= ~(USART_CR1_RXNEIE | USART_CR1_TXEIE | USART_CR1_M | USART_CR1_PCE);
+
+    /* Set number of data bits, stop bits, and parity */
+    if(self->use9Bit)
+        self->regs->CR1 |= USART_CR1_M;
+
+    switch(self->stopBits)
+    {
+        case UART_HALF_P:
+            self->regs->CR2 |= USART_CR2_STOP_0; // [1:0] = 01
+            self->regs->CR2 &= ~(USART_CR2_STOP_1);
+            break;
+        case UART_ONE_PLUS_HALF_P:
+            self->regs->CR2 |= (USART_CR2_STOP_1 | USART_CR2_STOP_0);
+            break;
+        case UART_TWO_P:
+            self->regs->CR2 &= ~(USART_CR2_STOP_0); // [1:0] = 10
+            self->regs->CR2 |= USART_CR2_STOP_1;
+            break;
+        default:
+            self->regs->CR2 &= ~(USART_CR2_STOP_1 | USART_CR2_STOP_0);
+            break;
+    }
+
+    if(self->parity == UART_EVEN_PARITY)
+    {
+        self->regs->CR1 &= ~USART_CR1_PS;
+        self->regs->CR1 |= USART_CR1_PCE;
+    }
+    else if(self->parity == UART_ODD_PARITY)
+    {
+        self->regs->CR1 |= USART_CR1_PS;
+        self->regs->CR1 |= USART_CR1_PCE;
+    }
+
+    /* TODO Implement software flow control some day */
+    if(self->flowControl == UART_FLOW_HARDWARE)
+    {
+        self->regs->CR3 |= (USART_CR3_CTSE | USART_CR3_RTSE);
+    }
+    else
+    {
+        self->regs->CR3 &= ~(USART_CR3_CTSE | USART_CR3_RTSE);
+    }
+
+    /* Set prescale and baud rate. For this processor, prescale is reserved
+    for low power (IrDa) use only*/
+    self->regs->BRR = (uint16_t)(params->BRGValue);
+
+    /* If you turn on the transmit interrupt during initialization, it could
+    fire off repeatedly. It's best to turn it on after placing data in the 
+    transmit register */
+
+    if(self->useRxInterrupt)
+        self->regs->CR1 |= USART_CR1_RXNEIE; // rx register not empty interrupt
+
+    self->regs->CR1 |= USART_CR1_RE; // enable receiver
+    self->regs->CR1 |= USART_CR1_TE; // enable transmitter
+    self->regs->CR1 |= USART_CR1_UE; // enable UART 
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_ReceivedDataEvent(UARTSTM32F1 *self)
+{
+    if(self->lockRxReceivedEvent == true)
+    {
+        /* Prevent the possibility of another interrupt from somehow calling us 
+        while we're in a callback */
+        if(self->regs->SR & (USART_SR_ORE | USART_SR_FE))
+        {
+            (void)self->regs->DR; // reading DR clears the error
+        }
+        return;
+    }
+    self->lockRxReceivedEvent = true;
+
+    /* RTS is asserted (low) whenever we are ready to receive data. It is 
+    deasserted (high) when the receive register is full. */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->SetRTSPin != NULL)
+    {
+        self->SetRTSPin(true); // set high
+    }
+
+    if(self->ReceivedDataCallback)
+    {
+        self->ReceivedDataCallback(self->GetReceivedByte);
+    }
+    self->lockRxReceivedEvent = false;
+}
+
+// *****************************************************************************
+
+uint8_t UART_STM32F1_GetReceivedByte(UARTSTM32F1 *self)
+{
+    uint8_t data = self->regs->DR;
+
+    /* RTS is asserted (low) whenever we are ready to receive data. It is 
+    deasserted (high) when the receive register is full */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->SetRTSPin != NULL)
+    {
+        self->SetRTSPin(false); // set low
+    }
+
+    return data;
+}
+
+// *****************************************************************************
+
+bool UART_STM32F1_IsReceiveRegisterFull(UARTSTM32F1 *self)
+{
+    bool rxFull = false;
+
+    /* The RX register not empty flag is set when the receive data register has 
+    a character placed in it. It is cleared by reading the character from the
+    receive data register. */
+    if(self->regs->SR & USART_SR_RXNE)
+        rxFull = true;
+
+    /* If the user chooses to poll this function instead of using the receive 
+    data event, we must still do something with the RTS pin. */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->SetRTSPin != NULL)
+    {
+        self->SetRTSPin(rxFull); // "deassert" (high) when full
+    }
+
+    return rxFull;
+}
+
+// *****************************************************************************
+
+bool UART_STM32F1_IsReceiveUsingInterrupts(UARTSTM32F1 *self)
+{
+    return self->useRxInterrupt;
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_ReceiveEnable(UARTSTM32F1 *self)
+{
+    self->regs->CR1 |= USART_CR1_RE;
+
+    if(self->useRxInterrupt) 
+        self->regs->CR1 |= USART_CR1_RXNEIE;
+
+    /* RTS is asserted (low) whenever we are ready to receive data. */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->SetRTSPin != NULL)
+    {
+        self->SetRTSPin(false); // set low
+    }
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_ReceiveDisable(UARTSTM32F1 *self)
+{
+    self->regs->CR1 &= ~USART_CR1_RE;
+
+    /* RTS is deasserted (high) whenever we are not ready to receive data. */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->SetRTSPin != NULL)
+    {
+        self->SetRTSPin(true); // set high
+    }
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_TransmitRegisterEmptyEvent(UARTSTM32F1 *self)
+{
+    /* This will prevent recursive calls if we call transmit byte function from
+    within the transmit interrupt callback. This requires the pending event
+    handler function to be called to catch the txFinishedEventPending flag. */
+    if(self->lockTxFinishedEvent == true)
+    {
+        self->txFinishedEventPending = true;
+        return;
+    }
+    self->lockTxFinishedEvent = true;
+
+    /* Disable transmit interrupt here */
+    self->regs->CR1 &= ~USART_CR1_TXEIE;
+
+    if(self->TransmitRegisterEmptyCallback)
+    {
+        self->TransmitRegisterEmptyCallback();
+    }
+    self->lockTxFinishedEvent = false;
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_TransmitByte(UARTSTM32F1 *self, uint8_t data)
+{
+    /* Check if CTS is asserted (low) before transmitting. If so, send data */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->IsCTSPinLow != NULL &&
+        self->IsCTSPinLow() == false)
+    {
+        return; // CTS was high
+    }
+    
+    /* Clear the transmission complete flag if implemented */
+    self->regs->SR &= ~USART_SR_TC;
+
+    self->regs->DR = data;
+
+    /* Enable transmit interrupt here if needed */
+    if(self->useTxInterrupt)
+        self->regs->CR1 |= USART_CR1_TXEIE;
+}
+
+// *****************************************************************************
+
+bool UART_STM32F1_IsTransmitRegisterEmpty(UARTSTM32F1 *self)
+{
+    bool txReady = false;
+
+    /* The transmit register empty flag is set when the contents of the
+    transmit data register are emptied. It is cleared when the transmit data
+    register is written to */
+    if(self->regs->SR & USART_SR_TXE)
+        txReady = true;
+
+    /* If the user chooses to poll this function instead of using the transmit
+    register empty event, we want to try and prevent transmission if CTS is 
+    asserted */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->IsCTSPinLow != NULL &&
+        self->IsCTSPinLow() == false)
+    {
+        txReady = false; // CTS was high. Don't allow transmission
+    }
+
+    return txReady;
+}
+
+// *****************************************************************************
+
+bool UART_STM32F1_IsTransmitFinished(UARTSTM32F1 *self)
+{
+    bool txReady = false;
+
+    /* The transmit complete flag is set when a full data byte is shifted out 
+    and the transmit register empty flag is set. It is cleared by writing a
+    zero to it. */
+    if(self->regs->SR & USART_SR_TC)
+        txReady = true;
+
+    /* This function will behave the same as the transmit register empty 
+    function. If the user chooses to poll this function, we want to make sure 
+    we block input to the transmit register when CTS is asserted */
+    if(self->flowControl == UART_FLOW_CALLBACKS && self->IsCTSPinLow != NULL &&
+        self->IsCTSPinLow() == false)
+    {
+        txReady = false; // CTS was high. Don't allow transmission
+    }
+
+    return txReady;
+}
+
+// *****************************************************************************
+
+bool UART_STM32F1_IsTransmitUsingInterrupts(UARTSTM32F1 *self)
+{
+    return self->useTxInterrupt;
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_TransmitEnable(UARTSTM32F1 *self)
+{
+    self->regs->CR1 |= USART_CR1_TE;
+
+    /* If the transmit register is full and interrupts are desired, 
+    enable them */
+    if(self->useTxInterrupt && !(self->regs->SR & USART_SR_TXE))
+        self->regs->CR1 |= USART_CR1_TXEIE;
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_TransmitDisable(UARTSTM32F1 *self)
+{
+    while(!(self->regs->SR & USART_SR_TC)){} // wait for transmission to finish
+    self->regs->CR1 &= ~USART_CR1_TE;
+}
+
+// *****************************************************************************
+
+void UART_STM32F1_PendingEventHandler(UARTSTM32F1 *self)
+{
+    if(self->txFinishedEventPending && !self->lockTxFinishedEvent)
+    {
+        self->txFinishedEventPending = false;
+        UART_STM32F1_TransmitRegisterEmptyEvent(self);
+    }
+}
+
+/*
+ End of File
+ */
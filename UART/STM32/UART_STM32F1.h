@@ -0,0 +1,251 @@
+/***************************************************************************//**
+ * @brief UART Driver Header (STM32F1, any port)
+ * 
+ * @file UART_STM32F1.h
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation. Replaces the UART1, UART2, and UART3
+ *                 STM32F1 files
+ * @date 10/18/26  Added actual baud rate
+ * 
+ * @details
+ *      I used to have a separate copy of the whole driver for each UART, with
+ * the only real difference being which registers it used. That's three copies
+ * of the same code in flash, and a new copy every time I needed another port.
+ * 
+ * Now there is one driver. Everything that used to be a static variable is in
+ * a UARTSTM32F1 struct, one for each port, along with a pointer to that
+ * port's registers. Every function takes a pointer to the struct.
+ * 
+ * The IUART function table doesn't give its functions any arguments, so each
+ * port still needs its own set of functions to put in the table. These are
+ * one line each. They just call the driver with the right struct. The macro
+ * UART_STM32F1_PORT writes all of them for you, along with the struct and the
+ * function table. UART_STM32F1_Ports.c uses it to make UART1 through UART3,
+ * and UART4 and UART5 on the parts that have them. The names are the same as
+ * before (UART1_FunctionTable, UART1_Init, UART1_ReceivedDataEvent, and so
+ * on), so nothing changes for code that uses them.
+ * 
+ * To add a port, add a line to UART_STM32F1_Ports.c with the port number,
+ * the register block, the clock enable register, and the clock enable bit.
+ * 
+ * I am currently using register names as given by the header file included
+ * with STM32 F10x standard peripheral library v2.0.3. For testing on a PC,
+ * UART/Host/Mock has a stand in for that header with the registers as plain
+ * variables.
+ * 
+ * @section example_code Example Code
+ *      UART myUART;
+ *      UARTInitType params;
+ *      UART_Create(&myUART, &UART2_FunctionTable);
+ *      UART_SetInitTypeToDefaultParams(&params);
+ *      UART_SetInitBRGValue(&params, UART_ComputeBRGValue(&myUART, 115200, 36000000UL));
+ *      UART_Init(&myUART, &params);
+ * 
+ *      // USART2 interrupt
+ *      void USART2_IRQHandler(void)
+ *      {
+ *          if(USART2->SR & USART_SR_RXNE)
+ *              UART2_ReceivedDataEvent();
+ *          if((USART2->CR1 & USART_CR1_TXEIE) && (USART2->SR & USART_SR_TXE))
+ *              UART2_TransmitRegisterEmptyEvent();
+ *      }
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ ******************************************************************************/
+
+#ifndef UART_STM32F1_H
+#define UART_STM32F1_H
+
+#include "IUART.h"
+
+/* Include processor specific header files here */
+#include "stm32f10x_map.h"
+
+// ***** Defines ***************************************************************
+
+/* Makes the struct, the functions for the function table, and the function
+table for one port. The functions aren't static so that they match the
+prototypes in UART1.h, UART2.h, and so on. */
+#define UART_STM32F1_PORT(n, registers, clockRegister, clockMask)             \
+                                                                               \
+uint8_t UART##n##_GetReceivedByte(void);                                       \
+                                                                               \
+static UARTSTM32F1 uart##n##Port = {                                           \
+    .regs = (registers),                                                       \
+    .clockEnableRegister = (volatile uint32_t *)&(clockRegister),              \
+    .clockEnableMask = (clockMask),                                            \
+    .GetReceivedByte = UART##n##_GetReceivedByte,                              \
+};                                                                             \
+                                                                               \
+uint32_t UART##n##_ComputeBRGValue(uint32_t desiredBaudRate, uint32_t pclkInHz)\
+{ return UART_STM32F1_ComputeBRGValue(desiredBaudRate, pclkInHz); }            \
+uint32_t UART##n##_ComputeActualBaudRate(uint32_t BRGValue, uint32_t pclkInHz) \
+{ return UART_STM32F1_ComputeActualBaudRate(BRGValue, pclkInHz); }            \
+void UART##n##_Init(UARTInitType *params)                                      \
+{ UART_STM32F1_Init(&uart##n##Port, params); }                                 \
+void UART##n##_ReceivedDataEvent(void)                                         \
+{ UART_STM32F1_ReceivedDataEvent(&uart##n##Port); }                            \
+uint8_t UART##n##_GetReceivedByte(void)                                        \
+{ return UART_STM32F1_GetReceivedByte(&uart##n##Port); }                       \
+bool UART##n##_IsReceiveRegisterFull(void)                                     \
+{ return UART_STM32F1_IsReceiveRegisterFull(&uart##n##Port); }                 \
+bool UART##n##_IsReceiveUsingInterrupts(void)                                  \
+{ return UART_STM32F1_IsReceiveUsingInterrupts(&uart##n##Port); }              \
+void UART##n##_ReceiveEnable(void)                                             \
+{ UART_STM32F1_ReceiveEnable(&uart##n##Port); }                                \
+void UART##n##_ReceiveDisable(void)                                            \
+{ UART_STM32F1_ReceiveDisable(&uart##n##Port); }                               \
+void UART##n##_TransmitRegisterEmptyEvent(void)                                \
+{ UART_STM32F1_TransmitRegisterEmptyEvent(&uart##n##Port); }                   \
+void UART##n##_TransmitByte(uint8_t data)                                      \
+{ UART_STM32F1_TransmitByte(&uart##n##Port, data); }                           \
+bool UART##n##_IsTransmitRegisterEmpty(void)                                   \
+{ return UART_STM32F1_IsTransmitRegisterEmpty(&uart##n##Port); }               \
+bool UART##n##_IsTransmitFinished(void)                                        \
+{ return UART_STM32F1_IsTransmitFinished(&uart##n##Port); }                    \
+bool UART##n##_IsTransmitUsingInterrupts(void)                                 \
+{ return UART_STM32F1_IsTransmitUsingInterrupts(&uart##n##Port); }             \
+void UART##n##_TransmitEnable(void)                                            \
+{ UART_STM32F1_TransmitEnable(&uart##n##Port); }                               \
+void UART##n##_TransmitDisable(void)                                           \
+{ UART_STM32F1_TransmitDisable(&uart##n##Port); }                              \
+void UART##n##_PendingEventHandler(void)                                       \
+{ UART_STM32F1_PendingEventHandler(&uart##n##Port); }                          \
+void UART##n##_SetTransmitRegisterEmptyCallback(void (*Function)(void))        \
+{ uart##n##Port.TransmitRegisterEmptyCallback = Function; }                    \
+void UART##n##_SetReceivedDataCallback(                                        \
+    void (*Function)(uint8_t (*CallToGetData)(void)))                          \
+{ uart##n##Port.ReceivedDataCallback = Function; }                             \
+void UART##n##_SetIsCTSPinLowFunc(bool (*Function)(void))                      \
+{ uart##n##Port.IsCTSPinLow = Function; }                                      \
+void UART##n##_SetRTSPinFunc(void (*Function)(bool setPinHigh))                \
+{ uart##n##Port.SetRTSPin = Function; }                                        \
+                                                                               \
+UARTInterface UART##n##_FunctionTable = {                                      \
+    .UART_ComputeBRGValue = UART##n##_ComputeBRGValue,                         \
+    .UART_Init = UART##n##_Init,                                               \
+    .UART_ReceivedDataEvent = UART##n##_ReceivedDataEvent,                     \
+    .UART_GetReceivedByte = UART##n##_GetReceivedByte,                         \
+    .UART_IsReceiveRegisterFull = UART##n##_IsReceiveRegisterFull,             \
+    .UART_IsReceiveUsingInterrupts = UART##n##_IsReceiveUsingInterrupts,       \
+    .UART_ReceiveEnable = UART##n##_ReceiveEnable,                             \
+    .UART_ReceiveDisable = UART##n##_ReceiveDisable,                           \
+    .UART_TransmitRegisterEmptyEvent = UART##n##_TransmitRegisterEmptyEvent,   \
+    .UART_TransmitByte = UART##n##_TransmitByte,                               \
+    .UART_IsTransmitRegisterEmpty = UART##n##_IsTransmitRegisterEmpty,         \
+    .UART_IsTransmitFinished = UART##n##_IsTransmitFinished,                   \
+    .UART_IsTransmitUsingInterrupts = UART##n##_IsTransmitUsingInterrupts,     \
+    .UART_TransmitEnable = UART##n##_TransmitEnable,                           \
+    .UART_TransmitDisable = UART##n##_TransmitDisable,                         \
+    .UART_PendingEventHandler = UART##n##_PendingEventHandler,                 \
+    .UART_SetTransmitRegisterEmptyCallback =                                   \
+        UART##n##_SetTransmitRegisterEmptyCallback,                            \
+    .UART_SetReceivedDataCallback = UART##n##_SetReceivedDataCallback,         \
+    .UART_SetIsCTSPinLowFunc = UART##n##_SetIsCTSPinLowFunc,                   \
+    .UART_SetRTSPinFunc = UART##n##_SetRTSPinFunc,                             \
+    .UART_ComputeActualBaudRate = UART##n##_ComputeActualBaudRate,             \
+}
+
+// ***** Global Variables ******************************************************
+
+typedef struct UARTSTM32F1Tag
+{
+    USART_TypeDef *regs;
+    volatile uint32_t *clockEnableRegister;
+    uint32_t clockEnableMask;
+    uint8_t (*GetReceivedByte)(void);
+    bool use9Bit;
+    bool useRxInterrupt;
+    bool useTxInterrupt;
+    UARTFlowControl flowControl;
+    UARTStopBits stopBits;
+    UARTParity parity;
+    volatile bool lockTxFinishedEvent;
+    volatile bool txFinishedEventPending;
+    volatile bool lockRxReceivedEvent;
+    void (*TransmitRegisterEmptyCallback)(void);
+    void (*ReceivedDataCallback)(uint8_t (*CallToGetData)(void));
+    bool (*IsCTSPinLow)(void);
+    void (*SetRTSPin)(bool setHigh);
+} UARTSTM32F1;
+
+/**
+ * Description of struct members:
+ * 
+ * regs  The port's registers, like USART1
+ * 
+ * clockEnableRegister  The RCC register with the port's clock enable bit.
+ *                      USART1 is on APB2. The rest are on APB1.
+ * 
+ * clockEnableMask  The clock enable bit
+ * 
+ * GetReceivedByte  This port's own GetReceivedByte function from the function
+ *                  table. It's what gets handed to the received data callback.
+ * 
+ * The rest are the settings, locks, and callbacks that used to be static
+ * variables in each file.
+ */
+
+/* The ports in UART_STM32F1_Ports.c that the UART1.h, UART2.h, and UART3.h
+headers don't cover */
+#ifdef UART4
+extern UARTInterface UART4_FunctionTable;
+#endif
+
+#ifdef UART5
+extern UARTInterface UART5_FunctionTable;
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// ***** Function Prototypes *************************************************//
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+/* These work the same as the functions in IUART.h, but for whichever port you
+give them. Normally you won't call these yourself. Use the function table. */
+
+uint32_t UART_STM32F1_ComputeBRGValue(uint32_t desiredBaudRate, uint32_t pclkInHz);
+
+uint32_t UART_STM32F1_ComputeActualBaudRate(uint32_t BRGValue, uint32_t pclkInHz);
+
+void UART_STM32F1_Init(UARTSTM32F1 *self, UARTInitType *params);
+
+void UART_STM32F1_ReceivedDataEvent(UARTSTM32F1 *self);
+
+uint8_t UART_STM32F1_GetReceivedByte(UARTSTM32F1 *self);
+
+bool UART_STM32F1_IsReceiveRegisterFull(UARTSTM32F1 *self);
+
+bool UART_STM32F1_IsReceiveUsingInterrupts(UARTSTM32F1 *self);
+
+void UART_STM32F1_ReceiveEnable(UARTSTM32F1 *self);
+
+void UART_STM32F1_ReceiveDisable(UARTSTM32F1 *self);
+
+void UART_STM32F1_TransmitRegisterEmptyEvent(UARTSTM32F1 *self);
+
+void UART_STM32F1_TransmitByte(UARTSTM32F1 *self, uint8_t data);
+
+bool UART_STM32F1_IsTransmitRegisterEmpty(UARTSTM32F1 *self);
+
+bool UART_STM32F1_IsTransmitFinished(UARTSTM32F1 *self);
+
+bool UART_STM32F1_IsTransmitUsingInterrupts(UARTSTM32F1 *self);
+
+void UART_STM32F1_TransmitEnable(UARTSTM32F1 *self);
+
+void UART_STM32F1_TransmitDisable(UARTSTM32F1 *self);
+
+void UART_STM32F1_PendingEventHandler(UARTSTM32F1 *self);
+
+#endif  /* UART_STM32F1_H */
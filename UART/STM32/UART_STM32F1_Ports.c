@@ -0,0 +1,50 @@
+/***************************************************************************//**
+ * @brief UART Ports (STM32F1)
+ * 
+ * @file UART_STM32F1_Ports.c
+ * 
+ * @author Matthew Spinks <https://github.com/mspinksosu>
+ * 
+ * @date 10/18/26  Original creation
+ * 
+ * @details
+ *      The UART ports that get a function table. Each line makes the struct,
+ * the UARTn_ functions, and UARTn_FunctionTable for one port. See 
+ * UART_STM32F1.h. If you aren't using a port, you can take its line out and 
+ * save a little bit of flash.
+ * 
+ * USART1 is on APB2. The rest are on APB1. UART4 and UART5 are only on the
+ * high density parts, so they are only made if the processor header has them.
+ * 
+ * @section license License
+ * SPDX-FileCopyrightText: © 2026 Matthew Spinks
+ * SPDX-License-Identifier: Zlib
+ * 
+ * This software is released under the Zlib license. You are free alter and
+ * redistribute it, but you must not misrepresent the origin of the software.
+ * This notice may not be removed. <http://www.zlib.net/zlib_license.html>
+ * 
+ * ****************************************************************************/
+
+#include "UART_STM32F1.h"
+#include "UART1.h"
+#include "UART2.h"
+#include "UART3.h"
+
+// ***** Global Variables ******************************************************
+
+UART_STM32F1_PORT(1, USART1, RCC->APB2ENR, RCC_APB2ENR_USART1EN);
+UART_STM32F1_PORT(2, USART2, RCC->APB1ENR, RCC_APB1ENR_USART2EN);
+UART_STM32F1_PORT(3, USART3, RCC->APB1ENR, RCC_APB1ENR_USART3EN);
+
+#ifdef UART4
+UART_STM32F1_PORT(4, UART4, RCC->APB1ENR, RCC_APB1ENR_UART4EN);
+#endif
+
+#ifdef UART5
+UART_STM32F1_PORT(5, UART5, RCC->APB1ENR, RCC_APB1ENR_UART5EN);
+#endif
+
+/*
+ End of File
+ */